@@ -0,0 +1,102 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime()
+
+#include <stdlib.h>         // EXIT_*, strtoull()
+#include <stdint.h>         // uint64_t
+#include <stdio.h>          // printf(), fprintf()
+#include <sys/resource.h>   // getrusage()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** Exits the program with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Benchmarks a backlog building up in a queue and draining, and reports the
+ * peak memory use of the process. The number of elements defaults to 20M and
+ * can be overridden (in M) by the first command line argument. Each backlog
+ * runs in a process of its own, so that peak memory use is that of the one
+ * implementation linked.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 20;
+    if (m == 0) m = 20;
+
+    size_t const n = m * 1000000;
+    Queue*       q = Queue_create(sizeof(uint64_t));
+    if (q == NULL) fail("cannot allocate memory");
+
+    double begin = bench_now();
+    for (uint64_t i = 0; i < n; ++i) {
+        if (!Queue_enqueue(q, &i)) fail("cannot enqueue");
+    }
+    bench_report("enqueue backlog", n, bench_now() - begin);
+
+    uint64_t sum  = 0;
+    uint64_t elem = 0;
+    begin         = bench_now();
+    while (Queue_front(q, &elem)) {
+        sum += elem;
+        Queue_dequeue(q);
+    }
+    bench_report("drain backlog", n, bench_now() - begin);
+    sink = sum;
+
+    // Linux reports the peak resident set size in KiB
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    printf("%-40s %10.2f MiB %10.2f B/elem\n", "peak resident memory",
+           (double)usage.ru_maxrss / 1024.0,
+           (double)usage.ru_maxrss * 1024.0 / (double)n);
+
+    Queue_destroy(q);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c bench_backlog.c -o bench_backlog_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_backlog_circ_array
+
+gcc ../src/queue_spill.c bench_backlog.c -o bench_backlog_spill -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_backlog_spill
+*/
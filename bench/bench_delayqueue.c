@@ -0,0 +1,256 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // fprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "delayqueue.h"    // DelayQueue, DelayQueue_*()
+#include "pqueue.h"        // PQueue, PQueue_*()
+
+static size_t const N_REPS = 3;
+
+/** Longest delay of a timer, in ticks. */
+static uint64_t const MAX_DELAY = (uint64_t)1 << 16;
+
+/** Number of ticks the steady-state workload runs for. */
+static uint64_t const N_TICKS = (uint64_t)1 << 18;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** A timeout, numbered in the order it was scheduled. */
+typedef struct {
+    uint64_t expiry;
+    uint64_t id;
+} Timeout;
+
+/** Determines whether a timeout expires before another in a priority queue. */
+bool expires_before(void const* a, void const* b) {
+    return ((Timeout const*)a)->expiry < ((Timeout const*)b)->expiry;
+}
+
+/** A cheap pseudo-random number generator, to keep `rand()` out of timings. */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/** Creates an array of `n` random delays in `[1, MAX_DELAY]`. */
+uint64_t* create_delays(size_t n) {
+    uint64_t* delays = malloc(n * sizeof(uint64_t));
+    uint64_t  state  = 1;
+    if (delays == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for delays");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        delays[i] = next_random(&state) % MAX_DELAY + 1;
+    }
+    return delays;
+}
+
+/** Expiry context of the delay queue workloads. */
+typedef struct {
+    DelayQueue*     dq;
+    uint64_t const* delays;
+    size_t          n;
+    size_t          next;   // Index of the delay to reschedule with next.
+    uint64_t        sum;
+} Expiry;
+
+/** Sums the ids of the timeouts that expire. */
+void sum_id(void const* elem, void* ctx) {
+    ((Expiry*)ctx)->sum += ((Timeout const*)elem)->id;
+}
+
+/** Sums the ids of the timeouts that expire, and schedules each again. */
+void sum_id_and_reschedule(void const* elem, void* ctx) {
+    Expiry* x       = ctx;
+    Timeout t       = *(Timeout const*)elem;
+    uint64_t const d = x->delays[x->next++ % x->n];
+    x->sum   += t.id;
+    t.expiry += d;
+    DelayQueue_schedule(x->dq, d, &t, NULL);
+}
+
+/** Schedules `n` timeouts on a delay queue, then expires them all. */
+uint64_t drain_by_delayqueue(uint64_t const* delays, size_t n) {
+    DelayQueue* dq = DelayQueue_create(sizeof(Timeout));
+    Expiry      x  = { dq, delays, n, 0, 0 };
+    for (size_t i = 0; i < n; ++i) {
+        Timeout const t = { delays[i], i };
+        DelayQueue_schedule(dq, delays[i], &t, NULL);
+    }
+    while (!DelayQueue_empty(dq)) DelayQueue_advance(dq, 1024, sum_id, &x);
+    DelayQueue_destroy(dq);
+    return x.sum;
+}
+
+/** Runs the same workload as `drain_by_delayqueue()` on a priority queue. */
+uint64_t drain_by_pqueue(uint64_t const* delays, size_t n) {
+    PQueue*  pq  = PQueue_create(sizeof(Timeout), expires_before);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Timeout const t = { delays[i], i };
+        PQueue_push(pq, &t);
+    }
+    for (uint64_t now = 1; !PQueue_empty(pq); ++now) {
+        Timeout const* t;
+        while ((t = PQueue_peek(pq)) != NULL && t->expiry <= now) {
+            sum += t->id;
+            PQueue_pop(pq);
+        }
+    }
+    PQueue_destroy(pq);
+    return sum;
+}
+
+/**
+ * Keeps `n` timeouts outstanding on a delay queue for `N_TICKS` ticks,
+ * scheduling each again as soon as it expires.
+ */
+uint64_t steady_by_delayqueue(uint64_t const* delays, size_t n) {
+    DelayQueue* dq = DelayQueue_create(sizeof(Timeout));
+    Expiry      x  = { dq, delays, n, 0, 0 };
+    for (size_t i = 0; i < n; ++i) {
+        Timeout const t = { delays[i], i };
+        DelayQueue_schedule(dq, delays[i], &t, NULL);
+    }
+    DelayQueue_advance(dq, N_TICKS, sum_id_and_reschedule, &x);
+    DelayQueue_destroy(dq);
+    return x.sum;
+}
+
+/** Runs the same workload as `steady_by_delayqueue()` on a priority queue. */
+uint64_t steady_by_pqueue(uint64_t const* delays, size_t n) {
+    PQueue*  pq   = PQueue_create(sizeof(Timeout), expires_before);
+    uint64_t sum  = 0;
+    size_t   next = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Timeout const t = { delays[i], i };
+        PQueue_push(pq, &t);
+    }
+    for (uint64_t now = 1; now <= N_TICKS; ++now) {
+        Timeout t;
+        while (PQueue_top(pq, &t) && t.expiry <= now) {
+            sum      += t.id;
+            t.expiry += delays[next++ % n];
+            PQueue_pop(pq);
+            PQueue_push(pq, &t);
+        }
+    }
+    PQueue_destroy(pq);
+    return sum;
+}
+
+/**
+ * Schedules `n` timeouts on a delay queue and cancels them all before they
+ * expire, as with requests answered before they time out.
+ */
+uint64_t cancel_by_delayqueue(uint64_t const* delays, size_t n) {
+    DelayQueue* dq  = DelayQueue_create(sizeof(Timeout));
+    TimerId*    ids = malloc(n * sizeof(TimerId));
+    Expiry      x   = { dq, delays, n, 0, 0 };
+    if (ids == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for timer ids");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        Timeout const t = { delays[i], i };
+        DelayQueue_schedule(dq, delays[i], &t, &ids[i]);
+    }
+    for (size_t i = 0; i < n; ++i) x.sum += DelayQueue_cancel(dq, ids[i]);
+    DelayQueue_advance(dq, MAX_DELAY, sum_id, &x);
+    free(ids);
+    DelayQueue_destroy(dq);
+    return x.sum;
+}
+
+/** Times a workload on `n` timeouts, and reports the best of `N_REPS`. */
+void bench_workload(char const* label, uint64_t const* delays, size_t n,
+                    size_t n_elems,
+                    uint64_t (*workload)(uint64_t const*, size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = workload(delays, n);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, n_elems, best);
+}
+
+/**
+ * Benchmarks the delay queue against a priority queue ordered by expiry, with
+ * 1M timeouts outstanding by default, which can be overridden (in M) by the
+ * first command line argument. Delays are uniform up to `MAX_DELAY` ticks.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+    if (m == 0) m = 1;
+
+    size_t const    n      = m << 20;
+    uint64_t* const delays = create_delays(n);
+
+    // Each timeout expires about once every `MAX_DELAY / 2` ticks when steady
+    size_t const n_steady = (size_t)(N_TICKS * n / (MAX_DELAY / 2 + 1));
+
+    bench_workload("schedule all + expire by DelayQueue", delays, n, n,
+                   drain_by_delayqueue);
+    bench_workload("schedule all + expire by PQueue", delays, n, n,
+                   drain_by_pqueue);
+    bench_workload("steady timeouts by DelayQueue", delays, n, n_steady,
+                   steady_by_delayqueue);
+    bench_workload("steady timeouts by PQueue", delays, n, n_steady,
+                   steady_by_pqueue);
+    bench_workload("schedule all + cancel by DelayQueue", delays, n, n,
+                   cancel_by_delayqueue);
+
+    free(delays);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/delayqueue_wheel.c ../src/pqueue_heap.c bench_delayqueue.c -o bench_delayqueue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_delayqueue
+*/
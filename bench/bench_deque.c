@@ -0,0 +1,162 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // printf(), fprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "deque.h"         // Deque, Deque_*()
+
+static size_t const N_REPS = 5;
+
+/** Number of elements kept in the windows and buffers benchmarked. */
+static size_t const WINDOW = 4096;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** A cheap pseudo-random number generator, to keep `rand()` out of timings. */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/** Slides a window of `WINDOW` elements over `n` elements with a queue. */
+void window_queue(size_t n) {
+    Queue*   q   = Queue_create(sizeof(uint64_t));
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        Queue_enqueue(q, &i);
+        if (Queue_size(q) > WINDOW) {
+            sum += *(uint64_t const*)Queue_peek(q);
+            Queue_dequeue(q);
+        }
+    }
+    sink = sum;
+    Queue_destroy(q);
+}
+
+/** Slides a window of `WINDOW` elements over `n` elements with a deque. */
+void window_deque(size_t n) {
+    Deque*   d   = Deque_create(sizeof(uint64_t));
+    uint64_t sum = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        Deque_push_back(d, &i);
+        if (Deque_size(d) > WINDOW) {
+            sum += *(uint64_t const*)Deque_at(d, 0);
+            Deque_pop_front(d);
+        }
+    }
+    sink = sum;
+    Deque_destroy(d);
+}
+
+/**
+ * Runs `n` operations on an undo buffer of at most `WINDOW` elements: records
+ * new elements at the back, forgetting the oldest at the front, and undoes
+ * the most recent ones from the back a quarter of the time.
+ */
+void undo_buffer_deque(size_t n) {
+    Deque*   d   = Deque_create(sizeof(uint64_t));
+    uint64_t sum = 0, state = 1;
+    for (uint64_t i = 0; i < n; ++i) {
+        if (next_random(&state) % 4 == 0 && Deque_back(d, &sum)) {
+            Deque_pop_back(d);
+            continue;
+        }
+        Deque_push_back(d, &i);
+        if (Deque_size(d) > WINDOW) Deque_pop_front(d);
+    }
+    sink = sum;
+    Deque_destroy(d);
+}
+
+/** Reads `n` elements at random positions of a full window of a deque. */
+void random_access_deque(size_t n) {
+    Deque*   d   = Deque_create(sizeof(uint64_t));
+    uint64_t sum = 0, state = 1;
+
+    // Rotate the window so that it wraps around the underlying array
+    for (uint64_t i = 0; i < WINDOW + WINDOW / 2; ++i) {
+        Deque_push_back(d, &i);
+        if (Deque_size(d) > WINDOW) Deque_pop_front(d);
+    }
+    for (size_t i = 0; i < n; ++i) {
+        sum += *(uint64_t const*)Deque_at(d, next_random(&state) % WINDOW);
+    }
+    sink = sum;
+    Deque_destroy(d);
+}
+
+/** Times a workload of `n` operations, and reports the best of `N_REPS`. */
+void bench_workload(char const* label, size_t n, void (*workload)(size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        workload(n);
+        double const secs = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Benchmarks the deque against the queue on a sliding window, and on
+ * workloads only the deque supports. The number of operations defaults to 16M
+ * and can be overridden (in M) by the first command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 16;
+    if (m == 0) m = 16;
+
+    size_t const n = m << 20;
+    bench_workload("sliding window (Queue)", n, window_queue);
+    bench_workload("sliding window (Deque)", n, window_deque);
+    bench_workload("undo buffer (Deque)", n, undo_buffer_deque);
+    bench_workload("random access (Deque)", n, random_access_deque);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/deque_circ_array.c bench_deque.c -o bench_deque -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_deque
+*/
@@ -0,0 +1,156 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // printf(), fprintf(), snprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+
+static size_t const N_REPS = 5;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/**
+ * Sums a queue the way it's done by hand without an iteration API: rotate
+ * each element through the queue, copying it out on the way.
+ */
+uint64_t sum_by_rotation(Queue* queue) {
+    size_t const n    = Queue_size(queue);
+    uint64_t     sum  = 0;
+    uint64_t     elem = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Queue_front(queue, &elem);
+        Queue_dequeue(queue);
+        Queue_enqueue(queue, &elem);
+        sum += elem;
+    }
+    return sum;
+}
+
+void add_elem(void const* elem, void* ctx) {
+    *(uint64_t*)ctx += *(uint64_t const*)elem;
+}
+
+uint64_t sum_by_for_each(Queue* queue) {
+    uint64_t sum = 0;
+    Queue_for_each(queue, add_elem, &sum);
+    return sum;
+}
+
+void combine(void* acc, void const* elem) {
+    *(uint64_t*)acc += *(uint64_t const*)elem;
+}
+
+uint64_t sum_by_fold(Queue* queue) {
+    uint64_t sum = 0;
+    Queue_fold(queue, &sum, combine);
+    return sum;
+}
+
+/** Sums a queue a contiguous segment at a time, in a loop the compiler sees. */
+uint64_t sum_by_segments(Queue* queue) {
+    uint64_t        sum = 0;
+    size_t          len = 0;
+    uint64_t const* seg = NULL;
+    while ((seg = Queue_segment(queue, seg, &len)) != NULL) {
+        for (size_t i = 0; i < len; ++i) sum += seg[i];
+    }
+    return sum;
+}
+
+/**
+ * Creates a queue of `n` consecutive integers that wrap around the end of the
+ * storage of circular-array queues.
+ */
+Queue* create_bench_queue(size_t n) {
+    Queue* q = Queue_create(sizeof(uint64_t));
+    if (q == NULL || !Queue_reserve(q, n)) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+
+    for (uint64_t i = 0; i < n + n / 2; ++i) {
+        if (!Queue_enqueue(q, &i) || (i < n / 2 && !Queue_dequeue(q))) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return q;
+}
+
+/** Times a sum function on a queue, and reports the best of `N_REPS`. */
+void bench_sum(char const* label, Queue* queue, uint64_t (*sum)(Queue*)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = sum(queue);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, Queue_size(queue), best);
+}
+
+/**
+ * Benchmarks summing a queue with `Queue_for_each()`, `Queue_fold()` and
+ * `Queue_segment()` against rotating elements through the queue by hand. The
+ * number of elements defaults to 16M and can be overridden (in M) by the first
+ * command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 16;
+    if (m == 0) m = 16;
+
+    Queue* q = create_bench_queue(m << 20);
+
+    bench_sum("sum by rotation", q, sum_by_rotation);
+    bench_sum("Queue_for_each()", q, sum_by_for_each);
+    bench_sum("Queue_fold()", q, sum_by_fold);
+    bench_sum("Queue_segment()", q, sum_by_segments);
+
+    Queue_destroy(q);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c bench_fold.c -o bench_fold_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_fold_circ_array
+
+gcc ../src/queue_linked_list.c bench_fold.c -o bench_fold_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_fold_linked_list
+*/
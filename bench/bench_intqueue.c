@@ -0,0 +1,277 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // printf(), fprintf()
+#include <string.h>   // memcpy()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "intqueue.h"      // IntQueue, IntQueue_*()
+#include "queue.h"         // Queue, Queue_*()
+
+static size_t const N_REPS = 3;
+
+/** Number of values written or read per call in the bulk workloads. */
+#define CHUNK 1024
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** Exits with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/** A cheap pseudo-random number generator, to keep `rand()` out of timings. */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/** A queue under benchmark, through the operations timed. */
+typedef struct {
+    char const* name;
+    void* (*create)(void);
+    void (*fill)(void* q, uint64_t const* values, size_t n);
+    uint64_t (*drain)(void* q);
+    size_t (*bytes)(void* q);
+    void (*destroy)(void* q);
+} Subject;
+
+static void* create_intqueue(void) {
+    IntQueue* iq = IntQueue_create();
+    if (iq == NULL) fail("cannot allocate memory for an intqueue");
+    return iq;
+}
+
+static void fill_intqueue(void* q, uint64_t const* values, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (!IntQueue_enqueue(q, values[i])) fail("enqueue failed");
+    }
+}
+
+static void write_intqueue(void* q, uint64_t const* values, size_t n) {
+    for (size_t i = 0; i < n; i += CHUNK) {
+        size_t const m = n - i < CHUNK ? n - i : CHUNK;
+        if (IntQueue_write(q, values + i, m) != m) fail("write failed");
+    }
+}
+
+static uint64_t drain_intqueue(void* q) {
+    uint64_t sum = 0;
+    uint64_t value;
+    while (IntQueue_front(q, &value)) {
+        sum += value;
+        IntQueue_dequeue(q);
+    }
+    return sum;
+}
+
+static uint64_t read_intqueue(void* q) {
+    uint64_t sum = 0;
+    uint64_t buf[CHUNK];
+    size_t   m;
+    while ((m = IntQueue_read(q, buf, CHUNK)) > 0) {
+        for (size_t i = 0; i < m; ++i) sum += buf[i];
+    }
+    return sum;
+}
+
+static size_t bytes_intqueue(void* q) { return IntQueue_bytes(q); }
+
+static void destroy_intqueue(void* q) { IntQueue_destroy(q); }
+
+static void* create_queue(void) {
+    Queue* queue = Queue_create(sizeof(uint64_t));
+    if (queue == NULL) fail("cannot allocate memory for a queue");
+    return queue;
+}
+
+static void fill_queue(void* q, uint64_t const* values, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        if (!Queue_enqueue(q, &values[i])) fail("enqueue failed");
+    }
+}
+
+/** Adds values a chunk at a time, written in place after `Queue_extend()`. */
+static void write_queue(void* q, uint64_t const* values, size_t n) {
+    for (size_t i = 0; i < n; i += CHUNK) {
+        size_t const m     = n - i < CHUNK ? n - i : CHUNK;
+        size_t const start = Queue_size(q);
+        if (!Queue_extend(q, m)) fail("extend failed");
+
+        // Skip the segments before the values added, then write them
+        size_t         skip = start;
+        size_t         done = 0;
+        uint64_t const* src = values + i;
+        void*          seg  = NULL;
+        size_t         len;
+        while (done < m && (seg = Queue_segment(q, seg, &len)) != NULL) {
+            size_t const from = skip < len ? skip : len;
+            size_t       k    = len - from;
+            if (k > m - done) k = m - done;
+            memcpy((uint64_t*)seg + from, src + done, k * sizeof(uint64_t));
+            skip -= from;
+            done += k;
+        }
+    }
+}
+
+static uint64_t drain_queue(void* q) {
+    uint64_t sum = 0;
+    uint64_t value;
+    while (Queue_front(q, &value)) {
+        sum += value;
+        Queue_dequeue(q);
+    }
+    return sum;
+}
+
+/** Removes values a chunk at a time, copied out of the front segment. */
+static uint64_t read_queue(void* q) {
+    uint64_t sum = 0;
+    uint64_t buf[CHUNK];
+    size_t   len;
+    void*    seg;
+    while ((seg = Queue_segment(q, NULL, &len)) != NULL) {
+        size_t const m = len < CHUNK ? len : CHUNK;
+        memcpy(buf, seg, m * sizeof(uint64_t));
+        Queue_dequeue_n(q, m);
+        for (size_t i = 0; i < m; ++i) sum += buf[i];
+    }
+    return sum;
+}
+
+static size_t bytes_queue(void* q) {
+    return Queue_capacity(q) * sizeof(uint64_t);
+}
+
+static void destroy_queue(void* q) { Queue_destroy(q); }
+
+// clang-format off
+static Subject const SUBJECTS[] = {
+    { "IntQueue",        create_intqueue, fill_intqueue,  drain_intqueue,
+      bytes_intqueue, destroy_intqueue },
+    { "IntQueue (bulk)", create_intqueue, write_intqueue, read_intqueue,
+      bytes_intqueue, destroy_intqueue },
+    { "Queue",           create_queue,    fill_queue,     drain_queue,
+      bytes_queue,    destroy_queue },
+    { "Queue (bulk)",    create_queue,    write_queue,    read_queue,
+      bytes_queue,    destroy_queue },
+};
+// clang-format on
+
+/**
+ * Times filling a queue with `n` values and draining it, and reports the best
+ * of `N_REPS` of each, and the bytes taken per value when full.
+ */
+void bench_subject(Subject const* subject, uint64_t const* values, size_t n) {
+    double fill_best  = 0.0;
+    double drain_best = 0.0;
+    size_t bytes      = 0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        void* q = subject->create();
+
+        double const begin = bench_now();
+        subject->fill(q, values, n);
+        double const mid = bench_now();
+        bytes            = subject->bytes(q);
+        sink             = subject->drain(q);
+        double const end = bench_now();
+
+        if (rep == 0 || mid - begin < fill_best) fill_best = mid - begin;
+        if (rep == 0 || end - mid < drain_best) drain_best = end - mid;
+        subject->destroy(q);
+    }
+
+    char label[64];
+    snprintf(label, sizeof(label), "  fill %s", subject->name);
+    bench_report(label, n, fill_best);
+    snprintf(label, sizeof(label), "  drain %s", subject->name);
+    bench_report(label, n, drain_best);
+    printf("%-40s %10.3f bytes/elem\n", "", (double)bytes / (double)n);
+}
+
+/**
+ * Benchmarks the integer queue against the circular array queue of 8-byte
+ * values, on 8M values by default, which can be overridden (in M) by the first
+ * command line argument, of each of: sequential IDs, timestamps 1 us apart
+ * with jitter, timestamps of irregular events, and random values.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 8;
+    if (m == 0) m = 1;
+
+    size_t const n      = m << 20;
+    uint64_t*    values = malloc(n * sizeof(uint64_t));
+    if (values == NULL) fail("cannot allocate memory for values");
+
+    char const* const datasets[] = { "sequential IDs", "timestamps 1 us apart",
+                                     "irregular timestamps", "random values" };
+    for (size_t d = 0; d < sizeof(datasets) / sizeof(datasets[0]); ++d) {
+        uint64_t state = 1;
+        uint64_t t     = (uint64_t)1700000000 * 1000000000;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t const r = next_random(&state);
+            switch (d) {
+            case 0: values[i] = 1000000 + i; break;
+            case 1: values[i] = (t += 1000 + r % 64); break;
+            case 2: values[i] = (t += r % 1000000); break;
+            default: values[i] = r;
+            }
+        }
+
+        printf("%s\n", datasets[d]);
+        for (size_t s = 0; s < sizeof(SUBJECTS) / sizeof(SUBJECTS[0]); ++s) {
+            bench_subject(&SUBJECTS[s], values, n);
+        }
+    }
+
+    free(values);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/recordqueue_circ_array.c ../src/intqueue_delta.c bench_intqueue.c -o bench_intqueue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_intqueue
+
+Add -mno-avx2 to compare with decoding without SIMD.
+*/
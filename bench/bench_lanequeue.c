@@ -0,0 +1,199 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint32_t, uint64_t
+#include <stdio.h>    // fprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "lanequeue.h"     // LaneQueue, LaneQueue_*()
+#include "pqueue.h"        // PQueue, PQueue_*()
+
+static size_t const N_REPS = 3;
+
+/** Number of jobs waiting in the steady-state workload. */
+static size_t const BACKLOG = 1024;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** A job of a priority class, numbered in the order it was submitted. */
+typedef struct {
+    uint32_t lane;
+    uint32_t id;
+    uint64_t seq;
+} Job;
+
+/**
+ * Determines whether a job goes before another in a priority queue, which
+ * requires the submission order to keep jobs of the same class in FIFO order.
+ */
+bool runs_before(void const* a, void const* b) {
+    Job const* x = a;
+    Job const* y = b;
+    return x->lane > y->lane || (x->lane == y->lane && x->seq < y->seq);
+}
+
+/** A cheap pseudo-random number generator, to keep `rand()` out of timings. */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/** Creates an array of `n` jobs of random classes, in submission order. */
+Job* create_jobs(size_t n) {
+    Job*     jobs  = malloc(n * sizeof(Job));
+    uint64_t state = 1;
+    if (jobs == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for jobs");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t const r = next_random(&state);
+        jobs[i] = (Job){ .lane = (uint32_t)(r % LANEQUEUE_MAX_LANES),
+                         .id   = (uint32_t)(r >> 32),
+                         .seq  = i };
+    }
+    return jobs;
+}
+
+/** Submits `n` jobs to a multi-level queue, then dispatches them all. */
+uint64_t drain_by_lanequeue(Job const* jobs, size_t n) {
+    LaneQueue* lq  = LaneQueue_create(sizeof(Job), LANEQUEUE_MAX_LANES);
+    uint64_t   sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        LaneQueue_enqueue(lq, jobs[i].lane, &jobs[i]);
+    }
+    while (!LaneQueue_empty(lq)) {
+        sum += ((Job const*)LaneQueue_peek(lq, NULL))->id;
+        LaneQueue_dequeue(lq);
+    }
+    LaneQueue_destroy(lq);
+    return sum;
+}
+
+/** Runs the same workload as `drain_by_lanequeue()` on a priority queue. */
+uint64_t drain_by_pqueue(Job const* jobs, size_t n) {
+    PQueue*  pq  = PQueue_create(sizeof(Job), runs_before);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) PQueue_push(pq, &jobs[i]);
+    while (!PQueue_empty(pq)) {
+        sum += ((Job const*)PQueue_peek(pq))->id;
+        PQueue_pop(pq);
+    }
+    PQueue_destroy(pq);
+    return sum;
+}
+
+/**
+ * Keeps `BACKLOG` jobs waiting in a multi-level queue, dispatching one for
+ * each of the other jobs submitted.
+ */
+uint64_t steady_by_lanequeue(Job const* jobs, size_t n) {
+    LaneQueue* lq  = LaneQueue_create(sizeof(Job), LANEQUEUE_MAX_LANES);
+    uint64_t   sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        LaneQueue_enqueue(lq, jobs[i].lane, &jobs[i]);
+        if (i < BACKLOG) continue;
+
+        sum += ((Job const*)LaneQueue_peek(lq, NULL))->id;
+        LaneQueue_dequeue(lq);
+    }
+    LaneQueue_destroy(lq);
+    return sum;
+}
+
+/** Runs the same workload as `steady_by_lanequeue()` on a priority queue. */
+uint64_t steady_by_pqueue(Job const* jobs, size_t n) {
+    PQueue*  pq  = PQueue_create(sizeof(Job), runs_before);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; ++i) {
+        PQueue_push(pq, &jobs[i]);
+        if (i < BACKLOG) continue;
+
+        sum += ((Job const*)PQueue_peek(pq))->id;
+        PQueue_pop(pq);
+    }
+    PQueue_destroy(pq);
+    return sum;
+}
+
+/** Times a workload on `n` jobs, and reports the best of `N_REPS`. */
+void bench_workload(char const* label, Job const* jobs, size_t n,
+                    uint64_t (*workload)(Job const*, size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = workload(jobs, n);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Benchmarks the multi-level queue against a priority queue ordered by class
+ * then submission, on jobs of `LANEQUEUE_MAX_LANES` classes. The number of
+ * jobs defaults to 4M and can be overridden (in M) by the first command line
+ * argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 4;
+    if (m == 0) m = 4;
+
+    size_t const n    = m << 20;
+    Job* const   jobs = create_jobs(n);
+
+    bench_workload("submit all + dispatch by LaneQueue", jobs, n,
+                   drain_by_lanequeue);
+    bench_workload("submit all + dispatch by PQueue", jobs, n,
+                   drain_by_pqueue);
+    bench_workload("steady backlog by LaneQueue", jobs, n,
+                   steady_by_lanequeue);
+    bench_workload("steady backlog by PQueue", jobs, n, steady_by_pqueue);
+
+    free(jobs);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/lanequeue_bitmap.c ../src/pqueue_heap.c bench_lanequeue.c -o bench_lanequeue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_lanequeue
+*/
@@ -0,0 +1,161 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), strtoull()
+#include <stdio.h>    // printf(), snprintf()
+#include <stdbool.h>  // bool
+#include <assert.h>   // assert()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // merge_queues(), merge_k_queues()
+
+static size_t const MAX_K  = 1024;
+static size_t const N_REPS = 3;
+
+bool less(void const* a, void const* b) { return *(int*)a < *(int*)b; }
+
+/** Fills `k` queues with `n` sorted random elements in total, round robin. */
+void fill_bench_queues(Queue** qs, size_t k, size_t n) {
+    int* last = calloc(k, sizeof(int));
+    if (last == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for keys");
+        exit(EXIT_FAILURE);
+    }
+
+    srand(42);
+    for (size_t j = 0; j < k; ++j) qs[j] = Queue_create(sizeof(int));
+    for (size_t i = 0; i < n; ++i) {
+        size_t const j = i % k;
+        last[j]        += rand() % 64;
+        if (!Queue_enqueue(qs[j], &last[j])) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    free(last);
+}
+
+/**
+ * Merges `k` non-empty queues by merging adjacent pairs of queues with
+ * `merge_queues()` level by level until one queue is left.
+ */
+Queue* merge_pairwise(Queue** qs, size_t k) {
+    Queue** level = malloc(k * sizeof(Queue*));
+    bool*   owned = malloc(k * sizeof(bool));   // intermediate queue?
+    for (size_t j = 0; j < k; ++j) {
+        level[j] = qs[j];
+        owned[j] = false;
+    }
+
+    for (size_t m = k; m > 1; m = (m + 1) / 2) {
+        for (size_t j = 0; j < m; j += 2) {
+            if (j + 1 == m) {
+                level[j / 2] = level[j];
+                owned[j / 2] = owned[j];
+                continue;
+            }
+            Queue* merged = merge_queues(level[j], level[j + 1], sizeof(int),
+                                         less);
+            if (owned[j]) Queue_destroy(level[j]);
+            if (owned[j + 1]) Queue_destroy(level[j + 1]);
+            level[j / 2] = merged;
+            owned[j / 2] = true;
+        }
+    }
+
+    Queue* merged = level[0];
+    free(level);
+    free(owned);
+    return merged;
+}
+
+/** Times merging `k` queues of `n` elements in total with both approaches. */
+void bench_merge_k(size_t k, size_t n) {
+    Queue** qs      = malloc(k * sizeof(Queue*));
+    double  best_k  = 0.0;
+    double  best_pw = 0.0;
+
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        fill_bench_queues(qs, k, n);
+        double begin  = bench_now();
+        Queue* merged = merge_k_queues(qs, k, sizeof(int), less);
+        double secs   = bench_now() - begin;
+        if (rep == 0 || secs < best_k) best_k = secs;
+        assert(Queue_size(merged) == n && "elements lost");
+        Queue_destroy(merged);
+        for (size_t j = 0; j < k; ++j) Queue_destroy(qs[j]);
+
+        fill_bench_queues(qs, k, n);
+        begin  = bench_now();
+        merged = merge_pairwise(qs, k);
+        secs   = bench_now() - begin;
+        if (rep == 0 || secs < best_pw) best_pw = secs;
+        assert(Queue_size(merged) == n && "elements lost");
+        Queue_destroy(merged);
+        for (size_t j = 0; j < k; ++j) Queue_destroy(qs[j]);
+    }
+    free(qs);
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "merge_k_queues() [k = %4lu]", k);
+    bench_report(buf, n, best_k);
+    snprintf(buf, sizeof(buf), "pairwise merge_queues() [k = %4lu]", k);
+    bench_report(buf, n, best_pw);
+}
+
+/**
+ * Benchmarks `merge_k_queues()` against merging pairs of queues level by level
+ * with `merge_queues()` for k = 2, 4, ..., 1024. The total number of elements
+ * defaults to 2^22 and can be overridden by the first command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 0;
+    if (n < MAX_K) n = (size_t)1 << 22;
+
+    for (size_t k = 2; k <= MAX_K; k *= 2) bench_merge_k(k, n);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/algos.c bench_merge_k_queues.c -o bench_merge_k_queues_circ_array -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_merge_k_queues_circ_array
+
+gcc ../src/queue_linked_list.c ../src/algos.c bench_merge_k_queues.c -o bench_merge_k_queues_linked_list -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_merge_k_queues_linked_list
+*/
@@ -0,0 +1,166 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdio.h>    // printf(), snprintf()
+#include <string.h>   // memset()
+#include <assert.h>   // assert()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // merge_queues()
+
+static size_t const ELEM_SZS[] = { 4, 64 };
+static size_t const RUNS[]     = { 1, 4, 64, 4096 };
+static size_t const N_REPS     = 5;
+
+bool less(void const* a, void const* b) { return *(int*)a < *(int*)b; }
+
+/**
+ * The merge that `merge_queues()` used to be before galloping: every element
+ * but the leftover tail is compared and moved one at a time.
+ */
+Queue* merge_queues_by_elem(Queue* queue1, Queue* queue2, size_t elem_sz,
+                            bool (*compare)(void const*, void const*)) {
+    Queue* merged = Queue_create(elem_sz);
+    Queue_reserve(merged, Queue_size(queue1) + Queue_size(queue2));
+
+    void const* elem1 = Queue_peek(queue1);
+    void const* elem2 = Queue_peek(queue2);
+    while (elem1 != NULL && elem2 != NULL) {
+        if (compare(elem1, elem2)) {
+            Queue_enqueue(merged, elem1);
+            Queue_dequeue(queue1);
+            elem1 = Queue_peek(queue1);
+        } else {
+            Queue_enqueue(merged, elem2);
+            Queue_dequeue(queue2);
+            elem2 = Queue_peek(queue2);
+        }
+    }
+
+    Queue* curr_queue = elem1 != NULL ? queue1 : queue2;
+    Queue_transfer(merged, curr_queue, Queue_size(curr_queue));
+    return merged;
+}
+
+/**
+ * Creates a queue of `n` elements of `elem_sz` bytes, keyed by the `int` at
+ * the start of each element. Keys go up by 2 in clusters of `run` elements;
+ * clusters of two queues created with `first` set to 0 and `run` interleave.
+ */
+Queue* create_bench_queue(size_t elem_sz, size_t n, size_t run, int first) {
+    Queue* q    = Queue_create(elem_sz);
+    char*  elem = malloc(elem_sz);
+    if (q == NULL || elem == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+    memset(elem, 0xab, elem_sz);
+
+    for (size_t i = 0; i < n; ++i) {
+        *(int*)elem = first + (int)((i / run) * 4 * run + (i % run) * 2);
+        if (!Queue_enqueue(q, elem)) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    free(elem);
+    return q;
+}
+
+/**
+ * Times a merge function on two queues of `n` elements each interleaving in
+ * clusters of `run` elements, and reports the best of `N_REPS`.
+ */
+void bench_merge(char const* label, size_t elem_sz, size_t n, size_t run,
+                 Queue* (*merge)(Queue*, Queue*, size_t,
+                                 bool (*)(void const*, void const*))) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        Queue* q1 = create_bench_queue(elem_sz, n, run, 0);
+        Queue* q2 = create_bench_queue(elem_sz, n, run, (int)run * 2);
+
+        double const begin  = bench_now();
+        Queue*       merged = merge(q1, q2, elem_sz, less);
+        double const secs   = bench_now() - begin;
+
+        assert(Queue_size(merged) == 2 * n && "elements lost");
+        if (rep == 0 || secs < best) best = secs;
+
+        Queue_destroy(q1);
+        Queue_destroy(q2);
+        Queue_destroy(merged);
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s [%4lu B, run %4lu]", label, elem_sz, run);
+    bench_report(buf, 2 * n, best);
+}
+
+/**
+ * Benchmarks `merge_queues()` against the element-by-element merge on queues
+ * that interleave element by element up to in long clusters, across element
+ * sizes. The total payload per queue defaults to 16 MiB and can be overridden
+ * (in MiB) by the first command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t mib = argc > 1 ? strtoull(argv[1], NULL, 10) : 16;
+    if (mib == 0) mib = 16;
+
+    size_t const n_szs  = sizeof(ELEM_SZS) / sizeof(size_t);
+    size_t const n_runs = sizeof(RUNS) / sizeof(size_t);
+    for (size_t i = 0; i < n_szs; ++i) {
+        size_t const n = (mib << 20) / ELEM_SZS[i];
+        for (size_t j = 0; j < n_runs; ++j) {
+            bench_merge("merge_queues_by_elem()", ELEM_SZS[i], n, RUNS[j],
+                        merge_queues_by_elem);
+            bench_merge("merge_queues()", ELEM_SZS[i], n, RUNS[j],
+                        merge_queues);
+        }
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/algos.c bench_merge_queues_galloping.c -o bench_merge_queues_galloping_circ_array -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_merge_queues_galloping_circ_array
+
+gcc ../src/queue_linked_list.c ../src/algos.c bench_merge_queues_galloping.c -o bench_merge_queues_galloping_linked_list -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_merge_queues_galloping_linked_list
+*/
@@ -0,0 +1,130 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, rand(), strtoull()
+#include <stdio.h>    // printf(), snprintf()
+#include <assert.h>   // assert()
+#include <unistd.h>   // sysconf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // merge_queues(), merge_queues_parallel()
+
+static size_t const N_REPS = 3;
+
+bool less(void const* a, void const* b) { return *(int*)a < *(int*)b; }
+
+/** Creates a queue of `n` sorted random elements. */
+Queue* create_bench_queue(size_t n) {
+    Queue* q    = Queue_create(sizeof(int));
+    int    elem = 0;
+    if (q == NULL || !Queue_reserve(q, n)) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        elem += rand() % 4;
+        if (!Queue_enqueue(q, &elem)) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return q;
+}
+
+/**
+ * Times merging two queues of `n` elements each with `n_threads` threads, or
+ * with `merge_queues()` if `n_threads` is zero, and reports the best of
+ * `N_REPS`.
+ */
+void bench_merge(size_t n, size_t n_threads) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        srand(42);
+        Queue* q1 = create_bench_queue(n);
+        Queue* q2 = create_bench_queue(n);
+
+        double const begin  = bench_now();
+        Queue* const merged = n_threads == 0
+                                  ? merge_queues(q1, q2, sizeof(int), less)
+                                  : merge_queues_parallel(q1, q2, sizeof(int),
+                                                          less, n_threads);
+        double const secs   = bench_now() - begin;
+
+        assert(merged != NULL && Queue_size(merged) == 2 * n && "lost elems");
+        if (rep == 0 || secs < best) best = secs;
+
+        Queue_destroy(q1);
+        Queue_destroy(q2);
+        Queue_destroy(merged);
+    }
+
+    char buf[64];
+    if (n_threads == 0) {
+        snprintf(buf, sizeof(buf), "merge_queues()");
+    } else {
+        snprintf(buf, sizeof(buf), "merge_queues_parallel() [p = %3lu]",
+                 n_threads);
+    }
+    bench_report(buf, 2 * n, best);
+}
+
+/**
+ * Benchmarks `merge_queues_parallel()` from one thread up to all online
+ * processors, doubling the number of threads each time, against
+ * `merge_queues()`. Each queue has 2^23 elements by default, which can be
+ * overridden by the first command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t n = argc > 1 ? strtoull(argv[1], NULL, 10) : 0;
+    if (n == 0) n = (size_t)1 << 23;
+
+    long const   n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    size_t const max_p  = n_cpus > 0 ? (size_t)n_cpus : 1;
+
+    bench_merge(n, 0);
+    for (size_t p = 1; p < max_p; p *= 2) bench_merge(n, p);
+    bench_merge(n, max_p);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/algos.c bench_merge_queues_parallel.c -o bench_merge_queues_parallel -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_merge_queues_parallel
+*/
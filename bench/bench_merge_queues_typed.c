@@ -0,0 +1,169 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), strtoull()
+#include <stdint.h>   // int32_t, uint64_t
+#include <stdio.h>    // printf(), snprintf()
+#include <assert.h>   // assert()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // merge_queues(), merge_queues_*()
+
+static size_t const N_REPS = 5;
+
+// clang-format off
+bool less_i32(void const* a, void const* b) { return *(int32_t*)a < *(int32_t*)b; }
+bool less_u64(void const* a, void const* b) { return *(uint64_t*)a < *(uint64_t*)b; }
+bool less_f32(void const* a, void const* b) { return *(float*)a < *(float*)b; }
+bool less_f64(void const* a, void const* b) { return *(double*)a < *(double*)b; }
+// clang-format on
+
+/** A primitive element type along with its merges. */
+struct elem_type
+{
+    char const* name;     // Name of the type
+    size_t      elemsz;   // Size of each element in bytes
+    bool (*less)(void const*, void const*);       // Generic element order
+    Queue* (*merge)(Queue*, Queue*, KeyOrder);    // Typed merge
+    void (*store)(long, void*);                   // Integral key to element
+};
+
+// clang-format off
+void store_i32(long key, void* elem) { *(int32_t*)elem = (int32_t)key; }
+void store_u64(long key, void* elem) { *(uint64_t*)elem = (uint64_t)key; }
+void store_f32(long key, void* elem) { *(float*)elem = (float)key; }
+void store_f64(long key, void* elem) { *(double*)elem = (double)key; }
+// clang-format on
+
+static struct elem_type const TYPES[] = {
+    { "i32", sizeof(int32_t), less_i32, merge_queues_i32, store_i32 },
+    { "u64", sizeof(uint64_t), less_u64, merge_queues_u64, store_u64 },
+    { "f32", sizeof(float), less_f32, merge_queues_f32, store_f32 },
+    { "f64", sizeof(double), less_f64, merge_queues_f64, store_f64 },
+};
+
+/**
+ * Creates a queue of `n` ascending elements. Keys go up by a random step
+ * below 4, in runs of `run` elements separated by gaps of `gap`, so that
+ * two such queues with a nonzero `gap` interleave in runs rather than
+ * element by element.
+ */
+Queue* create_bench_queue(struct elem_type const* type, size_t n, size_t run,
+                          long gap, long first) {
+    Queue* q   = Queue_create(type->elemsz);
+    long   key = first;
+    double elem;   // large enough for any element type
+    if (q == NULL || !Queue_reserve(q, n)) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        key += rand() % 4 + (i % run == 0 ? gap : 0);
+        type->store(key, &elem);
+        if (!Queue_enqueue(q, &elem)) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return q;
+}
+
+/**
+ * Times the generic and the typed merge of two queues of `n` elements each,
+ * and reports the best of `N_REPS` for each.
+ */
+void bench_merge(struct elem_type const* type, char const* input, size_t n,
+                 size_t run, long gap) {
+    double best_generic = 0.0;
+    double best_typed   = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        for (int typed = 0; typed <= 1; ++typed) {
+            srand(rep);
+            Queue* q1 = create_bench_queue(type, n, run, gap, 0);
+            Queue* q2 = create_bench_queue(type, n, run, gap, gap / 2);
+
+            double const begin  = bench_now();
+            Queue*       merged = typed
+                                      ? type->merge(q1, q2, ASCENDING)
+                                      : merge_queues(q1, q2, type->elemsz,
+                                                     type->less);
+            double const secs   = bench_now() - begin;
+
+            assert(Queue_size(merged) == 2 * n && "elements lost");
+            double* best = typed ? &best_typed : &best_generic;
+            if (rep == 0 || secs < *best) *best = secs;
+
+            Queue_destroy(q1);
+            Queue_destroy(q2);
+            Queue_destroy(merged);
+        }
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "merge_queues() [%s, %s]", type->name, input);
+    bench_report(buf, 2 * n, best_generic);
+    snprintf(buf, sizeof(buf), "merge_queues_%s() [%s]", type->name, input);
+    bench_report(buf, 2 * n, best_typed);
+}
+
+/**
+ * Benchmarks the typed merges against `merge_queues()` on randomly interleaved
+ * keys, for which the branches of a comparison-based merge are unpredictable,
+ * and on keys skewed into long runs from either queue. The number of elements
+ * per queue defaults to 4M and can be overridden (in M) by the first command
+ * line argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 4;
+    if (m == 0) m = 4;
+
+    size_t const n       = m << 20;
+    size_t const n_types = sizeof(TYPES) / sizeof(TYPES[0]);
+    for (size_t i = 0; i < n_types; ++i) {
+        bench_merge(&TYPES[i], "random", n, 1, 0);
+        bench_merge(&TYPES[i], "skewed", n, 256, 1024);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/algos.c ../src/merge_kernels.c bench_merge_queues_typed.c -o bench_merge_queues_typed -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_merge_queues_typed
+*/
@@ -0,0 +1,231 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // fprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // merge_queues()
+
+static size_t const N_REPS = 3;
+
+/** Size of a frame in bytes. */
+#define FRAME_SZ 16384
+
+/** Number of frames outstanding in the steady-state workloads. */
+static size_t const WINDOW = 64;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** A large element, of which only the header is written or read. */
+typedef struct {
+    uint64_t seq;
+    uint64_t key;
+    char     payload[FRAME_SZ - 2 * sizeof(uint64_t)];
+} Frame;
+
+/** Exits with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/** Allocates a frame, exiting on failure. */
+static Frame* create_frame(uint64_t seq, uint64_t key) {
+    Frame* f = malloc(sizeof(Frame));
+    if (f == NULL) fail("cannot allocate memory for a frame");
+    f->seq = seq;
+    f->key = key;
+    return f;
+}
+
+/** Orders frames by key. */
+bool key_before(void const* a, void const* b) {
+    return ((Frame const*)a)->key < ((Frame const*)b)->key;
+}
+
+/** Orders frames held by pointer by key. */
+bool owned_key_before(void const* a, void const* b) {
+    return key_before(*(Frame* const*)a, *(Frame* const*)b);
+}
+
+/**
+ * Keeps `WINDOW` frames outstanding on a queue of frames while `n` frames
+ * pass through it, copied in and out.
+ */
+uint64_t steady_by_value(size_t n) {
+    Queue*   q   = Queue_create(sizeof(Frame));
+    Frame*   in  = create_frame(0, 0);
+    Frame*   out = create_frame(0, 0);
+    uint64_t sum = 0;
+    if (q == NULL) fail("cannot allocate memory for a queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        in->seq = i;
+        if (!Queue_enqueue(q, in)) fail("enqueue failed");
+        if (i < WINDOW) continue;
+
+        Queue_front(q, out);
+        sum += out->seq;
+        Queue_dequeue(q);
+    }
+    free(out);
+    free(in);
+    Queue_destroy(q);
+    return sum;
+}
+
+/**
+ * Runs `steady_by_value()` on a queue that owns its frames, each allocated
+ * by the producer and freed by the consumer.
+ */
+uint64_t steady_owned(size_t n) {
+    Queue*   q   = Queue_create_owned(free);
+    uint64_t sum = 0;
+    if (q == NULL) fail("cannot allocate memory for a queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!Queue_enqueue_owned(q, create_frame(i, 0))) fail("enqueue failed");
+        if (i < WINDOW) continue;
+
+        Frame* f  = Queue_take_front(q);
+        sum      += f->seq;
+        free(f);
+    }
+    Queue_destroy(q);
+    return sum;
+}
+
+/** Merges two queues of `n / 2` frames each with interleaved keys. */
+uint64_t merge_by_value(size_t n) {
+    Queue* q1 = Queue_create(sizeof(Frame));
+    Queue* q2 = Queue_create(sizeof(Frame));
+    Frame* f  = create_frame(0, 0);
+    if (q1 == NULL || q2 == NULL) fail("cannot allocate memory for a queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        f->seq = f->key = i;
+        if (!Queue_enqueue(i % 2 == 0 ? q1 : q2, f)) fail("enqueue failed");
+    }
+    free(f);
+
+    double const begin  = bench_now();
+    Queue*       merged = merge_queues(q1, q2, sizeof(Frame), key_before);
+    double const secs   = bench_now() - begin;
+
+    if (merged != q1 && merged != q2) Queue_destroy(merged);
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+    return (uint64_t)(secs * 1e9);
+}
+
+/** Runs `merge_by_value()` on queues that own their frames. */
+uint64_t merge_owned(size_t n) {
+    Queue* q1 = Queue_create_owned(free);
+    Queue* q2 = Queue_create_owned(free);
+    if (q1 == NULL || q2 == NULL) fail("cannot allocate memory for a queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        Frame* f = create_frame(i, i);
+        if (!Queue_enqueue_owned(i % 2 == 0 ? q1 : q2, f)) {
+            fail("enqueue failed");
+        }
+    }
+
+    double const begin  = bench_now();
+    Queue*       merged = merge_queues(q1, q2, sizeof(Frame*),
+                                       owned_key_before);
+    double const secs   = bench_now() - begin;
+
+    // The merged queue owns the frames, unless it is one of the inputs
+    if (merged != q1 && merged != q2) Queue_destroy(merged);
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+    return (uint64_t)(secs * 1e9);
+}
+
+/** Times a workload on `n` frames, and reports the best of `N_REPS`. */
+void bench_workload(char const* label, size_t n, uint64_t (*workload)(size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = workload(n);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, n, best);
+}
+
+/** Times a workload that times itself, and reports the best of `N_REPS`. */
+void bench_timed(char const* label, size_t n, uint64_t (*workload)(size_t)) {
+    uint64_t best = 0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        uint64_t const ns = workload(n);
+        if (rep == 0 || ns < best) best = ns;
+    }
+    bench_report(label, n, (double)best * 1e-9);
+}
+
+/**
+ * Benchmarks queues of 16 KiB frames held by value against queues that own
+ * them by pointer, with 4K frames merged and 64K frames passed through by
+ * default, which can be overridden (in K frames merged) by the first command
+ * line argument.
+ */
+int main(int argc, char** argv) {
+    size_t k = argc > 1 ? strtoull(argv[1], NULL, 10) : 4;
+    if (k == 0) k = 1;
+
+    size_t const n = k << 10;
+
+    bench_workload("steady frames by value", 16 * n, steady_by_value);
+    bench_workload("steady frames owned", 16 * n, steady_owned);
+    bench_timed("merge_queues() by value", n, merge_by_value);
+    bench_timed("merge_queues() owned", n, merge_owned);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/algos.c ../src/merge_kernels.c ../src/sort.c ../src/partition.c ../src/window.c bench_owned.c -o bench_owned_circ_array -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_owned_circ_array
+
+gcc ../src/queue_linked_list.c ../src/algos.c ../src/merge_kernels.c ../src/sort.c ../src/partition.c ../src/window.c bench_owned.c -o bench_owned_linked_list -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_owned_linked_list
+*/
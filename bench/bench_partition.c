@@ -0,0 +1,175 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), srand(), ...
+#include <stdint.h>   // uint32_t
+#include <stdio.h>    // printf(), snprintf()
+#include <assert.h>   // assert()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // Queue_partition(), Queue_filter_in_place()
+
+static size_t const N_REPS = 5;
+
+/** Width of the spans of consecutive keys for which `pred()` is the same. */
+static uint32_t const SPAN_SHIFT = 6;
+
+bool pred(void const* elem) { return *(uint32_t*)elem >> SPAN_SHIFT & 1; }
+
+/**
+ * Partitions a queue the way it's done by hand without `Queue_partition()`:
+ * copy out the front element, enqueue it to either queue and dequeue it.
+ */
+bool partition_by_elem(Queue* src, Queue* out_true, Queue* out_false) {
+    uint32_t elem = 0;
+    while (Queue_front(src, &elem)) {
+        if (!Queue_enqueue(pred(&elem) ? out_true : out_false, &elem)) {
+            return false;
+        }
+        Queue_dequeue(src);
+    }
+    return true;
+}
+
+bool partition_by_span(Queue* src, Queue* out_true, Queue* out_false) {
+    return Queue_partition(src, sizeof(uint32_t), pred, out_true, out_false);
+}
+
+/**
+ * Filters a queue the way it's done by hand without `Queue_filter_in_place()`:
+ * rotate each element to the end of the queue if it's to keep.
+ */
+bool filter_by_elem(Queue* queue, Queue* unused1, Queue* unused2) {
+    size_t const n    = Queue_size(queue);
+    uint32_t     elem = 0;
+    for (size_t i = 0; i < n; ++i) {
+        Queue_front(queue, &elem);
+        Queue_dequeue(queue);
+        if (pred(&elem) && !Queue_enqueue(queue, &elem)) return false;
+    }
+    return true;
+}
+
+bool filter_in_place(Queue* queue, Queue* unused1, Queue* unused2) {
+    return Queue_filter_in_place(queue, sizeof(uint32_t), pred);
+}
+
+/**
+ * Creates a queue of `n` keys, which are consecutive if `clustered` is set, so
+ * that `pred()` is the same for spans of keys, and random otherwise.
+ */
+Queue* create_bench_queue(size_t n, bool clustered) {
+    Queue* q = Queue_create(sizeof(uint32_t));
+    if (q == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t const key =
+            clustered ? (uint32_t)i : (uint32_t)rand() << 16 ^ (uint32_t)rand();
+        if (!Queue_enqueue(q, &key)) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return q;
+}
+
+/**
+ * Times a partition or filter function on a queue of `n` keys, and reports the
+ * best of `N_REPS`.
+ */
+void bench_partition(char const* label, size_t n, bool clustered,
+                     bool (*partition)(Queue*, Queue*, Queue*)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        srand(rep);
+        Queue* q         = create_bench_queue(n, clustered);
+        Queue* out_true  = Queue_create(sizeof(uint32_t));
+        Queue* out_false = Queue_create(sizeof(uint32_t));
+        assert(out_true != NULL && out_false != NULL && "cannot allocate");
+
+        double const begin = bench_now();
+        bool const   res   = partition(q, out_true, out_false);
+        double const secs  = bench_now() - begin;
+
+        assert(res && "cannot allocate memory to partition");
+        if (rep == 0 || secs < best) best = secs;
+
+        (void)res;
+        Queue_destroy(q);
+        Queue_destroy(out_true);
+        Queue_destroy(out_false);
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s [%s]", label,
+             clustered ? "clustered" : "random");
+    bench_report(buf, n, best);
+}
+
+/**
+ * Benchmarks `Queue_partition()` and `Queue_filter_in_place()` against
+ * moving elements one at a time by hand, on random keys and on keys for which
+ * the predicate is the same for spans of 64 keys. The number of elements
+ * defaults to 4M and can be overridden (in M) by the first command line
+ * argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 4;
+    if (m == 0) m = 4;
+
+    size_t const n = m << 20;
+    for (int clustered = 0; clustered < 2; ++clustered) {
+        bench_partition("partition by elem", n, clustered, partition_by_elem);
+        bench_partition("Queue_partition()", n, clustered, partition_by_span);
+        bench_partition("filter by elem", n, clustered, filter_by_elem);
+        bench_partition("Queue_filter_in_place()", n, clustered,
+                        filter_in_place);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/partition.c bench_partition.c -o bench_partition_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_partition_circ_array
+
+gcc ../src/queue_linked_list.c ../src/partition.c bench_partition.c -o bench_partition_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_partition_linked_list
+*/
@@ -0,0 +1,220 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // printf(), fprintf(), snprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // merge_queues(), Queue_sort()
+#include "pqueue.h"        // PQueue, PQueue_*()
+
+#ifndef PQUEUE_ARITY
+#define PQUEUE_ARITY 4
+#endif
+
+static size_t const N_REPS = 3;
+
+/** Number of elements added in each batch of the batched workload. */
+static size_t const BATCH = 1024;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+bool greater(void const* a, void const* b) {
+    return *(uint64_t*)a > *(uint64_t*)b;
+}
+
+/** A cheap pseudo-random number generator, to keep `rand()` out of timings. */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/** Creates an array of `n` random priorities. */
+uint64_t* create_priorities(size_t n) {
+    uint64_t* prios = malloc(n * sizeof(uint64_t));
+    uint64_t  state = 1;
+    if (prios == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for priorities");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) prios[i] = next_random(&state);
+    return prios;
+}
+
+/** Pops all elements of a priority queue, summing them. */
+uint64_t pop_all(PQueue* pq) {
+    uint64_t sum = 0;
+    while (!PQueue_empty(pq)) {
+        sum += *(uint64_t const*)PQueue_peek(pq);
+        PQueue_pop(pq);
+    }
+    return sum;
+}
+
+/** Pushes `n` elements one at a time. */
+uint64_t push_all(uint64_t const* prios, size_t n) {
+    PQueue* pq = PQueue_create(sizeof(uint64_t), greater);
+    for (size_t i = 0; i < n; ++i) PQueue_push(pq, &prios[i]);
+
+    uint64_t const top = *(uint64_t const*)PQueue_peek(pq);
+    PQueue_destroy(pq);
+    return top;
+}
+
+/** Heapifies `n` elements at once. */
+uint64_t heapify_all(uint64_t const* prios, size_t n) {
+    PQueue* pq = PQueue_heapify(sizeof(uint64_t), greater, prios, n);
+
+    uint64_t const top = *(uint64_t const*)PQueue_peek(pq);
+    PQueue_destroy(pq);
+    return top;
+}
+
+/** Heapifies `n` elements at once, then pops them all. */
+uint64_t heapify_then_pop(uint64_t const* prios, size_t n) {
+    PQueue*        pq  = PQueue_heapify(sizeof(uint64_t), greater, prios, n);
+    uint64_t const sum = pop_all(pq);
+    PQueue_destroy(pq);
+    return sum;
+}
+
+/**
+ * Adds `n` elements in batches of `BATCH` to a priority queue, removing half a
+ * batch of the highest priority after each batch.
+ */
+uint64_t batches_by_pqueue(uint64_t const* prios, size_t n) {
+    PQueue*  pq  = PQueue_create(sizeof(uint64_t), greater);
+    uint64_t sum = 0;
+    for (size_t i = 0; i < n; i += BATCH) {
+        for (size_t j = i; j < i + BATCH && j < n; ++j) {
+            PQueue_push(pq, &prios[j]);
+        }
+        for (size_t j = 0; j < BATCH / 2; ++j) {
+            sum += *(uint64_t const*)PQueue_peek(pq);
+            PQueue_pop(pq);
+        }
+    }
+    sum += pop_all(pq);
+    PQueue_destroy(pq);
+    return sum;
+}
+
+/**
+ * Runs the same workload as `batches_by_pqueue()` by keeping a queue sorted,
+ * sorting each batch into a queue and merging it with `merge_queues()`.
+ */
+uint64_t batches_by_merge(uint64_t const* prios, size_t n) {
+    Queue*   sorted = Queue_create(sizeof(uint64_t));
+    uint64_t sum    = 0;
+    for (size_t i = 0; i < n; i += BATCH) {
+        Queue* batch = Queue_create(sizeof(uint64_t));
+        for (size_t j = i; j < i + BATCH && j < n; ++j) {
+            Queue_enqueue(batch, &prios[j]);
+        }
+        Queue_sort(batch, sizeof(uint64_t), greater);
+
+        // Either queue is returned as is when the other is empty
+        Queue* merged = merge_queues(sorted, batch, sizeof(uint64_t), greater);
+        if (merged != sorted) Queue_destroy(sorted);
+        if (merged != batch) Queue_destroy(batch);
+        sorted = merged;
+
+        for (size_t j = 0; j < BATCH / 2; ++j) {
+            sum += *(uint64_t const*)Queue_peek(sorted);
+            Queue_dequeue(sorted);
+        }
+    }
+    while (!Queue_empty(sorted)) {
+        sum += *(uint64_t const*)Queue_peek(sorted);
+        Queue_dequeue(sorted);
+    }
+    Queue_destroy(sorted);
+    return sum;
+}
+
+/** Times a workload on `n` priorities, and reports the best of `N_REPS`. */
+void bench_workload(char const* label, uint64_t const* prios, size_t n,
+                    uint64_t (*workload)(uint64_t const*, size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = workload(prios, n);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s [%d-ary]", label, PQUEUE_ARITY);
+    bench_report(buf, n, best);
+}
+
+/**
+ * Benchmarks the priority queue, built with the arity given by `PQUEUE_ARITY`,
+ * and compares it with keeping a FIFO queue sorted by `merge_queues()`. The
+ * number of elements defaults to 4M and can be overridden (in M) by the first
+ * command line argument; the batched workload uses 1/16 of them.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 4;
+    if (m == 0) m = 4;
+
+    size_t const    n     = m << 20;
+    uint64_t* const prios = create_priorities(n);
+
+    bench_workload("push all", prios, n, push_all);
+    bench_workload("heapify all", prios, n, heapify_all);
+    bench_workload("heapify + pop all", prios, n, heapify_then_pop);
+    bench_workload("batches by PQueue", prios, n / 16, batches_by_pqueue);
+    bench_workload("batches by merge_queues()", prios, n / 16,
+                   batches_by_merge);
+
+    free(prios);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/pqueue_heap.c ../src/queue_circ_array.c ../src/algos.c ../src/merge_kernels.c ../src/sort.c bench_pqueue.c -o bench_pqueue -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_pqueue
+
+gcc ../src/pqueue_heap.c ../src/queue_circ_array.c ../src/algos.c ../src/merge_kernels.c ../src/sort.c bench_pqueue.c -o bench_pqueue_binary -std=c99 -O3 -march=native -pthread -DNDEBUG -DPQUEUE_ARITY=2 -I../src && ./bench_pqueue_binary
+*/
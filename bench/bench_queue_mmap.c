@@ -0,0 +1,129 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime(), mkstemp()
+
+#include <stdlib.h>   // EXIT_*, strtoull(), mkstemp()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // fprintf()
+#include <unistd.h>   // close(), unlink()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue_mmap.h"    // Queue, Queue_*()
+
+static size_t const N_REPS = 3;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** Exits the program with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/**
+ * Opens a queue on a new file in the directory `dir`, or creates one backed
+ * by a temporary file if `dir` is `NULL`, with room for `n` elements.
+ */
+Queue* open_bench_queue(char const* dir, size_t n) {
+    Queue* q = NULL;
+    if (dir == NULL) {
+        q = Queue_create(sizeof(uint64_t));
+    } else {
+        char path[4096];
+        snprintf(path, sizeof(path), "%s/bench_queue_mmap_XXXXXX", dir);
+        int const fd = mkstemp(path);
+        if (fd < 0) fail("cannot create a file");
+        close(fd);
+        q = Queue_open(path, sizeof(uint64_t));
+        unlink(path);
+    }
+    if (q == NULL || !Queue_reserve(q, n)) fail("cannot map the file");
+    return q;
+}
+
+/**
+ * Times enqueuing `n` elements, syncing every `every` elements (never if `0`),
+ * and reports the best of `N_REPS`.
+ */
+void bench_enqueue(char const* label, char const* dir, size_t n,
+                   size_t every) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        Queue* q = open_bench_queue(dir, n);
+        Queue_set_sync(q, every);
+
+        double const begin = bench_now();
+        for (uint64_t i = 0; i < n; ++i) {
+            if (!Queue_enqueue(q, &i)) fail("cannot enqueue");
+        }
+        if (every > 0 && !Queue_sync(q)) fail("cannot sync");
+        double const secs = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+
+        sink = *(uint64_t const*)Queue_peek(q);
+        Queue_set_sync(q, 0);
+        Queue_destroy(q);
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Benchmarks enqueuing to a queue in a memory-mapped file, with and without
+ * periodic syncing to storage. The number of elements defaults to 1M and can
+ * be overridden (in M) by the first command line argument, and the directory
+ * of the file defaults to the current one and can be overridden by the second.
+ * Syncing costs depend on the file system of that directory.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+    if (m == 0) m = 1;
+
+    size_t const      n   = m * 1000000;
+    char const* const dir = argc > 2 ? argv[2] : ".";
+
+    bench_enqueue("Queue_create(), no sync", NULL, n, 0);
+    bench_enqueue("Queue_open(), no sync", dir, n, 0);
+    bench_enqueue("Queue_open(), sync every 64K", dir, n, 65536);
+    bench_enqueue("Queue_open(), sync every 1K", dir, n, 1024);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_mmap.c bench_queue_mmap.c -o bench_queue_mmap -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_queue_mmap
+*/
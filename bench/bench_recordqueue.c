@@ -0,0 +1,279 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // printf(), fprintf()
+#include <string.h>   // memcpy()
+
+#include "bench_utils.h"    // bench_now(), bench_report()
+#include "recordqueue.h"    // RecordQueue, RecordQueue_*()
+#include "queue.h"          // Queue, Queue_*()
+
+static size_t const N_REPS = 3;
+
+/** Longest message, which sizes the slots of the fixed-size queue. */
+#define MAX_LEN 4088
+
+/** Number of messages outstanding in the steady-state workloads. */
+static size_t const WINDOW = 4096;
+
+/** Number of messages handled per batch in the batch workload. */
+#define BATCH 64
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** Bytes of storage taken by the queue of the last workload at its largest. */
+static size_t peak;
+
+/** A message in a slot sized for the longest message. */
+typedef struct {
+    size_t        len;
+    unsigned char data[MAX_LEN];
+} Slot;
+
+/** A message in its own allocation, referenced from a queue of pointers. */
+typedef struct {
+    size_t        len;
+    unsigned char data[];
+} Boxed;
+
+/** Exits with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/** A cheap pseudo-random number generator, to keep `rand()` out of timings. */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/**
+ * Creates an array of `n` message lengths, most of them under 256 bytes and
+ * one in sixteen up to `MAX_LEN` bytes.
+ */
+size_t* create_lengths(size_t n) {
+    size_t*  lens  = malloc(n * sizeof(size_t));
+    uint64_t state = 1;
+    if (lens == NULL) fail("cannot allocate memory for lengths");
+
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t const r = next_random(&state);
+        lens[i] = r % 16 == 0 ? (size_t)(r >> 8) % (MAX_LEN + 1)
+                              : (size_t)(r >> 8) % 240 + 16;
+    }
+    return lens;
+}
+
+/** Reads a message as a consumer would, touching its first and last bytes. */
+static uint64_t consume(void const* data, size_t len) {
+    unsigned char const* bytes = data;
+    return len > 0 ? len + bytes[0] + bytes[len - 1] : 0;
+}
+
+/**
+ * Keeps `WINDOW` messages outstanding on a record queue while `n` messages
+ * pass through it, one at a time.
+ */
+uint64_t steady_by_recordqueue(size_t const* lens, size_t n,
+                               unsigned char const* payload) {
+    RecordQueue* rq  = RecordQueue_create();
+    uint64_t     sum = 0;
+    if (rq == NULL) fail("cannot allocate memory for a recordqueue");
+
+    for (size_t i = 0; i < n; ++i) {
+        if (!RecordQueue_enqueue(rq, payload, lens[i])) fail("enqueue failed");
+        if (i < WINDOW) continue;
+
+        RecordSpan rec;
+        RecordQueue_front(rq, &rec);
+        sum += consume(rec.data, rec.len);
+        RecordQueue_dequeue(rq);
+    }
+    peak = RecordQueue_capacity(rq);
+    RecordQueue_destroy(rq);
+    return sum;
+}
+
+/** Runs `steady_by_recordqueue()` in batches of `BATCH` messages. */
+uint64_t batch_by_recordqueue(size_t const* lens, size_t n,
+                              unsigned char const* payload) {
+    RecordQueue* rq  = RecordQueue_create();
+    uint64_t     sum = 0;
+    RecordSpan   recs[BATCH];
+    if (rq == NULL) fail("cannot allocate memory for a recordqueue");
+
+    for (size_t i = 0; i + BATCH <= n; i += BATCH) {
+        for (size_t j = 0; j < BATCH; ++j) {
+            recs[j].data = payload;
+            recs[j].len  = lens[i + j];
+        }
+        if (!RecordQueue_enqueue_n(rq, recs, BATCH)) fail("enqueue failed");
+        if (i < WINDOW) continue;
+
+        size_t const m = RecordQueue_front_n(rq, recs, BATCH);
+        for (size_t j = 0; j < m; ++j) {
+            sum += consume(recs[j].data, recs[j].len);
+        }
+        RecordQueue_dequeue_n(rq, m);
+    }
+    peak = RecordQueue_capacity(rq);
+    RecordQueue_destroy(rq);
+    return sum;
+}
+
+/** Runs `steady_by_recordqueue()` on a queue of slots of `MAX_LEN` bytes. */
+uint64_t steady_by_slots(size_t const* lens, size_t n,
+                         unsigned char const* payload) {
+    Queue*   q   = Queue_create(sizeof(Slot));
+    Slot*    s   = malloc(sizeof(Slot));
+    uint64_t sum = 0;
+    if (q == NULL || s == NULL) fail("cannot allocate memory for a queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        s->len = lens[i];
+        memcpy(s->data, payload, lens[i]);
+        if (!Queue_enqueue(q, s)) fail("enqueue failed");
+        if (i < WINDOW) continue;
+
+        Slot const* front = Queue_peek(q);
+        sum += consume(front->data, front->len);
+        Queue_dequeue(q);
+    }
+    peak = Queue_capacity(q) * sizeof(Slot);
+    free(s);
+    Queue_destroy(q);
+    return sum;
+}
+
+/**
+ * Runs `steady_by_recordqueue()` on a queue of pointers to messages, each in
+ * its own allocation. Storage counts the pointers and the messages at their
+ * most, but not the overhead of the allocator.
+ */
+uint64_t steady_by_pointers(size_t const* lens, size_t n,
+                            unsigned char const* payload) {
+    Queue*   q     = Queue_create(sizeof(Boxed*));
+    uint64_t sum   = 0;
+    size_t   bytes = 0;
+    size_t   most  = 0;
+    if (q == NULL) fail("cannot allocate memory for a queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        Boxed* b = malloc(sizeof(Boxed) + lens[i]);
+        if (b == NULL) fail("cannot allocate memory for a message");
+        b->len = lens[i];
+        memcpy(b->data, payload, lens[i]);
+        if (!Queue_enqueue(q, &b)) fail("enqueue failed");
+        bytes += sizeof(Boxed) + lens[i];
+        if (bytes > most) most = bytes;
+        if (i < WINDOW) continue;
+
+        Boxed* front;
+        Queue_front(q, &front);
+        sum   += consume(front->data, front->len);
+        bytes -= sizeof(Boxed) + front->len;
+        free(front);
+        Queue_dequeue(q);
+    }
+    peak = Queue_capacity(q) * sizeof(Boxed*) + most;
+
+    Boxed* b;
+    while (Queue_front(q, &b)) {
+        free(b);
+        Queue_dequeue(q);
+    }
+    Queue_destroy(q);
+    return sum;
+}
+
+/** Times a workload on `n` messages, and reports the best of `N_REPS`. */
+void bench_workload(char const* label, size_t const* lens, size_t n,
+                    unsigned char const* payload,
+                    uint64_t (*workload)(size_t const*, size_t,
+                                         unsigned char const*)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = workload(lens, n, payload);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, n, best);
+    printf("%-40s %10.2f MiB storage\n", "", (double)peak / (1 << 20));
+}
+
+/**
+ * Benchmarks the record queue against a queue of slots sized for the longest
+ * message and a queue of pointers to separately allocated messages, with 1M
+ * messages by default, which can be overridden (in M) by the first command
+ * line argument. Lengths are mostly under 256 bytes, with one in sixteen up
+ * to `MAX_LEN` bytes.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+    if (m == 0) m = 1;
+
+    size_t const   n       = m << 20;
+    size_t* const  lens    = create_lengths(n);
+    unsigned char* payload = malloc(MAX_LEN);
+    if (payload == NULL) fail("cannot allocate memory for the payload");
+    for (size_t i = 0; i < MAX_LEN; ++i) payload[i] = (unsigned char)i;
+
+    bench_workload("steady messages by RecordQueue", lens, n, payload,
+                   steady_by_recordqueue);
+    bench_workload("steady messages by RecordQueue (batch)", lens, n, payload,
+                   batch_by_recordqueue);
+    bench_workload("steady messages by Queue of slots", lens, n, payload,
+                   steady_by_slots);
+    bench_workload("steady messages by Queue of pointers", lens, n, payload,
+                   steady_by_pointers);
+
+    free(payload);
+    free(lens);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/recordqueue_circ_array.c bench_recordqueue.c -o bench_recordqueue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_recordqueue
+*/
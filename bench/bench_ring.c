@@ -0,0 +1,156 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // fprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+
+static size_t const N_REPS = 5;
+
+/** Number of most recent samples a telemetry buffer keeps. */
+static size_t const RING_CAP = (size_t)1 << 16;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** A telemetry sample. */
+typedef struct {
+    uint64_t timestamp;
+    uint64_t value;
+} Sample;
+
+/** Exits the program when a queue cannot be created. */
+static void check_created(Queue* q) {
+    if (q == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for a queue");
+        exit(EXIT_FAILURE);
+    }
+}
+
+/** Records `n` samples in a ring, which overwrites the oldest when full. */
+uint64_t record_by_ring(size_t n) {
+    Queue* q = Queue_create_ring(sizeof(Sample), RING_CAP);
+    check_created(q);
+
+    for (size_t i = 0; i < n; ++i) {
+        Sample const s = { i, i * 7 };
+        Queue_enqueue(q, &s);
+    }
+
+    uint64_t const res =
+        ((Sample const*)Queue_peek(q))->value + Queue_dropped(q);
+    Queue_destroy(q);
+    return res;
+}
+
+/**
+ * Records `n` samples in a growing queue, dropping the oldest by hand to keep
+ * the same number of samples as `record_by_ring()`.
+ */
+uint64_t record_by_dequeue(size_t n) {
+    Queue*   q        = Queue_create(sizeof(Sample));
+    uint64_t ndropped = 0;
+    check_created(q);
+
+    for (size_t i = 0; i < n; ++i) {
+        Sample const s = { i, i * 7 };
+        if (Queue_size(q) == RING_CAP) {
+            Queue_dequeue(q);
+            ++ndropped;
+        }
+        Queue_enqueue(q, &s);
+    }
+
+    uint64_t const res = ((Sample const*)Queue_peek(q))->value + ndropped;
+    Queue_destroy(q);
+    return res;
+}
+
+/** Records `n` samples in a growing queue, keeping all of them. */
+uint64_t record_by_growing(size_t n) {
+    Queue* q = Queue_create(sizeof(Sample));
+    check_created(q);
+
+    for (size_t i = 0; i < n; ++i) {
+        Sample const s = { i, i * 7 };
+        Queue_enqueue(q, &s);
+    }
+
+    uint64_t const res = ((Sample const*)Queue_peek(q))->value + Queue_size(q);
+    Queue_destroy(q);
+    return res;
+}
+
+/** Times a workload on `n` samples, and reports the best of `N_REPS`. */
+void bench_record(char const* label, size_t n, uint64_t (*workload)(size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = workload(n);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Benchmarks recording samples into a fixed-capacity ring against the growing
+ * mode of a queue. The number of samples defaults to 16M and can be
+ * overridden (in M) by the first command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 16;
+    if (m == 0) m = 16;
+
+    size_t const n = m << 20;
+
+    bench_record("ring overwriting oldest", n, record_by_ring);
+    bench_record("growing queue + Queue_dequeue()", n, record_by_dequeue);
+    bench_record("growing queue keeping all", n, record_by_growing);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c bench_ring.c -o bench_ring_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_ring_circ_array
+
+gcc ../src/queue_linked_list.c bench_ring.c -o bench_ring_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_ring_linked_list
+*/
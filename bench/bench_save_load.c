@@ -0,0 +1,179 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime(), fdopen(), mkstemp()
+
+#include <stdlib.h>   // EXIT_*, strtoull(), mkstemp()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // FILE, fdopen(), fwrite(), fread(), fprintf()
+#include <unistd.h>   // dup(), lseek(), ftruncate(), unlink(), close()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+
+static size_t const N_REPS = 3;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** Exits the program with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/** Creates a queue of `n` elements, `0` to `n - 1`. */
+Queue* create_bench_queue(size_t n) {
+    Queue* q = Queue_create(sizeof(uint64_t));
+    if (q == NULL || !Queue_reserve(q, n)) fail("cannot allocate memory");
+
+    for (uint64_t i = 0; i < n; ++i) {
+        if (!Queue_enqueue(q, &i)) fail("cannot allocate memory");
+    }
+    return q;
+}
+
+/** Empties a file and moves its descriptor back to the start. */
+void reset_file(int fd) {
+    if (ftruncate(fd, 0) != 0 || lseek(fd, 0, SEEK_SET) != 0) {
+        fail("cannot reset the file");
+    }
+}
+
+/** Saves a queue by draining it, writing each element with its own fwrite. */
+bool save_by_fwrite(Queue* queue, int fd) {
+    FILE* f = fdopen(dup(fd), "w");
+    if (f == NULL) return false;
+
+    uint64_t const n    = Queue_size(queue);
+    uint64_t       elem = 0;
+    bool           ok   = fwrite(&n, sizeof(n), 1, f) == 1;
+    while (ok && Queue_front(queue, &elem)) {
+        ok = fwrite(&elem, sizeof(elem), 1, f) == 1 && Queue_dequeue(queue);
+    }
+    return fclose(f) == 0 && ok;
+}
+
+/** Loads a queue saved by `save_by_fwrite()`, an element at a time. */
+Queue* load_by_fread(int fd) {
+    FILE* f = fdopen(dup(fd), "r");
+    if (f == NULL) return NULL;
+
+    Queue*   q    = Queue_create(sizeof(uint64_t));
+    uint64_t n    = 0;
+    uint64_t elem = 0;
+    bool     ok   = q != NULL && fread(&n, sizeof(n), 1, f) == 1;
+    for (uint64_t i = 0; ok && i < n; ++i) {
+        ok = fread(&elem, sizeof(elem), 1, f) == 1 && Queue_enqueue(q, &elem);
+    }
+    fclose(f);
+    if (!ok && q != NULL) Queue_destroy(q);
+    return ok ? q : NULL;
+}
+
+/** Loads a queue saved by `Queue_save()`. */
+Queue* load_by_queue_load(int fd) { return Queue_load(fd, sizeof(uint64_t)); }
+
+/** Times saving queues of `n` elements, and reports the best of `N_REPS`. */
+void bench_save(char const* label, int fd, size_t n,
+                bool (*save)(Queue*, int)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        Queue* q = create_bench_queue(n);
+        reset_file(fd);
+
+        double const begin = bench_now();
+        bool const   ok    = save(q, fd);
+        double const secs  = bench_now() - begin;
+        if (!ok) fail("cannot write queue to file");
+        if (rep == 0 || secs < best) best = secs;
+
+        Queue_destroy(q);
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Times loading the queue of `n` elements saved last to a file, and reports
+ * the best of `N_REPS`.
+ */
+void bench_load(char const* label, int fd, size_t n, Queue* (*load)(int)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        if (lseek(fd, 0, SEEK_SET) != 0) fail("cannot rewind the file");
+
+        double const begin = bench_now();
+        Queue*       q     = load(fd);
+        double const secs  = bench_now() - begin;
+        if (q == NULL || Queue_size(q) != n) fail("cannot read queue");
+        if (rep == 0 || secs < best) best = secs;
+
+        sink = *(uint64_t const*)Queue_peek(q);
+        Queue_destroy(q);
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Benchmarks checkpointing a queue to a temporary file and restoring it, by
+ * hand and with `Queue_save()` and `Queue_load()`. The number of elements
+ * defaults to 10M and can be overridden (in M) by the first command line
+ * argument. The file stays in the page cache, so timings leave out the disk.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 10;
+    if (m == 0) m = 10;
+
+    size_t const n      = m * 1000000;
+    char         path[] = "/tmp/bench_save_load_XXXXXX";
+    int const    fd     = mkstemp(path);
+    if (fd < 0) fail("cannot create a temporary file");
+    unlink(path);
+
+    bench_save("drain + fwrite() per element", fd, n, save_by_fwrite);
+    bench_load("fread() + enqueue per element", fd, n, load_by_fread);
+    bench_save("Queue_save()", fd, n, Queue_save);
+    bench_load("Queue_load()", fd, n, load_by_queue_load);
+
+    close(fd);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c bench_save_load.c -o bench_save_load_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_save_load_circ_array
+
+gcc ../src/queue_linked_list.c bench_save_load.c -o bench_save_load_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_save_load_linked_list
+*/
@@ -0,0 +1,199 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), srand(), ...
+#include <stdio.h>    // printf(), snprintf()
+#include <string.h>   // memcpy()
+#include <assert.h>   // assert()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // union_queues(), intersect_queues(), ...
+
+static size_t const N_REPS = 3;
+
+bool less(void const* a, void const* b) { return *(int*)a < *(int*)b; }
+
+/**
+ * The naive set operation: the fronts are copied out and compared on every
+ * iteration, and elements are enqueued and dequeued one at a time.
+ */
+Queue* set_op_by_elem(Queue* queue1, Queue* queue2, size_t elem_sz,
+                      bool (*compare)(void const*, void const*), bool keep1,
+                      bool keep2, bool keep_both) {
+    Queue* out   = Queue_create(elem_sz);
+    char*  elems = malloc(3 * elem_sz);
+    char*  elem1 = elems;
+    char*  elem2 = elems + elem_sz;
+    char*  last  = elems + 2 * elem_sz;
+    bool   has_last = false;
+    assert(out != NULL && elems != NULL && "cannot allocate memory");
+
+    while (!Queue_empty(queue1) || !Queue_empty(queue2)) {
+        bool const has1 = Queue_front(queue1, elem1);
+        bool const has2 = Queue_front(queue2, elem2);
+        char*      elem = elem1;
+        bool       keep = keep_both;
+
+        if (has1 && (!has2 || compare(elem1, elem2))) {
+            keep = keep1;
+            Queue_dequeue(queue1);
+        } else if (has2 && (!has1 || compare(elem2, elem1))) {
+            elem = elem2;
+            keep = keep2;
+            Queue_dequeue(queue2);
+        } else {
+            Queue_dequeue(queue1);
+            Queue_dequeue(queue2);
+        }
+
+        if (keep && (!has_last || compare(last, elem))) {
+            Queue_enqueue(out, elem);
+            memcpy(last, elem, elem_sz);
+            has_last = true;
+        }
+    }
+    free(elems);
+    return out;
+}
+
+Queue* union_by_elem(Queue* queue1, Queue* queue2, size_t elem_sz,
+                     bool (*compare)(void const*, void const*)) {
+    return set_op_by_elem(queue1, queue2, elem_sz, compare, true, true, true);
+}
+
+Queue* intersect_by_elem(Queue* queue1, Queue* queue2, size_t elem_sz,
+                         bool (*compare)(void const*, void const*)) {
+    return set_op_by_elem(queue1, queue2, elem_sz, compare, false, false,
+                          true);
+}
+
+Queue* subtract_by_elem(Queue* queue1, Queue* queue2, size_t elem_sz,
+                        bool (*compare)(void const*, void const*)) {
+    return set_op_by_elem(queue1, queue2, elem_sz, compare, true, false,
+                          false);
+}
+
+/**
+ * Creates a queue of `n` ascending distinct `int` IDs, with random gaps
+ * averaging `gap`.
+ */
+Queue* create_bench_queue(size_t n, int gap) {
+    Queue* q  = Queue_create(sizeof(int));
+    int    id = 0;
+    if (q == NULL || !Queue_reserve(q, n)) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        id += 1 + rand() % (2 * gap - 1);
+        if (!Queue_enqueue(q, &id)) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+    return q;
+}
+
+/**
+ * Times a set operation on a queue of `n1` IDs and a queue of `n2` IDs
+ * spanning the same range, and reports the best of `N_REPS`.
+ */
+void bench_set_op(char const* label, size_t n1, size_t n2,
+                  Queue* (*op)(Queue*, Queue*, size_t,
+                               bool (*)(void const*, void const*))) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        srand(rep);
+        Queue* q1 = create_bench_queue(n1, 2 * (int)(n1 < n2 ? n2 / n1 : 1));
+        Queue* q2 = create_bench_queue(n2, 2 * (int)(n2 < n1 ? n1 / n2 : 1));
+
+        double const begin = bench_now();
+        Queue*       out   = op(q1, q2, sizeof(int), less);
+        double const secs  = bench_now() - begin;
+
+        assert(out != NULL && Queue_empty(q1) && Queue_empty(q2) &&
+               "elements left behind");
+        if (rep == 0 || secs < best) best = secs;
+
+        Queue_destroy(q1);
+        Queue_destroy(q2);
+        Queue_destroy(out);
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s [%lu x %lu]", label, n1, n2);
+    bench_report(buf, n1 + n2, best);
+}
+
+/**
+ * Benchmarks the set operations against the naive per-element loop, on queues
+ * of equal sizes and on lopsided queues. The number of elements of the larger
+ * queue defaults to 16M and can be overridden (in M) by the first command line
+ * argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 16;
+    if (m == 0) m = 16;
+
+    size_t const n     = m << 20;
+    size_t const small = n >> 10;
+
+    bench_set_op("union_by_elem()", n, n, union_by_elem);
+    bench_set_op("union_queues()", n, n, union_queues);
+    bench_set_op("intersect_by_elem()", n, n, intersect_by_elem);
+    bench_set_op("intersect_queues()", n, n, intersect_queues);
+    bench_set_op("subtract_by_elem()", n, n, subtract_by_elem);
+    bench_set_op("subtract_queues()", n, n, subtract_queues);
+
+    bench_set_op("intersect_by_elem()", small, n, intersect_by_elem);
+    bench_set_op("intersect_queues()", small, n, intersect_queues);
+    bench_set_op("subtract_by_elem()", small, n, subtract_by_elem);
+    bench_set_op("subtract_queues()", small, n, subtract_queues);
+    bench_set_op("subtract_by_elem()", n, small, subtract_by_elem);
+    bench_set_op("subtract_queues()", n, small, subtract_queues);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/algos.c bench_set_ops.c -o bench_set_ops_circ_array -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_set_ops_circ_array
+
+gcc ../src/queue_linked_list.c ../src/algos.c bench_set_ops.c -o bench_set_ops_linked_list -std=c99 -O3 -march=native -pthread -DNDEBUG -I../src && ./bench_set_ops_linked_list
+*/
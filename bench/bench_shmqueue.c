@@ -0,0 +1,305 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // clock_gettime(), fork(), sched_yield()
+
+#include <stdlib.h>       // EXIT_*, strtoull()
+#include <stdint.h>       // uint64_t
+#include <stdio.h>        // snprintf(), fprintf()
+#include <sched.h>        // sched_yield()
+#include <unistd.h>       // fork(), pipe(), read(), write(), close(), _exit()
+#include <sys/socket.h>   // socketpair(), AF_UNIX
+#include <sys/wait.h>     // waitpid()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "shmqueue.h"      // ShmQueue, ShmQueue_*()
+
+static size_t const N_REPS = 3;
+
+/** Number of messages per batch. */
+#define BATCH 64
+
+/** What a producer process and a consumer process pass messages through. */
+typedef struct {
+    size_t    n;          // Number of messages to pass.
+    int       sock[2];    // Socket pair, producer's end first.
+    char      ping[64];   // Name of the queue to the consumer.
+    char      pong[64];   // Name of the queue back to the producer.
+    ShmQueue* to;         // Producer's end of `ping`.
+    ShmQueue* from;       // Producer's end of `pong`.
+} Channel;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+/** Exits the program with an error message. */
+static void fail(char const* message) {
+    fprintf(stderr, "%s\n", message);
+    exit(EXIT_FAILURE);
+}
+
+/** Sends or receives `len` bytes through a socket in full. */
+static void transfer_all(int fd, void* buf, size_t len, bool send) {
+    char* p = buf;
+    while (len > 0) {
+        ssize_t const res = send ? write(fd, p, len) : read(fd, p, len);
+        if (res <= 0) fail("cannot transfer through socket");
+        p   += res;
+        len -= (size_t)res;
+    }
+}
+
+/** Enqueues a message, waiting for room. */
+static void shm_send(ShmQueue* sq, uint64_t msg) {
+    while (!ShmQueue_enqueue(sq, &msg)) sched_yield();
+}
+
+/** Dequeues a message, waiting for one. */
+static uint64_t shm_recv(ShmQueue* sq) {
+    uint64_t msg = 0;
+    while (!ShmQueue_front(sq, &msg)) sched_yield();
+    ShmQueue_dequeue(sq);
+    return msg;
+}
+
+// Throughput: the producer sends messages `0` to `n - 1`, the consumer sums
+// them up
+
+static void sock_produce(Channel* ch) {
+    for (uint64_t i = 0; i < ch->n; ++i) {
+        transfer_all(ch->sock[0], &i, sizeof(i), true);
+    }
+}
+
+static uint64_t sock_consume(Channel* ch) {
+    uint64_t sum = 0;
+    uint64_t msg = 0;
+    for (size_t i = 0; i < ch->n; ++i) {
+        transfer_all(ch->sock[1], &msg, sizeof(msg), false);
+        sum += msg;
+    }
+    return sum;
+}
+
+static void sock_produce_batch(Channel* ch) {
+    uint64_t buf[BATCH];
+    for (uint64_t i = 0; i < ch->n; i += BATCH) {
+        for (uint64_t j = 0; j < BATCH; ++j) buf[j] = i + j;
+        transfer_all(ch->sock[0], buf, sizeof(buf), true);
+    }
+}
+
+static uint64_t sock_consume_batch(Channel* ch) {
+    uint64_t sum = 0;
+    uint64_t buf[BATCH];
+    for (size_t i = 0; i < ch->n; i += BATCH) {
+        transfer_all(ch->sock[1], buf, sizeof(buf), false);
+        for (size_t j = 0; j < BATCH; ++j) sum += buf[j];
+    }
+    return sum;
+}
+
+static void shm_produce(Channel* ch) {
+    for (uint64_t i = 0; i < ch->n; ++i) shm_send(ch->to, i);
+}
+
+static uint64_t shm_consume(Channel* ch) {
+    ShmQueue* sq = ShmQueue_open(ch->ping, sizeof(uint64_t), SHMQUEUE_CONSUMER);
+    if (sq == NULL) fail("cannot open shared-memory queue");
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < ch->n; ++i) sum += shm_recv(sq);
+    ShmQueue_destroy(sq);
+    return sum;
+}
+
+static void shm_produce_batch(Channel* ch) {
+    uint64_t buf[BATCH];
+    for (uint64_t i = 0; i < ch->n; i += BATCH) {
+        for (uint64_t j = 0; j < BATCH; ++j) buf[j] = i + j;
+        for (size_t sent = 0; sent < BATCH;) {
+            size_t const k = ShmQueue_write(ch->to, buf + sent, BATCH - sent);
+            if (k == 0) sched_yield();
+            sent += k;
+        }
+    }
+}
+
+static uint64_t shm_consume_batch(Channel* ch) {
+    ShmQueue* sq = ShmQueue_open(ch->ping, sizeof(uint64_t), SHMQUEUE_CONSUMER);
+    if (sq == NULL) fail("cannot open shared-memory queue");
+
+    uint64_t sum = 0;
+    uint64_t buf[BATCH];
+    for (size_t left = ch->n; left > 0;) {
+        size_t const k = ShmQueue_read(sq, buf, BATCH);
+        if (k == 0) sched_yield();
+        for (size_t j = 0; j < k; ++j) sum += buf[j];
+        left -= k;
+    }
+    ShmQueue_destroy(sq);
+    return sum;
+}
+
+// Latency: the producer sends a message, and waits for the consumer to send
+// it back before sending the next
+
+static void sock_ping(Channel* ch) {
+    for (uint64_t i = 0; i < ch->n; ++i) {
+        uint64_t msg = i;
+        transfer_all(ch->sock[0], &msg, sizeof(msg), true);
+        transfer_all(ch->sock[0], &msg, sizeof(msg), false);
+        if (msg != i) fail("reply out of order");
+    }
+}
+
+static uint64_t sock_pong(Channel* ch) {
+    uint64_t sum = 0;
+    uint64_t msg = 0;
+    for (size_t i = 0; i < ch->n; ++i) {
+        transfer_all(ch->sock[1], &msg, sizeof(msg), false);
+        transfer_all(ch->sock[1], &msg, sizeof(msg), true);
+        sum += msg;
+    }
+    return sum;
+}
+
+static void shm_ping(Channel* ch) {
+    for (uint64_t i = 0; i < ch->n; ++i) {
+        shm_send(ch->to, i);
+        if (shm_recv(ch->from) != i) fail("reply out of order");
+    }
+}
+
+static uint64_t shm_pong(Channel* ch) {
+    size_t const elem_sz = sizeof(uint64_t);
+    ShmQueue*    in      = ShmQueue_open(ch->ping, elem_sz, SHMQUEUE_CONSUMER);
+    ShmQueue*    out     = ShmQueue_open(ch->pong, elem_sz, SHMQUEUE_PRODUCER);
+    if (in == NULL || out == NULL) fail("cannot open shared-memory queue");
+
+    uint64_t sum = 0;
+    for (size_t i = 0; i < ch->n; ++i) {
+        uint64_t const msg = shm_recv(in);
+        shm_send(out, msg);
+        sum += msg;
+    }
+    ShmQueue_destroy(in);
+    ShmQueue_destroy(out);
+    return sum;
+}
+
+/**
+ * Times passing `n` messages from this process to a child process, or back
+ * and forth, and reports the best of `N_REPS`. The child reports the sum of
+ * the messages it received through a pipe, which ends the timing.
+ */
+void bench_pair(char const* label, size_t n, void (*produce)(Channel*),
+                uint64_t (*consume)(Channel*)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        Channel ch = { .n = n };
+        int     result[2];
+        snprintf(ch.ping, sizeof(ch.ping), "/bench_shmqueue_%ld_ping",
+                 (long)getpid());
+        snprintf(ch.pong, sizeof(ch.pong), "/bench_shmqueue_%ld_pong",
+                 (long)getpid());
+        ch.to = ShmQueue_create(ch.ping, sizeof(uint64_t), 4096,
+                                SHMQUEUE_PRODUCER);
+        ch.from = ShmQueue_create(ch.pong, sizeof(uint64_t), 4096,
+                                  SHMQUEUE_CONSUMER);
+        if (ch.to == NULL || ch.from == NULL || pipe(result) != 0 ||
+            socketpair(AF_UNIX, SOCK_STREAM, 0, ch.sock) != 0) {
+            fail("cannot set up channels");
+        }
+
+        pid_t const pid = fork();
+        if (pid < 0) fail("cannot fork");
+        if (pid == 0) {
+            uint64_t sum = consume(&ch);
+            transfer_all(result[1], &sum, sizeof(sum), true);
+            _exit(EXIT_SUCCESS);
+        }
+
+        uint64_t     sum   = 0;
+        double const begin = bench_now();
+        produce(&ch);
+        transfer_all(result[0], &sum, sizeof(sum), false);
+        double const secs = bench_now() - begin;
+        if (sum != (uint64_t)n * (n - 1) / 2) fail("messages lost");
+        if (rep == 0 || secs < best) best = secs;
+        sink = sum;
+
+        waitpid(pid, NULL, 0);
+        ShmQueue_destroy(ch.to);
+        ShmQueue_destroy(ch.from);
+        ShmQueue_unlink(ch.ping);
+        ShmQueue_unlink(ch.pong);
+        close(result[0]);
+        close(result[1]);
+        close(ch.sock[0]);
+        close(ch.sock[1]);
+    }
+    bench_report(label, n, best);
+}
+
+/**
+ * Benchmarks passing 8-byte messages between processes through a
+ * shared-memory queue and through a Unix socket pair, for throughput one way
+ * and for latency back and forth. The number of messages defaults to 1M, a
+ * multiple of `BATCH`, and can be overridden (in M) by the first command line
+ * argument. Round trips are reported per message.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+    if (m == 0) m = 1;
+
+    size_t const n = m * 1024 * 1024;
+
+    bench_pair("socket, a message per write()", n, sock_produce, sock_consume);
+    bench_pair("socket, 64 messages per write()", n, sock_produce_batch,
+               sock_consume_batch);
+    bench_pair("ShmQueue_enqueue()", n, shm_produce, shm_consume);
+    bench_pair("ShmQueue_write(), 64 messages", n, shm_produce_batch,
+               shm_consume_batch);
+    bench_pair("socket, round trip", n / 16, sock_ping, sock_pong);
+    bench_pair("ShmQueue, round trip", n / 16, shm_ping, shm_pong);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/shmqueue_spsc.c bench_shmqueue.c -o bench_shmqueue -std=c99 -O3 -march=native -DNDEBUG -I../src -lrt && ./bench_shmqueue
+*/
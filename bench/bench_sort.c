@@ -0,0 +1,166 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), qsort(), rand()
+#include <stdint.h>   // uint32_t
+#include <stdio.h>    // printf(), snprintf()
+#include <string.h>   // memset()
+#include <assert.h>   // assert()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "queue.h"         // Queue, Queue_*()
+#include "algos.h"         // Queue_sort(), Queue_radix_sort()
+
+static size_t const ELEM_SZS[] = { 8, 32 };
+static size_t const N_REPS     = 5;
+
+bool less(void const* a, void const* b) {
+    return *(uint32_t*)a < *(uint32_t*)b;
+}
+
+int cmp(void const* a, void const* b) {
+    uint32_t const x = *(uint32_t*)a;
+    uint32_t const y = *(uint32_t*)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * Sorts a queue the way it's done by hand without `Queue_sort()`: drain the
+ * queue into an array, `qsort()` the array and enqueue the elements back.
+ */
+bool sort_by_qsort(Queue* queue, size_t elem_sz) {
+    size_t const n     = Queue_size(queue);
+    char*        elems = malloc(n * elem_sz);
+    if (elems == NULL) return false;
+
+    for (size_t i = 0; i < n; ++i) {
+        Queue_front(queue, elems + i * elem_sz);
+        Queue_dequeue(queue);
+    }
+    qsort(elems, n, elem_sz, cmp);
+    for (size_t i = 0; i < n; ++i) Queue_enqueue(queue, elems + i * elem_sz);
+
+    free(elems);
+    return true;
+}
+
+bool sort_by_merge(Queue* queue, size_t elem_sz) {
+    return Queue_sort(queue, elem_sz, less);
+}
+
+bool sort_by_radix(Queue* queue, size_t elem_sz) {
+    return Queue_radix_sort(queue, elem_sz, 0, sizeof(uint32_t));
+}
+
+/**
+ * Creates a queue of `n` elements of `elem_sz` bytes, keyed by the random
+ * `uint32_t` at the start of each element.
+ */
+Queue* create_bench_queue(size_t elem_sz, size_t n) {
+    Queue* q    = Queue_create(elem_sz);
+    char*  elem = malloc(elem_sz);
+    if (q == NULL || elem == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory to create a queue");
+        exit(EXIT_FAILURE);
+    }
+    memset(elem, 0xab, elem_sz);
+
+    for (size_t i = 0; i < n; ++i) {
+        *(uint32_t*)elem = (uint32_t)rand() << 16 ^ (uint32_t)rand();
+        if (!Queue_enqueue(q, elem)) {
+            fprintf(stderr, "%s\n", "cannot allocate memory to enqueue");
+            exit(EXIT_FAILURE);
+        }
+    }
+
+    free(elem);
+    return q;
+}
+
+/**
+ * Times a sort function on a queue of `n` elements of random keys, and
+ * reports the best of `N_REPS`.
+ */
+void bench_sort(char const* label, size_t elem_sz, size_t n,
+                bool (*sort)(Queue*, size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        srand(rep);
+        Queue* q = create_bench_queue(elem_sz, n);
+
+        double const begin = bench_now();
+        bool const   res   = sort(q, elem_sz);
+        double const secs  = bench_now() - begin;
+
+        assert(res && Queue_size(q) == n && "elements lost");
+        if (rep == 0 || secs < best) best = secs;
+
+        (void)res;
+        Queue_destroy(q);
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s [%4lu B]", label, elem_sz);
+    bench_report(buf, n, best);
+}
+
+/**
+ * Benchmarks `Queue_sort()` and `Queue_radix_sort()` against sorting with
+ * `qsort()` by hand, across element sizes. The number of elements defaults to
+ * 1M and can be overridden (in M) by the first command line argument.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 1;
+    if (m == 0) m = 1;
+
+    size_t const n     = m << 20;
+    size_t const n_szs = sizeof(ELEM_SZS) / sizeof(size_t);
+    for (size_t i = 0; i < n_szs; ++i) {
+        bench_sort("qsort()", ELEM_SZS[i], n, sort_by_qsort);
+        bench_sort("Queue_sort()", ELEM_SZS[i], n, sort_by_merge);
+        bench_sort("Queue_radix_sort()", ELEM_SZS[i], n, sort_by_radix);
+    }
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/sort.c bench_sort.c -o bench_sort_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_sort_circ_array
+
+gcc ../src/queue_linked_list.c ../src/sort.c bench_sort.c -o bench_sort_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_sort_linked_list
+*/
@@ -0,0 +1,76 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      bench_utils.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Benchmarking library.
+ *
+ * A simple header-only benchmarking library that provides a monotonic clock
+ * and a uniform way to report timings. Programs including it must define
+ * `_POSIX_C_SOURCE` to at least `199309L` before including any header.
+ */
+
+#ifndef BENCH_UTILS_H
+#define BENCH_UTILS_H
+
+#include <stdio.h>   // printf()
+#include <time.h>    // clock_gettime(), CLOCK_MONOTONIC
+
+/**
+ * @brief Reads a monotonic clock.
+ *
+ * @return Current time in seconds since an unspecified starting point.
+ */
+static inline double bench_now(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+}
+
+/**
+ * @brief Prints the timing of a benchmark case.
+ *
+ * @param label Name of the benchmark case.
+ * @param n_elems Number of elements processed by the benchmark case.
+ * @param secs Elapsed time in seconds.
+ */
+static inline void bench_report(char const* label, size_t n_elems,
+                                double secs) {
+    printf("%-40s %10.2f ms %10.2f ns/elem\n", label, secs * 1e3,
+           secs * 1e9 / (double)(n_elems > 0 ? n_elems : 1));
+}
+
+#endif /* BENCH_UTILS_H */
@@ -0,0 +1,200 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 199309L   // clock_gettime()
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), strtoull()
+#include <stdint.h>   // uint64_t
+#include <stdio.h>    // printf(), fprintf(), snprintf()
+
+#include "bench_utils.h"   // bench_now(), bench_report()
+#include "algos.h"         // MonoWindow, AggWindow, ...
+
+static size_t const WIDTHS[] = { 10, 1000, 100000, 1000000 };
+static size_t const N_WIDTHS = sizeof(WIDTHS) / sizeof(WIDTHS[0]);
+static size_t const N_REPS   = 3;
+
+/** Number of window elements rescanned at most, to bound rescanning runs. */
+static size_t const MAX_RESCANNED = (size_t)1 << 30;
+
+/** Keeps results from being optimized away. */
+static volatile uint64_t sink;
+
+bool less(void const* a, void const* b) {
+    return *(uint64_t*)a < *(uint64_t*)b;
+}
+
+void add(void* out, void const* a, void const* b) {
+    *(uint64_t*)out = *(uint64_t const*)a + *(uint64_t const*)b;
+}
+
+void min(void* out, void const* a, void const* b) {
+    uint64_t const x = *(uint64_t const*)a, y = *(uint64_t const*)b;
+    *(uint64_t*)out  = x < y ? x : y;
+}
+
+/** Samples of a random walk, so that the minimum changes over time. */
+uint64_t* create_samples(size_t n) {
+    uint64_t* samples = malloc(n * sizeof(uint64_t));
+    uint64_t  state = 1, level = (uint64_t)1 << 32;
+    if (samples == NULL) {
+        fprintf(stderr, "%s\n", "cannot allocate memory for samples");
+        exit(EXIT_FAILURE);
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        level += state % 201;
+        level -= 100;
+        samples[i] = level;
+    }
+    return samples;
+}
+
+/**
+ * Rescans the window on every sample for its minimum, as done by hand. The
+ * windows rescanned are full, ending at samples `width - 1` to `n + width - 2`.
+ */
+uint64_t min_by_rescan(uint64_t const* samples, size_t n, size_t width) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t best = samples[i];
+        for (size_t j = i + 1; j < i + width; ++j) {
+            if (samples[j] < best) best = samples[j];
+        }
+        total += best;
+    }
+    return total;
+}
+
+/** Rescans the window on every sample for its sum, like `min_by_rescan()`. */
+uint64_t sum_by_rescan(uint64_t const* samples, size_t n, size_t width) {
+    uint64_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        uint64_t sum = 0;
+        for (size_t j = i; j < i + width; ++j) sum += samples[j];
+        total += sum;
+    }
+    return total;
+}
+
+uint64_t min_by_mono_window(uint64_t const* samples, size_t n, size_t width) {
+    MonoWindow* window = MonoWindow_create(sizeof(uint64_t), width, less);
+    uint64_t    total  = 0;
+    for (size_t i = 0; i < n; ++i) {
+        MonoWindow_push(window, &samples[i]);
+        total += *(uint64_t const*)MonoWindow_extreme(window);
+    }
+    MonoWindow_destroy(window);
+    return total;
+}
+
+/** Slides an aggregating window over samples, summing its aggregates. */
+uint64_t agg_window(uint64_t const* samples, size_t n, size_t width,
+                    AggOp op) {
+    AggWindow* window = AggWindow_create(sizeof(uint64_t), width, op);
+    uint64_t   total = 0, agg = 0;
+    for (size_t i = 0; i < n; ++i) {
+        AggWindow_push(window, &samples[i]);
+        AggWindow_aggregate(window, &agg);
+        total += agg;
+    }
+    AggWindow_destroy(window);
+    return total;
+}
+
+uint64_t min_by_agg_window(uint64_t const* samples, size_t n, size_t width) {
+    return agg_window(samples, n, width, min);
+}
+
+uint64_t sum_by_agg_window(uint64_t const* samples, size_t n, size_t width) {
+    return agg_window(samples, n, width, add);
+}
+
+/**
+ * Times a sliding-window aggregation over `n` samples, and reports the best of
+ * `N_REPS`.
+ */
+void bench_window(char const* label, uint64_t const* samples, size_t n,
+                  size_t width,
+                  uint64_t (*aggregate)(uint64_t const*, size_t, size_t)) {
+    double best = 0.0;
+    for (size_t rep = 0; rep < N_REPS; ++rep) {
+        double const begin = bench_now();
+        sink               = aggregate(samples, n, width);
+        double const secs  = bench_now() - begin;
+        if (rep == 0 || secs < best) best = secs;
+    }
+
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%s [%7lu]", label, width);
+    bench_report(buf, n, best);
+}
+
+/**
+ * Benchmarks `MonoWindow` and `AggWindow` against rescanning the window on
+ * every sample, across window widths. The number of samples defaults to 4M and
+ * can be overridden (in M) by the first command line argument; rescanning
+ * runs are cut short to bound their time, and are timed over full windows.
+ */
+int main(int argc, char** argv) {
+    size_t m = argc > 1 ? strtoull(argv[1], NULL, 10) : 4;
+    if (m == 0) m = 4;
+
+    // Rescanning runs read up to a whole window past their last sample
+    size_t const    n       = m << 20;
+    uint64_t* const samples = create_samples(n + WIDTHS[N_WIDTHS - 1]);
+
+    for (size_t i = 0; i < N_WIDTHS; ++i) {
+        size_t const w = WIDTHS[i];
+        size_t const n_rescan = n < MAX_RESCANNED / w ? n : MAX_RESCANNED / w;
+
+        bench_window("min by rescan", samples, n_rescan, w, min_by_rescan);
+        bench_window("min by MonoWindow", samples, n, w, min_by_mono_window);
+        bench_window("min by AggWindow", samples, n, w, min_by_agg_window);
+        bench_window("sum by rescan", samples, n_rescan, w, sum_by_rescan);
+        bench_window("sum by AggWindow", samples, n, w, sum_by_agg_window);
+    }
+
+    free(samples);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/deque_circ_array.c ../src/window.c bench_window.c -o bench_window -std=c99 -O3 -march=native -DNDEBUG -I../src && ./bench_window
+*/
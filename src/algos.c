@@ -1,9 +1,66 @@
 /*** Out-of-line definitions ***/
+#define _POSIX_C_SOURCE 200112L   // sysconf()
+
 #include "algos.h"
 
 #include <stdbool.h>   // bool
-#include <stdlib.h>    // malloc()
+#include <stdlib.h>    // malloc(), free()
+#include <string.h>    // memcpy()
 #include <assert.h>    // assert()
+#include <pthread.h>   // pthread_create(), pthread_join()
+#include <unistd.h>    // sysconf()
+
+// clang-format off
+#ifdef MERGE_MIN_CHUNK
+/** Minimum number of elements for a thread to merge in parallel merges */
+static size_t const MIN_CHUNK = MERGE_MIN_CHUNK;
+#else
+/** Minimum number of elements for a thread to merge in parallel merges */
+static size_t const MIN_CHUNK = 1 << 14;
+#endif
+
+#ifdef MERGE_MIN_GALLOP
+/** Initial number of consecutive wins of a queue after which merges gallop */
+static size_t const MIN_GALLOP = MERGE_MIN_GALLOP;
+#else
+/** Initial number of consecutive wins of a queue after which merges gallop */
+static size_t const MIN_GALLOP = 7;
+#endif
+// clang-format on
+
+/**
+ * Counts the leading elements of a contiguous run that go before `pivot` in a
+ * stable merge, where the run comes from the first queue to merge if `first`
+ * is set and from the second otherwise. The count is bracketed by probing at
+ * exponentially growing offsets, and then pinned down by binary search, so
+ * that it takes `O(log n)` comparisons to count `n` elements.
+ */
+static size_t gallop(char const* run, size_t len, size_t elem_sz,
+                     void const* pivot, bool first,
+                     bool (*compare)(void const*, void const*)) {
+    size_t lo = 0;   // all elements before `lo` go before `pivot`
+    size_t hi = 1;   // the element at `hi - 1` is probed next
+
+    while (hi <= len && (first ? compare(run + (hi - 1) * elem_sz, pivot)
+                               : !compare(pivot, run + (hi - 1) * elem_sz))) {
+        lo = hi;
+        hi = 2 * hi + 1;
+    }
+    if (hi > len) hi = len + 1;
+
+    // The first element that does not go before `pivot` is in [lo, hi - 1]
+    hi -= 1;
+    while (lo < hi) {
+        size_t const mid = lo + (hi - lo) / 2;
+        if (first ? compare(run + mid * elem_sz, pivot)
+                  : !compare(pivot, run + mid * elem_sz)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
 
 Queue* merge_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
                     bool (*compare)(void const*, void const*)) {
@@ -19,59 +76,644 @@ Queue* merge_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
     if (q1_is_empty && !q2_is_empty) return queue2;
     if (!q1_is_empty && q2_is_empty) return queue1;
 
-    void* elem1 = malloc(elem_sz);
-    void* elem2 = malloc(elem_sz);
-    bool  res;
+    Queue* merged = Queue_create_like(queue1);
+    if (merged == NULL) return NULL;
 
-    Queue* merged     = Queue_create(elem_sz);
-    Queue* curr_queue = NULL;
-    void*  curr_elem  = NULL;
+    bool res = Queue_reserve(merged, Queue_size(queue1) + Queue_size(queue2));
+    assert(res && "cannot allocate memory to fulfill reserve()");
 
-    // Compare the elements at the front of two queues
-    while (!Queue_empty(queue1) && !Queue_empty(queue2)) {
-        res = Queue_front(queue1, elem1);
-        assert(res && "Queue_front() failed when queue not empty");
-        res = Queue_front(queue2, elem2);
-        assert(res && "Queue_front() failed when queue not empty");
+    // Access the front elements in place; only the front of the queue just
+    // dequeued from needs to be looked up again
+    void const* elem1      = Queue_peek(queue1);
+    void const* elem2      = Queue_peek(queue2);
+    Queue*      curr_queue = NULL;
+
+    size_t min_gallop = MIN_GALLOP;   // wins in a row that trigger a gallop
+    size_t wins1      = 0;            // wins in a row of the first queue
+    size_t wins2      = 0;            // wins in a row of the second queue
 
+    // Compare the elements at the front of two queues
+    while (elem1 != NULL && elem2 != NULL) {
         if (compare(elem1, elem2)) {
-            curr_queue = queue1;
-            curr_elem  = elem1;
+            res = Queue_enqueue(merged, elem1);
+            assert(res && "cannot allocate memory to filful enqueue()");
+
+            res = Queue_dequeue(queue1);
+            assert(res && "Queue_dequeue() failed when queue not empty");
+            elem1 = Queue_peek(queue1);
+            wins2 = 0;
+            if (++wins1 < min_gallop) continue;
         } else {
-            curr_queue = queue2;
-            curr_elem  = elem2;
+            res = Queue_enqueue(merged, elem2);
+            assert(res && "cannot allocate memory to filful enqueue()");
+
+            res = Queue_dequeue(queue2);
+            assert(res && "Queue_dequeue() failed when queue not empty");
+            elem2 = Queue_peek(queue2);
+            wins1 = 0;
+            if (++wins2 < min_gallop) continue;
         }
 
-        res = Queue_enqueue(merged, curr_elem);
-        assert(res && "cannot allocate memory to filful enqueue()");
+        // On a winning streak, move the rest of the run that keeps winning
+        // from the front segment of the winning queue in bulk
+        if (elem1 == NULL || elem2 == NULL) break;
+        bool const first = wins1 > 0;
+        curr_queue       = first ? queue1 : queue2;
 
-        res = Queue_dequeue(curr_queue);
-        assert(res && "Queue_dequeue() failed when queue not empty");
-    }
+        size_t       len = 0;
+        char const*  run = Queue_segment(curr_queue, NULL, &len);
+        size_t const n   = gallop(run, len, elem_sz, first ? elem2 : elem1,
+                                  first, compare);
+
+        res = Queue_transfer(merged, curr_queue, n);
+        assert(res && "cannot allocate memory to fulfill transfer()");
 
-    // Retain elem1 on the heap to copy front element into for rest of algo
-    free(elem2);
+        // Gallop sooner if it pays off, later otherwise
+        if (n >= MIN_GALLOP) {
+            if (min_gallop > 1) min_gallop -= 1;
+        } else {
+            min_gallop += 1;
+        }
+        wins1 = wins2 = 0;
+        elem1 = Queue_peek(queue1);
+        elem2 = Queue_peek(queue2);
+    }
 
     // Find out which queue has unprocessed elements
-    if (!Queue_empty(queue1)) {
+    if (elem1 != NULL) {
         curr_queue = queue1;
     } else {
         curr_queue = queue2;
     }
 
-    // Sequentially move unprocessed elements into the merged queue
-    while (!Queue_empty(curr_queue)) {
-        res = Queue_front(curr_queue, elem1);
-        assert(res && "Queue_front() failed when queue not empty");
+    // Move unprocessed elements into the merged queue in bulk
+    res = Queue_transfer(merged, curr_queue, Queue_size(curr_queue));
+    assert(res && "cannot allocate memory to fulfill transfer()");
+
+    return merged;
+}
+
+/** State of a k-way merge: a loser tree over the front elements of queues. */
+struct loser_tree
+{
+    size_t       k;         // Number of queues merged
+    size_t*      losers;    // Loser at each internal node; winner at index 0
+    void const** fronts;    // Front element of each queue, `NULL` if empty
+    bool (*compare)(void const*, void const*);   // Element order
+};
+
+/**
+ * Determines whether the front element of the `i`-th queue goes before that of
+ * the `j`-th queue. Empty queues go last; ties go to the queue further down.
+ */
+static bool beats(struct loser_tree* tree, size_t i, size_t j) {
+    void const* a = tree->fronts[i];
+    void const* b = tree->fronts[j];
+
+    if (a == NULL) return false;
+    if (b == NULL) return true;
+    return i < j ? tree->compare(a, b) : !tree->compare(b, a);
+}
+
+/**
+ * Plays the matches in the subtree rooted at `node`, recording the loser of
+ * each match, and returns the index of the queue that wins the subtree.
+ */
+static size_t play(struct loser_tree* tree, size_t node) {
+    if (node >= tree->k) return node - tree->k;   // leaf
+
+    size_t const left  = play(tree, 2 * node);
+    size_t const right = play(tree, 2 * node + 1);
+
+    if (beats(tree, left, right)) {
+        tree->losers[node] = right;
+        return left;
+    }
+    tree->losers[node] = left;
+    return right;
+}
+
+/**
+ * Replays the matches on the path from the leaf of the `i`-th queue to the
+ * root after the front element of the queue changed.
+ */
+static void replay(struct loser_tree* tree, size_t i) {
+    size_t winner = i;
+    for (size_t node = (tree->k + i) / 2; node > 0; node /= 2) {
+        if (beats(tree, tree->losers[node], winner)) {
+            size_t const loser = winner;
+            winner             = tree->losers[node];
+            tree->losers[node] = loser;
+        }
+    }
+    tree->losers[0] = winner;
+}
+
+Queue* merge_k_queues(Queue** queues, size_t k, size_t elem_sz,
+                      bool (*compare)(void const*, void const*)) {
+    if (queues == NULL || k == 0) return NULL;
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    struct loser_tree tree = { k, NULL, NULL, compare };
+
+    tree.losers = malloc(k * sizeof(size_t));
+    tree.fronts = malloc(k * sizeof(void const*));
+    if (tree.losers == NULL || tree.fronts == NULL) {
+        free(tree.losers);
+        free(tree.fronts);
+        return NULL;
+    }
+
+    size_t n_elems    = 0;      // total number of elements to merge
+    size_t n_nonempty = 0;      // number of queues that are not empty
+    Queue* first      = NULL;   // first queue that is not empty
+    for (size_t i = 0; i < k; ++i) {
+        tree.fronts[i] = queues[i] != NULL ? Queue_peek(queues[i]) : NULL;
+        if (tree.fronts[i] != NULL) {
+            n_elems    += Queue_size(queues[i]);
+            n_nonempty += 1;
+            if (first == NULL) first = queues[i];
+        }
+    }
+
+    Queue* merged = n_elems > 0 ? Queue_create_like(first) : NULL;
+    if (merged == NULL || !Queue_reserve(merged, n_elems)) {
+        if (merged != NULL) Queue_destroy(merged);
+        free(tree.losers);
+        free(tree.fronts);
+        return NULL;
+    }
+
+    tree.losers[0] = play(&tree, 1);
+    bool res;
 
-        res = Queue_enqueue(merged, elem1);
+    // Move the winning front element until only one queue has elements left
+    while (n_nonempty > 1) {
+        size_t const i = tree.losers[0];
+
+        res = Queue_enqueue(merged, tree.fronts[i]);
         assert(res && "cannot allocate memory to filful enqueue()");
 
-        res = Queue_dequeue(curr_queue);
+        res = Queue_dequeue(queues[i]);
         assert(res && "Queue_dequeue() failed when queue not empty");
+
+        tree.fronts[i] = Queue_peek(queues[i]);
+        if (tree.fronts[i] == NULL) n_nonempty -= 1;
+
+        replay(&tree, i);
+    }
+
+    // Move unprocessed elements of the last queue into the merged queue in bulk
+    size_t const last = tree.losers[0];
+    res = Queue_transfer(merged, queues[last], Queue_size(queues[last]));
+    assert(res && "cannot allocate memory to fulfill transfer()");
+
+    free(tree.losers);
+    free(tree.fronts);
+
+    return merged;
+}
+
+/** Random access view of a queue stored in at most two contiguous segments. */
+struct view
+{
+    char*  segs[2];   // First element of each segment
+    size_t lens[2];   // Number of elements in each segment
+    size_t elemsz;    // Size of each element in bytes
+};
+
+/**
+ * Captures the view of a queue. Returns `false` if the queue is stored in more
+ * than two segments.
+ */
+static bool view_of(Queue* queue, size_t elem_sz, struct view* view) {
+    view->segs[0] = view->segs[1] = NULL;
+    view->lens[0] = view->lens[1] = 0;
+    view->elemsz  = elem_sz;
+
+    void*  seg = NULL;
+    size_t len = 0;
+    for (size_t i = 0; (seg = Queue_segment(queue, seg, &len)) != NULL; ++i) {
+        if (i == 2) return false;
+        view->segs[i] = seg;
+        view->lens[i] = len;
+    }
+    return true;
+}
+
+/** Computes the address of the `i`-th element in a view. */
+static char* view_at(struct view const* view, size_t i) {
+    if (i < view->lens[0]) return view->segs[0] + i * view->elemsz;
+    return view->segs[1] + (i - view->lens[0]) * view->elemsz;
+}
+
+/** A range of the output of a stable merge to be computed by one thread. */
+struct merge_task
+{
+    struct view const* a;       // First queue to merge
+    struct view const* b;       // Second queue to merge
+    struct view const* out;     // Merged queue
+    size_t             na;      // Number of elements in the first queue
+    size_t             nb;      // Number of elements in the second queue
+    size_t             begin;   // Position of the first element to output
+    size_t             end;     // Position one past the last element to output
+    bool (*compare)(void const*, void const*);   // Element order
+};
+
+/**
+ * Binary-searches the merge path along the diagonal `diag` for the number of
+ * elements from the first queue among the first `diag` merged elements.
+ */
+static size_t merge_path(struct merge_task const* task, size_t diag) {
+    size_t lo = diag > task->nb ? diag - task->nb : 0;
+    size_t hi = diag < task->na ? diag : task->na;
+
+    while (lo < hi) {
+        size_t const mid = lo + (hi - lo) / 2;
+        if (task->compare(view_at(task->a, mid),
+                          view_at(task->b, diag - mid - 1))) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/** Merges a range of the output independently of all other ranges. */
+static void* merge_range(void* arg) {
+    struct merge_task const* task = arg;
+
+    size_t       i     = merge_path(task, task->begin);
+    size_t       j     = task->begin - i;
+    size_t const i_end = merge_path(task, task->end);
+    size_t const j_end = task->end - i_end;
+
+    char const* elem = NULL;
+    for (size_t k = task->begin; k < task->end; ++k) {
+        if (j == j_end || (i < i_end && task->compare(view_at(task->a, i),
+                                                      view_at(task->b, j)))) {
+            elem = view_at(task->a, i++);
+        } else {
+            elem = view_at(task->b, j++);
+        }
+        memcpy(view_at(task->out, k), elem, task->a->elemsz);
+    }
+    return NULL;
+}
+
+Queue* merge_queues_parallel(Queue* queue1, Queue* queue2, size_t elem_sz,
+                             bool (*compare)(void const*, void const*),
+                             size_t n_threads) {
+    if (queue1 == NULL && queue2 == NULL) return NULL;
+    if (queue1 == NULL) return queue2;
+    if (queue2 == NULL) return queue1;
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    bool q1_is_empty = Queue_empty(queue1);
+    bool q2_is_empty = Queue_empty(queue2);
+
+    if (q1_is_empty && q2_is_empty) return NULL;
+    if (q1_is_empty && !q2_is_empty) return queue2;
+    if (!q1_is_empty && q2_is_empty) return queue1;
+
+    if (n_threads == 0) {
+        long const n_cpus = sysconf(_SC_NPROCESSORS_ONLN);
+        n_threads         = n_cpus > 0 ? (size_t)n_cpus : 1;
+    }
+
+    // Cap the number of threads so that each has enough elements to merge
+    size_t const n1 = Queue_size(queue1);
+    size_t const n2 = Queue_size(queue2);
+    size_t const n  = n1 + n2;
+    if (n_threads > n / MIN_CHUNK) n_threads = n / MIN_CHUNK;
+
+    // Fall back to a sequential merge unless random access is cheap, or if
+    // the queues own their elements, since the merged queue is pre-sized
+    struct view a, b, out;
+    if (n_threads < 2 || Queue_owned(queue1) || !view_of(queue1, elem_sz, &a) ||
+        !view_of(queue2, elem_sz, &b)) {
+        return merge_queues(queue1, queue2, elem_sz, compare);
+    }
+
+    // Pre-size the merged queue, into which threads write their ranges
+    Queue* merged = Queue_create(elem_sz);
+    if (merged == NULL) return NULL;
+    if (!Queue_extend(merged, n)) {
+        Queue_destroy(merged);
+        return NULL;
+    }
+    if (!view_of(merged, elem_sz, &out)) {
+        Queue_destroy(merged);
+        return merge_queues(queue1, queue2, elem_sz, compare);
     }
 
-    free(elem1);
+    struct merge_task* tasks   = malloc(n_threads * sizeof(struct merge_task));
+    pthread_t*         threads = malloc(n_threads * sizeof(pthread_t));
+    bool*              spawned = malloc(n_threads * sizeof(bool));
+    if (tasks == NULL || threads == NULL || spawned == NULL) {
+        free(tasks);
+        free(threads);
+        free(spawned);
+        Queue_destroy(merged);
+        return merge_queues(queue1, queue2, elem_sz, compare);
+    }
+
+    // Split the output into equal ranges; run the first on this thread
+    struct merge_task const task = { &a, &b, &out, n1, n2, 0, 0, compare };
+    for (size_t t = 0; t < n_threads; ++t) {
+        tasks[t]       = task;
+        tasks[t].begin = n * t / n_threads;
+        tasks[t].end   = n * (t + 1) / n_threads;
+        spawned[t]     = t > 0 && pthread_create(&threads[t], NULL,
+                                                 merge_range, &tasks[t]) == 0;
+    }
+    merge_range(&tasks[0]);
+
+    // Merge ranges of threads that cannot be spawned on this thread as well
+    for (size_t t = 1; t < n_threads; ++t) {
+        if (spawned[t]) {
+            pthread_join(threads[t], NULL);
+        } else {
+            merge_range(&tasks[t]);
+        }
+    }
+
+    free(tasks);
+    free(threads);
+    free(spawned);
+
+    // Empty the queues merged, as merge_queues() does
+    bool res = Queue_dequeue_n(queue1, n1) && Queue_dequeue_n(queue2, n2);
+    assert(res && "Queue_dequeue_n() failed when queue not empty");
 
     return merged;
 }
+
+struct merge_iter
+{
+    Queue* queue1;   // First queue to merge
+    Queue* queue2;   // Second queue to merge
+    size_t elemsz;   // Size of each element in bytes
+    bool (*compare)(void const*, void const*);   // Element order
+};
+
+MergeIter* MergeIter_create(Queue* queue1, Queue* queue2, size_t elem_sz,
+                            bool (*compare)(void const*, void const*)) {
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    MergeIter* iter = malloc(sizeof(MergeIter));
+    if (iter == NULL) return NULL;
+
+    iter->queue1  = queue1;
+    iter->queue2  = queue2;
+    iter->elemsz  = elem_sz;
+    iter->compare = compare;
+    return iter;
+}
+
+void MergeIter_destroy(MergeIter* iter) { free(iter); }
+
+/**
+ * Determines the queue from which the next element of a merge comes, or
+ * `NULL` if both queues are empty. The front element is stored in `front`.
+ */
+static Queue* next_queue(MergeIter* iter, void const** front) {
+    void const* elem1 = iter->queue1 != NULL ? Queue_peek(iter->queue1) : NULL;
+    void const* elem2 = iter->queue2 != NULL ? Queue_peek(iter->queue2) : NULL;
+
+    // Same choice as merge_queues(): second queue goes first on ties
+    if (elem1 != NULL && (elem2 == NULL || iter->compare(elem1, elem2))) {
+        *front = elem1;
+        return iter->queue1;
+    }
+    *front = elem2;
+    return elem2 != NULL ? iter->queue2 : NULL;
+}
+
+void const* MergeIter_peek(MergeIter* iter) {
+    assert(iter != NULL);
+
+    void const* front = NULL;
+    next_queue(iter, &front);
+    return front;
+}
+
+bool MergeIter_next(MergeIter* iter, void* elem) {
+    assert(iter != NULL);
+
+    void const* front = NULL;
+    Queue*      queue = next_queue(iter, &front);
+    if (queue == NULL) return false;
+
+    if (elem != NULL) memcpy(elem, front, iter->elemsz);
+
+    bool res = Queue_dequeue(queue);
+    assert(res && "Queue_dequeue() failed when queue not empty");
+
+    return true;
+}
+
+/** Number of times larger a queue has to be for set operations to gallop. */
+static size_t const GALLOP_RATIO = 8;
+
+/** Set operations on sorted queues. */
+enum set_op
+{
+    UNION,
+    INTERSECTION,
+    DIFFERENCE
+};
+
+/** Output of a set operation, kept free of duplicates. */
+struct set_output
+{
+    Queue* queue;      // Queue to which elements are output
+    char*  last;       // Copy of the last element output
+    bool   has_last;   // Whether any element has been output
+    size_t elemsz;     // Size of each element in bytes
+    bool (*compare)(void const*, void const*);   // Element order
+};
+
+/**
+ * Counts the leading elements of the front segment of a queue that go before
+ * `pivot`, by galloping if `by_gallop` is set or else by linear search. The
+ * front element must go before `pivot`.
+ */
+static size_t count_before(Queue* queue, size_t elem_sz, void const* pivot,
+                           bool by_gallop,
+                           bool (*compare)(void const*, void const*)) {
+    size_t      len = 0;
+    char const* run = Queue_segment(queue, NULL, &len);
+    if (len < 2 || !compare(run + elem_sz, pivot)) return 1;
+    if (by_gallop) return gallop(run, len, elem_sz, pivot, true, compare);
+
+    size_t n = 2;
+    while (n < len && compare(run + n * elem_sz, pivot)) ++n;
+    return n;
+}
+
+/**
+ * Moves the `n` leading elements of the front segment of a queue to the output
+ * of a set operation, dropping those equal to the element output before them.
+ * Spans of distinct elements are moved in bulk.
+ */
+static void output_run(struct set_output* out, Queue* src, size_t n) {
+    size_t const elem_sz = out->elemsz;
+    bool         res;
+
+    // Single elements, as in interleaved queues, skip the segment lookups
+    if (n == 1) {
+        void const* elem = Queue_peek(src);
+        if (!out->has_last || out->compare(out->last, elem)) {
+            memcpy(out->last, elem, elem_sz);
+            out->has_last = true;
+            res           = Queue_enqueue(out->queue, elem);
+            assert(res && "cannot allocate memory to fulfill enqueue()");
+            res = Queue_dequeue(src);
+        } else {
+            res = Queue_discard_n(src, 1);
+        }
+        assert(res && "Queue_dequeue() failed when queue not empty");
+        return;
+    }
+
+    while (n > 0) {
+        size_t      len = 0;
+        char const* run = Queue_segment(src, NULL, &len);
+        size_t      k   = 0;
+        assert(n <= len && "run does not fit in the front segment");
+
+        // Drop elements equal to the last element output
+        while (k < n && out->has_last && !out->compare(out->last, run)) {
+            run += elem_sz;
+            ++k;
+        }
+        if (k > 0) {
+            res = Queue_discard_n(src, k);
+            assert(res && "Queue_dequeue_n() failed when queue not that large");
+            n -= k;
+            continue;
+        }
+
+        // Move the span of elements each going after the one before in bulk
+        for (k = 1; k < n; ++k) {
+            if (!out->compare(run + (k - 1) * elem_sz, run + k * elem_sz)) {
+                break;
+            }
+        }
+        memcpy(out->last, run + (k - 1) * elem_sz, elem_sz);
+        out->has_last = true;
+
+        res = Queue_transfer(out->queue, src, k);
+        assert(res && "cannot allocate memory to fulfill transfer()");
+        n -= k;
+    }
+}
+
+/** Empties a queue, moving its elements to the output if `keep` is set. */
+static void output_rest(struct set_output* out, Queue* src, bool keep) {
+    if (src == NULL) return;
+    if (!keep) {
+        bool res = Queue_discard_n(src, Queue_size(src));
+        assert(res && "Queue_dequeue_n() failed when queue not that large");
+        return;
+    }
+
+    size_t len = 0;
+    while (Queue_segment(src, NULL, &len) != NULL) output_run(out, src, len);
+}
+
+/**
+ * Runs a set operation on two sorted queues. The front elements are compared
+ * as in a merge, and the run of elements of a queue that go before the front
+ * element of the other queue is then found as a whole and either output or
+ * dropped. Runs of a queue much larger than the other are found by galloping.
+ */
+static Queue* set_operation(Queue* queue1, Queue* queue2, size_t elem_sz,
+                            bool (*compare)(void const*, void const*),
+                            enum set_op op) {
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    size_t const n1 = queue1 != NULL ? Queue_size(queue1) : 0;
+    size_t const n2 = queue2 != NULL ? Queue_size(queue2) : 0;
+
+    // Reserve room for the largest possible output up front
+    size_t n = n1;
+    if (op == UNION) n = n1 + n2;
+    if (op == INTERSECTION && n2 < n1) n = n2;
+
+    Queue* const      like = queue1 != NULL ? queue1 : queue2;
+    struct set_output out  = { like != NULL ? Queue_create_like(like)
+                                            : Queue_create(elem_sz),
+                               malloc(elem_sz), false, elem_sz, compare };
+    if (out.queue == NULL || out.last == NULL || !Queue_reserve(out.queue, n)) {
+        if (out.queue != NULL) Queue_destroy(out.queue);
+        free(out.last);
+        return NULL;
+    }
+
+    bool const gallop1 = n1 / GALLOP_RATIO >= n2;
+    bool const gallop2 = n2 / GALLOP_RATIO >= n1;
+
+    void const* elem1 = n1 > 0 ? Queue_peek(queue1) : NULL;
+    void const* elem2 = n2 > 0 ? Queue_peek(queue2) : NULL;
+    bool        res;
+
+    while (elem1 != NULL && elem2 != NULL) {
+        if (compare(elem1, elem2)) {
+            n = count_before(queue1, elem_sz, elem2, gallop1, compare);
+            if (op == INTERSECTION) {
+                res = Queue_discard_n(queue1, n);
+                assert(res && "Queue_dequeue_n() failed when queue not that "
+                              "large");
+            } else {
+                output_run(&out, queue1, n);
+            }
+        } else if (compare(elem2, elem1)) {
+            n = count_before(queue2, elem_sz, elem1, gallop2, compare);
+            if (op == UNION) {
+                output_run(&out, queue2, n);
+            } else {
+                res = Queue_discard_n(queue2, n);
+                assert(res && "Queue_dequeue_n() failed when queue not that "
+                              "large");
+            }
+        } else if (op == DIFFERENCE) {
+            // Keep the element of the second queue to drop duplicates against
+            res = Queue_discard_n(queue1, 1);
+            assert(res && "Queue_dequeue() failed when queue not empty");
+        } else {
+            // The element of the second queue is dropped, as a duplicate in
+            // unions, once it comes after the last element output
+            output_run(&out, queue1, 1);
+            if (op == INTERSECTION) {
+                res = Queue_discard_n(queue2, 1);
+                assert(res && "Queue_dequeue() failed when queue not empty");
+            }
+        }
+        elem1 = Queue_peek(queue1);
+        elem2 = Queue_peek(queue2);
+    }
+
+    output_rest(&out, queue1, op != INTERSECTION);
+    output_rest(&out, queue2, op == UNION);
+
+    free(out.last);
+    return out.queue;
+}
+
+Queue* union_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
+                    bool (*compare)(void const*, void const*)) {
+    return set_operation(queue1, queue2, elem_sz, compare, UNION);
+}
+
+Queue* intersect_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
+                        bool (*compare)(void const*, void const*)) {
+    return set_operation(queue1, queue2, elem_sz, compare, INTERSECTION);
+}
+
+Queue* subtract_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
+                       bool (*compare)(void const*, void const*)) {
+    return set_operation(queue1, queue2, elem_sz, compare, DIFFERENCE);
+}
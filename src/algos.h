@@ -56,6 +56,14 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * in the original queues are preserved. A new queue is created and returned if
  * both queues to merge are not empty.
  *
+ * Once a queue wins several comparisons in a row, the merge gallops: it
+ * exponential-searches the contiguous segment at the front of that queue (see
+ * `Queue_segment()`) for how far the winning run extends, and moves the whole
+ * run at once. The number of wins that triggers a gallop adapts to how much
+ * galloping pays off, so inputs that interleave element by element cost
+ * little more than without it, whereas inputs in long runs take far fewer
+ * comparisons.
+ *
  * @param[in] queue1 A queue to merge.
  * @param[in] queue2 Another queue to merge.
  * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
@@ -68,12 +76,539 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  *      queues to merge if the other is empty, `NULL` if both are empty.
  *      **[IMPORTANT]** In the first case, call `Queue_destroy()` when
  *      you're done with the merged queue to free the memory allocated to it.
+ *      The merged queue is created with `Queue_create_like(queue1)`, so it
+ *      owns the elements if the queues to merge do (see
+ *      `Queue_create_owned()`); both should then be owned the same way. In
+ *      the second case, the queue returned is the input itself, which keeps
+ *      its elements: destroy the result only if it differs from both inputs.
  * @note The complexity of the merge algorithm is `O(n1 + n2)` in both time and
  *      space, where `n1` and `n2` are the sizes of the two queues to merge.
  */
 Queue* merge_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
                     bool (*compare)(void const*, void const*));
 
+/**
+ * @brief Stable-merges any number of queues.
+ *
+ * A loser tree is kept over the front elements of the queues, so that each
+ * element merged costs a single path of `O(log k)` comparisons from a leaf to
+ * the root, without creating any intermediate queues. Relative order of
+ * elements in the original queues are preserved. Just like `merge_queues()`,
+ * when neither of two elements precedes the other according to `compare`,
+ * the one from the queue further down `queues` comes first, so that merging
+ * two queues gives the same result as `merge_queues()` does.
+ *
+ * All queues to merge are emptied.
+ *
+ * @param[in] queues An array of queues to merge. `NULL` entries are treated as
+ *      empty queues.
+ * @param[in] k Number of queues in `queues`.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] compare A binary predicate that determines the element order in
+ *      the merged queue; it has not effect on the relative order of elements
+ *      in the original queues.
+ * @return The merged queue if any of the queues to merge is not empty, `NULL`
+ *      otherwise or if the system cannot allocate sufficient memory.
+ *      **[IMPORTANT]** In the first case, call `Queue_destroy()` when you're
+ *      done with the merged queue to free the memory allocated to it. The
+ *      merged queue is created like the first queue that is not empty (see
+ *      `Queue_create_like()`).
+ * @note The complexity of the merge algorithm is `O(n log k)` in time and
+ *      `O(n + k)` in space, where `n` is the total size of the queues to
+ *      merge.
+ */
+Queue* merge_k_queues(Queue** queues, size_t k, size_t elem_sz,
+                      bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Stable-merges two queues using multiple threads.
+ *
+ * The merged queue is pre-sized and split into equal ranges of positions.
+ * Each thread locates the start and end of its range in the queues to merge
+ * by binary-searching the merge path along a diagonal, and then merges its
+ * range directly into the merged queue independently of all other threads.
+ * The result is identical to that of `merge_queues()`.
+ *
+ * Random access to queue elements is required to search merge paths, so
+ * queues stored in more than two contiguous segments (see `Queue_segment()`),
+ * such as those of node-based implementations, are merged by `merge_queues()`
+ * on the calling thread instead. So are queues too small to be worth
+ * splitting.
+ *
+ * @param[in] queue1 A queue to merge.
+ * @param[in] queue2 Another queue to merge.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] compare A binary predicate that determines the element order in
+ *      the merged queue. It's called concurrently from multiple threads, so it
+ *      must not modify any shared state.
+ * @param[in] n_threads Maximum number of threads to use, including the
+ *      calling thread. Pass `0` to use as many threads as there are online
+ *      processors.
+ * @return Same as `merge_queues()`.
+ * @note The complexity of the merge algorithm is `O((n1 + n2) / p + p log(n1
+ *      + n2))` in time and `O(n1 + n2)` in space, where `n1` and `n2` are the
+ *      sizes of the two queues to merge and `p` is the number of threads.
+ */
+Queue* merge_queues_parallel(Queue* queue1, Queue* queue2, size_t elem_sz,
+                             bool (*compare)(void const*, void const*),
+                             size_t n_threads);
+
+/** An opaque type representing a lazy stable merge of two queues. */
+typedef struct merge_iter MergeIter;
+
+/**
+ * @brief Creates an iterator that yields the elements of the stable merge of
+ * two queues on demand.
+ *
+ * Unlike `merge_queues()`, no merged queue is materialized. Each call to
+ * `MergeIter_next()` dequeues exactly one element from one of the queues, so
+ * memory use is `O(1)` and the cost is proportional to the number of elements
+ * actually consumed. The order in which elements are yielded is the same as
+ * the order in which `merge_queues()` would merge them.
+ *
+ * The queues must outlive the iterator. Elements enqueued to the queues while
+ * iterating are taken into account from the next call on.
+ *
+ * It's the caller's responsibility to call `MergeIter_destroy()` to free all
+ * allocated memory associated with the iterator created.
+ *
+ * @param[in] queue1 A queue to merge, or `NULL` as if it were empty.
+ * @param[in] queue2 Another queue to merge, or `NULL` as if it were empty.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] compare A binary predicate that determines the element order in
+ *      the merge; it has not effect on the relative order of elements in the
+ *      original queues.
+ * @return The iterator created on success, `NULL` otherwise.
+ */
+MergeIter* MergeIter_create(Queue* queue1, Queue* queue2, size_t elem_sz,
+                            bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Destroys a merge iterator. The queues merged are left as they are.
+ *
+ * It is a no-op if the `iter` is `NULL`.
+ *
+ * @param iter The iterator to destroy.
+ */
+void MergeIter_destroy(MergeIter* iter);
+
+/**
+ * @brief Accesses the next element of a merge in place without consuming it.
+ *
+ * The pointer returned is invalidated by any subsequent operation that
+ * modifies the queue it belongs to, including `MergeIter_next()`.
+ *
+ * @param[in] iter The iterator to query.
+ * @return Address of the next element if any, `NULL` otherwise.
+ */
+void const* MergeIter_peek(MergeIter* iter);
+
+/**
+ * @brief Consumes the next element of a merge.
+ *
+ * @param[in] iter The iterator to advance.
+ * @param[out] elem The next element if any, undefined otherwise. Pass `NULL`
+ *      to discard the element, e.g. after accessing it with `MergeIter_peek()`.
+ * @return `false` if both queues merged are empty, `true` otherwise.
+ */
+bool MergeIter_next(MergeIter* iter, void* elem);
+
+/**
+ * @brief Computes the union of two sorted queues, without duplicates.
+ *
+ * Both queues must be sorted according to `compare`. Elements for which
+ * neither goes before the other are equal; only the first of equal elements
+ * is kept, taking elements of `queue1` before those of `queue2`. The merged
+ * queue is reserved for all elements up front, and runs of distinct elements
+ * are moved into it in bulk. Runs of elements of a queue that go before the
+ * front element of the other queue are found by galloping through the
+ * contiguous front segment (see `Queue_segment()`) of the queue if it is much
+ * larger than the other one, or else by linear search.
+ *
+ * Both queues are emptied. If they own their elements (see
+ * `Queue_create_owned()`), so does the queue returned, and elements left out
+ * are passed to the destructor of the queue they are dropped from.
+ *
+ * @param[in] queue1 A sorted queue, or `NULL` as if it were empty.
+ * @param[in] queue2 Another sorted queue, or `NULL` as if it were empty.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] compare A binary predicate that determines whether an element
+ *      goes before another.
+ * @return A new queue of the distinct elements of both queues in sorted
+ *      order, `NULL` if the system cannot allocate sufficient memory.
+ *      **[IMPORTANT]** Call `Queue_destroy()` when you're done with the queue
+ *      to free the memory allocated to it.
+ * @note The complexity of the algorithm is `O(n1 + n2)` in time and space,
+ *      where `n1` and `n2` are the sizes of the two queues, but only
+ *      `O(n1 log(n2 / n1))` comparisons if `n2` is much larger than `n1`.
+ */
+Queue* union_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
+                    bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Computes the intersection of two sorted queues, without duplicates.
+ *
+ * The elements of `queue1` that are equal to an element of `queue2` are kept,
+ * each distinct element once.
+ *
+ * @see `union_queues()` for details, including the parameters. The queue
+ *      returned is reserved for the size of the smaller queue.
+ */
+Queue* intersect_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
+                        bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Computes the difference of two sorted queues, without duplicates.
+ *
+ * The elements of `queue1` that are not equal to any element of `queue2` are
+ * kept, each distinct element once.
+ *
+ * @see `union_queues()` for details, including the parameters. The queue
+ *      returned is reserved for the size of `queue1`.
+ */
+Queue* subtract_queues(Queue* queue1, Queue* queue2, size_t elem_sz,
+                       bool (*compare)(void const*, void const*));
+
+/** Order in which keys appear in a merged queue. */
+typedef enum
+{
+    ASCENDING,    // Smallest key first
+    DESCENDING,   // Largest key first
+} KeyOrder;
+
+/**
+ * @brief Stable-merges two queues of `int32_t`.
+ *
+ * The result is identical to that of `merge_queues()` with `elem_sz` set to
+ * `sizeof(int32_t)` and `compare` set to `<` for `ASCENDING` order, or `>` for
+ * `DESCENDING` order, but the comparison is inlined and the queues are merged
+ * a contiguous run at a time (see `Queue_segment()`) by a branchless loop.
+ * Where AVX2 or SSE4.1 is available at compile time, runs are merged a vector
+ * at a time by a bitonic merge network instead.
+ *
+ * @param[in] queue1 A queue to merge.
+ * @param[in] queue2 Another queue to merge.
+ * @param[in] order Order of elements in both queues to merge and in the merged
+ *      queue.
+ * @return Same as `merge_queues()`.
+ * @note The complexity of the merge algorithm is `O(n1 + n2)` in both time and
+ *      space, where `n1` and `n2` are the sizes of the two queues to merge.
+ */
+Queue* merge_queues_i32(Queue* queue1, Queue* queue2, KeyOrder order);
+
+/**
+ * @brief Stable-merges two queues of `uint64_t` by a branchless loop.
+ *
+ * @see `merge_queues_i32()`, except that no SIMD merge network is used.
+ */
+Queue* merge_queues_u64(Queue* queue1, Queue* queue2, KeyOrder order);
+
+/**
+ * @brief Stable-merges two queues of `float` by a branchless loop.
+ *
+ * @see `merge_queues_i32()`, except that no SIMD merge network is used.
+ * @note Neither queue may contain NaN, which is not ordered.
+ */
+Queue* merge_queues_f32(Queue* queue1, Queue* queue2, KeyOrder order);
+
+/**
+ * @brief Stable-merges two queues of `double` by a branchless loop.
+ *
+ * @see `merge_queues_i32()`, except that no SIMD merge network is used.
+ * @note Neither queue may contain NaN, which is not ordered.
+ */
+Queue* merge_queues_f64(Queue* queue1, Queue* queue2, KeyOrder order);
+
+/** Type of the key by which elements are ordered. */
+typedef enum
+{
+    KEY_I32,   // int32_t
+    KEY_U32,   // uint32_t
+    KEY_I64,   // int64_t
+    KEY_U64,   // uint64_t
+    KEY_F32,   // float
+    KEY_F64,   // double
+} KeyType;
+
+/**
+ * @brief Stable-merges two queues by a key of primitive type embedded in each
+ * element.
+ *
+ * The result is identical to that of `merge_queues()` with `compare` set to
+ * compare the keys with `<` for `ASCENDING` order, or `>` for `DESCENDING`
+ * order, but keys are loaded and compared inline without calling through a
+ * function pointer, and the element to output is selected without a branch.
+ * Elements that are nothing but a key of type `int32_t`, `uint64_t`, `float`
+ * or `double` are merged as by `merge_queues_i32()` and the like.
+ *
+ * @param[in] queue1 A queue to merge.
+ * @param[in] queue2 Another queue to merge.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] key_offset Offset of the key in each element in bytes, e.g. as
+ *      given by `offsetof()`. The key need not be aligned.
+ * @param[in] key_type Type of the key.
+ * @param[in] order Order of keys in both queues to merge and in the merged
+ *      queue.
+ * @return Same as `merge_queues()`.
+ * @note The complexity of the merge algorithm is `O(n1 + n2)` in both time and
+ *      space, where `n1` and `n2` are the sizes of the two queues to merge.
+ *      Floating-point keys may not be NaN.
+ */
+Queue* merge_queues_by_key(Queue* queue1, Queue* queue2, size_t elem_sz,
+                           size_t key_offset, KeyType key_type,
+                           KeyOrder order);
+
+/**
+ * @brief Stable-sorts the elements of a queue.
+ *
+ * Queues that can store their elements contiguously (see `Queue_linearize()`)
+ * are sorted in place by merge sort, with an auxiliary array of the same size.
+ * Other queues are merge-sorted by moving elements between the queue and two
+ * other queues with `Queue_transfer()`, which relinks nodes in node-based
+ * implementations without copying or allocating elements. In the latter case,
+ * watermark callbacks (see `Queue_set_watermarks()`) may be called as the queue
+ * shrinks and grows back.
+ *
+ * @param[in] queue The queue to sort.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] compare A binary predicate that determines whether an element
+ *      goes before another; elements for which neither goes before the other
+ *      keep their relative order.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, in which case the queue is not modified; `true`
+ *      otherwise (on success).
+ * @note The complexity of the sorting algorithm is `O(n log n)` in time and
+ *      `O(n)` in space, where `n` is the size of the queue.
+ */
+bool Queue_sort(Queue* queue, size_t elem_sz,
+                bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Stable-sorts the elements of a queue in ascending order of an
+ * unsigned integer key embedded in each element.
+ *
+ * Elements are sorted by LSD radix sort, one byte of keys per pass, skipping
+ * bytes that all keys share. Like `Queue_sort()`, contiguous queues are sorted
+ * in place with an auxiliary array, and other queues by moving elements
+ * between bucket queues with `Queue_transfer()`. Signed keys can be sorted by
+ * flipping their sign bits before and after sorting.
+ *
+ * @param[in] queue The queue to sort.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] key_offset Offset of the key in each element in bytes, e.g. as
+ *      given by `offsetof()`.
+ * @param[in] key_width Size of the key in bytes, from 1 to 8. The key is in
+ *      native byte order.
+ * @return Same as `Queue_sort()`.
+ * @note The complexity of the sorting algorithm is `O(w n)` in time and `O(n)`
+ *      in space, where `n` is the size of the queue and `w` is `key_width`.
+ */
+bool Queue_radix_sort(Queue* queue, size_t elem_sz, size_t key_offset,
+                      size_t key_width);
+
+/**
+ * @brief Stably partitions the elements of a queue into two queues by a
+ * predicate.
+ *
+ * Elements for which the predicate holds are moved to the end of `out_true`,
+ * and the others to the end of `out_false`, in queue order. Elements are
+ * moved with `Queue_transfer()` a span at a time, where a span is the longest
+ * run of contiguous elements (see `Queue_segment()`) going to the same queue,
+ * so array-based implementations copy spans in bulk and node-based
+ * implementations relink nodes without copying or allocating elements.
+ *
+ * @param[in] src The queue to partition. It's emptied on success.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] pred A unary predicate that determines which queue an element
+ *      goes to.
+ * @param[in] out_true The queue to which elements satisfying `pred` are to
+ *      add. It must be a different queue from `src` with the same element
+ *      size.
+ * @param[in] out_false The queue to which the other elements are to add. It
+ *      must be a different queue from `src` with the same element size, and
+ *      may be the same queue as `out_true`.
+ * @return `false` if either output queue would exceed its size limit or the
+ *      system cannot allocate sufficient memory to complete the operation, in
+ *      which case the elements not yet moved are left in `src` in order;
+ *      `true` otherwise (on success).
+ * @note The complexity of the algorithm is `O(n)` in time and `O(1)` in
+ *      additional space, where `n` is the size of `src`.
+ */
+bool Queue_partition(Queue* src, size_t elem_sz, bool (*pred)(void const*),
+                     Queue* out_true, Queue* out_false);
+
+/**
+ * @brief Removes the elements of a queue for which a predicate does not hold,
+ * keeping the order of the others.
+ *
+ * Queues that can store their elements contiguously (see `Queue_linearize()`)
+ * are filtered in place in a single pass, by moving the elements to keep
+ * towards the end and then removing the front. Other queues, and queues that
+ * own their elements (see `Queue_create_owned()`), are filtered by moving
+ * spans of elements to keep to another queue with `Queue_transfer()` and
+ * back, in which case watermark callbacks (see `Queue_set_watermarks()`) may
+ * be called as the queue shrinks and grows back. Elements dropped from an
+ * owned queue are passed to its destructor.
+ *
+ * @param[in] queue The queue to filter.
+ * @param[in] elem_sz Size of each queue elements in bytes. **[IMPORTANT]**
+ *      It's the caller's responsibility to ensure `elem_sz` is a proper
+ *      positive integer.
+ * @param[in] pred A unary predicate that determines whether an element is
+ *      kept.
+ * @return `false` if the system cannot allocate sufficient memory, or the
+ *      queue cannot read or write its backing storage, to complete the
+ *      operation; `true` otherwise (on success). On failure, the queue holds
+ *      the elements kept so far followed by those not examined yet, or the
+ *      other way round if these cannot be moved, unless moving the elements
+ *      kept back fails too, in which case those are lost.
+ * @note The complexity of the algorithm is `O(n)` in time, where `n` is the
+ *      size of the queue.
+ */
+bool Queue_filter_in_place(Queue* queue, size_t elem_sz,
+                           bool (*pred)(void const*));
+
+/** An opaque type representing the extreme element of a sliding window. */
+typedef struct mono_window MonoWindow;
+
+/**
+ * @brief Creates a sliding window over the most recent `width` elements of a
+ * stream that tracks its extreme element, e.g. its minimum or maximum.
+ *
+ * The window keeps a monotonic deque of the elements that may still become
+ * the extreme, i.e. those that no later element goes before, so that sliding
+ * the window is amortized `O(1)` and querying the extreme is `O(1)`.
+ *
+ * It's the caller's responsibility to call `MonoWindow_destroy()` to free all
+ * allocated memory associated with the window created.
+ *
+ * @param[in] elem_sz Size of each element in bytes. **[IMPORTANT]** It's the
+ *      caller's responsibility to ensure `elem_sz` is a proper positive
+ *      integer.
+ * @param[in] width Number of most recent elements in the window, at least 1.
+ * @param[in] compare A binary predicate that determines whether an element
+ *      goes before another. The extreme is the element that no other element
+ *      in the window goes before, e.g. the minimum if `compare` is "less
+ *      than"; of equal elements, the most recent one.
+ * @return The window created on success, `NULL` otherwise.
+ */
+MonoWindow* MonoWindow_create(size_t elem_sz, size_t width,
+                              bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Destroys a sliding window.
+ *
+ * It is a no-op if the `window` is `NULL`.
+ *
+ * @param window The window to destroy.
+ */
+void MonoWindow_destroy(MonoWindow* window);
+
+/**
+ * @brief Slides a window by one element, which becomes the most recent
+ * element, evicting the least recent element once the window is full.
+ *
+ * @param[in] window The window to slide.
+ * @param[in] elem The element to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool MonoWindow_push(MonoWindow* window, void const* elem);
+
+/**
+ * @brief Accesses the extreme element of a window in place.
+ *
+ * The pointer returned is invalidated by the next call to `MonoWindow_push()`.
+ *
+ * @param[in] window The window to query.
+ * @return Address of the extreme element if any element has been added,
+ *      `NULL` otherwise.
+ */
+void const* MonoWindow_extreme(MonoWindow* window);
+
+/**
+ * @brief An associative binary operation on elements.
+ *
+ * @param[out] out Where to store the result, which never overlaps `a` or `b`.
+ * @param[in] a The left operand.
+ * @param[in] b The right operand.
+ */
+typedef void (*AggOp)(void* out, void const* a, void const* b);
+
+/** An opaque type representing the aggregate of a sliding window. */
+typedef struct agg_window AggWindow;
+
+/**
+ * @brief Creates a sliding window over the most recent `width` elements of a
+ * stream that tracks their aggregate under any associative operation, e.g. a
+ * sum, a product, a minimum or a greatest common divisor.
+ *
+ * The window is made of two stacks: elements are pushed onto a back stack that
+ * keeps a running aggregate, and are evicted from a front stack that keeps the
+ * aggregates of each of its suffixes, which is refilled from the back stack
+ * when empty. Sliding the window takes amortized `O(1)` applications of the
+ * operation, and querying the aggregate takes at most one. Unlike recomputing
+ * the aggregate, the operation need not be invertible or commutative.
+ *
+ * It's the caller's responsibility to call `AggWindow_destroy()` to free all
+ * allocated memory associated with the window created.
+ *
+ * @param[in] elem_sz Size of each element in bytes. **[IMPORTANT]** It's the
+ *      caller's responsibility to ensure `elem_sz` is a proper positive
+ *      integer.
+ * @param[in] width Number of most recent elements in the window, at least 1.
+ * @param[in] op An associative binary operation that combines elements, from
+ *      the least recent to the most recent.
+ * @return The window created on success, `NULL` otherwise.
+ */
+AggWindow* AggWindow_create(size_t elem_sz, size_t width, AggOp op);
+
+/**
+ * @brief Destroys a sliding window.
+ *
+ * It is a no-op if the `window` is `NULL`.
+ *
+ * @param window The window to destroy.
+ */
+void AggWindow_destroy(AggWindow* window);
+
+/**
+ * @brief Slides a window by one element, which becomes the most recent
+ * element, evicting the least recent element once the window is full.
+ *
+ * @param[in] window The window to slide.
+ * @param[in] elem The element to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool AggWindow_push(AggWindow* window, void const* elem);
+
+/**
+ * @brief Computes the aggregate of the elements in a window.
+ *
+ * @param[in] window The window to query.
+ * @param[out] result The aggregate if any element has been added, undefined
+ *      otherwise.
+ * @return `false` if no element has been added, `true` otherwise.
+ */
+bool AggWindow_aggregate(AggWindow* window, void* result);
+
 // -----------------------------------------------------------------------------
 
 #endif /* QUEUE_ALGOS_H */
\ No newline at end of file
@@ -0,0 +1,166 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      delayqueue.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) delay queue.
+ *
+ * Delay queue is a collection ADT in which each element is held until a given
+ * time, when it expires and is removed. Time is counted in ticks of a logical
+ * clock that only moves forward when advanced by the caller. This module
+ * defines the interface of the DelayQueue ADT.
+ *
+ * Use `DelayQueue_create()` to create a delay queue, which should be destroyed
+ * when it is no longer needed using `DelayQueue_destroy()`. Use
+ * `DelayQueue_schedule()` to add an element that expires after a delay,
+ * `DelayQueue_cancel()` to remove it before it expires, and
+ * `DelayQueue_advance()` to move the clock forward, which removes the elements
+ * that expire in the meantime in order of expiry time. Elements that expire on
+ * the same tick are removed in no particular order.
+ *
+ * All functions that accept a pointer to a delay queue asserts that it is not
+ * `NULL`, which can be disabled by adding the `-DNDEBUG` flag when compiling
+ * the library and/or programs using gcc.
+ */
+
+#ifndef DELAYQUEUE_H
+#define DELAYQUEUE_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+#include <stdint.h>    // uint64_t
+
+/** An opaque type representing a generic delay queue. */
+typedef struct delayqueue DelayQueue;
+
+/** A handle to an element scheduled on a delay queue, to cancel it. */
+typedef uint64_t TimerId;
+
+/**
+ * @brief Creates an empty, heap-allocated delay queue, with its clock at tick
+ * `0`.
+ *
+ * It's the caller's responsibility to
+ * -# call `DelayQueue_destroy()` to free all allocated memory associated
+ *    with the delay queue created; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] elem_sz Size of each element in bytes.
+ * @return The delay queue created on success, `NULL` otherwise.
+ */
+DelayQueue* DelayQueue_create(size_t elem_sz);
+
+/**
+ * @brief Destroys a heap-allocated delay queue, along with the elements that
+ * have not expired.
+ *
+ * @param delayqueue The delay queue to destroy.
+ */
+void DelayQueue_destroy(DelayQueue* delayqueue);
+
+/**
+ * @brief Determines whether a delay queue is empty.
+ *
+ * @param[in] delayqueue The delay queue to query.
+ * @return `true` if no element of the delay queue is pending, `false`
+ *      otherwise.
+ */
+bool DelayQueue_empty(DelayQueue* delayqueue);
+
+/**
+ * @brief Queries the size of a delay queue.
+ *
+ * @param[in] delayqueue The delay queue to query.
+ * @return Number of elements scheduled that have neither expired nor been
+ *      cancelled.
+ */
+size_t DelayQueue_size(DelayQueue* delayqueue);
+
+/**
+ * @brief Queries the current time of a delay queue.
+ *
+ * @param[in] delayqueue The delay queue to query.
+ * @return Number of ticks the delay queue has been advanced by.
+ */
+uint64_t DelayQueue_now(DelayQueue* delayqueue);
+
+/**
+ * @brief Adds an element to a delay queue, which expires after a delay.
+ *
+ * @param[in] delayqueue The delay queue to which the element is to add.
+ * @param[in] delay Number of ticks from now after which the element expires.
+ *      A delay of `0` is taken as `1`, the next tick.
+ * @param[in] elem The element to add.
+ * @param[out] id A handle to the element to pass to `DelayQueue_cancel()` if
+ *      it is not `NULL`, undefined on failure.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool DelayQueue_schedule(DelayQueue* delayqueue, uint64_t delay,
+                         void const* elem, TimerId* id);
+
+/**
+ * @brief Removes an element from a delay queue before it expires.
+ *
+ * @param[in] delayqueue The delay queue from which the element is to remove.
+ * @param[in] id The handle given when the element was scheduled.
+ * @return `false` if the element has already expired or been cancelled,
+ *      `true` otherwise (on success).
+ */
+bool DelayQueue_cancel(DelayQueue* delayqueue, TimerId id);
+
+/**
+ * @brief Moves the clock of a delay queue forward, removing the elements that
+ * expire on each tick as a batch.
+ *
+ * Elements are moved within the delay queue as the clock moves. If the system
+ * cannot allocate the memory to move one, it stays pending and is moved on
+ * the following ticks instead, in which case it may expire late, but it is
+ * never lost.
+ *
+ * @param[in] delayqueue The delay queue to advance.
+ * @param[in] ticks Number of ticks to move the clock forward by.
+ * @param[in] expire A function to call with the address of each element that
+ *      expires, in order, and `ctx`. It may schedule and cancel elements, but
+ *      must not advance the delay queue.
+ * @param[in] ctx A user context passed to `expire`, which may be `NULL`.
+ * @return Number of elements that expired.
+ */
+size_t DelayQueue_advance(DelayQueue* delayqueue, uint64_t ticks,
+                          void (*expire)(void const* elem, void* ctx),
+                          void* ctx);
+
+#endif /* DELAYQUEUE_H */
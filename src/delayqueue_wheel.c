@@ -0,0 +1,403 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @brief Implementation of the ADT delay queue as a hierarchical timing wheel
+ * of FIFO queues.
+ *
+ * The wheel has `LEVELS` levels of `SLOTS` buckets each, where a bucket of
+ * level `i` holds the elements that expire within a span of `SLOTS^i` ticks.
+ * Elements are added to the bucket of the lowest level whose span covers
+ * their delay, so scheduling takes constant time. Whenever the clock crosses
+ * the span of a bucket of a higher level, that bucket is cascaded, i.e. its
+ * elements are moved down to the level below, and the bucket of the lowest
+ * level for the current tick holds exactly the elements that expire on it.
+ * Elements whose delay exceeds the span of the wheel wait in its top level
+ * and are moved again when cascaded.
+ *
+ * Each bucket is a queue created on first use with `Queue_create()`, so the
+ * wheel uses whichever implementation of the Queue ADT it is linked with.
+ * Cancelling an element only invalidates its handle, by bumping the generation
+ * of its timer, so it takes constant time too. Cancelled elements stay in
+ * their bucket until it is cascaded or expired, where they are dropped.
+ * Elements that cannot be moved down for lack of memory stay at the front of
+ * their bucket, and are moved on the following ticks, once memory allows.
+ */
+
+#include "delayqueue.h"
+
+#include <assert.h>   // assert()
+#include <stdlib.h>   // malloc(), realloc(), free()
+#include <string.h>   // memcpy()
+
+#include "queue.h"   // Queue, Queue_*()
+
+/** Number of levels of the wheel. */
+#define LEVELS 4
+
+/** Number of bits of a tick that index the buckets of a level. */
+#define SLOT_BITS 6
+
+/** Number of buckets of each level. */
+#define SLOTS (1 << SLOT_BITS)
+
+/** Longest delay that the wheel can hold without cascading it again. */
+static uint64_t const MAX_DELAY = ((uint64_t)1 << (LEVELS * SLOT_BITS)) - 1;
+
+/** Marks the end of the list of free timers. */
+static uint32_t const NO_TIMER = UINT32_MAX;
+
+// -----------------------------------------------------------------------------
+
+/** Header of each element in a bucket, which is followed by the element. */
+struct entry
+{
+    uint64_t expiry;   // Tick on which the element expires.
+    uint32_t timer;    // Timer of the element.
+    uint32_t gen;      // Generation of the timer when the element was added.
+};
+
+/** State of a handle to an element. */
+struct timer
+{
+    uint32_t gen;    // Generation, bumped when its element leaves the queue.
+    uint32_t next;   // Next free timer, if the timer is free.
+};
+
+struct delayqueue
+{
+    size_t        elemsz;     // Element size in bytes.
+    size_t        entrysz;    // Bucket element size in bytes, with its header.
+    size_t        nlive;      // Number of elements pending.
+    size_t        nentries;   // Number of elements in buckets, cancelled too.
+    uint64_t      now;        // Current tick.
+    struct timer* timers;     // Timers of the elements, in use or free.
+    size_t        ntimers;    // Number of timers ever used.
+    size_t        timercap;   // Capacity of the array of timers.
+    uint32_t      freelist;   // First free timer.
+    char*         scratch;    // Bucket element being scheduled.
+    size_t        nstalled;   // Number of buckets with elements not moved.
+    Queue*        buckets[LEVELS][SLOTS];   // Buckets, `NULL` until used.
+    size_t        stalled[LEVELS][SLOTS];   // Front elements not moved down.
+};
+
+DelayQueue* DelayQueue_create(size_t elem_sz) {
+    DelayQueue* dq = malloc(sizeof(DelayQueue));
+    if (dq == NULL) return NULL;
+
+    dq->scratch = malloc(sizeof(struct entry) + elem_sz);
+    if (dq->scratch == NULL) {
+        free(dq);
+        return NULL;
+    }
+
+    dq->elemsz   = elem_sz;
+    dq->entrysz  = sizeof(struct entry) + elem_sz;
+    dq->nlive    = 0;
+    dq->nentries = 0;
+    dq->now      = 0;
+    dq->timers   = NULL;
+    dq->ntimers  = 0;
+    dq->timercap = 0;
+    dq->freelist = NO_TIMER;
+    dq->nstalled = 0;
+    for (size_t level = 0; level < LEVELS; ++level) {
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            dq->buckets[level][slot] = NULL;
+            dq->stalled[level][slot] = 0;
+        }
+    }
+    return dq;
+}
+
+void DelayQueue_destroy(DelayQueue* delayqueue) {
+    assert(delayqueue != NULL);
+
+    for (size_t level = 0; level < LEVELS; ++level) {
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            Queue* bucket = delayqueue->buckets[level][slot];
+            if (bucket != NULL) Queue_destroy(bucket);
+        }
+    }
+    free(delayqueue->timers);
+    free(delayqueue->scratch);
+    free(delayqueue);
+}
+
+bool DelayQueue_empty(DelayQueue* delayqueue) {
+    assert(delayqueue != NULL);
+
+    return delayqueue->nlive == 0;
+}
+
+size_t DelayQueue_size(DelayQueue* delayqueue) {
+    assert(delayqueue != NULL);
+
+    return delayqueue->nlive;
+}
+
+uint64_t DelayQueue_now(DelayQueue* delayqueue) {
+    assert(delayqueue != NULL);
+
+    return delayqueue->now;
+}
+
+/**
+ * Finds the bucket in which to add an element that expires on tick `expiry`,
+ * creating the bucket if need be. Elements overdue, which could not be moved
+ * down in time, expire on the current tick.
+ */
+static Queue* bucket_for(DelayQueue* dq, uint64_t expiry) {
+    if (expiry < dq->now) expiry = dq->now;
+    uint64_t const delay = expiry - dq->now;
+
+    // Elements beyond the span of the wheel wait in its last bucket
+    if (delay > MAX_DELAY) expiry = dq->now + MAX_DELAY;
+
+    size_t level = 0;
+    while (level < LEVELS - 1 && (delay >> (SLOT_BITS * (level + 1))) != 0) {
+        ++level;
+    }
+
+    size_t const slot = (expiry >> (SLOT_BITS * level)) & (SLOTS - 1);
+    Queue**      pb   = &dq->buckets[level][slot];
+    if (*pb == NULL) *pb = Queue_create(dq->entrysz);
+    return *pb;
+}
+
+/** Takes a free timer, or a new one, returning `NO_TIMER` on failure. */
+static uint32_t acquire_timer(DelayQueue* dq) {
+    uint32_t const timer = dq->freelist;
+    if (timer != NO_TIMER) {
+        dq->freelist = dq->timers[timer].next;
+        return timer;
+    }
+
+    if (dq->ntimers == NO_TIMER) return NO_TIMER;
+    if (dq->ntimers == dq->timercap) {
+        size_t const  new_cap = dq->timercap > 0 ? dq->timercap * 2 : 64;
+        struct timer* arr = realloc(dq->timers, new_cap * sizeof(*arr));
+        if (arr == NULL) return NO_TIMER;
+
+        dq->timers   = arr;
+        dq->timercap = new_cap;
+    }
+
+    dq->timers[dq->ntimers] = (struct timer){ .gen = 0, .next = NO_TIMER };
+    return (uint32_t)dq->ntimers++;
+}
+
+/** Invalidates the handles to a timer, and returns it to the free list. */
+static void release_timer(DelayQueue* dq, uint32_t timer) {
+    dq->timers[timer].gen  += 1;
+    dq->timers[timer].next  = dq->freelist;
+    dq->freelist            = timer;
+}
+
+/** Determines whether a bucket element has been cancelled. */
+static bool is_cancelled(DelayQueue* dq, struct entry const* e) {
+    return dq->timers[e->timer].gen != e->gen;
+}
+
+bool DelayQueue_schedule(DelayQueue* delayqueue, uint64_t delay,
+                         void const* elem, TimerId* id) {
+    assert(delayqueue != NULL);
+
+    uint32_t const timer = acquire_timer(delayqueue);
+    if (timer == NO_TIMER) return false;
+
+    if (delay == 0) delay = 1;
+    struct entry const e = { .expiry = delayqueue->now + delay,
+                             .timer  = timer,
+                             .gen    = delayqueue->timers[timer].gen };
+    memcpy(delayqueue->scratch, &e, sizeof(e));
+    memcpy(delayqueue->scratch + sizeof(e), elem, delayqueue->elemsz);
+
+    Queue* bucket = bucket_for(delayqueue, e.expiry);
+    if (bucket == NULL || !Queue_enqueue(bucket, delayqueue->scratch)) {
+        // Hand the timer back without invalidating handles never given out
+        delayqueue->timers[timer].next = delayqueue->freelist;
+        delayqueue->freelist           = timer;
+        return false;
+    }
+
+    delayqueue->nlive    += 1;
+    delayqueue->nentries += 1;
+    if (id != NULL) *id = ((TimerId)e.gen << 32) | timer;
+    return true;
+}
+
+bool DelayQueue_cancel(DelayQueue* delayqueue, TimerId id) {
+    assert(delayqueue != NULL);
+
+    uint32_t const timer = (uint32_t)id;
+    uint32_t const gen   = (uint32_t)(id >> 32);
+    if (timer >= delayqueue->ntimers) return false;
+    if (delayqueue->timers[timer].gen != gen) return false;
+
+    release_timer(delayqueue, timer);
+    delayqueue->nlive -= 1;
+    return true;
+}
+
+/** Context of the front elements of a bucket that are cascaded. */
+struct cascade
+{
+    DelayQueue* dq;       // Delay queue advanced.
+    size_t      nleft;    // Number of front elements left to move.
+    size_t      nmoved;   // Number of front elements moved or dropped.
+    bool        failed;   // Whether an element could not be moved.
+};
+
+/**
+ * Moves a bucket element to the bucket of a lower level where it belongs as
+ * of the current tick, unless it has been cancelled. Once an element cannot
+ * be moved, those behind it are left in place too, to keep them in order.
+ */
+static void cascade_entry(void const* elem, void* ctx) {
+    struct cascade* c = ctx;
+    if (c->failed || c->nleft == 0) return;
+
+    struct entry e;
+    memcpy(&e, elem, sizeof(e));
+    if (is_cancelled(c->dq, &e)) {
+        c->dq->nentries -= 1;
+    } else {
+        Queue* dst = bucket_for(c->dq, e.expiry);
+        if (dst == NULL || !Queue_enqueue(dst, elem)) {
+            c->failed = true;
+            return;
+        }
+    }
+    c->nleft  -= 1;
+    c->nmoved += 1;
+}
+
+/**
+ * Moves the first `n` elements of a bucket to the buckets of the lower levels
+ * where they belong as of the current tick, dropping the cancelled ones. The
+ * elements moved are removed at once rather than one at a time, so that the
+ * bucket keeps its capacity for the elements to come. Those that cannot be
+ * moved for lack of memory are left at the front of the bucket, and recorded
+ * to be moved on a later tick.
+ */
+static void cascade(DelayQueue* dq, size_t level, size_t slot, size_t n) {
+    Queue*         bucket = dq->buckets[level][slot];
+    struct cascade c      = { .dq = dq, .nleft = n, .nmoved = 0,
+                              .failed = false };
+    Queue_for_each(bucket, cascade_entry, &c);
+    bool const res = Queue_dequeue_n(bucket, c.nmoved);
+    assert(res && "Queue_dequeue_n() failed when queue not that large");
+    (void)res;
+
+    size_t* const stalled = &dq->stalled[level][slot];
+    dq->nstalled -= *stalled > 0;
+    *stalled      = c.nleft;
+    dq->nstalled += *stalled > 0;
+}
+
+/** Retries moving down the elements that earlier cascades could not. */
+static void retry_stalled(DelayQueue* dq) {
+    for (size_t level = 1; level < LEVELS && dq->nstalled > 0; ++level) {
+        for (size_t slot = 0; slot < SLOTS; ++slot) {
+            size_t const n = dq->stalled[level][slot];
+            if (n > 0) cascade(dq, level, slot, n);
+        }
+    }
+}
+
+/** Context of the elements of a bucket that expire as a batch. */
+struct expiry
+{
+    DelayQueue* dq;         // Delay queue advanced.
+    void*       ctx;        // Caller's context.
+    size_t      nexpired;   // Number of elements expired.
+    void (*expire)(void const* elem, void* ctx);   // Caller's function.
+};
+
+/** Expires a bucket element unless it has been cancelled. */
+static void expire_entry(void const* elem, void* ctx) {
+    struct expiry* x = ctx;
+    struct entry   e;
+    memcpy(&e, elem, sizeof(e));
+    if (is_cancelled(x->dq, &e)) return;
+
+    release_timer(x->dq, e.timer);
+    x->dq->nlive -= 1;
+    x->nexpired  += 1;
+    x->expire((char const*)elem + sizeof(e), x->ctx);
+}
+
+size_t DelayQueue_advance(DelayQueue* delayqueue, uint64_t ticks,
+                          void (*expire)(void const* elem, void* ctx),
+                          void* ctx) {
+    assert(delayqueue != NULL);
+    assert(expire != NULL && "expire is not a function");
+
+    struct expiry x = { .dq = delayqueue, .expire = expire, .ctx = ctx,
+                        .nexpired = 0 };
+
+    for (uint64_t t = 0; t < ticks; ++t) {
+        // Nothing can expire once all buckets are empty
+        if (delayqueue->nentries == 0) {
+            delayqueue->now += ticks - t;
+            break;
+        }
+
+        uint64_t const now = ++delayqueue->now;
+        if (delayqueue->nstalled > 0) retry_stalled(delayqueue);
+
+        // Cascade the buckets of the higher levels whose span starts now
+        for (size_t level = 1; level < LEVELS; ++level) {
+            if ((now & (((uint64_t)1 << (SLOT_BITS * level)) - 1)) != 0) break;
+
+            size_t const slot   = (now >> (SLOT_BITS * level)) & (SLOTS - 1);
+            Queue*       bucket = delayqueue->buckets[level][slot];
+            if (bucket != NULL) {
+                cascade(delayqueue, level, slot, Queue_size(bucket));
+            }
+        }
+
+        // Expire the bucket of the lowest level for this tick as a batch
+        Queue* bucket = delayqueue->buckets[0][now & (SLOTS - 1)];
+        if (bucket == NULL || Queue_empty(bucket)) continue;
+
+        size_t const n = Queue_size(bucket);
+        Queue_for_each(bucket, expire_entry, &x);
+        bool const res = Queue_dequeue_n(bucket, n);
+        assert(res && "Queue_dequeue_n() failed when queue not that large");
+        (void)res;
+        delayqueue->nentries -= n;
+    }
+    return x.nexpired;
+}
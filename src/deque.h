@@ -0,0 +1,218 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      deque.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) deque.
+ *
+ * Deque, or double-ended queue, is a sequential ADT that supports adding and
+ * removing elements at both ends, and accessing any element by its position.
+ * This module defines the interface of the Deque ADT.
+ *
+ * Use `Deque_create()` to create a deque, which should be destroyed when it is
+ * no longer needed using `Deque_destroy()`. Use `Deque_push_back()` and
+ * `Deque_push_front()` to add an element at either end, `Deque_pop_back()` and
+ * `Deque_pop_front()` to remove one, and `Deque_at()` to access the element at
+ * a position, counting from the front.
+ *
+ * All functions that accept a pointer to a deque asserts that the deque is not
+ * `NULL`, which can be disabled by adding the `-DNDEBUG` flag when compiling
+ * the library and/or programs using gcc.
+ */
+
+#ifndef DEQUE_H
+#define DEQUE_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+
+/** An opaque type representing a generic deque. */
+typedef struct deque Deque;
+
+/**
+ * @brief Creates an empty, heap-allocated deque.
+ *
+ * It's the caller's responsibility to
+ * -# call `Deque_destroy()` to free all allocated memory associated
+ *    with the deque created; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] elem_sz Size of each deque elements in bytes.
+ * @return The deque created on success, `NULL` otherwise.
+ */
+Deque* Deque_create(size_t elem_sz);
+
+/**
+ * @brief Destroys a heap-allocated deque.
+ *
+ * @param deque The deque to destroy.
+ */
+void Deque_destroy(Deque* deque);
+
+/**
+ * @brief Queries the capacity of a deque.
+ *
+ * @param[in] deque The deque to query.
+ * @return Maximum number of elements that can be stored by the deque without
+ *      further allocation.
+ */
+size_t Deque_capacity(Deque* deque);
+
+/**
+ * @brief Requests that a deque be able to hold at least `n` elements without
+ * further allocation.
+ *
+ * Removing elements from the deque afterwards may release the capacity
+ * reserved.
+ *
+ * @param[in] deque The deque to reserve capacity for.
+ * @param[in] n Number of elements to reserve capacity for.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation; `true` otherwise (on success).
+ */
+bool Deque_reserve(Deque* deque, size_t n);
+
+/**
+ * @brief Determines whether a deque is empty.
+ *
+ * @param[in] deque The deque to query.
+ * @return `true` if the deque is empty, `false` otherwise.
+ */
+bool Deque_empty(Deque* deque);
+
+/**
+ * @brief Queries the size of a deque.
+ *
+ * @param[in] deque The deque to query.
+ * @return Number of elements in the deque.
+ */
+size_t Deque_size(Deque* deque);
+
+/**
+ * @brief Accesses the front element of a deque.
+ *
+ * @param[in] deque The deque to query.
+ * @param[out] elem The front element if the deque is not empty, undefined
+ *      otherwise.
+ * @return `false` if the deque is empty, `true` otherwise (on success).
+ */
+bool Deque_front(Deque* deque, void* elem);
+
+/**
+ * @brief Accesses the back element of a deque.
+ *
+ * @param[in] deque The deque to query.
+ * @param[out] elem The back element if the deque is not empty, undefined
+ *      otherwise.
+ * @return `false` if the deque is empty, `true` otherwise (on success).
+ */
+bool Deque_back(Deque* deque, void* elem);
+
+/**
+ * @brief Accesses an element of a deque in place by its position.
+ *
+ * The address returned is invalidated by any subsequent operation that
+ * modifies the deque, other than writing elements in place.
+ *
+ * @param[in] deque The deque to query.
+ * @param[in] i Position of the element, where `0` is the front element and
+ *      `Deque_size(deque) - 1` is the back element.
+ * @return Address of the element if `i` is less than the size of the deque,
+ *      `NULL` otherwise.
+ */
+void* Deque_at(Deque* deque, size_t i);
+
+/**
+ * @brief Adds an element to the back of a deque.
+ *
+ * @param[in] deque The deque to which the element is to add.
+ * @param[in] elem The element to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool Deque_push_back(Deque* deque, void const* elem);
+
+/**
+ * @brief Adds an element to the front of a deque.
+ *
+ * @param[in] deque The deque to which the element is to add.
+ * @param[in] elem The element to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool Deque_push_front(Deque* deque, void const* elem);
+
+/**
+ * @brief Removes the back element from a deque.
+ *
+ * @param[in] deque The deque from which its back element is to remove.
+ * @return `false` if the deque is empty, `true` otherwise (on success).
+ */
+bool Deque_pop_back(Deque* deque);
+
+/**
+ * @brief Removes the front element from a deque.
+ *
+ * @param[in] deque The deque from which its front element is to remove.
+ * @return `false` if the deque is empty, `true` otherwise (on success).
+ */
+bool Deque_pop_front(Deque* deque);
+
+/**
+ * @brief Removes all elements from a deque, keeping its capacity.
+ *
+ * @param[in] deque The deque to clear.
+ */
+void Deque_clear(Deque* deque);
+
+/**
+ * @brief Prints a string representation of the elements in a deque to the
+ * standard output.
+ *
+ * Elements are listed from front to back, from left to right in a horizontal
+ * layout, or from top to bottom in a vertical layout.
+ *
+ * @param[in] deque The deque of which the elements to print.
+ * @param[in] sep A string used to separate successive elements. Has no effect
+ *      if `vertical` is `true`. Defaults to ",".
+ * @param[in] vertical Elements are listed vertically if `true`, horizontally
+ *      otherwise.
+ * @param[in] print_element A function to use for printing a deque element.
+ */
+void Deque_print(Deque* deque, char const* sep, bool vertical,
+                 void (*print_element)(void const*));
+
+#endif /* DEQUE_H */
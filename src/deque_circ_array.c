@@ -0,0 +1,292 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @brief Implementation of the ADT deque as an unbounded deque using a circular
+ * array of power-of-two capacity with dynamic resizing strategy.
+ *
+ * Positions in the underlying array are wrapped around by masking with the
+ * capacity less one rather than by division, so that elements can be added
+ * and removed at both ends and accessed by position in constant time.
+ *
+ * @note Use the compiler flag `DEQUE_INIT_CAP` to override the default initial
+ *      capacity of the underlying array, which is rounded up to a power of two.
+ */
+
+#include "deque.h"
+
+#include <assert.h>   // assert()
+#include <stdlib.h>   // malloc(), free()
+#include <string.h>   // memcpy()
+#include <stdio.h>    // printf()
+
+// clang-format off
+/** Initial underlying array capacity */
+#ifdef DEQUE_INIT_CAP
+static size_t const INIT_CAP = DEQUE_INIT_CAP;
+#else
+static size_t const INIT_CAP = 1024;
+#endif
+// clang-format on
+
+// -----------------------------------------------------------------------------
+
+struct deque
+{
+    size_t elemsz;   // Element size in bytes.
+    size_t nelems;   // Number of elements in the deque.
+    size_t cap;      // Capacity of the underlying array, a power of two.
+    size_t mask;     // Capacity less one, to wrap positions around.
+    size_t start;    // Position of the front element in the underlying array.
+    void*  elems;    // Underlying array that stores the deque elements.
+};
+
+/** Rounds a capacity up to the next power of two, which is at least 2. */
+static size_t round_up_cap(size_t n) {
+    size_t cap = 2;
+    while (cap < n) cap *= 2;
+    return cap;
+}
+
+Deque* Deque_create(size_t elem_sz) {
+    // Allocate deque
+    Deque* d = malloc(sizeof(Deque));
+    if (d == NULL) return NULL;
+
+    // Allocate underlying array
+    size_t const cap = round_up_cap(INIT_CAP);
+    void*        arr = malloc(cap * elem_sz);
+    if (arr == NULL) {
+        free(d);
+        return NULL;
+    }
+
+    // Initial data members
+    d->elems  = arr;
+    d->elemsz = elem_sz;
+    d->nelems = 0;
+    d->cap    = cap;
+    d->mask   = cap - 1;
+    d->start  = 0;
+    return d;
+}
+
+void Deque_destroy(Deque* deque) {
+    assert(deque != NULL);
+
+    free(deque->elems);
+    free(deque);
+}
+
+size_t Deque_capacity(Deque* deque) {
+    assert(deque != NULL);
+
+    return deque->cap;
+}
+
+bool Deque_empty(Deque* deque) {
+    assert(deque != NULL);
+
+    return deque->nelems == 0;
+}
+
+size_t Deque_size(Deque* deque) {
+    assert(deque != NULL);
+
+    return deque->nelems;
+}
+
+/** Copies an element, by a fixed-size copy for common element sizes. */
+static inline void copy_elem(void* dst, void const* src, size_t elem_sz) {
+    switch (elem_sz) {
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, elem_sz); break;
+    }
+}
+
+/** Computes the address of the element at position `i` from the front. */
+static inline void* slot(Deque* deque, size_t i) {
+    return (char*)deque->elems + (((deque->start + i) & deque->mask) *
+                                  deque->elemsz);
+}
+
+bool Deque_front(Deque* deque, void* elem) {
+    assert(deque != NULL);
+
+    if (deque->nelems == 0) return false;
+
+    copy_elem(elem, slot(deque, 0), deque->elemsz);
+    return true;
+}
+
+bool Deque_back(Deque* deque, void* elem) {
+    assert(deque != NULL);
+
+    if (deque->nelems == 0) return false;
+
+    copy_elem(elem, slot(deque, deque->nelems - 1), deque->elemsz);
+    return true;
+}
+
+void* Deque_at(Deque* deque, size_t i) {
+    assert(deque != NULL);
+
+    if (i >= deque->nelems) return NULL;
+
+    return slot(deque, i);
+}
+
+/**
+ * Moves the elements of a deque into a new underlying array of `new_cap`, a
+ * power of two, starting at its first position.
+ */
+static bool reallocate(Deque* deque, size_t new_cap) {
+    assert(new_cap >= deque->nelems && "new capacity too small");
+    assert((new_cap & (new_cap - 1)) == 0 && "capacity not a power of two");
+
+    // Allocate new block
+    void* arr = malloc(new_cap * deque->elemsz);
+    if (arr == NULL) return false;
+
+    // Copy the elements up to the end of the old block, then those wrapped
+    // around to its start, if any
+    size_t const ntail = deque->cap - deque->start;   // number of elems
+    size_t const nhead = deque->nelems < ntail ? deque->nelems : ntail;
+    memcpy(arr, slot(deque, 0), nhead * deque->elemsz);
+    memcpy((char*)arr + (nhead * deque->elemsz), deque->elems,
+           (deque->nelems - nhead) * deque->elemsz);
+    free(deque->elems);
+
+    deque->elems = arr;
+    deque->cap   = new_cap;
+    deque->mask  = new_cap - 1;
+    deque->start = 0;
+    return true;
+}
+
+/**
+ * Halves the underlying array of a deque while its size is below a quarter of
+ * its full capacity, down to the initial capacity, so that deques that stay
+ * small do not reallocate back and forth. Failing to shrink leaves the deque
+ * in a valid state.
+ */
+static void trim(Deque* deque) {
+    if (deque->nelems == 0 || deque->nelems * 4 >= deque->cap) return;
+
+    size_t const min_cap = round_up_cap(INIT_CAP);
+    size_t       new_cap = deque->cap;
+    while (new_cap / 2 >= min_cap && deque->nelems * 4 < new_cap) {
+        new_cap /= 2;
+    }
+
+    if (new_cap != deque->cap) (void)reallocate(deque, new_cap);
+}
+
+bool Deque_reserve(Deque* deque, size_t n) {
+    assert(deque != NULL);
+
+    if (n <= deque->cap) return true;
+    return reallocate(deque, round_up_cap(n));
+}
+
+bool Deque_push_back(Deque* deque, void const* elem) {
+    assert(deque != NULL);
+
+    // Double underlying array if it is full
+    if (deque->nelems == deque->cap) {
+        if (!reallocate(deque, deque->cap * 2)) return false;
+    }
+
+    copy_elem(slot(deque, deque->nelems), elem, deque->elemsz);
+    deque->nelems += 1;
+    return true;
+}
+
+bool Deque_push_front(Deque* deque, void const* elem) {
+    assert(deque != NULL);
+
+    // Double underlying array if it is full
+    if (deque->nelems == deque->cap) {
+        if (!reallocate(deque, deque->cap * 2)) return false;
+    }
+
+    // Move the front back by one position, wrapping around to the end
+    deque->start = (deque->start - 1) & deque->mask;
+    copy_elem(slot(deque, 0), elem, deque->elemsz);
+    deque->nelems += 1;
+    return true;
+}
+
+bool Deque_pop_back(Deque* deque) {
+    assert(deque != NULL);
+
+    if (deque->nelems == 0) return false;
+
+    deque->nelems -= 1;
+    trim(deque);
+    return true;
+}
+
+bool Deque_pop_front(Deque* deque) {
+    assert(deque != NULL);
+
+    if (deque->nelems == 0) return false;
+
+    deque->nelems -= 1;
+    deque->start  = (deque->start + 1) & deque->mask;
+    trim(deque);
+    return true;
+}
+
+void Deque_clear(Deque* deque) {
+    assert(deque != NULL);
+
+    deque->nelems = 0;
+    deque->start  = 0;
+}
+
+void Deque_print(Deque* deque, char const* sep, bool vertical,
+                 void (*print_element)(void const*)) {
+    assert(deque != NULL);
+    if (sep == NULL) sep = ",";
+
+    size_t const n_elems = deque->nelems;
+    for (size_t i = 0; i < n_elems; ++i) {
+        if (vertical) printf("[%lu] ", i);
+        print_element(slot(deque, i));
+        vertical ? printf("\n")
+                 : ((i == n_elems - 1) ? printf("%s", "") : printf("%s", sep));
+    }
+}
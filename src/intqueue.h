@@ -0,0 +1,174 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      intqueue.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) integer queue.
+ *
+ * Integer queue is a queue of 64-bit unsigned integers that stores them
+ * compressed, for long runs of values close to their predecessors such as
+ * sequential IDs and timestamps, which would otherwise take 8 bytes each.
+ * This module defines the interface of the IntQueue ADT.
+ *
+ * Values are compressed in blocks of `INTQUEUE_BLOCK_LEN` as the differences
+ * between consecutive values, bit-packed to the width of the widest in the
+ * block. Up to a block of the newest values and a block of the oldest values
+ * are kept uncompressed, so that adding or removing a value only compresses
+ * or decompresses a block once every `INTQUEUE_BLOCK_LEN` values. Any
+ * sequence of values may be stored, but one with large or erratic differences
+ * does not compress.
+ *
+ * Use `IntQueue_create()` to create an integer queue, which should be
+ * destroyed when it is no longer needed using `IntQueue_destroy()`. Use
+ * `IntQueue_enqueue()` or `IntQueue_write()` to add values, and
+ * `IntQueue_front()`, `IntQueue_dequeue()` or `IntQueue_read()` to access and
+ * remove them.
+ *
+ * All functions that accept a pointer to an integer queue asserts that it is
+ * not `NULL`, which can be disabled by adding the `-DNDEBUG` flag when
+ * compiling the library and/or programs using gcc.
+ */
+
+#ifndef INTQUEUE_H
+#define INTQUEUE_H
+
+#include <stddef.h>    // size_t
+#include <stdint.h>    // uint64_t
+#include <stdbool.h>   // bool
+
+/** Number of values compressed together in a block. */
+#define INTQUEUE_BLOCK_LEN 256
+
+/** An opaque type representing an integer queue. */
+typedef struct intqueue IntQueue;
+
+/**
+ * @brief Creates an empty, heap-allocated integer queue.
+ *
+ * It's the caller's responsibility to call `IntQueue_destroy()` to free all
+ * allocated memory associated with the integer queue created.
+ *
+ * @return The integer queue created on success, `NULL` otherwise.
+ */
+IntQueue* IntQueue_create(void);
+
+/**
+ * @brief Destroys a heap-allocated integer queue.
+ *
+ * @param intqueue The integer queue to destroy.
+ */
+void IntQueue_destroy(IntQueue* intqueue);
+
+/**
+ * @brief Determines whether an integer queue is empty.
+ *
+ * @param[in] intqueue The integer queue to query.
+ * @return `true` if the integer queue is empty, `false` otherwise.
+ */
+bool IntQueue_empty(IntQueue* intqueue);
+
+/**
+ * @brief Queries the size of an integer queue.
+ *
+ * @param[in] intqueue The integer queue to query.
+ * @return Number of values in the integer queue.
+ */
+size_t IntQueue_size(IntQueue* intqueue);
+
+/**
+ * @brief Queries the memory taken by an integer queue.
+ *
+ * @param[in] intqueue The integer queue to query.
+ * @return Number of bytes allocated to store the values, compressed or not.
+ */
+size_t IntQueue_bytes(IntQueue* intqueue);
+
+/**
+ * @brief Adds a value to the end of an integer queue.
+ *
+ * @param[in] intqueue The integer queue to which the value is to add.
+ * @param[in] value The value to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool IntQueue_enqueue(IntQueue* intqueue, uint64_t value);
+
+/**
+ * @brief Adds a number of values to the end of an integer queue.
+ *
+ * @param[in] intqueue The integer queue to which the values are to add.
+ * @param[in] values The values to add, in order.
+ * @param[in] n Number of values at `values`.
+ * @return Number of values added, which is less than `n` only if the system
+ *      cannot allocate sufficient memory to add them all.
+ */
+size_t IntQueue_write(IntQueue* intqueue, uint64_t const* values, size_t n);
+
+/**
+ * @brief Accesses the front value of an integer queue.
+ *
+ * @param[in] intqueue The integer queue to query.
+ * @param[out] value The front value if the integer queue is not empty,
+ *      undefined otherwise.
+ * @return `false` if the integer queue is empty, `true` otherwise (on
+ *      success).
+ */
+bool IntQueue_front(IntQueue* intqueue, uint64_t* value);
+
+/**
+ * @brief Removes the front value from an integer queue.
+ *
+ * @param[in] intqueue The integer queue from which the front value is to
+ *      remove.
+ * @return `false` if the integer queue is empty, `true` otherwise (on
+ *      success).
+ */
+bool IntQueue_dequeue(IntQueue* intqueue);
+
+/**
+ * @brief Copies and removes up to a number of values from the front of an
+ * integer queue.
+ *
+ * Whole blocks are decompressed straight into `values`.
+ *
+ * @param[in] intqueue The integer queue from which the values are to remove.
+ * @param[out] values The values removed, in order.
+ * @param[in] n Maximum number of values to remove.
+ * @return Number of values removed, `0` if the integer queue is empty.
+ */
+size_t IntQueue_read(IntQueue* intqueue, uint64_t* values, size_t n);
+
+#endif /* INTQUEUE_H */
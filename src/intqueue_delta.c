@@ -0,0 +1,362 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @brief Implementation of the ADT integer queue as a record queue of blocks
+ * of bit-packed differences between consecutive values, between a buffer of
+ * the oldest values and a buffer of the newest values, both uncompressed.
+ *
+ * A block stores its first value, the least difference between consecutive
+ * values in it, and each difference less the least one, packed to the width
+ * of the widest. Sequential IDs thus pack to zero bits per value, and evenly
+ * spaced timestamps to a few. The packed differences are interleaved across
+ * `LANES` 64-bit lanes: value `i` is packed in lane `i % LANES`, after those
+ * of the lane before it, so that the values of all lanes are unpacked
+ * together by the same shifts, with AVX2 where available.
+ */
+
+#include "intqueue.h"
+#include "recordqueue.h"
+
+#include <assert.h>   // assert()
+#include <stdint.h>   // int64_t, uint64_t, INT64_MAX
+#include <stdlib.h>   // malloc(), free()
+#include <string.h>   // memcpy(), memset()
+
+#if defined(__AVX2__)
+#include <immintrin.h>   // _mm256_*()
+#endif
+
+/** Number of values in a block. */
+#define BLK INTQUEUE_BLOCK_LEN
+
+/** Number of 64-bit lanes the packed differences are interleaved across. */
+#define LANES 4
+
+/** Number of words in the header of a block: first value, least difference. */
+#define HDR_WORDS 2
+
+// -----------------------------------------------------------------------------
+
+struct intqueue
+{
+    RecordQueue* blocks;     // Compressed blocks, oldest first.
+    size_t       size;       // Number of values.
+    size_t       head_pos;   // Position of the front value in `head`.
+    size_t       head_len;   // Number of values in `head`.
+    size_t       tail_len;   // Number of values in `tail`.
+    uint64_t     head[BLK];   // Oldest values, uncompressed.
+    uint64_t     tail[BLK];   // Newest values, uncompressed.
+
+    uint64_t packed[HDR_WORDS + LANES * 64];   // Block being compressed.
+};
+
+IntQueue* IntQueue_create(void) {
+    IntQueue* iq = malloc(sizeof(IntQueue));
+    if (iq == NULL) return NULL;
+
+    iq->blocks = RecordQueue_create();
+    if (iq->blocks == NULL) {
+        free(iq);
+        return NULL;
+    }
+
+    iq->size     = 0;
+    iq->head_pos = 0;
+    iq->head_len = 0;
+    iq->tail_len = 0;
+    return iq;
+}
+
+void IntQueue_destroy(IntQueue* intqueue) {
+    assert(intqueue != NULL);
+
+    RecordQueue_destroy(intqueue->blocks);
+    free(intqueue);
+}
+
+bool IntQueue_empty(IntQueue* intqueue) {
+    assert(intqueue != NULL);
+
+    return intqueue->size == 0;
+}
+
+size_t IntQueue_size(IntQueue* intqueue) {
+    assert(intqueue != NULL);
+
+    return intqueue->size;
+}
+
+size_t IntQueue_bytes(IntQueue* intqueue) {
+    assert(intqueue != NULL);
+
+    return sizeof(IntQueue) + RecordQueue_capacity(intqueue->blocks);
+}
+
+/**
+ * Compresses a block of values into `packed`, and returns the number of bytes
+ * it takes.
+ */
+static size_t encode(uint64_t const* values, uint64_t* packed) {
+    int64_t least = INT64_MAX;
+    for (size_t i = 1; i < BLK; ++i) {
+        int64_t const d = (int64_t)(values[i] - values[i - 1]);
+        if (d < least) least = d;
+    }
+
+    uint64_t bits = 0;
+    for (size_t i = 1; i < BLK; ++i) {
+        bits |= values[i] - values[i - 1] - (uint64_t)least;
+    }
+    size_t const width = bits == 0 ? 0 : 64 - (size_t)__builtin_clzll(bits);
+
+    packed[0] = values[0];
+    packed[1] = (uint64_t)least;
+
+    // The first value packs as no difference at all
+    uint64_t* lanes = packed + HDR_WORDS;
+    memset(lanes, 0, LANES * width * sizeof(uint64_t));
+    for (size_t i = 1; i < BLK && width > 0; ++i) {
+        uint64_t const u   = values[i] - values[i - 1] - (uint64_t)least;
+        size_t const   bit = i / LANES * width;
+        size_t const   w   = bit / 64 * LANES + i % LANES;
+        size_t const   s   = bit % 64;
+
+        lanes[w] |= u << s;
+        if (s + width > 64) lanes[w + LANES] |= u >> (64 - s);
+    }
+    return (HDR_WORDS + LANES * width) * sizeof(uint64_t);
+}
+
+#if defined(__AVX2__)
+
+/** Loads the words of all lanes at `p`. */
+#define LOAD(p) _mm256_loadu_si256((__m256i const*)(p))
+
+/** Decompresses a block of `len` bytes into `values`. */
+static void decode(uint64_t const* packed, size_t len, uint64_t* values) {
+    size_t const    width = (len / sizeof(uint64_t) - HDR_WORDS) / LANES;
+    uint64_t const  mask  = width == 64 ? ~(uint64_t)0
+                                        : ((uint64_t)1 << width) - 1;
+    uint64_t const* lanes = packed + HDR_WORDS;
+
+    uint64_t const  start = packed[0] - packed[1];
+
+    __m256i const vmask = _mm256_set1_epi64x((long long)mask);
+    __m256i const least = _mm256_set1_epi64x((long long)packed[1]);
+    __m256i const zero  = _mm256_setzero_si256();
+    __m256i       carry = _mm256_set1_epi64x((long long)start);
+
+    for (size_t k = 0; k < BLK / LANES; ++k) {
+        __m256i u = zero;
+        if (width > 0) {
+            size_t const bit = k * width;
+            size_t const w   = bit / 64 * LANES;
+            size_t const s   = bit % 64;
+
+            u = _mm256_srl_epi64(LOAD(lanes + w), _mm_cvtsi64_si128(s));
+            if (s + width > 64) {
+                __m256i const hi = _mm256_sll_epi64(LOAD(lanes + w + LANES),
+                                                    _mm_cvtsi64_si128(64 - s));
+                u = _mm256_or_si256(u, hi);
+            }
+            u = _mm256_and_si256(u, vmask);
+        }
+
+        // Prefix sum of the values across the lanes, then the carry from the
+        // last lane before
+        __m256i x = _mm256_add_epi64(u, least);
+        x         = _mm256_add_epi64(x, _mm256_slli_si256(x, 8));
+        __m256i y = _mm256_permute4x64_epi64(x, 0x55);
+        x         = _mm256_add_epi64(x, _mm256_blend_epi32(zero, y, 0xF0));
+        x         = _mm256_add_epi64(x, carry);
+
+        _mm256_storeu_si256((__m256i*)(values + k * LANES), x);
+        carry = _mm256_permute4x64_epi64(x, 0xFF);
+    }
+}
+
+#else
+
+/** Decompresses a block of `len` bytes into `values`. */
+static void decode(uint64_t const* packed, size_t len, uint64_t* values) {
+    size_t const    width = (len / sizeof(uint64_t) - HDR_WORDS) / LANES;
+    uint64_t const  mask  = width == 64 ? ~(uint64_t)0
+                                        : ((uint64_t)1 << width) - 1;
+    uint64_t const* lanes = packed + HDR_WORDS;
+    uint64_t const  least = packed[1];
+    uint64_t        value = packed[0] - least;
+
+    for (size_t i = 0; i < BLK; ++i) {
+        uint64_t u = 0;
+        if (width > 0) {
+            size_t const bit = i / LANES * width;
+            size_t const w   = bit / 64 * LANES + i % LANES;
+            size_t const s   = bit % 64;
+
+            u = lanes[w] >> s;
+            if (s + width > 64) u |= lanes[w + LANES] << (64 - s);
+            u &= mask;
+        }
+        value     += u + least;
+        values[i]  = value;
+    }
+}
+
+#endif
+
+/**
+ * Moves the oldest values after `head` into `head` once it is used up, by
+ * decompressing the front block, or else taking `tail` as is. Returns `false`
+ * if there are no such values.
+ */
+static bool refill(IntQueue* intqueue) {
+    IntQueue*  iq = intqueue;
+    RecordSpan rec;
+
+    if (RecordQueue_front(iq->blocks, &rec)) {
+        decode(rec.data, rec.len, iq->head);
+        RecordQueue_dequeue(iq->blocks);
+        iq->head_len = BLK;
+    } else if (iq->tail_len > 0) {
+        memcpy(iq->head, iq->tail, iq->tail_len * sizeof(uint64_t));
+        iq->head_len = iq->tail_len;
+        iq->tail_len = 0;
+    } else {
+        return false;
+    }
+    iq->head_pos = 0;
+    return true;
+}
+
+/**
+ * Makes room in `tail` once it is full, by compressing it into a block, or
+ * else moving it to `head` if there are no older values. Returns `false` if
+ * the system cannot allocate sufficient memory to complete the operation.
+ */
+static bool flush(IntQueue* intqueue) {
+    IntQueue* iq = intqueue;
+
+    if (iq->head_pos == iq->head_len && RecordQueue_empty(iq->blocks)) {
+        return refill(intqueue);
+    }
+
+    size_t const len = encode(iq->tail, iq->packed);
+    if (!RecordQueue_enqueue(iq->blocks, iq->packed, len)) return false;
+    iq->tail_len = 0;
+    return true;
+}
+
+bool IntQueue_enqueue(IntQueue* intqueue, uint64_t value) {
+    assert(intqueue != NULL);
+
+    if (intqueue->tail_len == BLK && !flush(intqueue)) return false;
+
+    intqueue->tail[intqueue->tail_len++]  = value;
+    intqueue->size                       += 1;
+    return true;
+}
+
+size_t IntQueue_write(IntQueue* intqueue, uint64_t const* values, size_t n) {
+    assert(intqueue != NULL);
+
+    IntQueue* iq = intqueue;
+    size_t    i  = 0;
+    while (i < n) {
+        if (iq->tail_len == BLK && !flush(intqueue)) break;
+
+        // Compress whole blocks straight from `values` behind older values
+        if (iq->tail_len == 0 && n - i >= BLK &&
+            (iq->head_pos < iq->head_len || !RecordQueue_empty(iq->blocks))) {
+            size_t const len = encode(values + i, iq->packed);
+            if (!RecordQueue_enqueue(iq->blocks, iq->packed, len)) break;
+            i += BLK;
+            continue;
+        }
+
+        size_t m = BLK - iq->tail_len;
+        if (m > n - i) m = n - i;
+        memcpy(iq->tail + iq->tail_len, values + i, m * sizeof(uint64_t));
+        iq->tail_len += m;
+        i            += m;
+    }
+    iq->size += i;
+    return i;
+}
+
+bool IntQueue_front(IntQueue* intqueue, uint64_t* value) {
+    assert(intqueue != NULL);
+
+    IntQueue* iq = intqueue;
+    if (iq->head_pos == iq->head_len && !refill(intqueue)) return false;
+
+    *value = iq->head[iq->head_pos];
+    return true;
+}
+
+bool IntQueue_dequeue(IntQueue* intqueue) {
+    assert(intqueue != NULL);
+
+    IntQueue* iq = intqueue;
+    if (iq->head_pos == iq->head_len && !refill(intqueue)) return false;
+
+    iq->head_pos += 1;
+    iq->size     -= 1;
+    return true;
+}
+
+size_t IntQueue_read(IntQueue* intqueue, uint64_t* values, size_t n) {
+    assert(intqueue != NULL);
+
+    IntQueue* iq   = intqueue;
+    size_t    done = 0;
+    while (done < n) {
+        RecordSpan rec;
+        if (iq->head_pos < iq->head_len) {
+            size_t m = iq->head_len - iq->head_pos;
+            if (m > n - done) m = n - done;
+            memcpy(values + done, iq->head + iq->head_pos,
+                   m * sizeof(uint64_t));
+            iq->head_pos += m;
+            done         += m;
+        } else if (n - done >= BLK && RecordQueue_front(iq->blocks, &rec)) {
+            // Decompress whole blocks straight into `values`
+            decode(rec.data, rec.len, values + done);
+            RecordQueue_dequeue(iq->blocks);
+            done += BLK;
+        } else if (!refill(intqueue)) {
+            break;
+        }
+    }
+    iq->size -= done;
+    return done;
+}
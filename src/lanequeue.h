@@ -0,0 +1,186 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      lanequeue.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) multi-level queue.
+ *
+ * Multi-level queue is a collection ADT that holds a fixed number of queues,
+ * called lanes, each of a distinct priority level. Elements are removed from
+ * the lane of the highest level that is not empty, in the order they were
+ * added to that lane. This module defines the interface of the LaneQueue ADT,
+ * for up to `LANEQUEUE_MAX_LANES` lanes numbered from `0`, the lowest level.
+ *
+ * Use `LaneQueue_create()` to create a multi-level queue, which should be
+ * destroyed when it is no longer needed using `LaneQueue_destroy()`. Use
+ * `LaneQueue_enqueue()` to add an element to a lane, `LaneQueue_front()` to
+ * access the next element and `LaneQueue_dequeue()` to remove it.
+ *
+ * All functions that accept a pointer to a multi-level queue asserts that it
+ * is not `NULL`, and that lane numbers are in range, which can be disabled by
+ * adding the `-DNDEBUG` flag when compiling the library and/or programs using
+ * gcc.
+ */
+
+#ifndef LANEQUEUE_H
+#define LANEQUEUE_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+
+/** Maximum number of lanes of a multi-level queue. */
+#define LANEQUEUE_MAX_LANES 64
+
+/** An opaque type representing a generic multi-level queue. */
+typedef struct lanequeue LaneQueue;
+
+/**
+ * @brief Creates an empty, heap-allocated multi-level queue.
+ *
+ * It's the caller's responsibility to
+ * -# call `LaneQueue_destroy()` to free all allocated memory associated
+ *    with the multi-level queue created; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] elem_sz Size of each element in bytes.
+ * @param[in] n_lanes Number of lanes, from `1` to `LANEQUEUE_MAX_LANES`.
+ * @return The multi-level queue created on success, `NULL` otherwise.
+ */
+LaneQueue* LaneQueue_create(size_t elem_sz, size_t n_lanes);
+
+/**
+ * @brief Destroys a heap-allocated multi-level queue.
+ *
+ * @param lanequeue The multi-level queue to destroy.
+ */
+void LaneQueue_destroy(LaneQueue* lanequeue);
+
+/**
+ * @brief Queries the number of lanes of a multi-level queue.
+ *
+ * @param[in] lanequeue The multi-level queue to query.
+ * @return Number of lanes of the multi-level queue.
+ */
+size_t LaneQueue_lanes(LaneQueue* lanequeue);
+
+/**
+ * @brief Requests that a lane of a multi-level queue be able to hold at least
+ * `n` elements without further allocation.
+ *
+ * @param[in] lanequeue The multi-level queue to reserve capacity for.
+ * @param[in] lane The lane to reserve capacity for.
+ * @param[in] n Number of elements to reserve capacity for.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation; `true` otherwise (on success).
+ */
+bool LaneQueue_reserve(LaneQueue* lanequeue, size_t lane, size_t n);
+
+/**
+ * @brief Determines whether a multi-level queue is empty.
+ *
+ * @param[in] lanequeue The multi-level queue to query.
+ * @return `true` if all lanes of the multi-level queue are empty, `false`
+ *      otherwise.
+ */
+bool LaneQueue_empty(LaneQueue* lanequeue);
+
+/**
+ * @brief Queries the size of a multi-level queue.
+ *
+ * @param[in] lanequeue The multi-level queue to query.
+ * @return Number of elements in all lanes of the multi-level queue.
+ */
+size_t LaneQueue_size(LaneQueue* lanequeue);
+
+/**
+ * @brief Queries the size of a lane of a multi-level queue.
+ *
+ * @param[in] lanequeue The multi-level queue to query.
+ * @param[in] lane The lane to query.
+ * @return Number of elements in the lane.
+ */
+size_t LaneQueue_lane_size(LaneQueue* lanequeue, size_t lane);
+
+/**
+ * @brief Accesses the next element of a multi-level queue, which is the front
+ * element of its highest non-empty lane.
+ *
+ * @param[in] lanequeue The multi-level queue to query.
+ * @param[out] elem The next element if the multi-level queue is not empty,
+ *      undefined otherwise.
+ * @param[out] lane The lane of the next element if it is not `NULL` and the
+ *      multi-level queue is not empty, undefined otherwise.
+ * @return `false` if the multi-level queue is empty, `true` otherwise (on
+ *      success).
+ */
+bool LaneQueue_front(LaneQueue* lanequeue, void* elem, size_t* lane);
+
+/**
+ * @brief Accesses the next element of a multi-level queue in place.
+ *
+ * Unlike `LaneQueue_front()`, no data is copied. The pointer returned is
+ * invalidated by any subsequent operation that modifies the multi-level queue.
+ *
+ * @param[in] lanequeue The multi-level queue to query.
+ * @param[out] lane Same as `LaneQueue_front()`.
+ * @return Address of the next element if the multi-level queue is not empty,
+ *      `NULL` otherwise.
+ */
+void const* LaneQueue_peek(LaneQueue* lanequeue, size_t* lane);
+
+/**
+ * @brief Adds an element to the back of a lane of a multi-level queue.
+ *
+ * @param[in] lanequeue The multi-level queue to which the element is to add.
+ * @param[in] lane The lane to which the element is to add.
+ * @param[in] elem The element to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool LaneQueue_enqueue(LaneQueue* lanequeue, size_t lane, void const* elem);
+
+/**
+ * @brief Removes the next element from a multi-level queue, which is the
+ * front element of its highest non-empty lane.
+ *
+ * @param[in] lanequeue The multi-level queue from which its next element is
+ *      to remove.
+ * @return `false` if the multi-level queue is empty, `true` otherwise (on
+ *      success).
+ */
+bool LaneQueue_dequeue(LaneQueue* lanequeue);
+
+#endif /* LANEQUEUE_H */
@@ -0,0 +1,261 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @brief Implementation of the ADT multi-level queue as an array of circular
+ * arrays, one per lane, indexed by a bitmap of the non-empty lanes.
+ *
+ * Bit `i` of the bitmap is set if and only if lane `i` is not empty, so that
+ * the highest non-empty lane is found by counting the leading zeros of the
+ * bitmap, a single instruction on most targets, instead of scanning the lanes.
+ * Each lane is a circular array of power-of-two capacity, allocated on its
+ * first element and doubled whenever it is full. Lanes keep their capacity
+ * when they drain, since lanes of a scheduler tend to refill.
+ *
+ * @note Use the compiler flag `LANEQUEUE_INIT_CAP` to override the default
+ *      initial capacity of the underlying array of each lane, which is rounded
+ *      up to a power of two.
+ */
+
+#include "lanequeue.h"
+
+#include <assert.h>   // assert()
+#include <stdint.h>   // uint64_t
+#include <stdlib.h>   // malloc(), free()
+#include <string.h>   // memcpy()
+
+// clang-format off
+/** Initial underlying array capacity of each lane */
+#ifdef LANEQUEUE_INIT_CAP
+static size_t const INIT_CAP = LANEQUEUE_INIT_CAP;
+#else
+static size_t const INIT_CAP = 64;
+#endif
+// clang-format on
+
+// -----------------------------------------------------------------------------
+
+struct lane
+{
+    size_t nelems;   // Number of elements in the lane.
+    size_t mask;     // Capacity less one, to wrap positions around.
+    size_t start;    // Position of the front element in the underlying array.
+    char*  elems;    // Underlying array, `NULL` until the first element.
+};
+
+struct lanequeue
+{
+    size_t      elemsz;    // Element size in bytes.
+    size_t      nelems;    // Number of elements in all lanes.
+    size_t      nlanes;    // Number of lanes.
+    uint64_t    bitmap;    // Bit `i` set if and only if lane `i` is not empty.
+    struct lane lanes[];   // Lanes from the lowest level to the highest.
+};
+
+/** Rounds a capacity up to the next power of two, which is at least 2. */
+static size_t round_up_cap(size_t n) {
+    size_t cap = 2;
+    while (cap < n) cap *= 2;
+    return cap;
+}
+
+LaneQueue* LaneQueue_create(size_t elem_sz, size_t n_lanes) {
+    assert(n_lanes >= 1 && n_lanes <= LANEQUEUE_MAX_LANES &&
+           "unsupported number of lanes");
+
+    LaneQueue* lq = malloc(sizeof(LaneQueue) + n_lanes * sizeof(struct lane));
+    if (lq == NULL) return NULL;
+
+    lq->elemsz = elem_sz;
+    lq->nelems = 0;
+    lq->nlanes = n_lanes;
+    lq->bitmap = 0;
+    for (size_t i = 0; i < n_lanes; ++i) {
+        lq->lanes[i] = (struct lane){ .nelems = 0, .mask = 0, .start = 0,
+                                      .elems = NULL };
+    }
+    return lq;
+}
+
+void LaneQueue_destroy(LaneQueue* lanequeue) {
+    assert(lanequeue != NULL);
+
+    for (size_t i = 0; i < lanequeue->nlanes; ++i) {
+        free(lanequeue->lanes[i].elems);
+    }
+    free(lanequeue);
+}
+
+size_t LaneQueue_lanes(LaneQueue* lanequeue) {
+    assert(lanequeue != NULL);
+
+    return lanequeue->nlanes;
+}
+
+bool LaneQueue_empty(LaneQueue* lanequeue) {
+    assert(lanequeue != NULL);
+
+    return lanequeue->bitmap == 0;
+}
+
+size_t LaneQueue_size(LaneQueue* lanequeue) {
+    assert(lanequeue != NULL);
+
+    return lanequeue->nelems;
+}
+
+size_t LaneQueue_lane_size(LaneQueue* lanequeue, size_t lane) {
+    assert(lanequeue != NULL);
+    assert(lane < lanequeue->nlanes && "lane out of range");
+
+    return lanequeue->lanes[lane].nelems;
+}
+
+/** Copies an element, by a fixed-size copy for common element sizes. */
+static inline void copy_elem(void* dst, void const* src, size_t elem_sz) {
+    switch (elem_sz) {
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, elem_sz); break;
+    }
+}
+
+/** Computes the address of the element at position `i` from a lane's front. */
+static inline char* slot(struct lane* lane, size_t i, size_t elem_sz) {
+    return lane->elems + ((lane->start + i) & lane->mask) * elem_sz;
+}
+
+/** Finds the highest lane set in a bitmap, which must not be empty. */
+static inline size_t highest_lane(uint64_t bitmap) {
+#ifdef __GNUC__
+    return 63 - (size_t)__builtin_clzll(bitmap);
+#else
+    size_t lane = 63;
+    while ((bitmap >> lane) == 0) --lane;
+    return lane;
+#endif
+}
+
+/**
+ * Moves the elements of a lane into a new underlying array of `new_cap`, a
+ * power of two, starting at its first position.
+ */
+static bool reallocate(struct lane* lane, size_t new_cap, size_t elem_sz) {
+    assert(new_cap >= lane->nelems && "new capacity too small");
+    assert((new_cap & (new_cap - 1)) == 0 && "capacity not a power of two");
+
+    char* arr = malloc(new_cap * elem_sz);
+    if (arr == NULL) return false;
+
+    // Copy the elements up to the end of the old block, then those wrapped
+    // around to its start, if any
+    if (lane->elems != NULL) {
+        size_t const ntail = lane->mask + 1 - lane->start;   // number of elems
+        size_t const nhead = lane->nelems < ntail ? lane->nelems : ntail;
+        memcpy(arr, slot(lane, 0, elem_sz), nhead * elem_sz);
+        memcpy(arr + nhead * elem_sz, lane->elems,
+               (lane->nelems - nhead) * elem_sz);
+        free(lane->elems);
+    }
+
+    lane->elems = arr;
+    lane->mask  = new_cap - 1;
+    lane->start = 0;
+    return true;
+}
+
+bool LaneQueue_reserve(LaneQueue* lanequeue, size_t lane, size_t n) {
+    assert(lanequeue != NULL);
+    assert(lane < lanequeue->nlanes && "lane out of range");
+
+    struct lane* l = &lanequeue->lanes[lane];
+    if (l->elems != NULL && n <= l->mask + 1) return true;
+    return reallocate(l, round_up_cap(n), lanequeue->elemsz);
+}
+
+bool LaneQueue_front(LaneQueue* lanequeue, void* elem, size_t* lane) {
+    assert(lanequeue != NULL);
+
+    void const* front = LaneQueue_peek(lanequeue, lane);
+    if (front == NULL) return false;
+
+    copy_elem(elem, front, lanequeue->elemsz);
+    return true;
+}
+
+void const* LaneQueue_peek(LaneQueue* lanequeue, size_t* lane) {
+    assert(lanequeue != NULL);
+
+    if (lanequeue->bitmap == 0) return NULL;
+
+    size_t const top = highest_lane(lanequeue->bitmap);
+    if (lane != NULL) *lane = top;
+    return slot(&lanequeue->lanes[top], 0, lanequeue->elemsz);
+}
+
+bool LaneQueue_enqueue(LaneQueue* lanequeue, size_t lane, void const* elem) {
+    assert(lanequeue != NULL);
+    assert(lane < lanequeue->nlanes && "lane out of range");
+
+    size_t const elem_sz = lanequeue->elemsz;
+    struct lane* l       = &lanequeue->lanes[lane];
+
+    // Allocate underlying array on first use, and double it when full
+    if (l->elems == NULL) {
+        if (!reallocate(l, round_up_cap(INIT_CAP), elem_sz)) return false;
+    } else if (l->nelems == l->mask + 1) {
+        if (!reallocate(l, (l->mask + 1) * 2, elem_sz)) return false;
+    }
+
+    copy_elem(slot(l, l->nelems, elem_sz), elem, elem_sz);
+    l->nelems         += 1;
+    lanequeue->nelems += 1;
+    lanequeue->bitmap |= (uint64_t)1 << lane;
+    return true;
+}
+
+bool LaneQueue_dequeue(LaneQueue* lanequeue) {
+    assert(lanequeue != NULL);
+
+    if (lanequeue->bitmap == 0) return false;
+
+    size_t const top = highest_lane(lanequeue->bitmap);
+    struct lane* l   = &lanequeue->lanes[top];
+
+    l->nelems         -= 1;
+    l->start           = (l->start + 1) & l->mask;
+    lanequeue->nelems -= 1;
+    if (l->nelems == 0) lanequeue->bitmap &= ~((uint64_t)1 << top);
+    return true;
+}
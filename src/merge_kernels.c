@@ -0,0 +1,445 @@
+/*** Out-of-line definitions ***/
+
+#include "algos.h"
+
+#include <stdbool.h>   // bool
+#include <stdint.h>    // int32_t, uint32_t, int64_t, uint64_t
+#include <string.h>    // memcpy()
+#include <assert.h>    // assert()
+
+#if defined(__AVX2__)
+#include <immintrin.h>   // _mm256_*()
+#elif defined(__SSE4_1__)
+#include <smmintrin.h>   // _mm_*()
+#endif
+
+/** Layout of the elements merged by key. */
+struct key_layout
+{
+    size_t elemsz;   // Size of each element in bytes
+    size_t offset;   // Offset of the key in each element in bytes
+};
+
+/**
+ * Merges the elements at the front of two contiguous runs of sorted elements
+ * into an output run until any of the three runs is exhausted. Returns the
+ * number of elements output, of which `*ia` are taken from the first run.
+ */
+typedef size_t (*merge_kernel)(struct key_layout const* layout, void const* a,
+                               size_t na, void const* b, size_t nb, void* out,
+                               size_t nout, size_t* ia);
+
+/** Element order of ascending merges: ties go to the second run. */
+#define BEFORE_ASC(x, y) ((x) < (y))
+
+/** Element order of descending merges: ties go to the second run. */
+#define BEFORE_DESC(x, y) ((x) > (y))
+
+/**
+ * Defines a scalar merge kernel for elements of type `T` ordered by `BEFORE`.
+ * The element to output is selected by a conditional move rather than a
+ * branch, so that the loop runs at the same speed however the runs interleave.
+ */
+#define DEFINE_SCALAR_KERNEL(name, T, BEFORE)                                 \
+    static size_t name(struct key_layout const* layout, void const* a_,       \
+                       size_t na, void const* b_, size_t nb, void* out_,      \
+                       size_t nout, size_t* ia) {                             \
+        T const* a   = a_;                                                    \
+        T const* b   = b_;                                                    \
+        T*       out = out_;                                                  \
+        size_t   i = 0, j = 0, k = 0;                                         \
+        (void)layout;                                                         \
+                                                                              \
+        while (i < na && j < nb && k < nout) {                                \
+            T const    x      = a[i];                                         \
+            T const    y      = b[j];                                         \
+            bool const take_a = BEFORE(x, y);                                 \
+                                                                              \
+            out[k++] = take_a ? x : y;                                        \
+            i += take_a;                                                      \
+            j += !take_a;                                                     \
+        }                                                                     \
+        *ia = i;                                                              \
+        return k;                                                             \
+    }
+
+// clang-format off
+DEFINE_SCALAR_KERNEL(merge_i32_asc_scalar,  int32_t,  BEFORE_ASC)
+DEFINE_SCALAR_KERNEL(merge_i32_desc_scalar, int32_t,  BEFORE_DESC)
+DEFINE_SCALAR_KERNEL(merge_u64_asc,         uint64_t, BEFORE_ASC)
+DEFINE_SCALAR_KERNEL(merge_u64_desc,        uint64_t, BEFORE_DESC)
+DEFINE_SCALAR_KERNEL(merge_f32_asc,         float,    BEFORE_ASC)
+DEFINE_SCALAR_KERNEL(merge_f32_desc,        float,    BEFORE_DESC)
+DEFINE_SCALAR_KERNEL(merge_f64_asc,         double,   BEFORE_ASC)
+DEFINE_SCALAR_KERNEL(merge_f64_desc,        double,   BEFORE_DESC)
+// clang-format on
+
+/** Copies an element, by a fixed-size copy for common element sizes. */
+static inline void copy_elem(char* dst, char const* src, size_t elem_sz) {
+    switch (elem_sz) {
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    case 24: memcpy(dst, src, 24); break;
+    case 32: memcpy(dst, src, 32); break;
+    default: memcpy(dst, src, elem_sz); break;
+    }
+}
+
+/**
+ * Defines a merge kernel for elements of any size with a key of type `T` at
+ * some offset ordered by `BEFORE`. Keys are loaded in place and compared
+ * inline, and the element to output is selected by a conditional move.
+ */
+#define DEFINE_KEY_KERNEL(name, T, BEFORE)                                    \
+    static size_t name(struct key_layout const* layout, void const* a_,       \
+                       size_t na, void const* b_, size_t nb, void* out_,      \
+                       size_t nout, size_t* ia) {                             \
+        char const*  a   = a_;                                                \
+        char const*  b   = b_;                                                \
+        char*        out = out_;                                              \
+        size_t const sz  = layout->elemsz;                                    \
+        size_t const off = layout->offset;                                    \
+        size_t       i = 0, j = 0, k = 0;                                     \
+                                                                              \
+        while (i < na && j < nb && k < nout) {                                \
+            char const* const x = a + i * sz;                                 \
+            char const* const y = b + j * sz;                                 \
+            T                 kx, ky;                                         \
+            memcpy(&kx, x + off, sizeof(T));                                  \
+            memcpy(&ky, y + off, sizeof(T));                                  \
+            bool const take_a = BEFORE(kx, ky);                               \
+                                                                              \
+            copy_elem(out + k * sz, take_a ? x : y, sz);                      \
+            k += 1;                                                           \
+            i += take_a;                                                      \
+            j += !take_a;                                                     \
+        }                                                                     \
+        *ia = i;                                                              \
+        return k;                                                             \
+    }
+
+// clang-format off
+DEFINE_KEY_KERNEL(merge_i32_key_asc,  int32_t,  BEFORE_ASC)
+DEFINE_KEY_KERNEL(merge_i32_key_desc, int32_t,  BEFORE_DESC)
+DEFINE_KEY_KERNEL(merge_u32_key_asc,  uint32_t, BEFORE_ASC)
+DEFINE_KEY_KERNEL(merge_u32_key_desc, uint32_t, BEFORE_DESC)
+DEFINE_KEY_KERNEL(merge_i64_key_asc,  int64_t,  BEFORE_ASC)
+DEFINE_KEY_KERNEL(merge_i64_key_desc, int64_t,  BEFORE_DESC)
+DEFINE_KEY_KERNEL(merge_u64_key_asc,  uint64_t, BEFORE_ASC)
+DEFINE_KEY_KERNEL(merge_u64_key_desc, uint64_t, BEFORE_DESC)
+DEFINE_KEY_KERNEL(merge_f32_key_asc,  float,    BEFORE_ASC)
+DEFINE_KEY_KERNEL(merge_f32_key_desc, float,    BEFORE_DESC)
+DEFINE_KEY_KERNEL(merge_f64_key_asc,  double,   BEFORE_ASC)
+DEFINE_KEY_KERNEL(merge_f64_key_desc, double,   BEFORE_DESC)
+// clang-format on
+
+#if defined(__AVX2__) || defined(__SSE4_1__)
+
+#if defined(__AVX2__)
+
+/** Number of `int32_t` lanes in a vector. */
+#define LANES 8
+
+typedef __m256i vec_i32;
+
+#define VEC_LOAD(p)     _mm256_loadu_si256((__m256i const*)(p))
+#define VEC_STORE(p, v) _mm256_storeu_si256((__m256i*)(p), (v))
+#define VEC_MIN(x, y)   _mm256_min_epi32((x), (y))
+#define VEC_MAX(x, y)   _mm256_max_epi32((x), (y))
+
+/**
+ * Sorts the lanes of a bitonic vector in ascending order, or descending order
+ * if `desc` is set, by comparing lanes 4, 2 and 1 apart in turn.
+ */
+static inline vec_i32 bitonic_clean(vec_i32 v, bool desc) {
+    vec_i32 t, lo, hi;
+
+    t  = _mm256_permute2x128_si256(v, v, 0x01);
+    lo = desc ? VEC_MAX(v, t) : VEC_MIN(v, t);
+    hi = desc ? VEC_MIN(v, t) : VEC_MAX(v, t);
+    v  = _mm256_blend_epi32(lo, hi, 0xF0);
+
+    t  = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    lo = desc ? VEC_MAX(v, t) : VEC_MIN(v, t);
+    hi = desc ? VEC_MIN(v, t) : VEC_MAX(v, t);
+    v  = _mm256_blend_epi32(lo, hi, 0xCC);
+
+    t  = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    lo = desc ? VEC_MAX(v, t) : VEC_MIN(v, t);
+    hi = desc ? VEC_MIN(v, t) : VEC_MAX(v, t);
+    return _mm256_blend_epi32(lo, hi, 0xAA);
+}
+
+/** Reverses the order of the lanes of a vector. */
+static inline vec_i32 reverse(vec_i32 v) {
+    return _mm256_permutevar8x32_epi32(v, _mm256_setr_epi32(7, 6, 5, 4, 3, 2,
+                                                            1, 0));
+}
+
+#else /* __SSE4_1__ */
+
+/** Number of `int32_t` lanes in a vector. */
+#define LANES 4
+
+typedef __m128i vec_i32;
+
+#define VEC_LOAD(p)     _mm_loadu_si128((__m128i const*)(p))
+#define VEC_STORE(p, v) _mm_storeu_si128((__m128i*)(p), (v))
+#define VEC_MIN(x, y)   _mm_min_epi32((x), (y))
+#define VEC_MAX(x, y)   _mm_max_epi32((x), (y))
+
+/**
+ * Sorts the lanes of a bitonic vector in ascending order, or descending order
+ * if `desc` is set, by comparing lanes 2 and 1 apart in turn.
+ */
+static inline vec_i32 bitonic_clean(vec_i32 v, bool desc) {
+    vec_i32 t, lo, hi;
+
+    t  = _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    lo = desc ? VEC_MAX(v, t) : VEC_MIN(v, t);
+    hi = desc ? VEC_MIN(v, t) : VEC_MAX(v, t);
+    v  = _mm_blend_epi16(lo, hi, 0xF0);
+
+    t  = _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    lo = desc ? VEC_MAX(v, t) : VEC_MIN(v, t);
+    hi = desc ? VEC_MIN(v, t) : VEC_MAX(v, t);
+    return _mm_blend_epi16(lo, hi, 0xCC);
+}
+
+/** Reverses the order of the lanes of a vector. */
+static inline vec_i32 reverse(vec_i32 v) {
+    return _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 1, 2, 3));
+}
+
+#endif
+
+/**
+ * Merges two sorted vectors with a bitonic network, leaving the first `LANES`
+ * merged elements in `*lo` and the last `LANES` in `*hi`, both sorted.
+ */
+static inline void bitonic_merge(vec_i32* lo, vec_i32* hi, bool desc) {
+    vec_i32 const r = reverse(*hi);
+    vec_i32 const l = desc ? VEC_MAX(*lo, r) : VEC_MIN(*lo, r);
+    vec_i32 const h = desc ? VEC_MIN(*lo, r) : VEC_MAX(*lo, r);
+
+    *lo = bitonic_clean(l, desc);
+    *hi = bitonic_clean(h, desc);
+}
+
+/**
+ * Merges runs of `int32_t` a vector at a time. The last `LANES` elements
+ * merged so far are carried in a register and merged again with the next
+ * vector loaded from whichever run has the element that goes first. On exit,
+ * the carried elements are handed back to the runs they came from: being the
+ * last of the elements loaded, they are the tails of what was loaded from each
+ * run, and which run the tied ones are handed back to makes no difference to
+ * the output.
+ */
+static inline size_t merge_i32_simd(int32_t const* a, size_t na,
+                                    int32_t const* b, size_t nb, int32_t* out,
+                                    size_t nout, size_t* ia, bool desc) {
+    vec_i32 lo = VEC_LOAD(a);
+    vec_i32 hi = VEC_LOAD(b);
+    size_t  i = LANES, j = LANES, k = 0;
+
+    bitonic_merge(&lo, &hi, desc);
+    VEC_STORE(out, lo);
+    k += LANES;
+
+    while (i < na && j < nb && k + LANES <= nout) {
+        bool const take_a = desc ? a[i] > b[j] : a[i] < b[j];
+        if (take_a ? i + LANES > na : j + LANES > nb) break;
+
+        if (take_a) {
+            lo  = VEC_LOAD(a + i);
+            i  += LANES;
+        } else {
+            lo  = VEC_LOAD(b + j);
+            j  += LANES;
+        }
+        bitonic_merge(&lo, &hi, desc);
+        VEC_STORE(out + k, lo);
+        k += LANES;
+    }
+
+    for (size_t n = 0; n < LANES; ++n) {
+        bool const back_a = j == 0 || (i > 0 && (desc ? !(a[i - 1] > b[j - 1])
+                                                       : !(a[i - 1] < b[j - 1])));
+        i -= back_a;
+        j -= !back_a;
+    }
+    *ia = i;
+    return k;
+}
+
+/** Merges runs of `int32_t` in ascending order. */
+static size_t merge_i32_asc(struct key_layout const* layout, void const* a,
+                            size_t na, void const* b, size_t nb, void* out,
+                            size_t nout, size_t* ia) {
+    if (na < 2 * LANES || nb < 2 * LANES || nout < 2 * LANES) {
+        return merge_i32_asc_scalar(layout, a, na, b, nb, out, nout, ia);
+    }
+    return merge_i32_simd(a, na, b, nb, out, nout, ia, false);
+}
+
+/** Merges runs of `int32_t` in descending order. */
+static size_t merge_i32_desc(struct key_layout const* layout, void const* a,
+                             size_t na, void const* b, size_t nb, void* out,
+                             size_t nout, size_t* ia) {
+    if (na < 2 * LANES || nb < 2 * LANES || nout < 2 * LANES) {
+        return merge_i32_desc_scalar(layout, a, na, b, nb, out, nout, ia);
+    }
+    return merge_i32_simd(a, na, b, nb, out, nout, ia, true);
+}
+
+#else /* scalar only */
+
+#define merge_i32_asc  merge_i32_asc_scalar
+#define merge_i32_desc merge_i32_desc_scalar
+
+#endif
+
+/**
+ * Merges two queues run by run: the kernel merges the contiguous segments
+ * at the front of the queues (see `Queue_segment()`) directly into those of
+ * the pre-sized merged queue, and the elements merged are then dequeued in
+ * bulk.
+ */
+static Queue* merge_by_kernel(Queue* queue1, Queue* queue2,
+                              struct key_layout const* layout,
+                              merge_kernel             kernel) {
+    size_t const elem_sz = layout->elemsz;
+
+    if (queue1 == NULL && queue2 == NULL) return NULL;
+    if (queue1 == NULL) return queue2;
+    if (queue2 == NULL) return queue1;
+
+    bool q1_is_empty = Queue_empty(queue1);
+    bool q2_is_empty = Queue_empty(queue2);
+
+    if (q1_is_empty && q2_is_empty) return NULL;
+    if (q1_is_empty && !q2_is_empty) return queue2;
+    if (!q1_is_empty && q2_is_empty) return queue1;
+
+    Queue* merged = Queue_create(elem_sz);
+    if (merged == NULL) return NULL;
+    if (!Queue_extend(merged, Queue_size(queue1) + Queue_size(queue2))) {
+        Queue_destroy(merged);
+        return NULL;
+    }
+
+    size_t nout = 0;   // number of elements in the output segment
+    size_t k    = 0;   // number of elements output to the output segment
+    char*  out  = Queue_segment(merged, NULL, &nout);
+
+    void*  a  = NULL;
+    void*  b  = NULL;
+    size_t na = 0, nb = 0, ia = 0;
+    bool   res;
+
+    while ((a = Queue_segment(queue1, NULL, &na)) != NULL &&
+           (b = Queue_segment(queue2, NULL, &nb)) != NULL) {
+        if (k == nout) {
+            out = Queue_segment(merged, out, &nout);
+            k   = 0;
+        }
+        size_t const m =
+            kernel(layout, a, na, b, nb, out + k * elem_sz, nout - k, &ia);
+        k += m;
+
+        res = Queue_dequeue_n(queue1, ia);
+        assert(res && "Queue_dequeue_n() failed when queue not that large");
+        res = Queue_dequeue_n(queue2, m - ia);
+        assert(res && "Queue_dequeue_n() failed when queue not that large");
+    }
+
+    // Copy unprocessed elements into the merged queue segment by segment
+    Queue* curr_queue = a != NULL ? queue1 : queue2;
+    while ((a = Queue_segment(curr_queue, NULL, &na)) != NULL) {
+        if (k == nout) {
+            out = Queue_segment(merged, out, &nout);
+            k   = 0;
+        }
+        size_t const m = na < nout - k ? na : nout - k;
+        memcpy(out + k * elem_sz, a, m * elem_sz);
+        k += m;
+
+        res = Queue_dequeue_n(curr_queue, m);
+        assert(res && "Queue_dequeue_n() failed when queue not that large");
+    }
+
+    return merged;
+}
+
+Queue* merge_queues_i32(Queue* queue1, Queue* queue2, KeyOrder order) {
+    struct key_layout const layout = { sizeof(int32_t), 0 };
+    return merge_by_kernel(queue1, queue2, &layout,
+                           order == DESCENDING ? merge_i32_desc
+                                               : merge_i32_asc);
+}
+
+Queue* merge_queues_u64(Queue* queue1, Queue* queue2, KeyOrder order) {
+    struct key_layout const layout = { sizeof(uint64_t), 0 };
+    return merge_by_kernel(queue1, queue2, &layout,
+                           order == DESCENDING ? merge_u64_desc
+                                               : merge_u64_asc);
+}
+
+Queue* merge_queues_f32(Queue* queue1, Queue* queue2, KeyOrder order) {
+    struct key_layout const layout = { sizeof(float), 0 };
+    return merge_by_kernel(queue1, queue2, &layout,
+                           order == DESCENDING ? merge_f32_desc
+                                               : merge_f32_asc);
+}
+
+Queue* merge_queues_f64(Queue* queue1, Queue* queue2, KeyOrder order) {
+    struct key_layout const layout = { sizeof(double), 0 };
+    return merge_by_kernel(queue1, queue2, &layout,
+                           order == DESCENDING ? merge_f64_desc
+                                               : merge_f64_asc);
+}
+
+/** Size of keys of each type in bytes. */
+static size_t const KEY_SIZES[] = {
+    [KEY_I32] = sizeof(int32_t), [KEY_U32] = sizeof(uint32_t),
+    [KEY_I64] = sizeof(int64_t), [KEY_U64] = sizeof(uint64_t),
+    [KEY_F32] = sizeof(float),   [KEY_F64] = sizeof(double),
+};
+
+/** Kernels that merge by keys of each type in each order. */
+static merge_kernel const KEY_KERNELS[][2] = {
+    [KEY_I32] = { merge_i32_key_asc, merge_i32_key_desc },
+    [KEY_U32] = { merge_u32_key_asc, merge_u32_key_desc },
+    [KEY_I64] = { merge_i64_key_asc, merge_i64_key_desc },
+    [KEY_U64] = { merge_u64_key_asc, merge_u64_key_desc },
+    [KEY_F32] = { merge_f32_key_asc, merge_f32_key_desc },
+    [KEY_F64] = { merge_f64_key_asc, merge_f64_key_desc },
+};
+
+/** Kernels that merge bare keys of each type in each order, if any. */
+static merge_kernel const BARE_KEY_KERNELS[][2] = {
+    [KEY_I32] = { merge_i32_asc, merge_i32_desc },
+    [KEY_U32] = { NULL, NULL },
+    [KEY_I64] = { NULL, NULL },
+    [KEY_U64] = { merge_u64_asc, merge_u64_desc },
+    [KEY_F32] = { merge_f32_asc, merge_f32_desc },
+    [KEY_F64] = { merge_f64_asc, merge_f64_desc },
+};
+
+Queue* merge_queues_by_key(Queue* queue1, Queue* queue2, size_t elem_sz,
+                           size_t key_offset, KeyType key_type,
+                           KeyOrder order) {
+    assert(key_type >= KEY_I32 && key_type <= KEY_F64 && "unknown key type");
+    assert(key_offset + KEY_SIZES[key_type] <= elem_sz &&
+           "key does not fit in elements");
+
+    struct key_layout const layout = { elem_sz, key_offset };
+    bool const              desc   = order == DESCENDING;
+
+    // Elements that are nothing but keys are merged by the typed kernels
+    merge_kernel kernel = BARE_KEY_KERNELS[key_type][desc];
+    if (kernel == NULL || elem_sz != KEY_SIZES[key_type]) {
+        kernel = KEY_KERNELS[key_type][desc];
+    }
+    return merge_by_kernel(queue1, queue2, &layout, kernel);
+}
@@ -0,0 +1,117 @@
+/*** Out-of-line definitions ***/
+
+#include "algos.h"
+
+#include <stdbool.h>   // bool
+#include <string.h>    // memcpy()
+#include <assert.h>    // assert()
+
+/** Copies an element, by a fixed-size copy for common element sizes. */
+static inline void copy_elem(char* dst, char const* src, size_t elem_sz) {
+    switch (elem_sz) {
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    case 32: memcpy(dst, src, 32); break;
+    default: memcpy(dst, src, elem_sz); break;
+    }
+}
+
+/**
+ * Counts the leading elements of the front segment of a queue for which a
+ * predicate gives the same result as for the front element, which is stored
+ * in `matches`.
+ */
+static size_t count_span(Queue* queue, size_t elem_sz,
+                         bool (*pred)(void const*), bool* matches) {
+    size_t      len = 0;
+    char const* run = Queue_segment(queue, NULL, &len);
+    size_t      n   = 1;
+
+    *matches = pred(run);
+    while (n < len && pred(run + n * elem_sz) == *matches) ++n;
+    return n;
+}
+
+bool Queue_partition(Queue* src, size_t elem_sz, bool (*pred)(void const*),
+                     Queue* out_true, Queue* out_false) {
+    assert(src != NULL && out_true != NULL && out_false != NULL);
+    assert(pred != NULL && "pred is not a unary predicate");
+
+    // Spans of elements going to the same queue are moved as a whole
+    while (!Queue_empty(src)) {
+        bool         matches = false;
+        size_t const n       = count_span(src, elem_sz, pred, &matches);
+        if (!Queue_transfer(matches ? out_true : out_false, src, n)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * Filters a contiguous array in place, moving the elements to keep towards the
+ * end of the array in order. Returns the number of elements dropped, which are
+ * left at the start of the array.
+ */
+static size_t filter_array(char* base, size_t n, size_t elem_sz,
+                           bool (*pred)(void const*)) {
+    size_t kept = 0;
+    for (size_t i = n; i-- > 0;) {
+        char const* elem = base + i * elem_sz;
+        if (!pred(elem)) continue;
+
+        ++kept;
+        char* const dst = base + (n - kept) * elem_sz;
+        if (dst != elem) copy_elem(dst, elem, elem_sz);
+    }
+    return n - kept;
+}
+
+/**
+ * Filters a queue by moving spans of elements to keep to another queue with
+ * `Queue_transfer()` and dropping the others, before moving the elements kept
+ * back, so node-based implementations relink their nodes without copying.
+ */
+static bool filter_by_transfer(Queue* queue, size_t elem_sz,
+                               bool (*pred)(void const*)) {
+    Queue* kept = Queue_create_like(queue);
+    if (kept == NULL || !Queue_reserve(kept, Queue_size(queue))) {
+        if (kept != NULL) Queue_destroy(kept);
+        return false;
+    }
+
+    bool ok = true;
+    while (ok && !Queue_empty(queue)) {
+        bool         matches = false;
+        size_t const n       = count_span(queue, elem_sz, pred, &matches);
+        ok = matches ? Queue_transfer(kept, queue, n)
+                     : Queue_discard_n(queue, n);
+    }
+
+    // Move the elements kept back, ahead of those left unfiltered on failure
+    // if the latter can move behind them, or else behind the latter
+    Queue_transfer(kept, queue, Queue_size(queue));
+    bool const restored = Queue_transfer(queue, kept, Queue_size(kept));
+    Queue_destroy(kept);
+    return ok && restored;
+}
+
+bool Queue_filter_in_place(Queue* queue, size_t elem_sz,
+                           bool (*pred)(void const*)) {
+    assert(queue != NULL);
+    assert(pred != NULL && "pred is not a unary predicate");
+
+    size_t const n = Queue_size(queue);
+    if (n == 0) return true;
+
+    // Elements dropped in place are overwritten before they can be destroyed
+    char* base = Queue_owned(queue) ? NULL : Queue_linearize(queue);
+    if (base == NULL) return filter_by_transfer(queue, elem_sz, pred);
+
+    bool res = Queue_dequeue_n(queue, filter_array(base, n, elem_sz, pred));
+    assert(res && "Queue_dequeue_n() failed when queue not that large");
+
+    (void)res;
+    return true;
+}
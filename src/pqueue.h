@@ -0,0 +1,178 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      pqueue.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) priority queue.
+ *
+ * Priority queue is a collection ADT in which the element removed next is the
+ * one of the highest priority, rather than the least recent one as in a queue.
+ * This module defines the interface of the PQueue ADT. Priorities are given by
+ * a binary predicate that determines whether an element goes before another,
+ * so that the top element is the one no other element goes before.
+ *
+ * Use `PQueue_create()` to create an empty priority queue, or
+ * `PQueue_heapify()` to create one from an array of elements at once, which
+ * should be destroyed when it is no longer needed using `PQueue_destroy()`.
+ * Use `PQueue_push()` to add an element, `PQueue_top()` to access the top
+ * element and `PQueue_pop()` to remove it. Elements of equal priority are
+ * removed in no particular order.
+ *
+ * All functions that accept a pointer to a priority queue asserts that it is
+ * not `NULL`, which can be disabled by adding the `-DNDEBUG` flag when
+ * compiling the library and/or programs using gcc.
+ */
+
+#ifndef PQUEUE_H
+#define PQUEUE_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+
+/** An opaque type representing a generic priority queue. */
+typedef struct pqueue PQueue;
+
+/**
+ * @brief Creates an empty, heap-allocated priority queue.
+ *
+ * It's the caller's responsibility to
+ * -# call `PQueue_destroy()` to free all allocated memory associated
+ *    with the priority queue created; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] elem_sz Size of each element in bytes.
+ * @param[in] compare A binary predicate that determines whether an element
+ *      goes before, i.e. has a higher priority than, another.
+ * @return The priority queue created on success, `NULL` otherwise.
+ */
+PQueue* PQueue_create(size_t elem_sz,
+                      bool (*compare)(void const*, void const*));
+
+/**
+ * @brief Creates a heap-allocated priority queue of the elements of an array.
+ *
+ * The elements are copied and arranged into a heap at once, in `O(n)` time,
+ * which is faster than pushing them one at a time in `O(n log n)` time.
+ *
+ * @param[in] elem_sz Size of each element in bytes.
+ * @param[in] compare Same as `PQueue_create()`.
+ * @param[in] elems The array of elements to add. It's not modified.
+ * @param[in] n Number of elements in the array.
+ * @return The priority queue created on success, `NULL` otherwise.
+ */
+PQueue* PQueue_heapify(size_t elem_sz,
+                       bool (*compare)(void const*, void const*),
+                       void const* elems, size_t n);
+
+/**
+ * @brief Destroys a heap-allocated priority queue.
+ *
+ * @param pqueue The priority queue to destroy.
+ */
+void PQueue_destroy(PQueue* pqueue);
+
+/**
+ * @brief Requests that a priority queue be able to hold at least `n` elements
+ * without further allocation.
+ *
+ * @param[in] pqueue The priority queue to reserve capacity for.
+ * @param[in] n Number of elements to reserve capacity for.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation; `true` otherwise (on success).
+ */
+bool PQueue_reserve(PQueue* pqueue, size_t n);
+
+/**
+ * @brief Determines whether a priority queue is empty.
+ *
+ * @param[in] pqueue The priority queue to query.
+ * @return `true` if the priority queue is empty, `false` otherwise.
+ */
+bool PQueue_empty(PQueue* pqueue);
+
+/**
+ * @brief Queries the size of a priority queue.
+ *
+ * @param[in] pqueue The priority queue to query.
+ * @return Number of elements in the priority queue.
+ */
+size_t PQueue_size(PQueue* pqueue);
+
+/**
+ * @brief Accesses the top element of a priority queue.
+ *
+ * @param[in] pqueue The priority queue to query.
+ * @param[out] elem The top element if the priority queue is not empty,
+ *      undefined otherwise.
+ * @return `false` if the priority queue is empty, `true` otherwise (on
+ *      success).
+ */
+bool PQueue_top(PQueue* pqueue, void* elem);
+
+/**
+ * @brief Accesses the top element of a priority queue in place without
+ * copying it.
+ *
+ * The pointer returned is invalidated by any subsequent operation that
+ * modifies the priority queue.
+ *
+ * @param[in] pqueue The priority queue to query.
+ * @return Address of the top element if the priority queue is not empty,
+ *      `NULL` otherwise.
+ */
+void const* PQueue_peek(PQueue* pqueue);
+
+/**
+ * @brief Adds an element to a priority queue.
+ *
+ * @param[in] pqueue The priority queue to which the element is to add.
+ * @param[in] elem The element to add.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool PQueue_push(PQueue* pqueue, void const* elem);
+
+/**
+ * @brief Removes the top element from a priority queue.
+ *
+ * @param[in] pqueue The priority queue from which its top element is to
+ *      remove.
+ * @return `false` if the priority queue is empty, `true` otherwise (on
+ *      success).
+ */
+bool PQueue_pop(PQueue* pqueue);
+
+#endif /* PQUEUE_H */
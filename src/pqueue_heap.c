@@ -0,0 +1,263 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+
+/**
+ * @brief Implementation of the ADT priority queue as an unbounded d-ary heap
+ * stored in a dynamic array.
+ *
+ * Each node has `PQUEUE_ARITY` children stored next to one another, which
+ * halves the height of the heap compared to a binary heap when the arity is
+ * four, so that removing the top element touches fewer, mostly contiguous
+ * cache lines at the cost of more comparisons per level.
+ *
+ * @note Use the compiler flag `PQUEUE_ARITY` to override the default arity
+ *      of the heap, and `PQUEUE_INIT_CAP` to override the default initial
+ *      capacity of the underlying array.
+ */
+
+#include "pqueue.h"
+
+#include <assert.h>   // assert()
+#include <stdlib.h>   // malloc(), realloc(), free()
+#include <string.h>   // memcpy()
+
+// clang-format off
+/** Number of children of each node of the heap */
+#ifdef PQUEUE_ARITY
+static size_t const ARITY = PQUEUE_ARITY;
+#else
+static size_t const ARITY = 4;
+#endif
+
+/** Initial underlying array capacity */
+#ifdef PQUEUE_INIT_CAP
+static size_t const INIT_CAP = PQUEUE_INIT_CAP;
+#else
+static size_t const INIT_CAP = 1024;
+#endif
+// clang-format on
+
+// -----------------------------------------------------------------------------
+
+struct pqueue
+{
+    size_t elemsz;   // Element size in bytes.
+    size_t nelems;   // Number of elements in the priority queue.
+    size_t cap;      // Maximum number of elements can be stored without malloc.
+    char*  elems;    // Heap-ordered elements, followed by a scratch element.
+    bool (*compare)(void const*, void const*);   // Element priority order.
+};
+
+/** Copies an element, by a fixed-size copy for common element sizes. */
+static inline void copy_elem(void* dst, void const* src, size_t elem_sz) {
+    switch (elem_sz) {
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    default: memcpy(dst, src, elem_sz); break;
+    }
+}
+
+/** Computes the address of the element at position `i` of the heap. */
+static inline char* at(PQueue* pqueue, size_t i) {
+    return pqueue->elems + i * pqueue->elemsz;
+}
+
+/** Moves the underlying array of a priority queue to one of `new_cap`. */
+static bool reallocate(PQueue* pqueue, size_t new_cap) {
+    assert(new_cap >= pqueue->nelems && "new capacity too small");
+
+    // Keep room for the scratch element past the end of the heap
+    char* arr = realloc(pqueue->elems, (new_cap + 1) * pqueue->elemsz);
+    if (arr == NULL) return false;
+
+    pqueue->elems = arr;
+    pqueue->cap   = new_cap;
+    return true;
+}
+
+PQueue* PQueue_create(size_t elem_sz,
+                      bool (*compare)(void const*, void const*)) {
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    PQueue* pq = malloc(sizeof(PQueue));
+    if (pq == NULL) return NULL;
+
+    pq->elemsz  = elem_sz;
+    pq->nelems  = 0;
+    pq->cap     = 0;
+    pq->elems   = NULL;
+    pq->compare = compare;
+
+    if (!reallocate(pq, INIT_CAP)) {
+        free(pq);
+        return NULL;
+    }
+    return pq;
+}
+
+void PQueue_destroy(PQueue* pqueue) {
+    assert(pqueue != NULL);
+
+    free(pqueue->elems);
+    free(pqueue);
+}
+
+bool PQueue_reserve(PQueue* pqueue, size_t n) {
+    assert(pqueue != NULL);
+
+    if (n <= pqueue->cap) return true;
+    return reallocate(pqueue, n);
+}
+
+bool PQueue_empty(PQueue* pqueue) {
+    assert(pqueue != NULL);
+
+    return pqueue->nelems == 0;
+}
+
+size_t PQueue_size(PQueue* pqueue) {
+    assert(pqueue != NULL);
+
+    return pqueue->nelems;
+}
+
+bool PQueue_top(PQueue* pqueue, void* elem) {
+    assert(pqueue != NULL);
+
+    if (pqueue->nelems == 0) return false;
+
+    copy_elem(elem, pqueue->elems, pqueue->elemsz);
+    return true;
+}
+
+void const* PQueue_peek(PQueue* pqueue) {
+    assert(pqueue != NULL);
+
+    return pqueue->nelems > 0 ? pqueue->elems : NULL;
+}
+
+/**
+ * Moves the element in the scratch slot up from the hole at position `i`
+ * towards the root, past the ancestors it goes before.
+ */
+static void sift_up(PQueue* pqueue, size_t i) {
+    size_t const elem_sz = pqueue->elemsz;
+    char* const  elem    = at(pqueue, pqueue->cap);
+
+    while (i > 0) {
+        size_t const parent = (i - 1) / ARITY;
+        if (!pqueue->compare(elem, at(pqueue, parent))) break;
+
+        copy_elem(at(pqueue, i), at(pqueue, parent), elem_sz);
+        i = parent;
+    }
+    copy_elem(at(pqueue, i), elem, elem_sz);
+}
+
+/**
+ * Moves the element in the scratch slot down from the hole at position `i`
+ * towards the leaves, past the children that go before it, among the first
+ * `n` elements of the heap.
+ */
+static void sift_down(PQueue* pqueue, size_t i, size_t n) {
+    size_t const elem_sz = pqueue->elemsz;
+    char* const  elem    = at(pqueue, pqueue->cap);
+
+    for (;;) {
+        size_t const first = i * ARITY + 1;
+        if (first >= n) break;
+
+        // Find the child that goes before its siblings
+        size_t const last = n - first < ARITY ? n : first + ARITY;
+        size_t       best = first;
+        for (size_t c = first + 1; c < last; ++c) {
+            if (pqueue->compare(at(pqueue, c), at(pqueue, best))) best = c;
+        }
+        if (!pqueue->compare(at(pqueue, best), elem)) break;
+
+        copy_elem(at(pqueue, i), at(pqueue, best), elem_sz);
+        i = best;
+    }
+    copy_elem(at(pqueue, i), elem, elem_sz);
+}
+
+PQueue* PQueue_heapify(size_t elem_sz,
+                       bool (*compare)(void const*, void const*),
+                       void const* elems, size_t n) {
+    PQueue* pq = PQueue_create(elem_sz, compare);
+    if (pq == NULL) return NULL;
+    if (!PQueue_reserve(pq, n)) {
+        PQueue_destroy(pq);
+        return NULL;
+    }
+
+    if (n > 0) memcpy(pq->elems, elems, n * elem_sz);
+    pq->nelems = n;
+
+    // Sift down each parent node, from the last one up to the root
+    for (size_t i = n > 1 ? (n - 2) / ARITY + 1 : 0; i-- > 0;) {
+        copy_elem(at(pq, pq->cap), at(pq, i), elem_sz);
+        sift_down(pq, i, n);
+    }
+    return pq;
+}
+
+bool PQueue_push(PQueue* pqueue, void const* elem) {
+    assert(pqueue != NULL);
+
+    // Double underlying array if it is full
+    if (pqueue->nelems == pqueue->cap) {
+        if (!reallocate(pqueue, pqueue->cap * 2)) return false;
+    }
+
+    copy_elem(at(pqueue, pqueue->cap), elem, pqueue->elemsz);
+    sift_up(pqueue, pqueue->nelems);
+    pqueue->nelems += 1;
+    return true;
+}
+
+bool PQueue_pop(PQueue* pqueue) {
+    assert(pqueue != NULL);
+
+    if (pqueue->nelems == 0) return false;
+
+    // Fill the hole left at the root with the last element
+    pqueue->nelems -= 1;
+    if (pqueue->nelems > 0) {
+        copy_elem(at(pqueue, pqueue->cap), at(pqueue, pqueue->nelems),
+                  pqueue->elemsz);
+        sift_down(pqueue, 0, pqueue->nelems);
+    }
+    return true;
+}
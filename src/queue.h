@@ -73,6 +73,77 @@ typedef struct queue Queue;
  */
 Queue* Queue_create(size_t elem_sz);
 
+/**
+ * @brief Creates an empty, heap-allocated queue of fixed capacity that
+ * overwrites its oldest elements when full.
+ *
+ * Once the queue holds `cap` elements, `Queue_enqueue()` drops the front
+ * element to make room for the new one instead of growing the queue, which
+ * suits buffers that would rather lose old samples than fail or grow. Use
+ * `Queue_dropped()` to find out how many elements have been dropped.
+ * Array-based implementations allocate all storage here and never allocate
+ * again, while node-based implementations reuse the node of the element
+ * dropped.
+ *
+ * It's the caller's responsibility to
+ * -# call `Queue_destroy()` to free all allocated memory associated
+ *    with the queue created; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] elem_sz Size of each queue elements in bytes.
+ * @param[in] cap Maximum number of elements in the queue.
+ * @return The queue created on success, `NULL` if `cap` is zero or the system
+ *      cannot allocate sufficient memory.
+ */
+Queue* Queue_create_ring(size_t elem_sz, size_t cap);
+
+/**
+ * @brief Creates an empty, heap-allocated queue that holds its elements by
+ * pointer and owns them.
+ *
+ * Elements added with `Queue_enqueue_owned()` and removed with
+ * `Queue_take_front()` pass their ownership along with their address, so that
+ * large elements are never copied. The elements of the queue are the pointers
+ * themselves, of size `sizeof(void*)`, to which all other functions apply as
+ * to any other element: functions that move elements, such as
+ * `Queue_transfer()`, move the pointers, and removing an element with
+ * `Queue_dequeue()` or `Queue_dequeue_n()` hands its ownership back to the
+ * caller as `Queue_take_front()` does. The elements left in the queue when it
+ * is destroyed, and those removed with `Queue_discard_n()`, are passed to
+ * `destroy`. The generic algorithms of `algos.h` keep the ownership of the
+ * elements they move: the queues they create are created with
+ * `Queue_create_like()`, and the elements they drop are passed to `destroy`.
+ *
+ * Since every element must be an address handed over to the queue,
+ * `Queue_extend()` fails on such a queue rather than add elements of
+ * unspecified values, and so does `Queue_save()` rather than write addresses
+ * that would be meaningless to `Queue_load()`.
+ *
+ * It's the caller's responsibility to call `Queue_destroy()` to free all
+ * allocated memory associated with the queue created.
+ *
+ * @param[in] destroy A function that frees an element, called on each element
+ *      left when the queue is destroyed, or `NULL` to leave them as they are.
+ * @return The queue created on success, `NULL` otherwise.
+ */
+Queue* Queue_create_owned(void (*destroy)(void* elem));
+
+/**
+ * @brief Creates an empty, heap-allocated queue of the same kind as another.
+ *
+ * The queue created has the same element size and, if `queue` was created
+ * with `Queue_create_owned()`, owns its elements with the same destructor, so
+ * that elements can move between the two without changing hands. It is never
+ * a ring, and has no size limit or watermarks, whatever those of `queue`.
+ *
+ * It's the caller's responsibility to call `Queue_destroy()` to free all
+ * allocated memory associated with the queue created.
+ *
+ * @param[in] queue The queue of which the kind to create.
+ * @return The queue created on success, `NULL` otherwise.
+ */
+Queue* Queue_create_like(Queue* queue);
+
 /**
  * @brief Destroys a heap-allocated queue.
  *
@@ -86,13 +157,29 @@ void Queue_destroy(Queue* queue);
  * @brief Queries the capacity of a queue.
  *
  * For node-based implementations, it always return `ULONG_MAX` to suggest that
- * the queue can hold as many elements as system memory allows.
+ * the queue can hold as many elements as system memory allows, unless the
+ * queue was created with `Queue_create_ring()`.
  *
  * @param[in] queue The queue to query.
  * @return Maximum number of elements that can be stored by the queue.
  */
 size_t Queue_capacity(Queue* queue);
 
+/**
+ * @brief Requests that a queue be able to hold at least `n` elements without
+ * further allocation.
+ *
+ * It is a no-op for node-based implementations. Removing elements from the
+ * queue afterwards may release the capacity reserved.
+ *
+ * @param[in] queue The queue to reserve capacity for.
+ * @param[in] n Number of elements to reserve capacity for.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, or if `n` exceeds the capacity of a queue created with
+ *      `Queue_create_ring()`; `true` otherwise (on success).
+ */
+bool Queue_reserve(Queue* queue, size_t n);
+
 /**
  * @brief Determines whether a queue is empty.
  *
@@ -109,6 +196,15 @@ bool Queue_empty(Queue* queue);
  */
 size_t Queue_size(Queue* queue);
 
+/**
+ * @brief Checks whether a queue owns its elements.
+ *
+ * @param[in] queue The queue to query.
+ * @return `true` if the queue was created with `Queue_create_owned()`, or with
+ *      `Queue_create_like()` from such a queue, `false` otherwise.
+ */
+bool Queue_owned(Queue* queue);
+
 /**
  * @brief Accesses the front element of a queue.
  *
@@ -119,16 +215,133 @@ size_t Queue_size(Queue* queue);
  */
 bool Queue_front(Queue* queue, void* elem);
 
+/**
+ * @brief Accesses the front element of a queue in place.
+ *
+ * Unlike `Queue_front()`, no data is copied. The pointer returned is
+ * invalidated by any subsequent operation that modifies the queue.
+ *
+ * @param[in] queue The queue to query.
+ * @return Address of the front element if the queue is not empty, `NULL`
+ *      otherwise.
+ */
+void const* Queue_peek(Queue* queue);
+
+/**
+ * @brief Iterates over the contiguous memory segments that store the elements
+ * of a queue, in queue order.
+ *
+ * Pass `NULL` as `prev` to get the first segment, which starts at the front
+ * element, and then the segment last returned to get the one that follows.
+ * Array-based implementations store their elements in at most two segments,
+ * while node-based implementations store each element in its own segment.
+ * Segments are invalidated by any subsequent operation that changes the size
+ * of the queue.
+ *
+ * @param[in] queue The queue to query.
+ * @param[in] prev The segment preceding the one to get, or `NULL` for the
+ *      first segment.
+ * @param[out] len Number of elements in the segment returned, undefined if
+ *      `NULL` is returned.
+ * @return Address of the first element in the segment, `NULL` if there are
+ *      no more segments.
+ */
+void* Queue_segment(Queue* queue, void const* prev, size_t* len);
+
+/**
+ * @brief Calls a function on each element of a queue in place, in queue
+ * order.
+ *
+ * Elements are visited a contiguous segment (see `Queue_segment()`) at a time,
+ * without being copied or dequeued.
+ *
+ * @param[in] queue The queue of which the elements to visit.
+ * @param[in] visit A function to call with the address of each element and
+ *      `ctx`. It must not modify the queue.
+ * @param[in] ctx A user context passed to `visit`, which may be `NULL`.
+ */
+void Queue_for_each(Queue* queue, void (*visit)(void const* elem, void* ctx),
+                    void* ctx);
+
+/**
+ * @brief Folds the elements of a queue into an accumulator in place, in queue
+ * order.
+ *
+ * @param[in] queue The queue of which the elements to fold.
+ * @param[in,out] acc The accumulator, holding the initial value on entry and
+ *      the result on return.
+ * @param[in] combine A function that combines the element at `elem` into the
+ *      accumulator at `acc`. It must not modify the queue.
+ */
+void Queue_fold(Queue* queue, void* acc,
+                void (*combine)(void* acc, void const* elem));
+
+/**
+ * @brief Rearranges the elements of a queue into a single contiguous memory
+ * segment, so that they can be accessed in place as an array.
+ *
+ * Array-based implementations move their elements to a new array, once, only
+ * if the elements wrap around the end of the array. Node-based
+ * implementations cannot store more than one element contiguously. The array
+ * is invalidated by any subsequent operation that changes the size of the
+ * queue.
+ *
+ * @param[in] queue The queue to rearrange.
+ * @return Address of the front element if all elements of the queue are
+ *      stored contiguously on return, `NULL` if the queue is empty, if the
+ *      implementation cannot store its elements contiguously, or if the system
+ *      cannot allocate sufficient memory to complete the operation.
+ */
+void* Queue_linearize(Queue* queue);
+
 /**
  * @brief Adds an element to the end of a queue.
  *
+ * If the queue was created with `Queue_create_ring()` and is full, its front
+ * element is dropped to make room.
+ *
  * @param[in] queue The queue to which the element is to add.
  * @param[in] elem The element to add.
- * @return `false` if the system cannot allocate sufficient memory to complete
- *      the operation; `true` otherwise (on success).
+ * @return `false` if the queue has reached its size limit (see
+ *      `Queue_set_limit()`) or the system cannot allocate sufficient memory to
+ *      complete the operation; `true` otherwise (on success).
  */
 bool Queue_enqueue(Queue* queue, void const* elem);
 
+/**
+ * @brief Adds an element to the end of a queue created with
+ * `Queue_create_owned()`, passing its ownership to the queue.
+ *
+ * Only the address of the element is stored: the element must stay where it
+ * is until the queue hands it back or destroys it.
+ *
+ * @param[in] queue The queue to which the element is to add.
+ * @param[in] elem The address of the element to add.
+ * @return `false` if the queue has reached its size limit (see
+ *      `Queue_set_limit()`) or the system cannot allocate sufficient memory to
+ *      complete the operation, in which case the caller keeps the ownership of
+ *      the element; `true` otherwise (on success).
+ */
+bool Queue_enqueue_owned(Queue* queue, void* elem);
+
+/**
+ * @brief Adds a number of elements with unspecified values to the end of a
+ * queue.
+ *
+ * The elements added are meant to be written in place through
+ * `Queue_segment()`, e.g. by multiple threads at once. If the queue was created
+ * with `Queue_create_ring()`, as many front elements are dropped as needed to
+ * make room, and `n` must not exceed its capacity.
+ *
+ * @param[in] queue The queue to which the elements are to add.
+ * @param[in] n Number of elements to add.
+ * @return `false` if the queue would exceed its size limit or capacity, if it
+ *      was created with `Queue_create_owned()`, or if the system cannot
+ *      allocate sufficient memory to complete the operation, in which case the
+ *      queue is not modified; `true` otherwise (on success).
+ */
+bool Queue_extend(Queue* queue, size_t n);
+
 /**
  * @brief Removes the front element from a queue.
  *
@@ -137,6 +350,62 @@ bool Queue_enqueue(Queue* queue, void const* elem);
  */
 bool Queue_dequeue(Queue* queue);
 
+/**
+ * @brief Removes a number of elements from the front of a queue.
+ *
+ * @param[in] queue The queue from which its least recent elements are to
+ *      remove.
+ * @param[in] n Number of elements to remove.
+ * @return `false` if the queue has fewer than `n` elements, in which case the
+ *      queue is not modified; `true` otherwise (on success).
+ */
+bool Queue_dequeue_n(Queue* queue, size_t n);
+
+/**
+ * @brief Removes the front element from a queue created with
+ * `Queue_create_owned()`, passing its ownership to the caller.
+ *
+ * @param[in] queue The queue from which its least recent element is to remove.
+ * @return The address of the element removed, `NULL` if the queue is empty.
+ */
+void* Queue_take_front(Queue* queue);
+
+/**
+ * @brief Removes a number of elements from the front of a queue, destroying
+ * those it owns.
+ *
+ * It is the same as `Queue_dequeue_n()`, except that the elements of a queue
+ * created with `Queue_create_owned()` are passed to its destructor rather than
+ * handed back to the caller.
+ *
+ * @param[in] queue The queue from which its least recent elements are to
+ *      remove.
+ * @param[in] n Number of elements to remove.
+ * @return `false` if the queue has fewer than `n` elements, in which case the
+ *      queue is not modified; `true` otherwise (on success).
+ */
+bool Queue_discard_n(Queue* queue, size_t n);
+
+/**
+ * @brief Moves elements from the front of a queue to the end of another.
+ *
+ * The relative order of the elements moved is preserved. Array-based
+ * implementations copy the elements in bulk, while node-based implementations
+ * relink the nodes without copying. If `dst` was created with
+ * `Queue_create_ring()`, as many of its front elements are dropped as needed
+ * to make room, and `n` must not exceed its capacity.
+ *
+ * @param[in] dst The queue to which the elements are to add. It must be a
+ *      different queue from `src` with the same element size.
+ * @param[in] src The queue from which the elements are to remove.
+ * @param[in] n Number of elements to move.
+ * @return `false` if `src` has fewer than `n` elements, if `dst` would exceed
+ *      its size limit or capacity, or if the system cannot allocate sufficient
+ *      memory to complete the operation, in which case neither queue is
+ *      modified; `true` otherwise (on success).
+ */
+bool Queue_transfer(Queue* dst, Queue* src, size_t n);
+
 /**
  * @brief Prints a string representation of the elements in a queue to the
  * standard output.
@@ -155,4 +424,115 @@ bool Queue_dequeue(Queue* queue);
 void Queue_print(Queue* queue, char const* sep, bool vertical,
                  void (*print_element)(void const*));
 
+/**
+ * @brief A function to call when the size of a queue crosses a watermark.
+ *
+ * @param[in] queue The queue of which the size crossed the watermark.
+ * @param[in] ctx The user context registered along with the callback.
+ */
+typedef void (*WatermarkCallback)(Queue* queue, void* ctx);
+
+/**
+ * @brief Registers a high and a low watermark on a queue.
+ *
+ * The queue becomes *congested* as soon as its size rises to `high` or above,
+ * at which point `on_high` is called. It stays congested until its size falls
+ * to `low` or below, at which point `on_low` is called. Callbacks fire only on
+ * these transitions, never on every operation in between, so that a producer
+ * can be throttled before the queue grows without bound.
+ *
+ * The congestion state is re-evaluated immediately against the current size
+ * of the queue, which fires `on_high` if the queue is already at or above
+ * `high`. Registering new watermarks replaces the old ones.
+ *
+ * @param[in] queue The queue to watch.
+ * @param[in] low The size at or below which a congested queue is
+ *      decongested.
+ * @param[in] high The size at or above which the queue becomes congested.
+ *      Pass `0` to remove the watermarks.
+ * @param[in] on_high A function to call when the queue becomes congested, or
+ *      `NULL` if no callback is needed.
+ * @param[in] on_low A function to call when the queue is decongested, or
+ *      `NULL` if no callback is needed.
+ * @param[in] ctx A user context to pass to the callbacks.
+ * @return `false` if `low` is not less than a nonzero `high`, `true`
+ *      otherwise.
+ */
+bool Queue_set_watermarks(Queue* queue, size_t low, size_t high,
+                          WatermarkCallback on_high, WatermarkCallback on_low,
+                          void* ctx);
+
+/**
+ * @brief Determines whether a queue is congested with respect to its
+ * watermarks.
+ *
+ * @param[in] queue The queue to query.
+ * @return `true` if the queue has risen to its high watermark and has not yet
+ *      fallen to its low watermark since, `false` otherwise.
+ */
+bool Queue_congested(Queue* queue);
+
+/**
+ * @brief Caps the number of elements a queue accepts.
+ *
+ * Once a queue holds `limit` elements, `Queue_enqueue()` rejects further
+ * elements by returning `false` instead of growing the queue.
+ *
+ * @param[in] queue The queue to cap.
+ * @param[in] limit Maximum number of elements in the queue. Pass `0` to
+ *      remove the limit.
+ */
+void Queue_set_limit(Queue* queue, size_t limit);
+
+/**
+ * @brief Queries the number of elements a queue has dropped to make room for
+ * new ones.
+ *
+ * Only a queue created with `Queue_create_ring()` drops elements.
+ *
+ * @param[in] queue The queue to query.
+ * @return Number of elements dropped since the queue was created.
+ */
+size_t Queue_dropped(Queue* queue);
+
+/**
+ * @brief Writes the elements of a queue to a file in binary form.
+ *
+ * The file receives a 24-byte header followed by the elements in queue order,
+ * packed back to back. The header holds the 4 bytes `CDSQ`, a 32-bit format
+ * version, then the element size and the number of elements as 64-bit
+ * integers, all in host byte order. The queue is left unchanged, and queues
+ * written by one implementation can be read by any other.
+ *
+ * Array-based implementations write their elements with a single `writev()`
+ * of at most two segments, while node-based implementations write their nodes
+ * in batches, gathered into a buffer unless the elements are large.
+ *
+ * @param[in] queue The queue of which the elements to write.
+ * @param[in] fd A file descriptor open for writing, at the position to write
+ *      the queue.
+ * @return `false` if the queue was created with `Queue_create_owned()`, in
+ *      which case `errno` is set to `EINVAL`, or if the file cannot be written
+ *      in full, in which case `errno` is set by the failed system call; `true`
+ *      otherwise (on success).
+ */
+bool Queue_save(Queue* queue, int fd);
+
+/**
+ * @brief Creates a heap-allocated queue from the elements written to a file
+ * by `Queue_save()`.
+ *
+ * Array-based implementations allocate their underlying array once, at the
+ * exact size of the queue, and read the elements into it directly.
+ *
+ * @param[in] fd A file descriptor open for reading, at the position of the
+ *      header. On success, it is left at the end of the queue read.
+ * @param[in] elem_sz Size of each queue elements in bytes, which must match
+ *      the element size written in the header.
+ * @return The queue created on success, `NULL` if the file does not start
+ *      with a valid header for `elem_sz`, ends before the last element, or
+ *      cannot be read, or if the system cannot allocate sufficient memory.
+ */
+Queue* Queue_load(int fd, size_t elem_sz);
+
 #endif /* QUEUE_H */
\ No newline at end of file
@@ -34,6 +34,9 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * @brief Implementation of the ADT queue as an unbounded queue using a circular
  * array with dynamic resizing strategy.
  *
+ * A queue created with `Queue_create_ring()` never resizes its array. When it
+ * is full, enqueue overwrites the front element and advances `start` instead.
+ *
  * @note Use the compiler flag `QUEUE_INIT_CAP` and `QUEUE_GROW_FACTOR` to
  *      override the default initial capacity of the underlying array and
  *      default underlying array growth factor respectively.
@@ -41,10 +44,15 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #include "queue.h"
 
-#include <assert.h>   // assert()
-#include <stdlib.h>   // malloc(), free()
-#include <string.h>   // memcpy()
-#include <stdio.h>    // printf()
+#include <assert.h>    // assert()
+#include <stdint.h>    // SIZE_MAX
+#include <stdlib.h>    // malloc(), free()
+#include <string.h>    // memcpy(), memcmp()
+#include <stdio.h>     // printf()
+#include <errno.h>     // errno, EINTR
+#include <unistd.h>    // lseek()
+#include <sys/stat.h>  // fstat(), struct stat, S_ISREG()
+#include <sys/uio.h>   // struct iovec, writev(), readv()
 
 // clang-format off
 #ifdef QUEUE_INIT_CAP
@@ -70,29 +78,103 @@ struct queue
     size_t cap;      // Maximum number of elements can be stored without malloc.
     size_t start;    // Position of the front element in the underlying array.
     void*  elems;    // Underlying array that stores the queue elements.
+    size_t limit;    // Maximum number of elements accepted by enqueue.
+
+    bool   ring;       // Whether the array is fixed and overwritten when full.
+    size_t ndropped;   // Number of elements overwritten when full.
+
+    bool owned;                    // Whether elements are owned pointers.
+    void (*destroy)(void* elem);   // Destructor of the elements owned.
+
+    size_t            lowm;        // Low watermark.
+    size_t            highm;       // High watermark, zero if not set.
+    size_t            hitrig;      // Size at or above which to cross high.
+    size_t            lotrig;      // Size below which to cross low.
+    bool              congested;   // Whether the high watermark is crossed.
+    WatermarkCallback on_high;     // Called when the queue becomes congested.
+    WatermarkCallback on_low;      // Called when the queue is decongested.
+    void*             wm_ctx;      // User context passed to the callbacks.
 };
 
-Queue* Queue_create(size_t elem_sz) {
+/** Creates an empty queue with an underlying array of capacity `cap`. */
+static Queue* create(size_t elem_sz, size_t cap) {
     // Allocate queue
     Queue* q = malloc(sizeof(Queue));
     if (q == NULL) return NULL;
 
     // Allocate underlying array
-    void* arr = malloc(INIT_CAP * elem_sz);
-    if (arr == NULL) return NULL;
+    void* arr = malloc(cap * elem_sz);
+    if (arr == NULL) {
+        free(q);
+        return NULL;
+    }
 
     // Initial data members
-    q->elems  = arr;
-    q->elemsz = elem_sz;
-    q->nelems = 0;
-    q->cap    = INIT_CAP;
-    q->start  = 0;
+    q->elems     = arr;
+    q->elemsz    = elem_sz;
+    q->nelems    = 0;
+    q->cap       = cap;
+    q->start     = 0;
+    q->limit     = SIZE_MAX;
+    q->ring      = false;
+    q->ndropped  = 0;
+    q->owned     = false;
+    q->destroy   = NULL;
+    q->lowm      = 0;
+    q->highm     = 0;
+    q->hitrig    = SIZE_MAX;
+    q->lotrig    = 0;
+    q->congested = false;
+    q->on_high   = NULL;
+    q->on_low    = NULL;
+    q->wm_ctx    = NULL;
+    return q;
+}
+
+Queue* Queue_create(size_t elem_sz) { return create(elem_sz, INIT_CAP); }
+
+Queue* Queue_create_ring(size_t elem_sz, size_t cap) {
+    if (cap == 0) return NULL;
+
+    // Allocate the whole array upfront, once and for all
+    Queue* q = create(elem_sz, cap);
+    if (q == NULL) return NULL;
+
+    q->ring = true;
+    return q;
+}
+
+Queue* Queue_create_owned(void (*destroy)(void* elem)) {
+    Queue* q = Queue_create(sizeof(void*));
+    if (q == NULL) return NULL;
+
+    q->owned   = true;
+    q->destroy = destroy;
     return q;
 }
 
+Queue* Queue_create_like(Queue* queue) {
+    assert(queue != NULL);
+
+    Queue* q = Queue_create(queue->elemsz);
+    if (q == NULL) return NULL;
+
+    q->owned   = queue->owned;
+    q->destroy = queue->destroy;
+    return q;
+}
+
+/** Passes an element of a queue that owns its elements to their destructor. */
+static void destroy_owned(void const* elem, void* ctx) {
+    void* owned = NULL;
+    memcpy(&owned, elem, sizeof(void*));
+    ((Queue*)ctx)->destroy(owned);
+}
+
 void Queue_destroy(Queue* queue) {
     assert(queue != NULL);
 
+    if (queue->destroy != NULL) Queue_for_each(queue, destroy_owned, queue);
     free(queue->elems);
     free(queue);
 }
@@ -115,6 +197,12 @@ size_t Queue_size(Queue* queue) {
     return queue->nelems;
 }
 
+bool Queue_owned(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->owned;
+}
+
 bool Queue_front(Queue* queue, void* elem) {
     assert(queue != NULL);
 
@@ -125,6 +213,14 @@ bool Queue_front(Queue* queue, void* elem) {
     return true;
 }
 
+void const* Queue_peek(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    return (char*)queue->elems + (queue->start * queue->elemsz);
+}
+
 /**
  * Computes the underlying array position that corresponds to one past the last
  * element in a queue.
@@ -139,25 +235,17 @@ enum resize_dir
     GROW
 }; /** Array resizing direction. */
 
-/** Grows or shrinks the underlying array of a queue. */
-static bool resize(Queue* queue, enum resize_dir dir) {
-    size_t new_cap = 0;   // new capacity
-
-    if (dir == GROW) {
-        new_cap = queue->cap * grow_factor;
-    } else if (dir == SHRINK) {
-        new_cap = queue->cap / grow_factor;
-    }
-
-    assert(new_cap > 0 && "zero new capacity");
+/** Moves the elements of a queue into a new underlying array of `new_cap`. */
+static bool reallocate(Queue* queue, size_t new_cap) {
+    assert(new_cap >= queue->nelems && "new capacity too small");
 
     // Allocate new block
     void* arr = malloc(new_cap * queue->elemsz);
     if (arr == NULL) return false;
 
     // Copy data from old block into new block and free the old
-    // CASE 1: no wrapping around
-    if (end(queue) > queue->start) {
+    // CASE 1: no wrapping around (or nothing to copy)
+    if (queue->nelems == 0 || end(queue) > queue->start) {
         void* src = (char*)queue->elems + (queue->start * queue->elemsz);
         memcpy(arr, src, queue->nelems * queue->elemsz);
     }
@@ -179,9 +267,72 @@ static bool resize(Queue* queue, enum resize_dir dir) {
     return true;
 }
 
+/** Grows or shrinks the underlying array of a queue. */
+static bool resize(Queue* queue, enum resize_dir dir) {
+    size_t new_cap = 0;   // new capacity
+
+    if (dir == GROW) {
+        new_cap = queue->cap * grow_factor;
+    } else if (dir == SHRINK) {
+        new_cap = queue->cap / grow_factor;
+    }
+
+    assert(new_cap > 0 && "zero new capacity");
+
+    return reallocate(queue, new_cap);
+}
+
+/**
+ * Shrinks the underlying array of a queue as long as its size is below a
+ * quarter of its full capacity.
+ */
+static bool trim(Queue* queue) {
+    if (queue->ring) return true;
+
+    size_t new_cap = queue->cap;
+    while (queue->nelems > 0 && new_cap / grow_factor >= 2 &&
+           queue->nelems * 4 < new_cap) {
+        new_cap /= grow_factor;
+    }
+
+    if (new_cap == queue->cap) return true;
+    return reallocate(queue, new_cap);
+}
+
+/**
+ * Flags a queue as congested and arms its low watermark. Called only on the
+ * transition so that no extra work is done on each operation.
+ */
+static void cross_high(Queue* queue) {
+    queue->congested = true;
+    queue->hitrig    = SIZE_MAX;
+    queue->lotrig    = queue->lowm + 1;
+    if (queue->on_high != NULL) queue->on_high(queue, queue->wm_ctx);
+}
+
+/** Flags a queue as decongested and re-arms its high watermark. */
+static void cross_low(Queue* queue) {
+    queue->congested = false;
+    queue->hitrig    = queue->highm;
+    queue->lotrig    = 0;
+    if (queue->on_low != NULL) queue->on_low(queue, queue->wm_ctx);
+}
+
 bool Queue_enqueue(Queue* queue, void const* elem) {
     assert(queue != NULL);
 
+    // Overwrite the front element of a full ring, leaving the size unchanged
+    if (queue->ring && queue->nelems == queue->cap) {
+        memcpy((char*)queue->elems + (queue->start * queue->elemsz), elem,
+               queue->elemsz);
+        if (++queue->start == queue->cap) queue->start = 0;
+        queue->ndropped += 1;
+        return true;
+    }
+
+    // Reject element if the queue has reached its size limit
+    if (queue->nelems >= queue->limit) return false;
+
     // Grow underlying array if it is full
     if (queue->nelems == queue->cap) {
         if (!resize(queue, GROW)) return false;
@@ -191,9 +342,18 @@ bool Queue_enqueue(Queue* queue, void const* elem) {
     memcpy((char*)queue->elems + (end(queue) * queue->elemsz), elem,
            queue->elemsz);
     queue->nelems += 1;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
     return true;
 }
 
+bool Queue_enqueue_owned(Queue* queue, void* elem) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    return Queue_enqueue(queue, &elem);
+}
+
 bool Queue_dequeue(Queue* queue) {
     assert(queue != NULL);
 
@@ -202,14 +362,11 @@ bool Queue_dequeue(Queue* queue) {
     queue->nelems -= 1;
     queue->start  = (queue->start + 1) % queue->cap;
 
+    if (queue->nelems < queue->lotrig) cross_low(queue);
+
     // Shrink underlying array if its size falls below a quarter of its full
     // capacity
-    if (queue->nelems > 0 && queue->cap / grow_factor >= 2 &&
-        queue->nelems * 4 < queue->cap) {
-        if (!resize(queue, SHRINK)) return false;
-    }
-
-    return true;
+    return trim(queue);
 }
 
 void Queue_print(Queue* queue, char const* sep, bool vertical,
@@ -219,13 +376,389 @@ void Queue_print(Queue* queue, char const* sep, bool vertical,
 
     size_t const n_elems = queue->nelems;
 
-    void* elem           = NULL;
+    // Wrap around the end of the array instead of computing each position
+    char const* elem = (char*)queue->elems + (queue->start * queue->elemsz);
+    char const* last = (char*)queue->elems + (queue->cap * queue->elemsz);
     for (size_t i = 0; i < n_elems; ++i) {
         if (vertical) printf("[%lu] ", i);
-        elem = (char*)queue->elems +
-               (((queue->start + i) % queue->cap) * queue->elemsz);
         print_element(elem);
         vertical ? printf("\n")
                  : ((i == n_elems - 1) ? printf("%s", "") : printf("%s", sep));
+        elem += queue->elemsz;
+        if (elem == last) elem = queue->elems;
+    }
+}
+
+bool Queue_set_watermarks(Queue* queue, size_t low, size_t high,
+                          WatermarkCallback on_high, WatermarkCallback on_low,
+                          void* ctx) {
+    assert(queue != NULL);
+
+    if (high > 0 && low >= high) return false;
+
+    queue->lowm      = low;
+    queue->highm     = high;
+    queue->on_high   = on_high;
+    queue->on_low    = on_low;
+    queue->wm_ctx    = ctx;
+    queue->congested = false;
+    queue->hitrig    = high > 0 ? high : SIZE_MAX;
+    queue->lotrig    = 0;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_congested(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->congested;
+}
+
+void Queue_set_limit(Queue* queue, size_t limit) {
+    assert(queue != NULL);
+
+    queue->limit = limit > 0 ? limit : SIZE_MAX;
+}
+
+size_t Queue_dropped(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->ndropped;
+}
+
+bool Queue_reserve(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (n <= queue->cap) return true;
+    if (queue->ring) return false;
+
+    // Grow geometrically so that repeated reservations stay amortized O(1)
+    size_t new_cap = queue->cap;
+    while (new_cap < n) new_cap *= grow_factor;
+
+    return reallocate(queue, new_cap);
+}
+
+/**
+ * Makes room for `n` more elements in a queue, dropping front elements of a
+ * full ring as needed, and growing the array of any other queue.
+ */
+static bool make_room(Queue* queue, size_t n) {
+    if (!queue->ring) return Queue_reserve(queue, queue->nelems + n);
+    if (n > queue->cap) return false;
+
+    size_t const free_slots = queue->cap - queue->nelems;
+    if (n <= free_slots) return true;
+
+    size_t const ndrop = n - free_slots;
+    queue->nelems   -= ndrop;
+    queue->start     = (queue->start + ndrop) % queue->cap;
+    queue->ndropped += ndrop;
+    return true;
+}
+
+/** Computes the size of a queue after `n` elements are added to it. */
+static size_t size_after(Queue* queue, size_t n) {
+    if (queue->ring && queue->nelems + n > queue->cap) return queue->cap;
+    return queue->nelems + n;
+}
+
+/**
+ * Copies `n` elements from a contiguous memory block to the end of a queue of
+ * sufficient capacity, wrapping around the underlying array at most once.
+ */
+static void append(Queue* queue, void const* elems, size_t n) {
+    assert(queue->nelems + n <= queue->cap && "insufficient capacity");
+
+    size_t const back   = end(queue);
+    size_t const nhead  = n < queue->cap - back ? n : queue->cap - back;
+    size_t const headsz = nhead * queue->elemsz;   // number of bytes
+
+    memcpy((char*)queue->elems + (back * queue->elemsz), elems, headsz);
+    memcpy(queue->elems, (char const*)elems + headsz,
+           (n - nhead) * queue->elemsz);
+    queue->nelems += n;
+}
+
+bool Queue_transfer(Queue* dst, Queue* src, size_t n) {
+    assert(dst != NULL && src != NULL);
+    assert(dst != src && "cannot transfer elements within the same queue");
+    assert(dst->elemsz == src->elemsz && "element sizes differ");
+
+    if (n > src->nelems) return false;
+    if (size_after(dst, n) > dst->limit) return false;
+    if (!make_room(dst, n)) return false;
+
+    // Copy the elements in at most two contiguous runs of the source array
+    size_t const nhead = n < src->cap - src->start ? n : src->cap - src->start;
+    append(dst, (char*)src->elems + (src->start * src->elemsz), nhead);
+    append(dst, src->elems, n - nhead);
+
+    src->nelems -= n;
+    src->start  = (src->start + n) % src->cap;
+
+    if (dst->nelems >= dst->hitrig) cross_high(dst);
+    if (src->nelems < src->lotrig) cross_low(src);
+
+    // Failing to shrink the source leaves both queues in a valid state
+    (void)trim(src);
+    return true;
+}
+
+void* Queue_segment(Queue* queue, void const* prev, size_t* len) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    void*        first = (char*)queue->elems + (queue->start * queue->elemsz);
+    size_t const ntail = queue->cap - queue->start;   // number of elems
+
+    // Elements up to the end of the underlying array come first
+    if (prev == NULL) {
+        *len = queue->nelems < ntail ? queue->nelems : ntail;
+        return first;
+    }
+
+    // Elements wrapped around to the start of the array, if any, come next
+    if (prev == first && queue->nelems > ntail) {
+        *len = queue->nelems - ntail;
+        return queue->elems;
+    }
+
+    return NULL;
+}
+
+void Queue_for_each(Queue* queue, void (*visit)(void const* elem, void* ctx),
+                    void* ctx) {
+    assert(queue != NULL);
+    assert(visit != NULL && "visit is not a function");
+
+    size_t const elem_sz = queue->elemsz;
+    size_t       len     = 0;
+    char const*  seg     = NULL;
+    while ((seg = Queue_segment(queue, seg, &len)) != NULL) {
+        char const* const last = seg + len * elem_sz;
+        for (char const* elem = seg; elem != last; elem += elem_sz) {
+            visit(elem, ctx);
+        }
+    }
+}
+
+void Queue_fold(Queue* queue, void* acc,
+                void (*combine)(void* acc, void const* elem)) {
+    assert(queue != NULL);
+    assert(combine != NULL && "combine is not a function");
+
+    size_t const elem_sz = queue->elemsz;
+    size_t       len     = 0;
+    char const*  seg     = NULL;
+    while ((seg = Queue_segment(queue, seg, &len)) != NULL) {
+        char const* const last = seg + len * elem_sz;
+        for (char const* elem = seg; elem != last; elem += elem_sz) {
+            combine(acc, elem);
+        }
+    }
+}
+
+/** Reverses the bytes in the memory block `[first, last)` in place. */
+static void reverse_bytes(char* first, char* last) {
+    while (first < last) {
+        char const tmp = *first;
+        *first++       = *--last;
+        *last          = tmp;
+    }
+}
+
+void* Queue_linearize(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    // Rotate a ring in place rather than allocate a new array
+    if (queue->ring && queue->start + queue->nelems > queue->cap) {
+        char* const  arr   = queue->elems;
+        size_t const split = queue->start * queue->elemsz;
+        size_t const arrsz = queue->cap * queue->elemsz;
+        reverse_bytes(arr, arr + split);
+        reverse_bytes(arr + split, arr + arrsz);
+        reverse_bytes(arr, arr + arrsz);
+        queue->start = 0;
+    }
+
+    // Unwrap the elements into a new array of the same capacity if needed
+    if (queue->start + queue->nelems > queue->cap &&
+        !reallocate(queue, queue->cap)) {
+        return NULL;
+    }
+    return (char*)queue->elems + (queue->start * queue->elemsz);
+}
+
+bool Queue_extend(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    // An owned queue holds only the addresses handed over to it
+    if (queue->owned) return false;
+
+    if (size_after(queue, n) > queue->limit) return false;
+    if (!make_room(queue, n)) return false;
+
+    queue->nelems += n;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_dequeue_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (n > queue->nelems) return false;
+
+    queue->nelems -= n;
+    queue->start  = (queue->start + n) % queue->cap;
+
+    if (queue->nelems < queue->lotrig) cross_low(queue);
+
+    // Failing to shrink leaves the queue in a valid state
+    (void)trim(queue);
+    return true;
+}
+
+void* Queue_take_front(Queue* queue) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    void* elem = NULL;
+    if (!Queue_front(queue, &elem)) return NULL;
+
+    Queue_dequeue(queue);
+    return elem;
+}
+
+bool Queue_discard_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (queue->destroy == NULL) return Queue_dequeue_n(queue, n);
+    if (n > queue->nelems) return false;
+
+    for (size_t i = 0; i < n; ++i) queue->destroy(Queue_take_front(queue));
+    return true;
+}
+
+/** Magic bytes at the start of a queue written by `Queue_save()`. */
+static char const MAGIC[4] = { 'C', 'D', 'S', 'Q' };
+
+/** Version of the format written by `Queue_save()`. */
+static uint32_t const FORMAT_VERSION = 1;
+
+/** Header of a queue written by `Queue_save()`, 24 bytes with no padding. */
+struct file_header
+{
+    char     magic[4];   // `MAGIC`.
+    uint32_t version;    // `FORMAT_VERSION`.
+    uint64_t elemsz;     // Element size in bytes.
+    uint64_t nelems;     // Number of elements that follow.
+};
+
+/** Fills in the header of a queue to write. */
+static void fill_header(Queue* queue, struct file_header* hdr) {
+    memcpy(hdr->magic, MAGIC, sizeof(MAGIC));
+    hdr->version = FORMAT_VERSION;
+    hdr->elemsz  = queue->elemsz;
+    hdr->nelems  = queue->nelems;
+}
+
+/**
+ * Determines whether a header read is valid for elements of `elem_sz` bytes,
+ * and the elements that follow fit in memory.
+ */
+static bool is_valid_header(struct file_header const* hdr, size_t elem_sz) {
+    return memcmp(hdr->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+           hdr->version == FORMAT_VERSION && hdr->elemsz == elem_sz &&
+           elem_sz > 0 && hdr->nelems <= SIZE_MAX / elem_sz;
+}
+
+/**
+ * Transfers the buffers of `iov` to or from a file in full, resuming after
+ * partial transfers and interruptions. Reaching the end of the file before
+ * the last buffer is an error.
+ */
+static bool transfer_all(int fd, struct iovec* iov, int iovcnt, bool write) {
+    while (iovcnt > 0) {
+        ssize_t const res =
+            write ? writev(fd, iov, iovcnt) : readv(fd, iov, iovcnt);
+        if (res < 0 && errno == EINTR) continue;
+        if (res < 0) return false;
+
+        // Skip the buffers transferred in full, then the part of the next
+        size_t done = (size_t)res;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt == 0) break;
+        if (res == 0) return false;
+
+        iov->iov_base  = (char*)iov->iov_base + done;
+        iov->iov_len  -= done;
+    }
+    return true;
+}
+
+bool Queue_save(Queue* queue, int fd) {
+    assert(queue != NULL);
+
+    // The addresses of owned elements are meaningless once loaded
+    if (queue->owned) {
+        errno = EINVAL;
+        return false;
     }
-}
\ No newline at end of file
+
+    struct file_header hdr;
+    fill_header(queue, &hdr);
+
+    // The elements up to the end of the array, then those wrapped around
+    size_t const ntail = queue->cap - queue->start;
+    size_t const nhead = queue->nelems < ntail ? queue->nelems : ntail;
+    struct iovec iov[3] = {
+        { &hdr, sizeof(hdr) },
+        { (char*)queue->elems + (queue->start * queue->elemsz),
+          nhead * queue->elemsz },
+        { queue->elems, (queue->nelems - nhead) * queue->elemsz }
+    };
+    return transfer_all(fd, iov, 3, true);
+}
+
+/**
+ * Determines whether a regular file holds fewer than `nbytes` bytes past its
+ * current offset, so that a corrupt header cannot make a load allocate more
+ * than the file could fill. Other files are read until they run out instead.
+ */
+static bool is_short_file(int fd, uint64_t nbytes) {
+    struct stat st;
+    off_t const pos = lseek(fd, 0, SEEK_CUR);
+    return pos >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+           (st.st_size < pos || (uint64_t)(st.st_size - pos) < nbytes);
+}
+
+Queue* Queue_load(int fd, size_t elem_sz) {
+    struct file_header hdr;
+    struct iovec       iov = { &hdr, sizeof(hdr) };
+    if (!transfer_all(fd, &iov, 1, false)) return NULL;
+    if (!is_valid_header(&hdr, elem_sz)) return NULL;
+    if (is_short_file(fd, hdr.nelems * elem_sz)) return NULL;
+
+    // Allocate the array at the exact size, and read the elements right in
+    size_t const n = (size_t)hdr.nelems;
+    Queue*       q = create(elem_sz, n > 0 ? n : INIT_CAP);
+    if (q == NULL) return NULL;
+
+    iov = (struct iovec){ q->elems, n * elem_sz };
+    if (!transfer_all(fd, &iov, 1, false)) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    q->nelems = n;
+    return q;
+}
@@ -39,16 +39,35 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  * 64-bit architecture) stores the address of its succeeding element in the
  * queue, followed by the value of the element. As a result, the queue elements
  * have **value semantics**.
+ *
+ * A queue created with `Queue_create_ring()` holds at most `cap` nodes. When it
+ * is full, enqueue moves the front node to the back and overwrites its value
+ * instead of allocating a new node.
  */
 
 #include "queue.h"
 
-#include <stddef.h>   // size_t
-#include <stdlib.h>   // malloc(), free()
-#include <string.h>   // memcpy()
-#include <limits.h>   // ULONG_MAX
-#include <assert.h>   // assert()
-#include <stdio.h>    // printf()
+#include <stddef.h>    // size_t
+#include <stdint.h>    // SIZE_MAX
+#include <stdlib.h>    // malloc(), free()
+#include <string.h>    // memcpy(), memcmp()
+#include <limits.h>    // ULONG_MAX
+#include <assert.h>    // assert()
+#include <stdio.h>     // printf()
+#include <errno.h>     // errno, EINTR
+#include <sys/uio.h>   // struct iovec, writev(), readv()
+
+/** Number of nodes gathered into a single `writev()` or `readv()`. */
+#define IOV_BATCH 1024
+
+/**
+ * Element size below which nodes are gathered into a staging buffer instead,
+ * since the kernel spends more per segment than it takes to copy them.
+ */
+#define IOV_MIN_ELEMSZ 512
+
+/** Size of the staging buffer for small elements, in bytes. */
+#define STAGING_SZ 65536
 
 struct queue
 {
@@ -56,22 +75,90 @@ struct queue
     size_t nelems;   // Number of elements in the queue
     void*  front;    // Element at the front of the queue
     void*  back;     // Element at the end of the queue
+    size_t limit;    // Maximum number of elements accepted by enqueue
+
+    size_t cap;        // Maximum number of nodes, SIZE_MAX if not a ring
+    size_t ndropped;   // Number of elements overwritten when full
+
+    bool owned;                    // Whether elements are owned pointers
+    void (*destroy)(void* elem);   // Destructor of the elements owned
+
+    size_t            lowm;        // Low watermark
+    size_t            highm;       // High watermark, zero if not set
+    size_t            hitrig;      // Size at or above which to cross high
+    size_t            lotrig;      // Size below which to cross low
+    bool              congested;   // Whether the high watermark is crossed
+    WatermarkCallback on_high;     // Called when the queue becomes congested
+    WatermarkCallback on_low;      // Called when the queue is decongested
+    void*             wm_ctx;      // User context passed to the callbacks
 };
 
 Queue* Queue_create(size_t elem_sz) {
     Queue* q = malloc(sizeof(Queue));
     if (q == NULL) return NULL;
 
-    q->elemsz = elem_sz;
-    q->nelems = 0;
-    q->front  = NULL;
-    q->back   = NULL;
+    q->elemsz    = elem_sz;
+    q->nelems    = 0;
+    q->front     = NULL;
+    q->back      = NULL;
+    q->limit     = SIZE_MAX;
+    q->cap       = SIZE_MAX;
+    q->ndropped  = 0;
+    q->owned     = false;
+    q->destroy   = NULL;
+    q->lowm      = 0;
+    q->highm     = 0;
+    q->hitrig    = SIZE_MAX;
+    q->lotrig    = 0;
+    q->congested = false;
+    q->on_high   = NULL;
+    q->on_low    = NULL;
+    q->wm_ctx    = NULL;
+    return q;
+}
+
+Queue* Queue_create_ring(size_t elem_sz, size_t cap) {
+    if (cap == 0) return NULL;
+
+    Queue* q = Queue_create(elem_sz);
+    if (q == NULL) return NULL;
+
+    q->cap = cap;
+    return q;
+}
+
+Queue* Queue_create_owned(void (*destroy)(void* elem)) {
+    Queue* q = Queue_create(sizeof(void*));
+    if (q == NULL) return NULL;
+
+    q->owned   = true;
+    q->destroy = destroy;
+    return q;
+}
+
+Queue* Queue_create_like(Queue* queue) {
+    assert(queue != NULL);
+
+    Queue* q = Queue_create(queue->elemsz);
+    if (q == NULL) return NULL;
+
+    q->owned   = queue->owned;
+    q->destroy = queue->destroy;
     return q;
 }
 
+/** Passes an element of a queue that owns its elements to their destructor. */
+static void destroy_owned(void const* elem, void* ctx) {
+    void* owned = NULL;
+    memcpy(&owned, elem, sizeof(void*));
+    ((Queue*)ctx)->destroy(owned);
+}
+
 void Queue_destroy(Queue* queue) {
     assert(queue != NULL);
 
+    if (queue->destroy != NULL) Queue_for_each(queue, destroy_owned, queue);
+
     // Deallocate all nodes
     void* elem = queue->front;
     void* next = NULL;
@@ -88,7 +175,7 @@ void Queue_destroy(Queue* queue) {
 size_t Queue_capacity(Queue* queue) {
     assert(queue != NULL);
 
-    return ULONG_MAX;
+    return queue->cap == SIZE_MAX ? ULONG_MAX : queue->cap;
 }
 
 bool Queue_empty(Queue* queue) {
@@ -103,6 +190,12 @@ size_t Queue_size(Queue* queue) {
     return queue->nelems;
 }
 
+bool Queue_owned(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->owned;
+}
+
 bool Queue_front(Queue* queue, void* elem) {
     assert(queue != NULL);
 
@@ -112,9 +205,54 @@ bool Queue_front(Queue* queue, void* elem) {
     return true;
 }
 
+void const* Queue_peek(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    return (char*)queue->front + sizeof(void*);
+}
+
+/**
+ * Flags a queue as congested and arms its low watermark. Called only on the
+ * transition so that no extra work is done on each operation.
+ */
+static void cross_high(Queue* queue) {
+    queue->congested = true;
+    queue->hitrig    = SIZE_MAX;
+    queue->lotrig    = queue->lowm + 1;
+    if (queue->on_high != NULL) queue->on_high(queue, queue->wm_ctx);
+}
+
+/** Flags a queue as decongested and re-arms its high watermark. */
+static void cross_low(Queue* queue) {
+    queue->congested = false;
+    queue->hitrig    = queue->highm;
+    queue->lotrig    = 0;
+    if (queue->on_low != NULL) queue->on_low(queue, queue->wm_ctx);
+}
+
 bool Queue_enqueue(Queue* queue, void const* elem) {
     assert(queue != NULL);
 
+    // Move the front node of a full ring to the back, leaving the size
+    // unchanged
+    if (queue->nelems == queue->cap) {
+        void* node = queue->front;
+        memcpy((char*)node + sizeof(void*), elem, queue->elemsz);
+        if (node != queue->back) {
+            queue->front         = *(void**)node;
+            *(void**)node        = NULL;
+            *(void**)queue->back = node;
+            queue->back          = node;
+        }
+        queue->ndropped += 1;
+        return true;
+    }
+
+    // Reject element if the queue has reached its size limit
+    if (queue->nelems >= queue->limit) return false;
+
     void* node = malloc(sizeof(void*) + queue->elemsz);
     if (node == NULL) return false;
 
@@ -137,9 +275,17 @@ bool Queue_enqueue(Queue* queue, void const* elem) {
     // Increment queue size
     queue->nelems += 1;
 
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
     return true;
 }
 
+bool Queue_enqueue_owned(Queue* queue, void* elem) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    return Queue_enqueue(queue, &elem);
+}
+
 bool Queue_dequeue(Queue* queue) {
     assert(queue != NULL);
 
@@ -161,6 +307,7 @@ bool Queue_dequeue(Queue* queue) {
     // Deallocate old front node
     free(front);
 
+    if (queue->nelems < queue->lotrig) cross_low(queue);
     return true;
 }
 
@@ -186,4 +333,408 @@ void Queue_print(Queue* queue, char const* sep, bool vertical,
         node = *(void**)node;
         ++i;
     } while (node);
-}
\ No newline at end of file
+}
+
+bool Queue_set_watermarks(Queue* queue, size_t low, size_t high,
+                          WatermarkCallback on_high, WatermarkCallback on_low,
+                          void* ctx) {
+    assert(queue != NULL);
+
+    if (high > 0 && low >= high) return false;
+
+    queue->lowm      = low;
+    queue->highm     = high;
+    queue->on_high   = on_high;
+    queue->on_low    = on_low;
+    queue->wm_ctx    = ctx;
+    queue->congested = false;
+    queue->hitrig    = high > 0 ? high : SIZE_MAX;
+    queue->lotrig    = 0;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_congested(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->congested;
+}
+
+void Queue_set_limit(Queue* queue, size_t limit) {
+    assert(queue != NULL);
+
+    queue->limit = limit > 0 ? limit : SIZE_MAX;
+}
+
+size_t Queue_dropped(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->ndropped;
+}
+
+bool Queue_reserve(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    // Nodes are allocated one at a time; there's nothing to reserve
+    return n <= queue->cap;
+}
+
+/** Computes the size of a queue after `n` elements are added to it. */
+static size_t size_after(Queue* queue, size_t n) {
+    size_t const room = queue->cap - queue->nelems;
+    return n > room ? queue->cap : queue->nelems + n;
+}
+
+/** Deallocates the front nodes of a ring so that `n` more elements fit. */
+static void drop_to_fit(Queue* queue, size_t n) {
+    size_t const room = queue->cap - queue->nelems;
+    if (n <= room) return;
+
+    size_t const ndrop = n - room;
+    for (size_t i = 0; i < ndrop; ++i) {
+        void* next = *(void**)queue->front;
+        free(queue->front);
+        queue->front = next;
+    }
+    if (queue->front == NULL) queue->back = NULL;
+    queue->nelems   -= ndrop;
+    queue->ndropped += ndrop;
+}
+
+bool Queue_transfer(Queue* dst, Queue* src, size_t n) {
+    assert(dst != NULL && src != NULL);
+    assert(dst != src && "cannot transfer elements within the same queue");
+    assert(dst->elemsz == src->elemsz && "element sizes differ");
+
+    if (n > src->nelems || n > dst->cap) return false;
+    if (size_after(dst, n) > dst->limit) return false;
+    if (n == 0) return true;
+
+    drop_to_fit(dst, n);
+
+    // Find the last node to move -- no need to walk if moving all
+    void* last = src->back;
+    if (n < src->nelems) {
+        last = src->front;
+        for (size_t i = 1; i < n; ++i) last = *(void**)last;
+    }
+
+    // Splice the chain of nodes onto the end of the destination
+    if (dst->back == NULL) {
+        dst->front = src->front;
+    } else {
+        *(void**)dst->back = src->front;
+    }
+    dst->back   = last;
+    dst->nelems += n;
+
+    // Detach the chain of nodes from the source
+    src->front  = *(void**)last;
+    src->nelems -= n;
+    if (src->front == NULL) src->back = NULL;
+    *(void**)last = NULL;
+
+    if (dst->nelems >= dst->hitrig) cross_high(dst);
+    if (src->nelems < src->lotrig) cross_low(src);
+    return true;
+}
+
+void* Queue_segment(Queue* queue, void const* prev, size_t* len) {
+    assert(queue != NULL);
+
+    // Each node is a segment on its own
+    void* node = prev == NULL ? queue->front
+                              : *(void**)((char const*)prev - sizeof(void*));
+    if (node == NULL) return NULL;
+
+    *len = 1;
+    return (char*)node + sizeof(void*);
+}
+
+void Queue_for_each(Queue* queue, void (*visit)(void const* elem, void* ctx),
+                    void* ctx) {
+    assert(queue != NULL);
+    assert(visit != NULL && "visit is not a function");
+
+    for (void* node = queue->front; node != NULL; node = *(void**)node) {
+        visit((char*)node + sizeof(void*), ctx);
+    }
+}
+
+void Queue_fold(Queue* queue, void* acc,
+                void (*combine)(void* acc, void const* elem)) {
+    assert(queue != NULL);
+    assert(combine != NULL && "combine is not a function");
+
+    for (void* node = queue->front; node != NULL; node = *(void**)node) {
+        combine(acc, (char*)node + sizeof(void*));
+    }
+}
+
+void* Queue_linearize(Queue* queue) {
+    assert(queue != NULL);
+
+    // Only a single node is contiguous
+    if (queue->nelems != 1) return NULL;
+    return (char*)queue->front + sizeof(void*);
+}
+
+bool Queue_extend(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    // An owned queue holds only the addresses handed over to it
+    if (queue->owned) return false;
+
+    if (n > queue->cap || size_after(queue, n) > queue->limit) return false;
+    if (n == 0) return true;
+
+    // Allocate a chain of nodes before touching the queue
+    void* first = NULL;
+    void* last  = NULL;
+    for (size_t i = 0; i < n; ++i) {
+        void* node = malloc(sizeof(void*) + queue->elemsz);
+        if (node == NULL) {
+            while (first != NULL) {
+                void* next = *(void**)first;
+                free(first);
+                first = next;
+            }
+            return false;
+        }
+        *(void**)node = NULL;
+        if (last == NULL) {
+            first = node;
+        } else {
+            *(void**)last = node;
+        }
+        last = node;
+    }
+
+    // Splice the chain of nodes onto the end of the queue
+    drop_to_fit(queue, n);
+    if (queue->back == NULL) {
+        queue->front = first;
+    } else {
+        *(void**)queue->back = first;
+    }
+    queue->back   = last;
+    queue->nelems += n;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_dequeue_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (n > queue->nelems) return false;
+
+    // Deallocate front nodes
+    for (size_t i = 0; i < n; ++i) {
+        void* next = *(void**)queue->front;
+        free(queue->front);
+        queue->front = next;
+    }
+    if (queue->front == NULL) queue->back = NULL;
+    queue->nelems -= n;
+
+    if (queue->nelems < queue->lotrig) cross_low(queue);
+    return true;
+}
+
+void* Queue_take_front(Queue* queue) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    void* elem = NULL;
+    if (!Queue_front(queue, &elem)) return NULL;
+
+    Queue_dequeue(queue);
+    return elem;
+}
+
+bool Queue_discard_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (queue->destroy == NULL) return Queue_dequeue_n(queue, n);
+    if (n > queue->nelems) return false;
+
+    for (size_t i = 0; i < n; ++i) queue->destroy(Queue_take_front(queue));
+    return true;
+}
+
+/** Magic bytes at the start of a queue written by `Queue_save()`. */
+static char const MAGIC[4] = { 'C', 'D', 'S', 'Q' };
+
+/** Version of the format written by `Queue_save()`. */
+static uint32_t const FORMAT_VERSION = 1;
+
+/** Header of a queue written by `Queue_save()`, 24 bytes with no padding. */
+struct file_header
+{
+    char     magic[4];   // `MAGIC`.
+    uint32_t version;    // `FORMAT_VERSION`.
+    uint64_t elemsz;     // Element size in bytes.
+    uint64_t nelems;     // Number of elements that follow.
+};
+
+/** Fills in the header of a queue to write. */
+static void fill_header(Queue* queue, struct file_header* hdr) {
+    memcpy(hdr->magic, MAGIC, sizeof(MAGIC));
+    hdr->version = FORMAT_VERSION;
+    hdr->elemsz  = queue->elemsz;
+    hdr->nelems  = queue->nelems;
+}
+
+/**
+ * Determines whether a header read is valid for elements of `elem_sz` bytes,
+ * and the elements that follow fit in memory.
+ */
+static bool is_valid_header(struct file_header const* hdr, size_t elem_sz) {
+    return memcmp(hdr->magic, MAGIC, sizeof(MAGIC)) == 0 &&
+           hdr->version == FORMAT_VERSION && hdr->elemsz == elem_sz &&
+           elem_sz > 0 && hdr->nelems <= SIZE_MAX / elem_sz;
+}
+
+/**
+ * Transfers the buffers of `iov` to or from a file in full, resuming after
+ * partial transfers and interruptions. Reaching the end of the file before
+ * the last buffer is an error.
+ */
+static bool transfer_all(int fd, struct iovec* iov, int iovcnt, bool write) {
+    while (iovcnt > 0) {
+        ssize_t const res =
+            write ? writev(fd, iov, iovcnt) : readv(fd, iov, iovcnt);
+        if (res < 0 && errno == EINTR) continue;
+        if (res < 0) return false;
+
+        // Skip the buffers transferred in full, then the part of the next
+        size_t done = (size_t)res;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt == 0) break;
+        if (res == 0) return false;
+
+        iov->iov_base  = (char*)iov->iov_base + done;
+        iov->iov_len  -= done;
+    }
+    return true;
+}
+
+/**
+ * Transfers the values of `n` nodes of a queue from `node` on to or from a
+ * file, a batch of `IOV_BATCH` nodes at a time, in place.
+ */
+static bool transfer_nodes_in_place(Queue* queue, void* node, size_t n, int fd,
+                                    bool write) {
+    struct iovec iov[IOV_BATCH];
+    int          cnt = 0;
+
+    for (; n > 0; --n, node = *(void**)node) {
+        iov[cnt++] =
+            (struct iovec){ (char*)node + sizeof(void*), queue->elemsz };
+        if (cnt == IOV_BATCH) {
+            if (!transfer_all(fd, iov, cnt, write)) return false;
+            cnt = 0;
+        }
+    }
+    return cnt == 0 || transfer_all(fd, iov, cnt, write);
+}
+
+/**
+ * Number of nodes whose values are transferred to or from a file at a time.
+ */
+static size_t nodes_per_batch(size_t elemsz) {
+    return elemsz >= IOV_MIN_ELEMSZ ? IOV_BATCH : STAGING_SZ / elemsz;
+}
+
+/**
+ * Transfers the values of `n` nodes of a queue from `node` on to or from a
+ * file, through a staging buffer of `STAGING_SZ` bytes unless the elements
+ * are large.
+ */
+static bool transfer_nodes(Queue* queue, void* node, size_t n, int fd,
+                           bool write) {
+    size_t const elemsz = queue->elemsz;
+    if (elemsz >= IOV_MIN_ELEMSZ) {
+        return transfer_nodes_in_place(queue, node, n, fd, write);
+    }
+
+    size_t const per_batch = nodes_per_batch(elemsz);
+    char*        buf       = malloc(per_batch * elemsz);
+    if (buf == NULL) return false;
+
+    size_t left = n;
+    bool   ok   = true;
+    while (ok && left > 0) {
+        size_t const nbatch = left < per_batch ? left : per_batch;
+        struct iovec iov    = { buf, nbatch * elemsz };
+        if (!write && !transfer_all(fd, &iov, 1, false)) {
+            ok = false;
+            break;
+        }
+
+        // Copy the values between the nodes of the batch and the buffer
+        for (char* elem = buf; elem != buf + nbatch * elemsz; elem += elemsz) {
+            char* val = (char*)node + sizeof(void*);
+            write ? memcpy(elem, val, elemsz) : memcpy(val, elem, elemsz);
+            node = *(void**)node;
+        }
+
+        if (write) ok = transfer_all(fd, &iov, 1, true);
+        left -= nbatch;
+    }
+
+    free(buf);
+    return ok;
+}
+
+bool Queue_save(Queue* queue, int fd) {
+    assert(queue != NULL);
+
+    // The addresses of owned elements are meaningless once loaded
+    if (queue->owned) {
+        errno = EINVAL;
+        return false;
+    }
+
+    struct file_header hdr;
+    fill_header(queue, &hdr);
+
+    struct iovec iov = { &hdr, sizeof(hdr) };
+    return transfer_all(fd, &iov, 1, true) &&
+           transfer_nodes(queue, queue->front, queue->nelems, fd, true);
+}
+
+Queue* Queue_load(int fd, size_t elem_sz) {
+    struct file_header hdr;
+    struct iovec       iov = { &hdr, sizeof(hdr) };
+    if (!transfer_all(fd, &iov, 1, false)) return NULL;
+    if (!is_valid_header(&hdr, elem_sz)) return NULL;
+
+    Queue* q = Queue_create(elem_sz);
+    if (q == NULL) return NULL;
+
+    // Allocate the nodes a batch at a time, so a count in the header that
+    // exceeds the elements in the file fails without exhausting memory
+    size_t const per_batch = nodes_per_batch(elem_sz);
+    bool         ok        = true;
+    for (uint64_t n = hdr.nelems; ok && n > 0;) {
+        size_t const k    = (size_t)(n < per_batch ? n : per_batch);
+        void* const  back = q->back;
+        ok = Queue_extend(q, k) &&
+             transfer_nodes(q, back != NULL ? *(void**)back : q->front, k, fd,
+                            false);
+        n -= k;
+    }
+
+    if (!ok) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    return q;
+}
@@ -0,0 +1,959 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @brief Implementation of the ADT queue as an unbounded queue using a circular
+ * array in a memory-mapped file.
+ *
+ * The file starts with a header of `HEADER_SZ` bytes, followed by the array.
+ * The header holds two copies of the state of the queue -- the capacity of the
+ * array, the position of the front element and the number of elements -- and
+ * the index of the one in effect. Each operation writes the new state to the
+ * other copy, and only then switches to it with a release store, so that a
+ * crash at any point leaves the file with either the old or the new state,
+ * and never a state that refers to elements not yet written.
+ *
+ * The array grows by doubling like that of `libqueuearr`. Elements that wrap
+ * around the end of the old array are copied, not moved, past its end, so
+ * that the old state stays valid until the new one is committed. The array
+ * never shrinks, since the file would have to be remapped each time.
+ *
+ * @note Use the compiler flag `QUEUE_INIT_CAP` to override the default initial
+ *      capacity of the underlying array.
+ */
+
+#define _POSIX_C_SOURCE 200809L   // ftruncate(), fstat(), mkstemp(), msync()
+
+#include "queue.h"
+#include "queue_mmap.h"
+
+#include <assert.h>      // assert()
+#include <stdint.h>      // SIZE_MAX, uint32_t, uint64_t
+#include <stdlib.h>      // malloc(), free(), getenv(), mkstemp()
+#include <string.h>      // memcpy(), memcmp(), strlen()
+#include <stdio.h>       // printf(), snprintf()
+#include <errno.h>       // errno, EINTR
+#include <fcntl.h>       // open(), O_*
+#include <unistd.h>      // close(), ftruncate(), unlink(), sysconf(), lseek()
+#include <sys/mman.h>    // mmap(), munmap(), msync()
+#include <sys/stat.h>    // fstat(), struct stat
+#include <sys/uio.h>     // struct iovec, writev(), readv()
+
+// clang-format off
+#ifdef QUEUE_INIT_CAP
+size_t const INIT_CAP = QUEUE_INIT_CAP; /** Initial underlying array capacity */
+#else
+size_t const INIT_CAP = 1024; /** Initial underlying array capacity */
+#endif
+// clang-format on
+
+/** Size of the header of a file, so that the array starts on a page. */
+#define HEADER_SZ 4096
+
+/** Magic bytes at the start of a file that backs a queue. */
+static char const MMAP_MAGIC[4] = { 'C', 'D', 'Q', 'M' };
+
+/** Version of the layout of a file that backs a queue. */
+static uint32_t const MMAP_VERSION = 1;
+
+// -----------------------------------------------------------------------------
+
+/** State of a queue, as committed to its file. */
+struct mmap_state
+{
+    uint64_t cap;      // Capacity of the array.
+    uint64_t start;    // Position of the front element in the array.
+    uint64_t nelems;   // Number of elements in the queue.
+};
+
+/** Header of a file that backs a queue. */
+struct mmap_header
+{
+    char              magic[4];    // `MMAP_MAGIC`.
+    uint32_t          version;     // `MMAP_VERSION`.
+    uint64_t          elemsz;      // Element size in bytes.
+    uint64_t          active;      // Index of the state in effect.
+    struct mmap_state states[2];   // Current and previous states.
+};
+
+struct queue
+{
+    size_t elemsz;   // Element size in bytes.
+    size_t nelems;   // Number of elements in the queue.
+    size_t cap;      // Maximum number of elements can be stored without remap.
+    size_t start;    // Position of the front element in the underlying array.
+    char*  elems;    // Underlying array that stores the queue elements.
+    size_t limit;    // Maximum number of elements accepted by enqueue.
+
+    bool   ring;       // Whether the array is fixed and overwritten when full.
+    size_t ndropped;   // Number of elements overwritten when full.
+
+    bool owned;                    // Whether elements are owned pointers.
+    void (*destroy)(void* elem);   // Destructor of the elements owned.
+
+    int                 fd;          // File that backs the queue.
+    struct mmap_header* hdr;         // Mapping of the whole file.
+    size_t              mapsz;       // Size of the mapping in bytes.
+    size_t              sync_every;  // Elements added between syncs, 0 if off.
+    size_t              nunsynced;   // Elements added since the last sync.
+    size_t              dirty_lo;    // Offset of the first byte not synced.
+    size_t              dirty_hi;    // Offset past the last byte not synced.
+
+    size_t            lowm;        // Low watermark.
+    size_t            highm;       // High watermark, zero if not set.
+    size_t            hitrig;      // Size at or above which to cross high.
+    size_t            lotrig;      // Size below which to cross low.
+    bool              congested;   // Whether the high watermark is crossed.
+    WatermarkCallback on_high;     // Called when the queue becomes congested.
+    WatermarkCallback on_low;      // Called when the queue is decongested.
+    void*             wm_ctx;      // User context passed to the callbacks.
+};
+
+/**
+ * Commits the state of a queue to its file. The state written becomes the one
+ * in effect only once it is complete.
+ */
+static void commit(Queue* queue) {
+    struct mmap_header* hdr  = queue->hdr;
+    uint64_t const      next = 1 - hdr->active;
+
+    hdr->states[next] = (struct mmap_state){ .cap    = queue->cap,
+                                             .start  = queue->start,
+                                             .nelems = queue->nelems };
+#if defined(__GNUC__) || defined(__clang__)
+    __atomic_store_n(&hdr->active, next, __ATOMIC_RELEASE);
+#else
+    *(uint64_t volatile*)&hdr->active = next;
+#endif
+}
+
+/** Records that `n` elements from position `pos` of the array are unsynced. */
+static void mark_dirty(Queue* queue, size_t pos, size_t n) {
+    if (n == 0) return;
+
+    size_t const lo = HEADER_SZ + pos * queue->elemsz;
+    size_t const hi = lo + n * queue->elemsz;
+    if (queue->dirty_lo >= queue->dirty_hi || lo < queue->dirty_lo) {
+        queue->dirty_lo = lo;
+    }
+    if (hi > queue->dirty_hi) queue->dirty_hi = hi;
+}
+
+/** Syncs a queue if it has had enough elements added since the last sync. */
+static void count_added(Queue* queue, size_t n) {
+    if (queue->sync_every == 0) return;
+
+    queue->nunsynced += n;
+    if (queue->nunsynced >= queue->sync_every) (void)Queue_sync(queue);
+}
+
+/** Maps the first `size` bytes of the file of a queue, which must exist. */
+static bool map_file(Queue* queue, size_t size) {
+    void* map =
+        mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, queue->fd, 0);
+    if (map == MAP_FAILED) return false;
+
+    if (queue->hdr != NULL) munmap(queue->hdr, queue->mapsz);
+    queue->hdr   = map;
+    queue->mapsz = size;
+    queue->elems = (char*)map + HEADER_SZ;
+    return true;
+}
+
+/** Computes the size of the file of a queue with an array of `cap`. */
+static size_t file_size(Queue* queue, size_t cap) {
+    return HEADER_SZ + cap * queue->elemsz;
+}
+
+/**
+ * Creates a queue backed by an open file, without any mapping. The file
+ * descriptor is closed on failure.
+ */
+static Queue* create(int fd, size_t elem_sz) {
+    Queue* q = malloc(sizeof(Queue));
+    if (q == NULL) {
+        close(fd);
+        return NULL;
+    }
+
+    q->elemsz     = elem_sz;
+    q->nelems     = 0;
+    q->cap        = 0;
+    q->start      = 0;
+    q->elems      = NULL;
+    q->limit      = SIZE_MAX;
+    q->ring       = false;
+    q->ndropped   = 0;
+    q->owned      = false;
+    q->destroy    = NULL;
+    q->fd         = fd;
+    q->hdr        = NULL;
+    q->mapsz      = 0;
+    q->sync_every = 0;
+    q->nunsynced  = 0;
+    q->dirty_lo   = 0;
+    q->dirty_hi   = 0;
+    q->lowm       = 0;
+    q->highm      = 0;
+    q->hitrig     = SIZE_MAX;
+    q->lotrig     = 0;
+    q->congested  = false;
+    q->on_high    = NULL;
+    q->on_low     = NULL;
+    q->wm_ctx     = NULL;
+    return q;
+}
+
+/** Sizes and maps the file of a new queue, and writes an empty queue to it. */
+static bool init_file(Queue* queue, size_t cap) {
+    if (ftruncate(queue->fd, (off_t)file_size(queue, cap)) != 0) return false;
+    if (!map_file(queue, file_size(queue, cap))) return false;
+
+    struct mmap_header* hdr = queue->hdr;
+    memcpy(hdr->magic, MMAP_MAGIC, sizeof(MMAP_MAGIC));
+    hdr->version   = MMAP_VERSION;
+    hdr->elemsz    = queue->elemsz;
+    hdr->active    = 0;
+    hdr->states[0] = (struct mmap_state){ .cap = cap, .start = 0, .nelems = 0 };
+    queue->cap     = cap;
+    return true;
+}
+
+/**
+ * Creates an empty queue with an underlying array of capacity `cap`, backed
+ * by a temporary file that is removed as soon as it is created.
+ */
+static Queue* create_temp(size_t elem_sz, size_t cap) {
+    char const* dir = getenv("TMPDIR");
+    if (dir == NULL || *dir == '\0') dir = "/tmp";
+
+    size_t const len  = strlen(dir) + sizeof("/queue_mmap_XXXXXX");
+    char*        path = malloc(len);
+    if (path == NULL) return NULL;
+
+    snprintf(path, len, "%s/queue_mmap_XXXXXX", dir);
+    int const fd = mkstemp(path);
+    if (fd >= 0) unlink(path);
+    free(path);
+    if (fd < 0) return NULL;
+
+    Queue* q = create(fd, elem_sz);
+    if (q == NULL) return NULL;
+    if (!init_file(q, cap)) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    return q;
+}
+
+Queue* Queue_create(size_t elem_sz) { return create_temp(elem_sz, INIT_CAP); }
+
+Queue* Queue_create_ring(size_t elem_sz, size_t cap) {
+    if (cap == 0) return NULL;
+
+    // Size the file once and for all
+    Queue* q = create_temp(elem_sz, cap);
+    if (q == NULL) return NULL;
+
+    q->ring = true;
+    return q;
+}
+
+Queue* Queue_create_owned(void (*destroy)(void* elem)) {
+    Queue* q = Queue_create(sizeof(void*));
+    if (q == NULL) return NULL;
+
+    q->owned   = true;
+    q->destroy = destroy;
+    return q;
+}
+
+Queue* Queue_create_like(Queue* queue) {
+    assert(queue != NULL);
+
+    Queue* q = Queue_create(queue->elemsz);
+    if (q == NULL) return NULL;
+
+    q->owned   = queue->owned;
+    q->destroy = queue->destroy;
+    return q;
+}
+
+/** Passes an element of a queue that owns its elements to their destructor. */
+static void destroy_owned(void const* elem, void* ctx) {
+    void* owned = NULL;
+    memcpy(&owned, elem, sizeof(void*));
+    ((Queue*)ctx)->destroy(owned);
+}
+
+/**
+ * Recovers the state of a queue from the header of its file, of `size`
+ * bytes, which is mapped.
+ */
+static bool recover(Queue* queue, size_t size) {
+    struct mmap_header const* hdr = queue->hdr;
+    if (memcmp(hdr->magic, MMAP_MAGIC, sizeof(MMAP_MAGIC)) != 0 ||
+        hdr->version != MMAP_VERSION || hdr->elemsz != queue->elemsz ||
+        hdr->active > 1) {
+        return false;
+    }
+
+    struct mmap_state const s = hdr->states[hdr->active];
+    if (s.cap == 0 || s.cap > (size - HEADER_SZ) / queue->elemsz ||
+        s.start >= s.cap || s.nelems > s.cap) {
+        return false;
+    }
+
+    queue->cap    = (size_t)s.cap;
+    queue->start  = (size_t)s.start;
+    queue->nelems = (size_t)s.nelems;
+    return true;
+}
+
+Queue* Queue_open(char const* path, size_t elem_sz) {
+    int const fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) return NULL;
+
+    struct stat st;
+    Queue*      q = create(fd, elem_sz);
+    if (q == NULL) return NULL;
+
+    bool ok = elem_sz > 0 && fstat(fd, &st) == 0;
+    if (ok && st.st_size == 0) {
+        ok = init_file(q, INIT_CAP);
+    } else if (ok) {
+        size_t const size = (size_t)st.st_size;
+        ok = size > HEADER_SZ && map_file(q, size) && recover(q, size);
+    }
+
+    if (!ok) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    return q;
+}
+
+void Queue_destroy(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->hdr != NULL) {
+        if (queue->destroy != NULL) Queue_for_each(queue, destroy_owned, queue);
+        if (queue->sync_every > 0) (void)Queue_sync(queue);
+        munmap(queue->hdr, queue->mapsz);
+    }
+    close(queue->fd);
+    free(queue);
+}
+
+bool Queue_sync(Queue* queue) {
+    assert(queue != NULL);
+
+    // Sync the elements before the state that refers to them
+    bool         ok     = true;
+    size_t const pagesz = (size_t)sysconf(_SC_PAGESIZE);
+    if (queue->dirty_lo < queue->dirty_hi) {
+        size_t const lo = queue->dirty_lo / pagesz * pagesz;
+        ok = msync((char*)queue->hdr + lo, queue->dirty_hi - lo, MS_SYNC) == 0;
+    }
+    ok = ok && msync(queue->hdr, HEADER_SZ, MS_SYNC) == 0;
+
+    if (ok) {
+        queue->dirty_lo  = 0;
+        queue->dirty_hi  = 0;
+        queue->nunsynced = 0;
+    }
+    return ok;
+}
+
+void Queue_set_sync(Queue* queue, size_t every) {
+    assert(queue != NULL);
+
+    queue->sync_every = every;
+    queue->nunsynced  = 0;
+}
+
+size_t Queue_capacity(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->cap;
+}
+
+bool Queue_empty(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->nelems == 0;
+}
+
+size_t Queue_size(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->nelems;
+}
+
+bool Queue_owned(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->owned;
+}
+
+bool Queue_front(Queue* queue, void* elem) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return false;
+
+    memcpy(elem, queue->elems + (queue->start * queue->elemsz), queue->elemsz);
+    return true;
+}
+
+void const* Queue_peek(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    return queue->elems + (queue->start * queue->elemsz);
+}
+
+/**
+ * Computes the underlying array position that corresponds to one past the last
+ * element in a queue.
+ */
+static size_t end(Queue* queue) {
+    return (queue->start + queue->nelems) % queue->cap;
+}
+
+/**
+ * Grows the underlying array of a queue to `new_cap`, at least twice its
+ * capacity, and commits the new capacity.
+ */
+static bool grow(Queue* queue, size_t new_cap) {
+    assert(new_cap >= 2 * queue->cap && "new capacity too small");
+
+    size_t const size = file_size(queue, new_cap);
+    if (ftruncate(queue->fd, (off_t)size) != 0) return false;
+    if (!map_file(queue, size)) return false;
+
+    // Copy the elements wrapped around past the end of the old array
+    size_t const ntail = queue->cap - queue->start;
+    if (queue->nelems > ntail) {
+        size_t const nwrapped = queue->nelems - ntail;
+        memcpy(queue->elems + (queue->cap * queue->elemsz), queue->elems,
+               nwrapped * queue->elemsz);
+        mark_dirty(queue, queue->cap, nwrapped);
+    }
+
+    queue->cap = new_cap;
+    commit(queue);
+    return true;
+}
+
+/**
+ * Flags a queue as congested and arms its low watermark. Called only on the
+ * transition so that no extra work is done on each operation.
+ */
+static void cross_high(Queue* queue) {
+    queue->congested = true;
+    queue->hitrig    = SIZE_MAX;
+    queue->lotrig    = queue->lowm + 1;
+    if (queue->on_high != NULL) queue->on_high(queue, queue->wm_ctx);
+}
+
+/** Flags a queue as decongested and re-arms its high watermark. */
+static void cross_low(Queue* queue) {
+    queue->congested = false;
+    queue->hitrig    = queue->highm;
+    queue->lotrig    = 0;
+    if (queue->on_low != NULL) queue->on_low(queue, queue->wm_ctx);
+}
+
+/**
+ * Drops the front elements of a full ring so that `n` more elements fit, and
+ * commits the drop before the slots are overwritten.
+ */
+static void drop_to_fit(Queue* queue, size_t n) {
+    size_t const free_slots = queue->cap - queue->nelems;
+    if (n <= free_slots) return;
+
+    size_t const ndrop = n - free_slots;
+    queue->nelems   -= ndrop;
+    queue->start     = (queue->start + ndrop) % queue->cap;
+    queue->ndropped += ndrop;
+    commit(queue);
+}
+
+bool Queue_enqueue(Queue* queue, void const* elem) {
+    assert(queue != NULL);
+
+    // Overwrite the front element of a full ring, leaving the size unchanged
+    if (queue->ring && queue->nelems == queue->cap) {
+        drop_to_fit(queue, 1);
+    } else {
+        // Reject element if the queue has reached its size limit
+        if (queue->nelems >= queue->limit) return false;
+
+        // Grow underlying array if it is full
+        if (queue->nelems == queue->cap && !grow(queue, queue->cap * 2)) {
+            return false;
+        }
+    }
+
+    // Write the element before committing the state that includes it
+    size_t const back = end(queue);
+    memcpy(queue->elems + (back * queue->elemsz), elem, queue->elemsz);
+    mark_dirty(queue, back, 1);
+    queue->nelems += 1;
+    commit(queue);
+    count_added(queue, 1);
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_enqueue_owned(Queue* queue, void* elem) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    return Queue_enqueue(queue, &elem);
+}
+
+bool Queue_dequeue(Queue* queue) {
+    assert(queue != NULL);
+
+    return Queue_dequeue_n(queue, 1);
+}
+
+bool Queue_dequeue_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (n > queue->nelems) return false;
+    if (n == 0) return true;
+
+    queue->nelems -= n;
+    queue->start  = (queue->start + n) % queue->cap;
+    commit(queue);
+
+    if (queue->nelems < queue->lotrig) cross_low(queue);
+    return true;
+}
+
+void* Queue_take_front(Queue* queue) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    void* elem = NULL;
+    if (!Queue_front(queue, &elem)) return NULL;
+
+    Queue_dequeue(queue);
+    return elem;
+}
+
+bool Queue_discard_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (queue->destroy == NULL) return Queue_dequeue_n(queue, n);
+    if (n > queue->nelems) return false;
+
+    for (size_t i = 0; i < n; ++i) queue->destroy(Queue_take_front(queue));
+    return true;
+}
+
+void Queue_print(Queue* queue, char const* sep, bool vertical,
+                 void (*print_element)(void const*)) {
+    assert(queue != NULL);
+    if (sep == NULL) sep = ",";
+
+    size_t const n_elems = queue->nelems;
+
+    // Wrap around the end of the array instead of computing each position
+    char const* elem = queue->elems + (queue->start * queue->elemsz);
+    char const* last = queue->elems + (queue->cap * queue->elemsz);
+    for (size_t i = 0; i < n_elems; ++i) {
+        if (vertical) printf("[%lu] ", i);
+        print_element(elem);
+        vertical ? printf("\n")
+                 : ((i == n_elems - 1) ? printf("%s", "") : printf("%s", sep));
+        elem += queue->elemsz;
+        if (elem == last) elem = queue->elems;
+    }
+}
+
+bool Queue_set_watermarks(Queue* queue, size_t low, size_t high,
+                          WatermarkCallback on_high, WatermarkCallback on_low,
+                          void* ctx) {
+    assert(queue != NULL);
+
+    if (high > 0 && low >= high) return false;
+
+    queue->lowm      = low;
+    queue->highm     = high;
+    queue->on_high   = on_high;
+    queue->on_low    = on_low;
+    queue->wm_ctx    = ctx;
+    queue->congested = false;
+    queue->hitrig    = high > 0 ? high : SIZE_MAX;
+    queue->lotrig    = 0;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_congested(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->congested;
+}
+
+void Queue_set_limit(Queue* queue, size_t limit) {
+    assert(queue != NULL);
+
+    queue->limit = limit > 0 ? limit : SIZE_MAX;
+}
+
+size_t Queue_dropped(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->ndropped;
+}
+
+bool Queue_reserve(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (n <= queue->cap) return true;
+    if (queue->ring) return false;
+
+    // Grow geometrically so that repeated reservations stay amortized O(1)
+    size_t new_cap = queue->cap;
+    while (new_cap < n) new_cap *= 2;
+
+    return grow(queue, new_cap);
+}
+
+/**
+ * Makes room for `n` more elements in a queue, dropping front elements of a
+ * full ring as needed, and growing the array of any other queue.
+ */
+static bool make_room(Queue* queue, size_t n) {
+    if (!queue->ring) return Queue_reserve(queue, queue->nelems + n);
+    if (n > queue->cap) return false;
+
+    drop_to_fit(queue, n);
+    return true;
+}
+
+/** Computes the size of a queue after `n` elements are added to it. */
+static size_t size_after(Queue* queue, size_t n) {
+    if (queue->ring && queue->nelems + n > queue->cap) return queue->cap;
+    return queue->nelems + n;
+}
+
+/**
+ * Copies `n` elements from a contiguous memory block to the end of a queue of
+ * sufficient capacity, wrapping around the underlying array at most once. The
+ * elements are not committed.
+ */
+static void append(Queue* queue, void const* elems, size_t n) {
+    assert(queue->nelems + n <= queue->cap && "insufficient capacity");
+
+    size_t const back   = end(queue);
+    size_t const nhead  = n < queue->cap - back ? n : queue->cap - back;
+    size_t const headsz = nhead * queue->elemsz;   // number of bytes
+
+    memcpy(queue->elems + (back * queue->elemsz), elems, headsz);
+    memcpy(queue->elems, (char const*)elems + headsz,
+           (n - nhead) * queue->elemsz);
+    mark_dirty(queue, back, nhead);
+    mark_dirty(queue, 0, n - nhead);
+    queue->nelems += n;
+}
+
+bool Queue_transfer(Queue* dst, Queue* src, size_t n) {
+    assert(dst != NULL && src != NULL);
+    assert(dst != src && "cannot transfer elements within the same queue");
+    assert(dst->elemsz == src->elemsz && "element sizes differ");
+
+    if (n > src->nelems) return false;
+    if (size_after(dst, n) > dst->limit) return false;
+    if (!make_room(dst, n)) return false;
+
+    // Copy the elements in at most two contiguous runs of the source array,
+    // and commit them to the destination before removing them from the source
+    size_t const nhead = n < src->cap - src->start ? n : src->cap - src->start;
+    append(dst, src->elems + (src->start * src->elemsz), nhead);
+    append(dst, src->elems, n - nhead);
+    commit(dst);
+    count_added(dst, n);
+
+    src->nelems -= n;
+    src->start  = (src->start + n) % src->cap;
+    commit(src);
+
+    if (dst->nelems >= dst->hitrig) cross_high(dst);
+    if (src->nelems < src->lotrig) cross_low(src);
+    return true;
+}
+
+void* Queue_segment(Queue* queue, void const* prev, size_t* len) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    char*        first = queue->elems + (queue->start * queue->elemsz);
+    size_t const ntail = queue->cap - queue->start;   // number of elems
+
+    // Elements up to the end of the underlying array come first
+    if (prev == NULL) {
+        *len = queue->nelems < ntail ? queue->nelems : ntail;
+        return first;
+    }
+
+    // Elements wrapped around to the start of the array, if any, come next
+    if (prev == first && queue->nelems > ntail) {
+        *len = queue->nelems - ntail;
+        return queue->elems;
+    }
+
+    return NULL;
+}
+
+void Queue_for_each(Queue* queue, void (*visit)(void const* elem, void* ctx),
+                    void* ctx) {
+    assert(queue != NULL);
+    assert(visit != NULL && "visit is not a function");
+
+    size_t const elem_sz = queue->elemsz;
+    size_t       len     = 0;
+    char const*  seg     = NULL;
+    while ((seg = Queue_segment(queue, seg, &len)) != NULL) {
+        char const* const last = seg + len * elem_sz;
+        for (char const* elem = seg; elem != last; elem += elem_sz) {
+            visit(elem, ctx);
+        }
+    }
+}
+
+void Queue_fold(Queue* queue, void* acc,
+                void (*combine)(void* acc, void const* elem)) {
+    assert(queue != NULL);
+    assert(combine != NULL && "combine is not a function");
+
+    size_t const elem_sz = queue->elemsz;
+    size_t       len     = 0;
+    char const*  seg     = NULL;
+    while ((seg = Queue_segment(queue, seg, &len)) != NULL) {
+        char const* const last = seg + len * elem_sz;
+        for (char const* elem = seg; elem != last; elem += elem_sz) {
+            combine(acc, elem);
+        }
+    }
+}
+
+/** Reverses the bytes in the range `[first, last)`. */
+static void reverse_bytes(char* first, char* last) {
+    while (first < last) {
+        char const tmp = *first;
+        *first++       = *--last;
+        *last          = tmp;
+    }
+}
+
+void* Queue_linearize(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+    if (queue->start + queue->nelems <= queue->cap) {
+        return queue->elems + (queue->start * queue->elemsz);
+    }
+
+    // Rotate a ring in place, since its array cannot grow. Unlike any other
+    // operation, this is not atomic with respect to a crash
+    if (queue->ring) {
+        char* const  arr   = queue->elems;
+        size_t const split = queue->start * queue->elemsz;
+        size_t const arrsz = queue->cap * queue->elemsz;
+        reverse_bytes(arr, arr + split);
+        reverse_bytes(arr + split, arr + arrsz);
+        reverse_bytes(arr, arr + arrsz);
+        mark_dirty(queue, 0, queue->cap);
+        queue->start = 0;
+        commit(queue);
+        return queue->elems;
+    }
+
+    // Unwrap the elements into the free part of the array if they fit there,
+    // or else by growing the array, either of which keeps the old state valid
+    // throughout, unlike moving them over themselves
+    if (queue->nelems > queue->cap / 2) {
+        if (!grow(queue, queue->cap * 2)) return NULL;
+        return queue->elems + (queue->start * queue->elemsz);
+    }
+
+    size_t const ntail    = queue->cap - queue->start;
+    size_t const nwrapped = queue->nelems - ntail;
+    char* const  dst      = queue->elems + (nwrapped * queue->elemsz);
+    memcpy(dst, queue->elems + (queue->start * queue->elemsz),
+           ntail * queue->elemsz);
+    memcpy(dst + (ntail * queue->elemsz), queue->elems,
+           nwrapped * queue->elemsz);
+    mark_dirty(queue, nwrapped, queue->nelems);
+    queue->start = nwrapped;
+    commit(queue);
+    return dst;
+}
+
+bool Queue_extend(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    // An owned queue holds only the addresses handed over to it
+    if (queue->owned) return false;
+
+    if (size_after(queue, n) > queue->limit) return false;
+    if (!make_room(queue, n)) return false;
+
+    // The caller writes the elements, which are synced with the others
+    size_t const back  = end(queue);
+    size_t const nhead = n < queue->cap - back ? n : queue->cap - back;
+    mark_dirty(queue, back, nhead);
+    mark_dirty(queue, 0, n - nhead);
+    queue->nelems += n;
+    commit(queue);
+    count_added(queue, n);
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+/** Magic bytes at the start of a queue written by `Queue_save()`. */
+static char const MAGIC[4] = { 'C', 'D', 'S', 'Q' };
+
+/** Version of the format written by `Queue_save()`. */
+static uint32_t const FORMAT_VERSION = 1;
+
+/** Header of a queue written by `Queue_save()`, 24 bytes with no padding. */
+struct file_header
+{
+    char     magic[4];   // `MAGIC`.
+    uint32_t version;    // `FORMAT_VERSION`.
+    uint64_t elemsz;     // Element size in bytes.
+    uint64_t nelems;     // Number of elements that follow.
+};
+
+/**
+ * Transfers the buffers of `iov` to or from a file in full, resuming after
+ * partial transfers and interruptions. Reaching the end of the file before
+ * the last buffer is an error.
+ */
+static bool transfer_all(int fd, struct iovec* iov, int iovcnt, bool write) {
+    while (iovcnt > 0) {
+        ssize_t const res =
+            write ? writev(fd, iov, iovcnt) : readv(fd, iov, iovcnt);
+        if (res < 0 && errno == EINTR) continue;
+        if (res < 0) return false;
+
+        // Skip the buffers transferred in full, then the part of the next
+        size_t done = (size_t)res;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt == 0) break;
+        if (res == 0) return false;
+
+        iov->iov_base  = (char*)iov->iov_base + done;
+        iov->iov_len  -= done;
+    }
+    return true;
+}
+
+bool Queue_save(Queue* queue, int fd) {
+    assert(queue != NULL);
+
+    // The addresses of owned elements are meaningless once loaded
+    if (queue->owned) {
+        errno = EINVAL;
+        return false;
+    }
+
+    struct file_header hdr = { .version = FORMAT_VERSION,
+                               .elemsz  = queue->elemsz,
+                               .nelems  = queue->nelems };
+    memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+
+    // The elements up to the end of the array, then those wrapped around
+    size_t const ntail = queue->cap - queue->start;
+    size_t const nhead = queue->nelems < ntail ? queue->nelems : ntail;
+    struct iovec iov[3] = {
+        { &hdr, sizeof(hdr) },
+        { queue->elems + (queue->start * queue->elemsz),
+          nhead * queue->elemsz },
+        { queue->elems, (queue->nelems - nhead) * queue->elemsz }
+    };
+    return transfer_all(fd, iov, 3, true);
+}
+
+/**
+ * Determines whether a regular file holds fewer than `nbytes` bytes past its
+ * current offset, so that a corrupt header cannot make a load allocate more
+ * than the file could fill. Other files are read until they run out instead.
+ */
+static bool is_short_file(int fd, uint64_t nbytes) {
+    struct stat st;
+    off_t const pos = lseek(fd, 0, SEEK_CUR);
+    return pos >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+           (st.st_size < pos || (uint64_t)(st.st_size - pos) < nbytes);
+}
+
+Queue* Queue_load(int fd, size_t elem_sz) {
+    struct file_header hdr;
+    struct iovec       iov = { &hdr, sizeof(hdr) };
+    if (!transfer_all(fd, &iov, 1, false)) return NULL;
+    if (memcmp(hdr.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        hdr.version != FORMAT_VERSION || hdr.elemsz != elem_sz ||
+        elem_sz == 0 || hdr.nelems > SIZE_MAX / elem_sz ||
+        is_short_file(fd, hdr.nelems * elem_sz)) {
+        return NULL;
+    }
+
+    // Size the file at the exact size, and read the elements right in
+    size_t const n = (size_t)hdr.nelems;
+    Queue*       q = create_temp(elem_sz, n > 0 ? n : INIT_CAP);
+    if (q == NULL) return NULL;
+
+    iov = (struct iovec){ q->elems, n * elem_sz };
+    if (!transfer_all(fd, &iov, 1, false)) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    mark_dirty(q, 0, n);
+    q->nelems = n;
+    commit(q);
+    return q;
+}
@@ -0,0 +1,108 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      queue_mmap.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Extensions to the Queue ADT for persistent, file-backed queues.
+ *
+ * The `libqueuemmap` implementation of the Queue ADT keeps its elements in a
+ * circular array inside a memory-mapped file, so that a queue survives the
+ * crash of the process that uses it and is not bounded by the heap. Queues
+ * created with `Queue_create()` are backed by a temporary file that is
+ * removed when they are destroyed, while queues opened with `Queue_open()`
+ * are backed by a file of the caller's choosing and can be opened again, by
+ * the same or another process, to carry on from their last state.
+ *
+ * The state of a queue is committed to its file after each operation that
+ * modifies it, without any system call. Elements committed are never lost
+ * when the process crashes. They are only durable across a system crash once
+ * synced to storage, either explicitly with `Queue_sync()` or periodically as
+ * set with `Queue_set_sync()`. A crash during `Queue_transfer()` may leave
+ * the elements transferred in both queues, but never in neither, and one
+ * before the elements added by `Queue_extend()` are written leaves them
+ * unspecified.
+ *
+ * A file must not be opened by more than one queue at a time.
+ */
+
+#ifndef QUEUE_MMAP_H
+#define QUEUE_MMAP_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+
+#include "queue.h"   // Queue
+
+/**
+ * @brief Opens a persistent queue backed by a file, creating an empty one if
+ * the file does not exist or is empty.
+ *
+ * If the file holds a queue, its state is recovered as of the last operation
+ * committed, even if the process that last used it crashed.
+ *
+ * It's the caller's responsibility to
+ * -# call `Queue_destroy()` to unmap and close the file when the queue is no
+ *    longer needed, which leaves the file in place; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] path Path to the file that backs the queue.
+ * @param[in] elem_sz Size of each queue elements in bytes, which must match
+ *      that of the queue held by the file, if any.
+ * @return The queue opened on success, `NULL` if the file cannot be opened or
+ *      mapped, or holds something other than a queue of `elem_sz` elements.
+ */
+Queue* Queue_open(char const* path, size_t elem_sz);
+
+/**
+ * @brief Writes the elements and state of a queue through to storage.
+ *
+ * @param[in] queue The queue to sync.
+ * @return `false` if the file cannot be synced, `true` otherwise (on
+ *      success).
+ */
+bool Queue_sync(Queue* queue);
+
+/**
+ * @brief Makes a queue sync itself to storage periodically as elements are
+ * added, and when it is destroyed.
+ *
+ * @param[in] queue The queue to sync.
+ * @param[in] every Number of elements added between syncs. Pass `0` to only
+ *      sync when `Queue_sync()` is called, the default.
+ */
+void Queue_set_sync(Queue* queue, size_t every);
+
+#endif /* QUEUE_MMAP_H */
@@ -0,0 +1,970 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @brief Implementation of the ADT queue as an unbounded queue that keeps its
+ * front and back elements in memory, and spills the rest to disk.
+ *
+ * Elements are kept in three tiers, in queue order: a circular array of two
+ * blocks (the head), a list of segment files, and a linear array of one block
+ * (the tail). New elements go to the head while the other tiers are empty,
+ * and to the tail otherwise, which is appended to the last segment file once
+ * full. As elements are removed from the head, it is refilled a block at a
+ * time from the first segment file, or else from the tail, so that reading
+ * from disk stays ahead of the consumer.
+ */
+
+#define _POSIX_C_SOURCE 200809L   // pread(), pwrite(), mkstemp()
+
+#include "queue.h"
+#include "queue_spill.h"
+
+#include <assert.h>      // assert()
+#include <stdint.h>      // SIZE_MAX, uint32_t, uint64_t
+#include <stdlib.h>      // malloc(), free(), getenv(), mkstemp()
+#include <string.h>      // memcpy(), memmove(), memcmp(), strlen()
+#include <stdio.h>       // printf(), snprintf()
+#include <errno.h>       // errno, EINTR
+#include <unistd.h>      // close(), unlink(), pread(), pwrite()
+#include <sys/uio.h>     // struct iovec, writev(), readv()
+
+// clang-format off
+#ifdef QUEUE_SPILL_BLOCK_CAP
+size_t const BLOCK_CAP = QUEUE_SPILL_BLOCK_CAP; /** Elements per block */
+#else
+size_t const BLOCK_CAP = 0; /** Elements per block, 0 to fit the budget */
+#endif
+// clang-format on
+
+/** Memory budget of a queue created with `Queue_create()`, in bytes. */
+#define DEFAULT_MEM_SZ ((size_t)64 << 20)
+
+/** Number of blocks written to a segment file before starting another. */
+#define SEG_BLOCKS 64
+
+// -----------------------------------------------------------------------------
+
+/** A segment file, which holds elements between the head and the tail. */
+struct segment
+{
+    int             fd;       // Unlinked file that holds the elements.
+    size_t          nelems;   // Number of elements written to the file.
+    size_t          nread;    // Number of elements read back or removed.
+    struct segment* next;     // Segment file written after this one.
+};
+
+struct queue
+{
+    size_t elemsz;     // Element size in bytes.
+    size_t nelems;     // Number of elements in the queue.
+    size_t limit;      // Maximum number of elements accepted by enqueue.
+    size_t blk;        // Number of elements read or written at once.
+    bool   ring;       // Whether the head is fixed and overwritten when full.
+    size_t ndropped;   // Number of elements overwritten when full.
+
+    bool owned;                    // Whether elements are owned pointers.
+    void (*destroy)(void* elem);   // Destructor of the elements owned.
+
+    char*  head;     // Circular array that stores the front elements.
+    size_t hcap;     // Capacity of the head.
+    size_t hstart;   // Position of the front element in the head.
+    size_t nhead;    // Number of elements in the head.
+
+    struct segment* first;      // Segment file to read back from next.
+    struct segment* last;       // Segment file to write to next.
+    size_t          nspilled;   // Number of elements in segment files.
+    char*           dir;        // Directory in which to create segment files.
+
+    char*  tail;    // Array of `blk` elements that stores the back elements.
+    size_t ntail;   // Number of elements in the tail.
+
+    char*  stage;    // Block to access elements on disk in, `NULL` until used.
+    size_t itpos;    // Position of the segment to return next.
+    size_t stpos;    // Position of the elements staged by `Queue_segment()`.
+    size_t stlen;    // Number of elements staged, to write back if nonzero.
+
+    size_t            lowm;        // Low watermark.
+    size_t            highm;       // High watermark, zero if not set.
+    size_t            hitrig;      // Size at or above which to cross high.
+    size_t            lotrig;      // Size below which to cross low.
+    bool              congested;   // Whether the high watermark is crossed.
+    WatermarkCallback on_high;     // Called when the queue becomes congested.
+    WatermarkCallback on_low;      // Called when the queue is decongested.
+    void*             wm_ctx;      // User context passed to the callbacks.
+};
+
+/** Returns the lesser of two sizes. */
+static size_t min_size(size_t a, size_t b) { return a < b ? a : b; }
+
+/**
+ * Creates an empty queue with a head of capacity `hcap`, and blocks of `blk`
+ * elements for a tail, or no tail if `blk` is zero. Segment files go to `dir`,
+ * or to the default temporary directory if `NULL`.
+ */
+static Queue* create(size_t elem_sz, size_t hcap, size_t blk, char const* dir) {
+    if (dir == NULL) dir = getenv("TMPDIR");
+    if (dir == NULL || *dir == '\0') dir = "/tmp";
+
+    Queue* q = malloc(sizeof(Queue));
+    if (q == NULL) return NULL;
+
+    q->elemsz    = elem_sz;
+    q->nelems    = 0;
+    q->limit     = SIZE_MAX;
+    q->blk       = blk;
+    q->ring      = blk == 0;
+    q->ndropped  = 0;
+    q->owned     = false;
+    q->destroy   = NULL;
+    q->head      = malloc(hcap * elem_sz);
+    q->hcap      = hcap;
+    q->hstart    = 0;
+    q->nhead     = 0;
+    q->first     = NULL;
+    q->last      = NULL;
+    q->nspilled  = 0;
+    q->dir       = malloc(strlen(dir) + 1);
+    q->tail      = blk > 0 ? malloc(blk * elem_sz) : NULL;
+    q->ntail     = 0;
+    q->stage     = NULL;
+    q->itpos     = 0;
+    q->stpos     = 0;
+    q->stlen     = 0;
+    q->lowm      = 0;
+    q->highm     = 0;
+    q->hitrig    = SIZE_MAX;
+    q->lotrig    = 0;
+    q->congested = false;
+    q->on_high   = NULL;
+    q->on_low    = NULL;
+    q->wm_ctx    = NULL;
+
+    if (q->head == NULL || q->dir == NULL || (blk > 0 && q->tail == NULL)) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    memcpy(q->dir, dir, strlen(dir) + 1);
+    return q;
+}
+
+Queue* Queue_create_spill(size_t elem_sz, size_t mem_sz, char const* dir) {
+    size_t blk = mem_sz / elem_sz / 4;
+    if (blk == 0) blk = 1;
+
+    return create(elem_sz, 2 * blk, blk, dir);
+}
+
+Queue* Queue_create(size_t elem_sz) {
+    if (BLOCK_CAP > 0) return create(elem_sz, 2 * BLOCK_CAP, BLOCK_CAP, NULL);
+
+    return Queue_create_spill(elem_sz, DEFAULT_MEM_SZ, NULL);
+}
+
+Queue* Queue_create_ring(size_t elem_sz, size_t cap) {
+    if (cap == 0) return NULL;
+
+    // The head holds all elements, so nothing is ever spilled
+    return create(elem_sz, cap, 0, NULL);
+}
+
+Queue* Queue_create_owned(void (*destroy)(void* elem)) {
+    Queue* q = Queue_create(sizeof(void*));
+    if (q == NULL) return NULL;
+
+    q->owned   = true;
+    q->destroy = destroy;
+    return q;
+}
+
+Queue* Queue_create_like(Queue* queue) {
+    assert(queue != NULL);
+
+    // Keep the memory budget and directory of a queue that spills
+    Queue* q = queue->ring ? Queue_create(queue->elemsz)
+                           : create(queue->elemsz, 2 * queue->blk, queue->blk,
+                                    queue->dir);
+    if (q == NULL) return NULL;
+
+    q->owned   = queue->owned;
+    q->destroy = queue->destroy;
+    return q;
+}
+
+/** Passes an element of a queue that owns its elements to their destructor. */
+static void destroy_owned(void const* elem, void* ctx) {
+    void* owned = NULL;
+    memcpy(&owned, elem, sizeof(void*));
+    ((Queue*)ctx)->destroy(owned);
+}
+
+/** Closes the first segment file of a queue and removes it from the list. */
+static void pop_segment(Queue* queue) {
+    struct segment* seg = queue->first;
+    queue->first        = seg->next;
+    if (queue->first == NULL) queue->last = NULL;
+
+    close(seg->fd);
+    free(seg);
+}
+
+void Queue_destroy(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->destroy != NULL) Queue_for_each(queue, destroy_owned, queue);
+    while (queue->first != NULL) pop_segment(queue);
+    free(queue->head);
+    free(queue->tail);
+    free(queue->stage);
+    free(queue->dir);
+    free(queue);
+}
+
+size_t Queue_capacity(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->ring ? queue->hcap : SIZE_MAX;
+}
+
+bool Queue_reserve(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    return !queue->ring || n <= queue->hcap;
+}
+
+bool Queue_empty(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->nelems == 0;
+}
+
+size_t Queue_size(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->nelems;
+}
+
+bool Queue_owned(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->owned;
+}
+
+size_t Queue_spilled(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->nspilled;
+}
+
+/**
+ * Reads or writes `len` bytes of a file at offset `off` in full, resuming
+ * after partial transfers and interruptions.
+ */
+static bool transfer_at(int fd, char* buf, size_t len, size_t off,
+                        bool write) {
+    while (len > 0) {
+        ssize_t const res = write ? pwrite(fd, buf, len, (off_t)off)
+                                  : pread(fd, buf, len, (off_t)off);
+        if (res < 0 && errno == EINTR) continue;
+        if (res <= 0) return false;
+
+        buf += res;
+        off += (size_t)res;
+        len -= (size_t)res;
+    }
+    return true;
+}
+
+/** Copies `n` elements, or leaves them unspecified if `elems` is `NULL`, to
+ * the end of the head of a queue, which must have room for them. */
+static void head_append(Queue* queue, char const* elems, size_t n) {
+    assert(queue->nhead + n <= queue->hcap && "insufficient capacity");
+
+    size_t const back  = (queue->hstart + queue->nhead) % queue->hcap;
+    size_t const nhead = min_size(n, queue->hcap - back);
+    if (elems != NULL) {
+        memcpy(queue->head + back * queue->elemsz, elems,
+               nhead * queue->elemsz);
+        memcpy(queue->head, elems + nhead * queue->elemsz,
+               (n - nhead) * queue->elemsz);
+    }
+    queue->nhead += n;
+}
+
+/** Removes the first `n` elements of the tail of a queue. */
+static void tail_remove(Queue* queue, size_t n) {
+    queue->ntail -= n;
+    if (queue->ntail == 0) return;   // the tail may not be allocated yet
+    memmove(queue->tail, queue->tail + n * queue->elemsz,
+            queue->ntail * queue->elemsz);
+}
+
+/**
+ * Moves elements from disk, or else from the tail, to the head of a queue
+ * while it has room for a block of them.
+ */
+static bool refill(Queue* queue) {
+    size_t const elem_sz = queue->elemsz;
+    while (queue->nspilled > 0 && queue->hcap - queue->nhead >= queue->blk) {
+        struct segment* seg = queue->first;
+        size_t const    n   = min_size(queue->blk, seg->nelems - seg->nread);
+
+        // Read into the free part of the head, which may wrap around
+        size_t const back  = (queue->hstart + queue->nhead) % queue->hcap;
+        size_t const nhead = min_size(n, queue->hcap - back);
+        size_t const off   = seg->nread * elem_sz;
+        if (!transfer_at(seg->fd, queue->head + back * elem_sz,
+                         nhead * elem_sz, off, false) ||
+            !transfer_at(seg->fd, queue->head, (n - nhead) * elem_sz,
+                         off + nhead * elem_sz, false)) {
+            return false;
+        }
+
+        queue->nhead    += n;
+        queue->nspilled -= n;
+        seg->nread      += n;
+        if (seg->nread == seg->nelems) pop_segment(queue);
+    }
+
+    // The whole tail fits in a block, so it is never moved piecemeal
+    if (queue->nspilled == 0 && queue->ntail > 0 &&
+        queue->hcap - queue->nhead >= queue->blk) {
+        head_append(queue, queue->tail, queue->ntail);
+        queue->ntail = 0;
+    }
+    return true;
+}
+
+/** Writes the tail of a queue to the end of its last segment file. */
+static bool spill_tail(Queue* queue) {
+    size_t const    elem_sz = queue->elemsz;
+    struct segment* seg     = queue->last;
+
+    // Start a new segment file once the last one is full
+    bool const is_new =
+        seg == NULL || seg->nelems + queue->ntail > SEG_BLOCKS * queue->blk;
+    if (is_new) {
+        size_t const len  = strlen(queue->dir) + sizeof("/queue_spill_XXXXXX");
+        char*        path = malloc(len);
+        seg               = malloc(sizeof(struct segment));
+        if (path == NULL || seg == NULL) {
+            free(path);
+            free(seg);
+            return false;
+        }
+
+        snprintf(path, len, "%s/queue_spill_XXXXXX", queue->dir);
+        seg->fd = mkstemp(path);
+        if (seg->fd >= 0) unlink(path);
+        free(path);
+        if (seg->fd < 0) {
+            free(seg);
+            return false;
+        }
+        seg->nelems = 0;
+        seg->nread  = 0;
+        seg->next   = NULL;
+    }
+
+    if (!transfer_at(seg->fd, queue->tail, queue->ntail * elem_sz,
+                     seg->nelems * elem_sz, true)) {
+        if (is_new) {
+            close(seg->fd);
+            free(seg);
+        }
+        return false;
+    }
+
+    if (is_new) {
+        if (queue->last != NULL) queue->last->next = seg;
+        if (queue->first == NULL) queue->first = seg;
+        queue->last = seg;
+    }
+    seg->nelems     += queue->ntail;
+    queue->nspilled += queue->ntail;
+    queue->ntail     = 0;
+    return true;
+}
+
+/** Removes the last `n` elements of a queue, wherever they are. */
+static void remove_back(Queue* queue, size_t n) {
+    size_t const ntail = min_size(n, queue->ntail);
+    queue->ntail -= ntail;
+    n            -= ntail;
+
+    // Elements written to the last segment files are overwritten later
+    while (n > 0 && queue->last != NULL) {
+        struct segment* seg = queue->last;
+        size_t const    k   = min_size(n, seg->nelems - seg->nread);
+        seg->nelems     -= k;
+        queue->nspilled -= k;
+        n               -= k;
+        if (seg->nelems > seg->nread) break;
+
+        // Unlink the empty segment file from the end of the list
+        struct segment* prev = queue->first;
+        while (prev != seg && prev->next != seg) prev = prev->next;
+        if (prev == seg) {
+            queue->first = NULL;
+            queue->last  = NULL;
+        } else {
+            prev->next  = NULL;
+            queue->last = prev;
+        }
+        close(seg->fd);
+        free(seg);
+    }
+
+    queue->nhead -= n;
+}
+
+/** Removes the first `n` elements of a queue, wherever they are. */
+static void remove_front(Queue* queue, size_t n) {
+    size_t const nhead = min_size(n, queue->nhead);
+    queue->hstart  = (queue->hstart + nhead) % queue->hcap;
+    queue->nhead  -= nhead;
+    n             -= nhead;
+
+    // Elements on disk are skipped over without being read
+    while (n > 0 && queue->first != NULL) {
+        struct segment* seg = queue->first;
+        size_t const    k   = min_size(n, seg->nelems - seg->nread);
+        seg->nread      += k;
+        queue->nspilled -= k;
+        n               -= k;
+        if (seg->nread == seg->nelems) pop_segment(queue);
+    }
+
+    tail_remove(queue, n);
+}
+
+/**
+ * Copies `n` elements from a contiguous memory block, or adds them with
+ * unspecified values if `elems` is `NULL`, to the end of a queue. On failure,
+ * the queue is left unchanged.
+ */
+static bool append(Queue* queue, char const* elems, size_t n) {
+    size_t const elem_sz = queue->elemsz;
+
+    // The head takes new elements only while nothing follows it
+    size_t added = 0;
+    if (queue->nspilled == 0 && queue->ntail == 0) {
+        added = min_size(n, queue->hcap - queue->nhead);
+        head_append(queue, elems, added);
+    }
+
+    while (added < n) {
+        if (queue->ntail == queue->blk && !spill_tail(queue)) {
+            remove_back(queue, added);
+            return false;
+        }
+
+        size_t const k = min_size(n - added, queue->blk - queue->ntail);
+        if (elems != NULL) {
+            memcpy(queue->tail + queue->ntail * elem_sz,
+                   elems + added * elem_sz, k * elem_sz);
+        }
+        queue->ntail += k;
+        added        += k;
+    }
+
+    queue->nelems += n;
+    return true;
+}
+
+/**
+ * Accesses the run of contiguous elements that starts at position `pos` of a
+ * queue, reading them into the staging block if they are on disk.
+ */
+static char* run_at(Queue* queue, size_t pos, size_t* len) {
+    size_t const elem_sz = queue->elemsz;
+    if (pos >= queue->nelems) return NULL;
+
+    if (pos < queue->nhead) {
+        size_t const first = (queue->hstart + pos) % queue->hcap;
+        *len = min_size(queue->nhead - pos, queue->hcap - first);
+        return queue->head + first * elem_sz;
+    }
+
+    pos -= queue->nhead;
+    if (pos >= queue->nspilled) {
+        *len = queue->ntail - (pos - queue->nspilled);
+        return queue->tail + (pos - queue->nspilled) * elem_sz;
+    }
+
+    // Find the segment file that holds the element
+    struct segment* seg = queue->first;
+    while (pos >= seg->nelems - seg->nread) {
+        pos -= seg->nelems - seg->nread;
+        seg  = seg->next;
+    }
+
+    if (queue->stage == NULL) queue->stage = malloc(queue->blk * elem_sz);
+    if (queue->stage == NULL) return NULL;
+
+    size_t const off = seg->nread + pos;
+    *len             = min_size(queue->blk, seg->nelems - off);
+    if (!transfer_at(seg->fd, queue->stage, *len * elem_sz, off * elem_sz,
+                     false)) {
+        return NULL;
+    }
+    return queue->stage;
+}
+
+/** Writes the elements staged by `Queue_segment()` back to disk. */
+static bool write_back(Queue* queue) {
+    size_t          pos = queue->stpos - queue->nhead;
+    struct segment* seg = queue->first;
+    while (pos >= seg->nelems - seg->nread) {
+        pos -= seg->nelems - seg->nread;
+        seg  = seg->next;
+    }
+
+    size_t const off = (seg->nread + pos) * queue->elemsz;
+    return transfer_at(seg->fd, queue->stage, queue->stlen * queue->elemsz,
+                       off, true);
+}
+
+bool Queue_front(Queue* queue, void* elem) {
+    assert(queue != NULL);
+
+    void const* front = Queue_peek(queue);
+    if (front == NULL) return false;
+
+    memcpy(elem, front, queue->elemsz);
+    return true;
+}
+
+void const* Queue_peek(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    // The head is empty only if refilling it failed before
+    if (queue->nhead == 0 && (!refill(queue) || queue->nhead == 0)) {
+        return NULL;
+    }
+    return queue->head + (queue->hstart * queue->elemsz);
+}
+
+void* Queue_segment(Queue* queue, void const* prev, size_t* len) {
+    assert(queue != NULL);
+
+    // Staged elements, which may have been written, go back where they were
+    if (prev == NULL) {
+        queue->itpos = 0;
+    } else if (queue->stlen > 0 && !write_back(queue)) {
+        queue->stlen = 0;
+        return NULL;
+    }
+    queue->stlen = 0;
+
+    char* run = run_at(queue, queue->itpos, len);
+    if (run == NULL) return NULL;
+
+    if (run == queue->stage) {
+        queue->stpos = queue->itpos;
+        queue->stlen = *len;
+    }
+    queue->itpos += *len;
+    return run;
+}
+
+void Queue_for_each(Queue* queue, void (*visit)(void const* elem, void* ctx),
+                    void* ctx) {
+    assert(queue != NULL);
+    assert(visit != NULL && "visit is not a function");
+
+    size_t const elem_sz = queue->elemsz;
+    size_t       len     = 0;
+    char const*  run     = NULL;
+    for (size_t pos = 0; (run = run_at(queue, pos, &len)) != NULL;
+         pos += len) {
+        char const* const last = run + len * elem_sz;
+        for (char const* elem = run; elem != last; elem += elem_sz) {
+            visit(elem, ctx);
+        }
+    }
+}
+
+void Queue_fold(Queue* queue, void* acc,
+                void (*combine)(void* acc, void const* elem)) {
+    assert(queue != NULL);
+    assert(combine != NULL && "combine is not a function");
+
+    size_t const elem_sz = queue->elemsz;
+    size_t       len     = 0;
+    char const*  run     = NULL;
+    for (size_t pos = 0; (run = run_at(queue, pos, &len)) != NULL;
+         pos += len) {
+        char const* const last = run + len * elem_sz;
+        for (char const* elem = run; elem != last; elem += elem_sz) {
+            combine(acc, elem);
+        }
+    }
+}
+
+/** Reverses the bytes in the range `[first, last)`. */
+static void reverse_bytes(char* first, char* last) {
+    while (first < last) {
+        char const tmp = *first;
+        *first++       = *--last;
+        *last          = tmp;
+    }
+}
+
+void* Queue_linearize(Queue* queue) {
+    assert(queue != NULL);
+
+    if (queue->nelems == 0) return NULL;
+
+    // Only elements that all fit in the head can be stored contiguously
+    if (!refill(queue) || queue->nhead < queue->nelems) return NULL;
+
+    // Rotate the head in place rather than allocate another
+    if (queue->hstart + queue->nhead > queue->hcap) {
+        char* const  arr   = queue->head;
+        size_t const split = queue->hstart * queue->elemsz;
+        size_t const arrsz = queue->hcap * queue->elemsz;
+        reverse_bytes(arr, arr + split);
+        reverse_bytes(arr + split, arr + arrsz);
+        reverse_bytes(arr, arr + arrsz);
+        queue->hstart = 0;
+    }
+    return queue->head + (queue->hstart * queue->elemsz);
+}
+
+/**
+ * Flags a queue as congested and arms its low watermark. Called only on the
+ * transition so that no extra work is done on each operation.
+ */
+static void cross_high(Queue* queue) {
+    queue->congested = true;
+    queue->hitrig    = SIZE_MAX;
+    queue->lotrig    = queue->lowm + 1;
+    if (queue->on_high != NULL) queue->on_high(queue, queue->wm_ctx);
+}
+
+/** Flags a queue as decongested and re-arms its high watermark. */
+static void cross_low(Queue* queue) {
+    queue->congested = false;
+    queue->hitrig    = queue->highm;
+    queue->lotrig    = 0;
+    if (queue->on_low != NULL) queue->on_low(queue, queue->wm_ctx);
+}
+
+/** Drops the front elements of a full ring so that `n` more elements fit. */
+static void drop_to_fit(Queue* queue, size_t n) {
+    size_t const free_slots = queue->hcap - queue->nelems;
+    if (n <= free_slots) return;
+
+    size_t const ndrop = n - free_slots;
+    remove_front(queue, ndrop);
+    queue->nelems   -= ndrop;
+    queue->ndropped += ndrop;
+}
+
+/** Computes the size of a queue after `n` elements are added to it. */
+static size_t size_after(Queue* queue, size_t n) {
+    if (queue->ring && queue->nelems + n > queue->hcap) return queue->hcap;
+    return queue->nelems + n;
+}
+
+bool Queue_enqueue(Queue* queue, void const* elem) {
+    assert(queue != NULL);
+
+    // Overwrite the front element of a full ring, leaving the size unchanged
+    if (queue->ring && queue->nelems == queue->hcap) {
+        drop_to_fit(queue, 1);
+    } else if (queue->nelems >= queue->limit) {
+        return false;
+    }
+
+    if (!append(queue, elem, 1)) return false;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_enqueue_owned(Queue* queue, void* elem) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    return Queue_enqueue(queue, &elem);
+}
+
+bool Queue_extend(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    // An owned queue holds only the addresses handed over to it
+    if (queue->owned) return false;
+
+    if (size_after(queue, n) > queue->limit) return false;
+    if (queue->ring && n > queue->hcap) return false;
+
+    if (queue->ring) drop_to_fit(queue, n);
+    if (!append(queue, NULL, n)) return false;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_dequeue(Queue* queue) {
+    assert(queue != NULL);
+
+    return Queue_dequeue_n(queue, 1);
+}
+
+bool Queue_dequeue_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (n > queue->nelems) return false;
+
+    remove_front(queue, n);
+    queue->nelems -= n;
+
+    // Failing to read ahead is retried when the front element is accessed
+    (void)refill(queue);
+
+    if (queue->nelems < queue->lotrig) cross_low(queue);
+    return true;
+}
+
+void* Queue_take_front(Queue* queue) {
+    assert(queue != NULL);
+    assert(queue->owned && "queue does not own its elements");
+
+    void* elem = NULL;
+    if (!Queue_front(queue, &elem)) return NULL;
+
+    Queue_dequeue(queue);
+    return elem;
+}
+
+bool Queue_discard_n(Queue* queue, size_t n) {
+    assert(queue != NULL);
+
+    if (queue->destroy == NULL) return Queue_dequeue_n(queue, n);
+    if (n > queue->nelems) return false;
+
+    for (size_t i = 0; i < n; ++i) queue->destroy(Queue_take_front(queue));
+    return true;
+}
+
+bool Queue_transfer(Queue* dst, Queue* src, size_t n) {
+    assert(dst != NULL && src != NULL);
+    assert(dst != src && "cannot transfer elements within the same queue");
+    assert(dst->elemsz == src->elemsz && "element sizes differ");
+
+    if (n > src->nelems) return false;
+    if (size_after(dst, n) > dst->limit) return false;
+    if (dst->ring && n > dst->hcap) return false;
+
+    // Copy the elements a run at a time, undoing the copy on failure
+    if (dst->ring) drop_to_fit(dst, n);
+    size_t len = 0;
+    for (size_t pos = 0; pos < n; pos += len) {
+        char const* run = run_at(src, pos, &len);
+        len             = min_size(len, n - pos);
+        if (run == NULL || !append(dst, run, len)) {
+            remove_back(dst, pos);
+            dst->nelems -= pos;
+            return false;
+        }
+    }
+
+    remove_front(src, n);
+    src->nelems -= n;
+    (void)refill(src);
+
+    if (dst->nelems >= dst->hitrig) cross_high(dst);
+    if (src->nelems < src->lotrig) cross_low(src);
+    return true;
+}
+
+void Queue_print(Queue* queue, char const* sep, bool vertical,
+                 void (*print_element)(void const*)) {
+    assert(queue != NULL);
+    if (sep == NULL) sep = ",";
+
+    size_t const n_elems = queue->nelems;
+    size_t       len     = 0;
+    char const*  run     = NULL;
+    for (size_t i = 0; (run = run_at(queue, i, &len)) != NULL;) {
+        for (size_t j = 0; j < len; ++j, ++i) {
+            if (vertical) printf("[%lu] ", i);
+            print_element(run + j * queue->elemsz);
+            vertical
+                ? printf("\n")
+                : ((i == n_elems - 1) ? printf("%s", "") : printf("%s", sep));
+        }
+    }
+}
+
+bool Queue_set_watermarks(Queue* queue, size_t low, size_t high,
+                          WatermarkCallback on_high, WatermarkCallback on_low,
+                          void* ctx) {
+    assert(queue != NULL);
+
+    if (high > 0 && low >= high) return false;
+
+    queue->lowm      = low;
+    queue->highm     = high;
+    queue->on_high   = on_high;
+    queue->on_low    = on_low;
+    queue->wm_ctx    = ctx;
+    queue->congested = false;
+    queue->hitrig    = high > 0 ? high : SIZE_MAX;
+    queue->lotrig    = 0;
+
+    if (queue->nelems >= queue->hitrig) cross_high(queue);
+    return true;
+}
+
+bool Queue_congested(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->congested;
+}
+
+void Queue_set_limit(Queue* queue, size_t limit) {
+    assert(queue != NULL);
+
+    queue->limit = limit > 0 ? limit : SIZE_MAX;
+}
+
+size_t Queue_dropped(Queue* queue) {
+    assert(queue != NULL);
+
+    return queue->ndropped;
+}
+
+/** Magic bytes at the start of a queue written by `Queue_save()`. */
+static char const MAGIC[4] = { 'C', 'D', 'S', 'Q' };
+
+/** Version of the format written by `Queue_save()`. */
+static uint32_t const FORMAT_VERSION = 1;
+
+/** Header of a queue written by `Queue_save()`, 24 bytes with no padding. */
+struct file_header
+{
+    char     magic[4];   // `MAGIC`.
+    uint32_t version;    // `FORMAT_VERSION`.
+    uint64_t elemsz;     // Element size in bytes.
+    uint64_t nelems;     // Number of elements that follow.
+};
+
+/**
+ * Transfers the buffers of `iov` to or from a file in full, resuming after
+ * partial transfers and interruptions. Reaching the end of the file before
+ * the last buffer is an error.
+ */
+static bool transfer_all(int fd, struct iovec* iov, int iovcnt, bool write) {
+    while (iovcnt > 0) {
+        ssize_t const res =
+            write ? writev(fd, iov, iovcnt) : readv(fd, iov, iovcnt);
+        if (res < 0 && errno == EINTR) continue;
+        if (res < 0) return false;
+
+        // Skip the buffers transferred in full, then the part of the next
+        size_t done = (size_t)res;
+        while (iovcnt > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            ++iov;
+            --iovcnt;
+        }
+        if (iovcnt == 0) break;
+        if (res == 0) return false;
+
+        iov->iov_base  = (char*)iov->iov_base + done;
+        iov->iov_len  -= done;
+    }
+    return true;
+}
+
+bool Queue_save(Queue* queue, int fd) {
+    assert(queue != NULL);
+
+    // The addresses of owned elements are meaningless once loaded
+    if (queue->owned) {
+        errno = EINVAL;
+        return false;
+    }
+
+    struct file_header hdr = { .version = FORMAT_VERSION,
+                               .elemsz  = queue->elemsz,
+                               .nelems  = queue->nelems };
+    memcpy(hdr.magic, MAGIC, sizeof(MAGIC));
+
+    struct iovec iov = { &hdr, sizeof(hdr) };
+    if (!transfer_all(fd, &iov, 1, true)) return false;
+
+    // Write a run at a time, those on disk a block at a time
+    size_t len = 0;
+    for (size_t pos = 0; pos < queue->nelems; pos += len) {
+        char* run = run_at(queue, pos, &len);
+        if (run == NULL) return false;
+
+        iov = (struct iovec){ run, len * queue->elemsz };
+        if (!transfer_all(fd, &iov, 1, true)) return false;
+    }
+    return true;
+}
+
+Queue* Queue_load(int fd, size_t elem_sz) {
+    struct file_header hdr;
+    struct iovec       iov = { &hdr, sizeof(hdr) };
+    if (!transfer_all(fd, &iov, 1, false)) return NULL;
+    if (memcmp(hdr.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        hdr.version != FORMAT_VERSION || hdr.elemsz != elem_sz ||
+        elem_sz == 0) {
+        return NULL;
+    }
+
+    Queue* q = Queue_create(elem_sz);
+    if (q == NULL) return NULL;
+
+    // Read a block at a time, which spills as usual once the head is full
+    q->stage = malloc(q->blk * elem_sz);
+    bool ok  = q->stage != NULL;
+    for (uint64_t n = hdr.nelems; ok && n > 0;) {
+        size_t const k = (size_t)(n < q->blk ? n : q->blk);
+        iov            = (struct iovec){ q->stage, k * elem_sz };
+        ok = transfer_all(fd, &iov, 1, false) && append(q, q->stage, k);
+        n -= k;
+    }
+
+    if (!ok) {
+        Queue_destroy(q);
+        return NULL;
+    }
+    return q;
+}
@@ -0,0 +1,106 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      queue_spill.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Extensions to the Queue ADT for queues that spill to disk.
+ *
+ * The `libqueuespill` implementation of the Queue ADT keeps a bounded amount
+ * of its elements in memory, however large the queue grows: a ring of the
+ * front elements, which the consumer reads from, and a block of the back
+ * elements, which the producer writes to. When the ring is full, every block
+ * of elements enqueued is written out sequentially to append-only segment
+ * files, and read back in whole blocks into the ring ahead of the consumer.
+ * Segment files are removed as soon as they are created, so that the space
+ * they take is reclaimed once they are read back in full, or if the process
+ * exits.
+ *
+ * Elements on disk are accessed through a staging block in memory. Those
+ * visited by `Queue_for_each()`, `Queue_fold()` and `Queue_print()` are read
+ * and discarded, while those returned by `Queue_segment()` are written back
+ * when the following segment is requested, so that elements added by
+ * `Queue_extend()` can be written in place as long as all segments are
+ * iterated over. `Queue_linearize()` fails unless all elements are in the
+ * ring.
+ *
+ * A queue created with `Queue_create_ring()` keeps all its elements in
+ * memory, and never spills.
+ *
+ * @note Use the compiler flag `QUEUE_SPILL_BLOCK_CAP` to override the default
+ *      number of elements per block of queues created with `Queue_create()`,
+ *      which otherwise fits a budget of 64 MiB. Unlike `QUEUE_INIT_CAP` for the
+ *      other implementations, it is meant for tests only, since small blocks
+ *      turn the large sequential writes and reads into many small ones.
+ */
+
+#ifndef QUEUE_SPILL_H
+#define QUEUE_SPILL_H
+
+#include <stddef.h>   // size_t
+
+#include "queue.h"   // Queue
+
+/**
+ * @brief Creates an empty, heap-allocated queue that spills to disk, with a
+ * given memory budget.
+ *
+ * The queue allocates memory for a ring of two blocks, a block for the back
+ * elements, and a block to stage elements read from disk, each of a quarter
+ * of `mem_sz` rounded down to a whole number of elements, and at least one.
+ *
+ * It's the caller's responsibility to
+ * -# call `Queue_destroy()` to free all allocated memory and files associated
+ *    with the queue created; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] elem_sz Size of each queue elements in bytes.
+ * @param[in] mem_sz Maximum number of bytes of elements to keep in memory.
+ * @param[in] dir Directory in which to create segment files, or `NULL` for
+ *      that named by the `TMPDIR` environment variable, or else `/tmp`.
+ * @return The queue created on success, `NULL` if the system cannot allocate
+ *      sufficient memory.
+ */
+Queue* Queue_create_spill(size_t elem_sz, size_t mem_sz, char const* dir);
+
+/**
+ * @brief Queries the number of elements of a queue that are on disk.
+ *
+ * @param[in] queue The queue to query.
+ * @return Number of elements written to segment files and not read back.
+ */
+size_t Queue_spilled(Queue* queue);
+
+#endif /* QUEUE_SPILL_H */
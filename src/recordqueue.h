@@ -0,0 +1,198 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      recordqueue.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) record queue.
+ *
+ * Record queue is a queue of variable-length byte strings, called records,
+ * for messages of mixed sizes that would otherwise have to be stored in slots
+ * of the largest size, or each in its own allocation. This module defines the
+ * interface of the RecordQueue ADT.
+ *
+ * Use `RecordQueue_create()` to create a record queue, which should be
+ * destroyed when it is no longer needed using `RecordQueue_destroy()`. Use
+ * `RecordQueue_enqueue()` to add a record, `RecordQueue_front()` to access
+ * the front record in place, and `RecordQueue_dequeue()` to remove it, or
+ * their batch counterparts to handle many records at once.
+ *
+ * All functions that accept a pointer to a record queue asserts that it is
+ * not `NULL`, which can be disabled by adding the `-DNDEBUG` flag when
+ * compiling the library and/or programs using gcc.
+ */
+
+#ifndef RECORDQUEUE_H
+#define RECORDQUEUE_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+
+/** An opaque type representing a record queue. */
+typedef struct recordqueue RecordQueue;
+
+/** A record, as a contiguous span of bytes. */
+typedef struct {
+    void const* data;   // Address of the first byte of the record.
+    size_t      len;    // Number of bytes in the record.
+} RecordSpan;
+
+/**
+ * @brief Creates an empty, heap-allocated record queue.
+ *
+ * It's the caller's responsibility to call `RecordQueue_destroy()` to free
+ * all allocated memory associated with the record queue created.
+ *
+ * @return The record queue created on success, `NULL` otherwise.
+ */
+RecordQueue* RecordQueue_create(void);
+
+/**
+ * @brief Destroys a heap-allocated record queue.
+ *
+ * @param recordqueue The record queue to destroy.
+ */
+void RecordQueue_destroy(RecordQueue* recordqueue);
+
+/**
+ * @brief Determines whether a record queue is empty.
+ *
+ * @param[in] recordqueue The record queue to query.
+ * @return `true` if the record queue is empty, `false` otherwise.
+ */
+bool RecordQueue_empty(RecordQueue* recordqueue);
+
+/**
+ * @brief Queries the size of a record queue.
+ *
+ * @param[in] recordqueue The record queue to query.
+ * @return Number of records in the record queue.
+ */
+size_t RecordQueue_size(RecordQueue* recordqueue);
+
+/**
+ * @brief Queries the total length of the records in a record queue.
+ *
+ * @param[in] recordqueue The record queue to query.
+ * @return Number of bytes in all records of the record queue.
+ */
+size_t RecordQueue_bytes(RecordQueue* recordqueue);
+
+/**
+ * @brief Queries the capacity of a record queue.
+ *
+ * Each record takes an 8-byte header and its length rounded up to a multiple
+ * of 8 bytes, so that records start on 8-byte boundaries.
+ *
+ * @param[in] recordqueue The record queue to query.
+ * @return Number of bytes of the underlying array that stores the records.
+ */
+size_t RecordQueue_capacity(RecordQueue* recordqueue);
+
+/**
+ * @brief Adds a record to the end of a record queue.
+ *
+ * @param[in] recordqueue The record queue to which the record is to add.
+ * @param[in] data The bytes of the record.
+ * @param[in] len Number of bytes in the record, which may be zero.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, `true` otherwise (on success).
+ */
+bool RecordQueue_enqueue(RecordQueue* recordqueue, void const* data,
+                         size_t len);
+
+/**
+ * @brief Adds records to the end of a record queue, all or none.
+ *
+ * The underlying array grows at most once for the whole batch.
+ *
+ * @param[in] recordqueue The record queue to which the records are to add.
+ * @param[in] recs The records to add, in order.
+ * @param[in] n Number of records at `recs`.
+ * @return `false` if the system cannot allocate sufficient memory to complete
+ *      the operation, in which case the record queue is not modified; `true`
+ *      otherwise (on success).
+ */
+bool RecordQueue_enqueue_n(RecordQueue* recordqueue, RecordSpan const* recs,
+                           size_t n);
+
+/**
+ * @brief Accesses the front record of a record queue in place.
+ *
+ * No data is copied. The span returned is invalidated by any subsequent
+ * operation that adds or removes records.
+ *
+ * @param[in] recordqueue The record queue to query.
+ * @param[out] rec The front record if the record queue is not empty,
+ *      undefined otherwise.
+ * @return `false` if the record queue is empty, `true` otherwise (on success).
+ */
+bool RecordQueue_front(RecordQueue* recordqueue, RecordSpan* rec);
+
+/**
+ * @brief Accesses up to a number of front records of a record queue in place.
+ *
+ * No data is copied. The spans returned are invalidated by any subsequent
+ * operation that adds or removes records.
+ *
+ * @param[in] recordqueue The record queue to query.
+ * @param[out] recs The front records, in order.
+ * @param[in] n Maximum number of records to access.
+ * @return Number of records accessed, `0` if the record queue is empty.
+ */
+size_t RecordQueue_front_n(RecordQueue* recordqueue, RecordSpan* recs,
+                           size_t n);
+
+/**
+ * @brief Removes the front record from a record queue.
+ *
+ * @param[in] recordqueue The record queue from which the front record is to
+ *      remove.
+ * @return `false` if the record queue is empty, `true` otherwise (on success).
+ */
+bool RecordQueue_dequeue(RecordQueue* recordqueue);
+
+/**
+ * @brief Removes a number of records from the front of a record queue.
+ *
+ * @param[in] recordqueue The record queue from which the records are to
+ *      remove.
+ * @param[in] n Number of records to remove.
+ * @return `false` if the record queue has fewer than `n` records, in which
+ *      case it is not modified; `true` otherwise (on success).
+ */
+bool RecordQueue_dequeue_n(RecordQueue* recordqueue, size_t n);
+
+#endif /* RECORDQUEUE_H */
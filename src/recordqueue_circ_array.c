@@ -0,0 +1,315 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @brief Implementation of the ADT record queue as a circular array of bytes,
+ * in which each record is stored contiguously after a length prefix.
+ *
+ * Records are laid out back to back, each as an 8-byte header that holds its
+ * length followed by its bytes, padded to a multiple of 8 bytes. A record
+ * never wraps around the end of the array: one that does not fit before the
+ * end goes to the start of the array instead, if it fits before the front
+ * record, and the end of the records before the gap is recorded so that
+ * readers skip it. Otherwise, the array doubles and the records are moved to
+ * its start in at most two blocks.
+ *
+ * @note Use the compiler flag `RECORDQUEUE_INIT_CAP` to override the default
+ *      initial capacity of the underlying array in bytes, which is rounded up
+ *      to a multiple of 8.
+ */
+
+#include "recordqueue.h"
+
+#include <assert.h>   // assert()
+#include <stdint.h>   // SIZE_MAX, uint64_t
+#include <stdlib.h>   // malloc(), free()
+#include <string.h>   // memcpy()
+
+// clang-format off
+/** Initial underlying array capacity in bytes */
+#ifdef RECORDQUEUE_INIT_CAP
+static size_t const INIT_CAP = RECORDQUEUE_INIT_CAP;
+#else
+static size_t const INIT_CAP = 4096;
+#endif
+// clang-format on
+
+/** Size of the header of a record, and the alignment of all records. */
+#define HDR_SZ sizeof(uint64_t)
+
+/** Offset of no position in the underlying array. */
+#define NO_POS SIZE_MAX
+
+// -----------------------------------------------------------------------------
+
+struct recordqueue
+{
+    char*  buf;      // Underlying array that stores the records.
+    size_t cap;      // Capacity of the array in bytes, a multiple of 8.
+    size_t head;     // Offset of the front record.
+    size_t tail;     // Offset past the back record.
+    size_t end;      // Offset past the records before the gap, or `NO_POS`.
+    size_t nrecs;    // Number of records.
+    size_t nbytes;   // Number of bytes in all records.
+    size_t nused;    // Number of bytes taken by all records and headers.
+};
+
+/** Rounds a size up to a multiple of `HDR_SZ`. */
+static size_t round_up(size_t n) { return (n + HDR_SZ - 1) / HDR_SZ * HDR_SZ; }
+
+/** Computes the number of bytes a record of `len` bytes takes. */
+static size_t record_size(size_t len) { return HDR_SZ + round_up(len); }
+
+/** Reads the length of the record at offset `pos`. */
+static size_t record_len(RecordQueue* recordqueue, size_t pos) {
+    uint64_t len;
+    memcpy(&len, recordqueue->buf + pos, HDR_SZ);
+    return (size_t)len;
+}
+
+RecordQueue* RecordQueue_create(void) {
+    RecordQueue* rq = malloc(sizeof(RecordQueue));
+    if (rq == NULL) return NULL;
+
+    size_t const cap = INIT_CAP > HDR_SZ ? round_up(INIT_CAP) : HDR_SZ;
+    rq->buf          = malloc(cap);
+    if (rq->buf == NULL) {
+        free(rq);
+        return NULL;
+    }
+
+    rq->cap    = cap;
+    rq->head   = 0;
+    rq->tail   = 0;
+    rq->end    = NO_POS;
+    rq->nrecs  = 0;
+    rq->nbytes = 0;
+    rq->nused  = 0;
+    return rq;
+}
+
+void RecordQueue_destroy(RecordQueue* recordqueue) {
+    assert(recordqueue != NULL);
+
+    free(recordqueue->buf);
+    free(recordqueue);
+}
+
+bool RecordQueue_empty(RecordQueue* recordqueue) {
+    assert(recordqueue != NULL);
+
+    return recordqueue->nrecs == 0;
+}
+
+size_t RecordQueue_size(RecordQueue* recordqueue) {
+    assert(recordqueue != NULL);
+
+    return recordqueue->nrecs;
+}
+
+size_t RecordQueue_bytes(RecordQueue* recordqueue) {
+    assert(recordqueue != NULL);
+
+    return recordqueue->nbytes;
+}
+
+size_t RecordQueue_capacity(RecordQueue* recordqueue) {
+    assert(recordqueue != NULL);
+
+    return recordqueue->cap;
+}
+
+/**
+ * Finds the offset at which `sz` contiguous bytes fit after the back record,
+ * wrapping around to the start of the array if needed, or `NO_POS` if they
+ * do not fit.
+ */
+static size_t find_room(RecordQueue* recordqueue, size_t sz) {
+    RecordQueue const* rq = recordqueue;
+
+    if (rq->nrecs == 0) return sz <= rq->cap ? 0 : NO_POS;
+    if (rq->end != NO_POS) return sz <= rq->head - rq->tail ? rq->tail : NO_POS;
+    if (sz <= rq->cap - rq->tail) return rq->tail;
+    return sz <= rq->head ? 0 : NO_POS;
+}
+
+/**
+ * Moves the records of a record queue to the start of a new array with room
+ * for at least `sz` more bytes after them.
+ */
+static bool grow(RecordQueue* recordqueue, size_t sz) {
+    RecordQueue* rq = recordqueue;
+    if (sz > SIZE_MAX / 2 - rq->nused) return false;
+
+    size_t new_cap = rq->cap * 2;
+    while (new_cap < rq->nused + sz) new_cap *= 2;
+
+    char* buf = malloc(new_cap);
+    if (buf == NULL) return false;
+
+    // The records before the gap, if any, then those from the start
+    size_t const top = rq->end != NO_POS ? rq->end : rq->tail;
+    if (rq->nrecs > 0) {
+        memcpy(buf, rq->buf + rq->head, top - rq->head);
+        if (rq->end != NO_POS) {
+            memcpy(buf + (top - rq->head), rq->buf, rq->tail);
+        }
+    }
+
+    free(rq->buf);
+    rq->buf  = buf;
+    rq->cap  = new_cap;
+    rq->head = 0;
+    rq->tail = rq->nused;
+    rq->end  = NO_POS;
+    return true;
+}
+
+/** Writes a record at offset `pos`, as found by `find_room()`. */
+static void put(RecordQueue* recordqueue, size_t pos, void const* data,
+                size_t len) {
+    RecordQueue* rq = recordqueue;
+
+    // Leave a gap at the end of the array when wrapping around
+    if (rq->nrecs > 0 && pos == 0 && rq->end == NO_POS) rq->end = rq->tail;
+
+    uint64_t const hdr = len;
+    memcpy(rq->buf + pos, &hdr, HDR_SZ);
+    if (len > 0) memcpy(rq->buf + pos + HDR_SZ, data, len);
+
+    size_t const sz  = record_size(len);
+    rq->tail         = pos + sz;
+    rq->nrecs       += 1;
+    rq->nbytes      += len;
+    rq->nused       += sz;
+}
+
+bool RecordQueue_enqueue(RecordQueue* recordqueue, void const* data,
+                         size_t len) {
+    assert(recordqueue != NULL);
+
+    if (len > SIZE_MAX / 2) return false;
+
+    size_t const sz  = record_size(len);
+    size_t       pos = find_room(recordqueue, sz);
+    if (pos == NO_POS) {
+        if (!grow(recordqueue, sz)) return false;
+        pos = find_room(recordqueue, sz);
+    }
+
+    put(recordqueue, pos, data, len);
+    return true;
+}
+
+bool RecordQueue_enqueue_n(RecordQueue* recordqueue, RecordSpan const* recs,
+                           size_t n) {
+    assert(recordqueue != NULL);
+
+    size_t total = 0;
+    for (size_t i = 0; i < n; ++i) {
+        if (recs[i].len > SIZE_MAX / 2 - total) return false;
+        total += record_size(recs[i].len);
+    }
+
+    // Records that fit together in one block fit one after another
+    if (find_room(recordqueue, total) == NO_POS &&
+        !grow(recordqueue, total)) {
+        return false;
+    }
+
+    for (size_t i = 0; i < n; ++i) {
+        size_t const pos = find_room(recordqueue, record_size(recs[i].len));
+        assert(pos != NO_POS && "insufficient room for batch");
+        put(recordqueue, pos, recs[i].data, recs[i].len);
+    }
+    return true;
+}
+
+bool RecordQueue_front(RecordQueue* recordqueue, RecordSpan* rec) {
+    assert(recordqueue != NULL);
+
+    return RecordQueue_front_n(recordqueue, rec, 1) == 1;
+}
+
+size_t RecordQueue_front_n(RecordQueue* recordqueue, RecordSpan* recs,
+                           size_t n) {
+    assert(recordqueue != NULL);
+
+    RecordQueue const* rq = recordqueue;
+    if (n > rq->nrecs) n = rq->nrecs;
+
+    size_t pos = rq->head;
+    for (size_t i = 0; i < n; ++i) {
+        recs[i].len  = record_len(recordqueue, pos);
+        recs[i].data = rq->buf + pos + HDR_SZ;
+
+        pos += record_size(recs[i].len);
+        if (pos == rq->end) pos = 0;
+    }
+    return n;
+}
+
+bool RecordQueue_dequeue(RecordQueue* recordqueue) {
+    assert(recordqueue != NULL);
+
+    return RecordQueue_dequeue_n(recordqueue, 1);
+}
+
+bool RecordQueue_dequeue_n(RecordQueue* recordqueue, size_t n) {
+    assert(recordqueue != NULL);
+
+    RecordQueue* rq = recordqueue;
+    if (n > rq->nrecs) return false;
+
+    for (size_t i = 0; i < n; ++i) {
+        size_t const len = record_len(recordqueue, rq->head);
+        size_t const sz  = record_size(len);
+        rq->head        += sz;
+        rq->nbytes      -= len;
+        rq->nused       -= sz;
+
+        // Skip the gap once the records before it are gone
+        if (rq->head == rq->end) {
+            rq->head = 0;
+            rq->end  = NO_POS;
+        }
+    }
+    rq->nrecs -= n;
+
+    // Start over from the start of the array once empty, to delay wrapping
+    if (rq->nrecs == 0) {
+        rq->head = 0;
+        rq->tail = 0;
+        rq->end  = NO_POS;
+    }
+    return true;
+}
@@ -0,0 +1,235 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @file      shmqueue.h
+ * @author    KriztoferY (https://github.com/KriztoferY)
+ * @version   0.1.0
+ * @copyright Copyright (c) 2023 KriztoferY. All rights reserved.
+ *
+ * @brief     Interface for the abstract data type (ADT) shared-memory queue.
+ *
+ * Shared-memory queue is a bounded queue of fixed-size elements that lives in
+ * a named POSIX shared-memory object, through which a producer process passes
+ * elements to a consumer process without any system call. This module defines
+ * the interface of the ShmQueue ADT, for a single producer and a single
+ * consumer (SPSC) at a time.
+ *
+ * One process uses `ShmQueue_create()` to create a shared-memory queue, and
+ * the other `ShmQueue_open()` to attach to it, each in a role: the producer
+ * may only add elements with `ShmQueue_enqueue()` or `ShmQueue_write()`, and
+ * the consumer may only access and remove them with `ShmQueue_front()`,
+ * `ShmQueue_dequeue()` or `ShmQueue_read()`. Each process detaches with
+ * `ShmQueue_destroy()`, which leaves the shared-memory object in place until
+ * `ShmQueue_unlink()` is called.
+ *
+ * The queue holds no lock, so that a process that dies cannot block the other.
+ * An element becomes visible to the consumer only once written in full, and
+ * the elements added by a producer that died remain in the queue. Use
+ * `ShmQueue_peer_alive()` to find out whether the process in the other role
+ * is still attached, and `ShmQueue_open()` to take over the role of a process
+ * that died. Processes are identified by their process IDs, which must be
+ * those of the same PID namespace, and may be reused by the system.
+ *
+ * All functions that accept a pointer to a shared-memory queue asserts that it
+ * is not `NULL`, and that it is called in the right role, which can be
+ * disabled by adding the `-DNDEBUG` flag when compiling the library and/or
+ * programs using gcc.
+ */
+
+#ifndef SHMQUEUE_H
+#define SHMQUEUE_H
+
+#include <stddef.h>    // size_t
+#include <stdbool.h>   // bool
+
+/** An opaque type representing a process' view of a shared-memory queue. */
+typedef struct shmqueue ShmQueue;
+
+/** The role in which a process attaches to a shared-memory queue. */
+typedef enum {
+    SHMQUEUE_PRODUCER,   // Adds elements to the queue.
+    SHMQUEUE_CONSUMER    // Removes elements from the queue.
+} ShmQueueRole;
+
+/**
+ * @brief Creates an empty shared-memory queue, and attaches to it.
+ *
+ * It's the caller's responsibility to
+ * -# call `ShmQueue_destroy()` to detach from the queue when it is no longer
+ *    needed, and `ShmQueue_unlink()` to remove it; and
+ * -# ensure `elem_sz` is a proper positive integer.
+ *
+ * @param[in] name Name of the shared-memory object, which starts with a `/`,
+ *      as for `shm_open()`. There must not be an object by the same name.
+ * @param[in] elem_sz Size of each element in bytes.
+ * @param[in] cap Minimum number of elements the queue can hold, which is
+ *      rounded up to a power of two.
+ * @param[in] role The role in which to attach to the queue.
+ * @return The queue created on success, `NULL` if `cap` is zero, or the
+ *      shared-memory object cannot be created or mapped.
+ */
+ShmQueue* ShmQueue_create(char const* name, size_t elem_sz, size_t cap,
+                          ShmQueueRole role);
+
+/**
+ * @brief Attaches to a shared-memory queue created by another process, or the
+ * same one.
+ *
+ * A role can be taken by one process at a time. It is free once the process
+ * in that role has detached, or has died without detaching, in which case the
+ * new process carries on from where the old one left off.
+ *
+ * @param[in] name Name of the shared-memory object, as passed to
+ *      `ShmQueue_create()`.
+ * @param[in] elem_sz Size of each element in bytes, which must match that of
+ *      the queue.
+ * @param[in] role The role in which to attach to the queue.
+ * @return The queue attached to on success, `NULL` if there is no queue by
+ *      that name yet, it holds elements of another size, the role is taken
+ *      by a live process, or the shared-memory object cannot be mapped.
+ */
+ShmQueue* ShmQueue_open(char const* name, size_t elem_sz, ShmQueueRole role);
+
+/**
+ * @brief Detaches from a shared-memory queue, freeing its role.
+ *
+ * @param shmqueue The queue to detach from.
+ */
+void ShmQueue_destroy(ShmQueue* shmqueue);
+
+/**
+ * @brief Removes the name of a shared-memory queue, so that it is freed once
+ * all processes have detached.
+ *
+ * @param[in] name Name of the shared-memory object.
+ * @return `false` if there is no shared-memory object by that name, `true`
+ *      otherwise (on success).
+ */
+bool ShmQueue_unlink(char const* name);
+
+/**
+ * @brief Queries the capacity of a shared-memory queue.
+ *
+ * @param[in] shmqueue The queue to query.
+ * @return Maximum number of elements that can be stored by the queue.
+ */
+size_t ShmQueue_capacity(ShmQueue* shmqueue);
+
+/**
+ * @brief Queries the size of a shared-memory queue.
+ *
+ * The size may change as soon as it is read, by the process in the other
+ * role.
+ *
+ * @param[in] shmqueue The queue to query.
+ * @return Number of elements in the queue.
+ */
+size_t ShmQueue_size(ShmQueue* shmqueue);
+
+/**
+ * @brief Determines whether the process in the other role is attached to a
+ * shared-memory queue, and alive.
+ *
+ * @param[in] shmqueue The queue to query.
+ * @return `true` if the other role is taken by a process that is alive,
+ *      `false` otherwise.
+ */
+bool ShmQueue_peer_alive(ShmQueue* shmqueue);
+
+/**
+ * @brief Adds an element to the end of a shared-memory queue, as the producer.
+ *
+ * @param[in] shmqueue The queue to which the element is to add.
+ * @param[in] elem The element to add.
+ * @return `false` if the queue is full, `true` otherwise (on success).
+ */
+bool ShmQueue_enqueue(ShmQueue* shmqueue, void const* elem);
+
+/**
+ * @brief Adds as many elements as fit, up to a number of them, to the end of
+ * a shared-memory queue, as the producer.
+ *
+ * The elements are copied in at most two blocks, and made visible to the
+ * consumer at once.
+ *
+ * @param[in] shmqueue The queue to which the elements are to add.
+ * @param[in] elems The elements to add, stored contiguously.
+ * @param[in] n Number of elements at `elems`.
+ * @return Number of elements added, from the first one.
+ */
+size_t ShmQueue_write(ShmQueue* shmqueue, void const* elems, size_t n);
+
+/**
+ * @brief Accesses the front element of a shared-memory queue, as the consumer.
+ *
+ * @param[in] shmqueue The queue to query.
+ * @param[out] elem The front element if the queue is not empty, undefined
+ *      otherwise.
+ * @return `false` if the queue is empty, `true` otherwise (on success).
+ */
+bool ShmQueue_front(ShmQueue* shmqueue, void* elem);
+
+/**
+ * @brief Accesses the front element of a shared-memory queue in place, as the
+ * consumer.
+ *
+ * The pointer returned stays valid until the element is removed, since the
+ * producer cannot overwrite it before then.
+ *
+ * @param[in] shmqueue The queue to query.
+ * @return Address of the front element if the queue is not empty, `NULL`
+ *      otherwise.
+ */
+void const* ShmQueue_peek(ShmQueue* shmqueue);
+
+/**
+ * @brief Removes the front element from a shared-memory queue, as the
+ * consumer.
+ *
+ * @param[in] shmqueue The queue from which its front element is to remove.
+ * @return `false` if the queue is empty, `true` otherwise (on success).
+ */
+bool ShmQueue_dequeue(ShmQueue* shmqueue);
+
+/**
+ * @brief Removes up to a number of elements from the front of a shared-memory
+ * queue, and copies them out, as the consumer.
+ *
+ * @param[in] shmqueue The queue from which the elements are to remove.
+ * @param[out] elems Where to copy the elements removed, contiguously.
+ * @param[in] n Maximum number of elements to remove.
+ * @return Number of elements removed, `0` if the queue is empty.
+ */
+size_t ShmQueue_read(ShmQueue* shmqueue, void* elems, size_t n);
+
+#endif /* SHMQUEUE_H */
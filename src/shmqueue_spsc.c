@@ -0,0 +1,384 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+/**
+ * @brief Implementation of the ADT shared-memory queue as a single-producer
+ * single-consumer circular array in a POSIX shared-memory object.
+ *
+ * The object starts with a header that holds the layout of the queue, the
+ * process ID in each role, and the positions of the front and back of the
+ * queue, each on a cache line of its own so that the producer and the
+ * consumer do not contend for the same line. The array follows at an offset
+ * recorded in the header, since the object is mapped at a different address
+ * in each process, and holds no pointer.
+ *
+ * Positions are 64-bit counters that only ever increase, and wrap around the
+ * array of power-of-two capacity by masking. Each side publishes its position
+ * with a release store once it is done with the element, and reads the other
+ * side's with an acquire load only when its cached copy says that the queue is
+ * full or empty, so that the shared cache lines move between processes as
+ * rarely as possible.
+ */
+
+#define _POSIX_C_SOURCE 200809L   // shm_open(), kill(), ftruncate(), fstat()
+
+#include "shmqueue.h"
+
+#include <assert.h>      // assert()
+#include <stdint.h>      // uint32_t, uint64_t, int64_t
+#include <stdlib.h>      // malloc(), free()
+#include <string.h>      // memcpy(), memcmp()
+#include <errno.h>       // errno, EPERM
+#include <fcntl.h>       // O_*
+#include <signal.h>      // kill()
+#include <unistd.h>      // close(), ftruncate(), getpid()
+#include <sys/mman.h>    // shm_open(), shm_unlink(), mmap(), munmap()
+#include <sys/stat.h>    // fstat(), struct stat
+
+/** Size of a cache line, the unit of contention between processes. */
+#define LINE_SZ 64
+
+/** Magic bytes at the start of a shared-memory queue. */
+static char const SHM_MAGIC[4] = { 'C', 'D', 'S', 'M' };
+
+/** Version of the layout of a shared-memory queue, written last on creation. */
+static uint32_t const SHM_VERSION = 1;
+
+// -----------------------------------------------------------------------------
+
+/** Header of a shared-memory queue, at the start of the object. */
+struct shm_header
+{
+    char     magic[4];             // `SHM_MAGIC`.
+    uint32_t version;              // `SHM_VERSION` once initialized.
+    uint64_t elemsz;               // Element size in bytes.
+    uint64_t cap;                  // Capacity of the array.
+    uint64_t data_off;             // Offset of the array in the object.
+    int64_t  pids[2];              // Process in each role, `0` if none.
+    char     pad0[LINE_SZ - 48];   // Keeps `head` on a line of its own.
+    uint64_t head;                 // Position of the front element.
+    char     pad1[LINE_SZ - 8];    // Keeps `tail` on a line of its own.
+    uint64_t tail;                 // Position past the back element.
+    char     pad2[LINE_SZ - 8];    // Keeps the array off `tail`'s line.
+};
+
+struct shmqueue
+{
+    struct shm_header* hdr;      // Mapping of the whole object.
+    size_t             mapsz;    // Size of the mapping in bytes.
+    char*              elems;    // Underlying array, in the mapping.
+    size_t             elemsz;   // Element size in bytes.
+    uint64_t           mask;     // Capacity less one, to wrap positions.
+    ShmQueueRole       role;     // Role in which the process is attached.
+    uint64_t           pos;      // Own position, `tail` or `head`.
+    uint64_t           peer;     // Last seen position of the other side.
+};
+
+/** Loads a position or process ID published by another process. */
+static uint64_t load_acquire(uint64_t const* p) {
+    return __atomic_load_n(p, __ATOMIC_ACQUIRE);
+}
+
+/** Publishes a position to another process. */
+static void store_release(uint64_t* p, uint64_t v) {
+    __atomic_store_n(p, v, __ATOMIC_RELEASE);
+}
+
+/** Determines whether a process exists, if not necessarily ours to signal. */
+static bool process_alive(int64_t pid) {
+    return kill((pid_t)pid, 0) == 0 || errno == EPERM;
+}
+
+/** Computes the size of the object of a queue of `cap` elements. */
+static size_t object_size(size_t elem_sz, size_t cap) {
+    return sizeof(struct shm_header) + cap * elem_sz;
+}
+
+/**
+ * Maps the shared-memory object open as `fd`, of `size` bytes, and claims a
+ * role in the queue it holds. The file descriptor is closed in any case.
+ */
+static ShmQueue* attach(int fd, size_t size, ShmQueueRole role) {
+    void* map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) return NULL;
+
+    ShmQueue* sq = malloc(sizeof(ShmQueue));
+    if (sq == NULL) {
+        munmap(map, size);
+        return NULL;
+    }
+
+    struct shm_header* hdr = map;
+    sq->hdr                = hdr;
+    sq->mapsz              = size;
+    sq->elems              = (char*)map + hdr->data_off;
+    sq->elemsz             = hdr->elemsz;
+    sq->mask               = hdr->cap - 1;
+    sq->role               = role;
+
+    // Take over from a process that died without detaching, if any
+    int64_t const self = (int64_t)getpid();
+    int64_t       cur  = __atomic_load_n(&hdr->pids[role], __ATOMIC_ACQUIRE);
+    do {
+        if (cur != 0 && process_alive(cur)) {
+            munmap(map, size);
+            free(sq);
+            return NULL;
+        }
+    } while (!__atomic_compare_exchange_n(&hdr->pids[role], &cur, self, false,
+                                          __ATOMIC_ACQ_REL,
+                                          __ATOMIC_ACQUIRE));
+
+    bool const producer = role == SHMQUEUE_PRODUCER;
+    sq->pos             = load_acquire(producer ? &hdr->tail : &hdr->head);
+    sq->peer            = load_acquire(producer ? &hdr->head : &hdr->tail);
+    return sq;
+}
+
+ShmQueue* ShmQueue_create(char const* name, size_t elem_sz, size_t cap,
+                          ShmQueueRole role) {
+    if (cap == 0) return NULL;
+
+    size_t rounded = 1;
+    while (rounded < cap) rounded *= 2;
+
+    int const fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0600);
+    if (fd < 0) return NULL;
+
+    size_t const size = object_size(elem_sz, rounded);
+    if (ftruncate(fd, (off_t)size) != 0) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+
+    // The object is zero-filled, so only the layout needs to be written
+    struct shm_header* hdr =
+        mmap(NULL, sizeof(*hdr), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (hdr == MAP_FAILED) {
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    memcpy(hdr->magic, SHM_MAGIC, sizeof(SHM_MAGIC));
+    hdr->elemsz   = elem_sz;
+    hdr->cap      = rounded;
+    hdr->data_off = sizeof(*hdr);
+    __atomic_store_n(&hdr->version, SHM_VERSION, __ATOMIC_RELEASE);
+    munmap(hdr, sizeof(*hdr));
+
+    ShmQueue* sq = attach(fd, size, role);
+    if (sq == NULL) shm_unlink(name);
+    return sq;
+}
+
+ShmQueue* ShmQueue_open(char const* name, size_t elem_sz, ShmQueueRole role) {
+    int const fd = shm_open(name, O_RDWR, 0600);
+    if (fd < 0) return NULL;
+
+    // Check the layout before mapping the whole object
+    struct stat              st;
+    struct shm_header const* hdr = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(*hdr)) {
+        hdr = mmap(NULL, sizeof(*hdr), PROT_READ, MAP_SHARED, fd, 0);
+    }
+    if (hdr == MAP_FAILED) {
+        close(fd);
+        return NULL;
+    }
+
+    bool const ok =
+        __atomic_load_n(&hdr->version, __ATOMIC_ACQUIRE) == SHM_VERSION &&
+        memcmp(hdr->magic, SHM_MAGIC, sizeof(SHM_MAGIC)) == 0 &&
+        hdr->elemsz == elem_sz && hdr->cap > 0 &&
+        (hdr->cap & (hdr->cap - 1)) == 0 &&
+        hdr->data_off == sizeof(*hdr) &&
+        object_size(elem_sz, hdr->cap) <= (size_t)st.st_size;
+    size_t const size = ok ? object_size(elem_sz, hdr->cap) : 0;
+    munmap((void*)hdr, sizeof(*hdr));
+    if (!ok) {
+        close(fd);
+        return NULL;
+    }
+
+    return attach(fd, size, role);
+}
+
+void ShmQueue_destroy(ShmQueue* shmqueue) {
+    assert(shmqueue != NULL);
+
+    // Free the role, unless it was taken over
+    int64_t self = (int64_t)getpid();
+    __atomic_compare_exchange_n(&shmqueue->hdr->pids[shmqueue->role], &self, 0,
+                                false, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+    munmap(shmqueue->hdr, shmqueue->mapsz);
+    free(shmqueue);
+}
+
+bool ShmQueue_unlink(char const* name) { return shm_unlink(name) == 0; }
+
+size_t ShmQueue_capacity(ShmQueue* shmqueue) {
+    assert(shmqueue != NULL);
+
+    return (size_t)shmqueue->mask + 1;
+}
+
+size_t ShmQueue_size(ShmQueue* shmqueue) {
+    assert(shmqueue != NULL);
+
+    // Read the front first, so that the back is never seen behind it
+    uint64_t const head = load_acquire(&shmqueue->hdr->head);
+    uint64_t const tail = load_acquire(&shmqueue->hdr->tail);
+    return (size_t)(tail - head);
+}
+
+bool ShmQueue_peer_alive(ShmQueue* shmqueue) {
+    assert(shmqueue != NULL);
+
+    int64_t const pid = __atomic_load_n(
+        &shmqueue->hdr->pids[1 - shmqueue->role], __ATOMIC_ACQUIRE);
+    return pid != 0 && process_alive(pid);
+}
+
+/**
+ * Computes the number of free slots of a queue, as the producer, re-reading
+ * the front position only if fewer than `n` slots are known to be free.
+ */
+static size_t free_slots(ShmQueue* shmqueue, size_t n) {
+    uint64_t const cap   = shmqueue->mask + 1;
+    uint64_t       nfree = cap - (shmqueue->pos - shmqueue->peer);
+    if (nfree < n) {
+        shmqueue->peer = load_acquire(&shmqueue->hdr->head);
+        nfree          = cap - (shmqueue->pos - shmqueue->peer);
+    }
+    return (size_t)nfree;
+}
+
+/**
+ * Computes the number of elements of a queue, as the consumer, re-reading
+ * the back position only if fewer than `n` elements are known to be there.
+ */
+static size_t avail_elems(ShmQueue* shmqueue, size_t n) {
+    uint64_t navail = shmqueue->peer - shmqueue->pos;
+    if (navail < n) {
+        shmqueue->peer = load_acquire(&shmqueue->hdr->tail);
+        navail         = shmqueue->peer - shmqueue->pos;
+    }
+    return (size_t)navail;
+}
+
+bool ShmQueue_enqueue(ShmQueue* shmqueue, void const* elem) {
+    assert(shmqueue != NULL);
+    assert(shmqueue->role == SHMQUEUE_PRODUCER && "not the producer");
+
+    if (free_slots(shmqueue, 1) == 0) return false;
+
+    size_t const back = (size_t)(shmqueue->pos & shmqueue->mask);
+    memcpy(shmqueue->elems + back * shmqueue->elemsz, elem, shmqueue->elemsz);
+    store_release(&shmqueue->hdr->tail, ++shmqueue->pos);
+    return true;
+}
+
+size_t ShmQueue_write(ShmQueue* shmqueue, void const* elems, size_t n) {
+    assert(shmqueue != NULL);
+    assert(shmqueue->role == SHMQUEUE_PRODUCER && "not the producer");
+
+    size_t const nfree = free_slots(shmqueue, n);
+    if (n > nfree) n = nfree;
+    if (n == 0) return 0;
+
+    // Copy up to the end of the array, then the rest to its start
+    size_t const elem_sz = shmqueue->elemsz;
+    size_t const back    = (size_t)(shmqueue->pos & shmqueue->mask);
+    size_t const ntail   = shmqueue->mask + 1 - back;
+    size_t const nfirst  = n < ntail ? n : ntail;
+    memcpy(shmqueue->elems + back * elem_sz, elems, nfirst * elem_sz);
+    memcpy(shmqueue->elems, (char const*)elems + nfirst * elem_sz,
+           (n - nfirst) * elem_sz);
+
+    shmqueue->pos += n;
+    store_release(&shmqueue->hdr->tail, shmqueue->pos);
+    return n;
+}
+
+void const* ShmQueue_peek(ShmQueue* shmqueue) {
+    assert(shmqueue != NULL);
+    assert(shmqueue->role == SHMQUEUE_CONSUMER && "not the consumer");
+
+    if (avail_elems(shmqueue, 1) == 0) return NULL;
+
+    size_t const front = (size_t)(shmqueue->pos & shmqueue->mask);
+    return shmqueue->elems + front * shmqueue->elemsz;
+}
+
+bool ShmQueue_front(ShmQueue* shmqueue, void* elem) {
+    assert(shmqueue != NULL);
+
+    void const* front = ShmQueue_peek(shmqueue);
+    if (front == NULL) return false;
+
+    memcpy(elem, front, shmqueue->elemsz);
+    return true;
+}
+
+bool ShmQueue_dequeue(ShmQueue* shmqueue) {
+    assert(shmqueue != NULL);
+    assert(shmqueue->role == SHMQUEUE_CONSUMER && "not the consumer");
+
+    if (avail_elems(shmqueue, 1) == 0) return false;
+
+    store_release(&shmqueue->hdr->head, ++shmqueue->pos);
+    return true;
+}
+
+size_t ShmQueue_read(ShmQueue* shmqueue, void* elems, size_t n) {
+    assert(shmqueue != NULL);
+    assert(shmqueue->role == SHMQUEUE_CONSUMER && "not the consumer");
+
+    size_t const navail = avail_elems(shmqueue, n);
+    if (n > navail) n = navail;
+    if (n == 0) return 0;
+
+    // Copy up to the end of the array, then the rest from its start
+    size_t const elem_sz = shmqueue->elemsz;
+    size_t const front   = (size_t)(shmqueue->pos & shmqueue->mask);
+    size_t const ntail   = shmqueue->mask + 1 - front;
+    size_t const nfirst  = n < ntail ? n : ntail;
+    memcpy(elems, shmqueue->elems + front * elem_sz, nfirst * elem_sz);
+    memcpy((char*)elems + nfirst * elem_sz, shmqueue->elems,
+           (n - nfirst) * elem_sz);
+
+    shmqueue->pos += n;
+    store_release(&shmqueue->hdr->head, shmqueue->pos);
+    return n;
+}
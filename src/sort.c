@@ -0,0 +1,309 @@
+/*** Out-of-line definitions ***/
+
+#include "algos.h"
+
+#include <stdbool.h>   // bool
+#include <stdint.h>    // uint8_t
+#include <stdlib.h>    // malloc(), calloc(), free()
+#include <string.h>    // memcpy(), memmove()
+#include <assert.h>    // assert()
+
+/** Number of elements in runs sorted by insertion before merging runs. */
+static size_t const MIN_RUN = 32;
+
+/** Maximum width of radix sort keys in bytes. */
+#define MAX_KEY_WIDTH 8
+
+/** Number of distinct values of a byte. */
+#define RADIX 256
+
+/** Copies an element, by a fixed-size copy for common element sizes. */
+static inline void copy_elem(char* dst, char const* src, size_t elem_sz) {
+    switch (elem_sz) {
+    case 4: memcpy(dst, src, 4); break;
+    case 8: memcpy(dst, src, 8); break;
+    case 16: memcpy(dst, src, 16); break;
+    case 32: memcpy(dst, src, 32); break;
+    default: memcpy(dst, src, elem_sz); break;
+    }
+}
+
+/** Stable-sorts a short array by insertion, using `tmp` to hold an element. */
+static void insertion_sort(char* base, size_t n, size_t elem_sz, char* tmp,
+                           bool (*compare)(void const*, void const*)) {
+    for (size_t i = 1; i < n; ++i) {
+        char* const elem = base + i * elem_sz;
+
+        // Elements that the element does not go before stay before it
+        size_t j = i;
+        while (j > 0 && compare(elem, base + (j - 1) * elem_sz)) --j;
+        if (j == i) continue;
+
+        copy_elem(tmp, elem, elem_sz);
+        memmove(base + (j + 1) * elem_sz, base + j * elem_sz,
+                (i - j) * elem_sz);
+        copy_elem(base + j * elem_sz, tmp, elem_sz);
+    }
+}
+
+/**
+ * Stable-merges the adjacent sorted runs `[lo, mid)` and `[mid, hi)` of `src`
+ * into the same positions of `dst`.
+ */
+static void merge_runs(char const* src, char* dst, size_t lo, size_t mid,
+                       size_t hi, size_t elem_sz,
+                       bool (*compare)(void const*, void const*)) {
+    size_t i = lo, j = mid, k = lo;
+
+    // Runs already in order are copied as a whole
+    if (mid < hi && !compare(src + mid * elem_sz, src + (mid - 1) * elem_sz)) {
+        memcpy(dst + lo * elem_sz, src + lo * elem_sz, (hi - lo) * elem_sz);
+        return;
+    }
+
+    while (i < mid && j < hi) {
+        if (compare(src + j * elem_sz, src + i * elem_sz)) {
+            copy_elem(dst + (k++) * elem_sz, src + (j++) * elem_sz, elem_sz);
+        } else {
+            copy_elem(dst + (k++) * elem_sz, src + (i++) * elem_sz, elem_sz);
+        }
+    }
+    memcpy(dst + k * elem_sz, src + i * elem_sz, (mid - i) * elem_sz);
+    k += mid - i;
+    memcpy(dst + k * elem_sz, src + j * elem_sz, (hi - j) * elem_sz);
+}
+
+/**
+ * Stable-sorts an array by bottom-up merge sort, ping-ponging runs between
+ * the array and an auxiliary array of the same size.
+ */
+static bool sort_array(char* base, size_t n, size_t elem_sz,
+                       bool (*compare)(void const*, void const*)) {
+    char* aux = malloc(n * elem_sz);
+    if (aux == NULL) return false;
+
+    for (size_t lo = 0; lo < n; lo += MIN_RUN) {
+        size_t const len = n - lo < MIN_RUN ? n - lo : MIN_RUN;
+        insertion_sort(base + lo * elem_sz, len, elem_sz, aux, compare);
+    }
+
+    char* src = base;
+    char* dst = aux;
+    for (size_t width = MIN_RUN; width < n; width *= 2) {
+        for (size_t lo = 0; lo < n; lo += 2 * width) {
+            size_t const mid = n - lo < width ? n : lo + width;
+            size_t const hi  = n - lo < 2 * width ? n : lo + 2 * width;
+            merge_runs(src, dst, lo, mid, hi, elem_sz, compare);
+        }
+        char* const tmp = src;
+        src             = dst;
+        dst             = tmp;
+    }
+    if (src != base) memcpy(base, src, n * elem_sz);
+
+    free(aux);
+    return true;
+}
+
+/**
+ * Stable-sorts a queue by bottom-up merge sort, moving elements one at a time
+ * with `Queue_transfer()`. Each pass moves pairs of runs from the front of the
+ * queue into two run queues, and merges them back onto the end of the queue,
+ * so node-based implementations relink their nodes without copying.
+ */
+static bool sort_by_transfer(Queue* queue, size_t elem_sz,
+                             bool (*compare)(void const*, void const*)) {
+    Queue* runs[2] = { Queue_create(elem_sz), Queue_create(elem_sz) };
+    if (runs[0] == NULL || runs[1] == NULL) {
+        if (runs[0] != NULL) Queue_destroy(runs[0]);
+        if (runs[1] != NULL) Queue_destroy(runs[1]);
+        return false;
+    }
+
+    size_t const n = Queue_size(queue);
+    bool         res;
+
+    for (size_t width = 1; width < n; width *= 2) {
+        for (size_t left = n; left > 0;) {
+            size_t const n0 = left < width ? left : width;
+            size_t const n1 = left - n0 < width ? left - n0 : width;
+            left -= n0 + n1;
+
+            res = Queue_transfer(runs[0], queue, n0) &&
+                  Queue_transfer(runs[1], queue, n1);
+            assert(res && "cannot allocate memory to fulfill transfer()");
+
+            void const* elem0 = Queue_peek(runs[0]);
+            void const* elem1 = Queue_peek(runs[1]);
+            while (elem0 != NULL && elem1 != NULL) {
+                if (compare(elem1, elem0)) {
+                    res   = Queue_transfer(queue, runs[1], 1);
+                    elem1 = Queue_peek(runs[1]);
+                } else {
+                    res   = Queue_transfer(queue, runs[0], 1);
+                    elem0 = Queue_peek(runs[0]);
+                }
+                assert(res && "cannot allocate memory to fulfill transfer()");
+            }
+
+            res = Queue_transfer(queue, runs[0], Queue_size(runs[0])) &&
+                  Queue_transfer(queue, runs[1], Queue_size(runs[1]));
+            assert(res && "cannot allocate memory to fulfill transfer()");
+        }
+    }
+
+    Queue_destroy(runs[0]);
+    Queue_destroy(runs[1]);
+    return true;
+}
+
+bool Queue_sort(Queue* queue, size_t elem_sz,
+                bool (*compare)(void const*, void const*)) {
+    assert(queue != NULL);
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    size_t const n = Queue_size(queue);
+    if (n < 2) return true;
+
+    char* base = Queue_linearize(queue);
+    if (base != NULL) return sort_array(base, n, elem_sz, compare);
+    return sort_by_transfer(queue, elem_sz, compare);
+}
+
+/** Offset of the `d`-th least significant byte in a key of `width` bytes. */
+static size_t byte_offset(size_t d, size_t width) {
+    uint16_t const one = 1;
+    return *(uint8_t const*)&one == 1 ? d : width - 1 - d;
+}
+
+/**
+ * Counts the occurrences of each value of each byte of the keys in a
+ * contiguous run of elements.
+ */
+static void count_digits(char const* run, size_t len, size_t elem_sz,
+                         size_t key_offset, size_t key_width,
+                         size_t counts[][RADIX]) {
+    for (size_t i = 0; i < len; ++i) {
+        uint8_t const* key = (uint8_t const*)run + i * elem_sz + key_offset;
+        for (size_t d = 0; d < key_width; ++d) {
+            counts[d][key[byte_offset(d, key_width)]] += 1;
+        }
+    }
+}
+
+/** Determines whether all `n` keys have the same value of a byte. */
+static bool is_trivial(size_t const counts[RADIX], size_t n) {
+    for (size_t b = 0; b < RADIX; ++b) {
+        if (counts[b] != 0) return counts[b] == n;
+    }
+    return true;
+}
+
+/**
+ * Stable-sorts an array by LSD radix sort, scattering elements between the
+ * array and an auxiliary array of the same size one byte of keys at a time.
+ */
+static bool radix_sort_array(char* base, size_t n, size_t elem_sz,
+                             size_t key_offset, size_t key_width,
+                             size_t counts[][RADIX]) {
+    char* aux = malloc(n * elem_sz);
+    if (aux == NULL) return false;
+
+    char* src = base;
+    char* dst = aux;
+    for (size_t d = 0; d < key_width; ++d) {
+        if (is_trivial(counts[d], n)) continue;
+
+        // Turn the counts of each byte value into where they go
+        size_t pos[RADIX];
+        size_t sum = 0;
+        for (size_t b = 0; b < RADIX; ++b) {
+            pos[b]  = sum;
+            sum    += counts[d][b];
+        }
+
+        size_t const off = key_offset + byte_offset(d, key_width);
+        for (size_t i = 0; i < n; ++i) {
+            char const* elem = src + i * elem_sz;
+            copy_elem(dst + (pos[(uint8_t)elem[off]]++) * elem_sz, elem,
+                      elem_sz);
+        }
+        char* const tmp = src;
+        src             = dst;
+        dst             = tmp;
+    }
+    if (src != base) memcpy(base, src, n * elem_sz);
+
+    free(aux);
+    return true;
+}
+
+/**
+ * Stable-sorts a queue by LSD radix sort, moving elements one at a time with
+ * `Queue_transfer()` into a bucket queue per byte value and then appending the
+ * buckets back in order, so node-based implementations relink their nodes
+ * without copying.
+ */
+static bool radix_sort_by_transfer(Queue* queue, size_t elem_sz,
+                                   size_t key_offset, size_t key_width,
+                                   size_t counts[][RADIX]) {
+    Queue* buckets[RADIX] = { NULL };
+    for (size_t b = 0; b < RADIX; ++b) {
+        buckets[b] = Queue_create(elem_sz);
+        if (buckets[b] == NULL) {
+            while (b-- > 0) Queue_destroy(buckets[b]);
+            return false;
+        }
+    }
+
+    size_t const n = Queue_size(queue);
+    bool         res;
+
+    for (size_t d = 0; d < key_width; ++d) {
+        if (is_trivial(counts[d], n)) continue;
+
+        size_t const   off  = key_offset + byte_offset(d, key_width);
+        uint8_t const* elem = NULL;
+        while ((elem = Queue_peek(queue)) != NULL) {
+            res = Queue_transfer(buckets[elem[off]], queue, 1);
+            assert(res && "cannot allocate memory to fulfill transfer()");
+        }
+        for (size_t b = 0; b < RADIX; ++b) {
+            res = Queue_transfer(queue, buckets[b], Queue_size(buckets[b]));
+            assert(res && "cannot allocate memory to fulfill transfer()");
+        }
+    }
+
+    for (size_t b = 0; b < RADIX; ++b) Queue_destroy(buckets[b]);
+    return true;
+}
+
+bool Queue_radix_sort(Queue* queue, size_t elem_sz, size_t key_offset,
+                      size_t key_width) {
+    assert(queue != NULL);
+    assert(key_width >= 1 && key_width <= MAX_KEY_WIDTH &&
+           "unsupported key width");
+    assert(key_offset + key_width <= elem_sz && "key does not fit in elements");
+
+    size_t const n = Queue_size(queue);
+    if (n < 2) return true;
+
+    // Count the byte values of all keys in a single pass
+    size_t (*counts)[RADIX] = calloc(key_width, sizeof(*counts));
+    if (counts == NULL) return false;
+
+    size_t      len = 0;
+    char const* seg = NULL;
+    while ((seg = Queue_segment(queue, seg, &len)) != NULL) {
+        count_digits(seg, len, elem_sz, key_offset, key_width, counts);
+    }
+
+    char* base = Queue_linearize(queue);
+    bool  res  = base != NULL ? radix_sort_array(base, n, elem_sz, key_offset,
+                                                 key_width, counts)
+                              : radix_sort_by_transfer(queue, elem_sz,
+                                                       key_offset, key_width,
+                                                       counts);
+    free(counts);
+    return res;
+}
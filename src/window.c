@@ -0,0 +1,198 @@
+/*** Out-of-line definitions ***/
+
+#include "algos.h"
+#include "deque.h"   // Deque, Deque_*()
+
+#include <stdbool.h>   // bool
+#include <stdlib.h>    // malloc(), free()
+#include <string.h>    // memcpy()
+#include <assert.h>    // assert()
+
+struct mono_window
+{
+    Deque* deque;    // Candidates for the extreme, each after its sequence no.
+    char*  entry;    // Scratch space for a deque entry
+    size_t elemsz;   // Size of each element in bytes
+    size_t width;    // Number of most recent elements in the window
+    size_t count;    // Number of elements added so far
+    bool (*compare)(void const*, void const*);   // Element order
+};
+
+MonoWindow* MonoWindow_create(size_t elem_sz, size_t width,
+                              bool (*compare)(void const*, void const*)) {
+    assert(width > 0 && "window width is zero");
+    assert(compare != NULL && "compare is not a binary predicate");
+
+    MonoWindow* window = malloc(sizeof(MonoWindow));
+    if (window == NULL) return NULL;
+
+    window->deque = Deque_create(sizeof(size_t) + elem_sz);
+    window->entry = malloc(sizeof(size_t) + elem_sz);
+    if (window->deque == NULL || window->entry == NULL) {
+        if (window->deque != NULL) Deque_destroy(window->deque);
+        free(window->entry);
+        free(window);
+        return NULL;
+    }
+
+    window->elemsz  = elem_sz;
+    window->width   = width;
+    window->count   = 0;
+    window->compare = compare;
+    return window;
+}
+
+void MonoWindow_destroy(MonoWindow* window) {
+    if (window == NULL) return;
+
+    Deque_destroy(window->deque);
+    free(window->entry);
+    free(window);
+}
+
+bool MonoWindow_push(MonoWindow* window, void const* elem) {
+    assert(window != NULL);
+
+    Deque* const deque = window->deque;
+    size_t const seq   = window->count;
+
+    // Candidates that the element goes before, or equals, never become the
+    // extreme again; there's no back candidate once the deque is empty
+    char const* back = NULL;
+    while ((back = Deque_at(deque, Deque_size(deque) - 1)) != NULL &&
+           !window->compare(back + sizeof(size_t), elem)) {
+        Deque_pop_back(deque);
+    }
+
+    memcpy(window->entry, &seq, sizeof(size_t));
+    memcpy(window->entry + sizeof(size_t), elem, window->elemsz);
+    if (!Deque_push_back(deque, window->entry)) return false;
+    window->count += 1;
+
+    // Evict the least recent candidate once it falls out of the window
+    size_t front_seq = 0;
+    memcpy(&front_seq, Deque_at(deque, 0), sizeof(size_t));
+    if (seq - front_seq >= window->width) Deque_pop_front(deque);
+    return true;
+}
+
+void const* MonoWindow_extreme(MonoWindow* window) {
+    assert(window != NULL);
+
+    char const* front = Deque_at(window->deque, 0);
+    return front != NULL ? front + sizeof(size_t) : NULL;
+}
+
+struct agg_window
+{
+    Deque* elems;      // Elements in the window, least recent first
+    char*  suffixes;   // Aggregates of each suffix of the front stack
+    size_t nfront;     // Number of elements in the front stack
+    size_t top;        // Position of the aggregate of the front stack
+    char*  back;       // Running aggregate of the back stack
+    char*  tmp;        // Scratch space for an aggregate
+    size_t elemsz;     // Size of each element in bytes
+    size_t width;      // Number of most recent elements in the window
+    AggOp  op;         // Associative operation
+};
+
+AggWindow* AggWindow_create(size_t elem_sz, size_t width, AggOp op) {
+    assert(width > 0 && "window width is zero");
+    assert(op != NULL && "op is not a binary operation");
+
+    AggWindow* window = malloc(sizeof(AggWindow));
+    if (window == NULL) return NULL;
+
+    // The front stack holds up to the whole window plus the element added
+    window->elems    = Deque_create(elem_sz);
+    window->suffixes = malloc((width + 1) * elem_sz);
+    window->back     = malloc(2 * elem_sz);
+    if (window->elems == NULL || window->suffixes == NULL ||
+        window->back == NULL || !Deque_reserve(window->elems, width + 1)) {
+        if (window->elems != NULL) Deque_destroy(window->elems);
+        free(window->suffixes);
+        free(window->back);
+        free(window);
+        return NULL;
+    }
+
+    window->tmp    = window->back + elem_sz;
+    window->nfront = 0;
+    window->top    = 0;
+    window->elemsz = elem_sz;
+    window->width  = width;
+    window->op     = op;
+    return window;
+}
+
+void AggWindow_destroy(AggWindow* window) {
+    if (window == NULL) return;
+
+    Deque_destroy(window->elems);
+    free(window->suffixes);
+    free(window->back);
+    free(window);
+}
+
+/**
+ * Moves all elements of the back stack of a window to its empty front stack,
+ * computing the aggregate of each suffix from the most recent element.
+ */
+static void flip(AggWindow* window) {
+    assert(window->nfront == 0 && "front stack not empty");
+
+    size_t const elem_sz = window->elemsz;
+    size_t const n       = Deque_size(window->elems);
+    char* const  last    = window->suffixes + (n - 1) * elem_sz;
+
+    memcpy(last, Deque_at(window->elems, n - 1), elem_sz);
+    for (size_t i = n - 1; i-- > 0;) {
+        char* const suffix = window->suffixes + i * elem_sz;
+        window->op(suffix, Deque_at(window->elems, i), suffix + elem_sz);
+    }
+
+    window->nfront = n;
+    window->top    = 0;
+}
+
+bool AggWindow_push(AggWindow* window, void const* elem) {
+    assert(window != NULL);
+
+    size_t const elem_sz = window->elemsz;
+    size_t const nback   = Deque_size(window->elems) - window->nfront;
+
+    if (!Deque_push_back(window->elems, elem)) return false;
+
+    if (nback == 0) {
+        memcpy(window->back, elem, elem_sz);
+    } else {
+        window->op(window->tmp, window->back, elem);
+        memcpy(window->back, window->tmp, elem_sz);
+    }
+
+    // Evict the least recent element once the window is full
+    if (Deque_size(window->elems) > window->width) {
+        if (window->nfront == 0) flip(window);
+        Deque_pop_front(window->elems);
+        window->nfront -= 1;
+        window->top    += 1;
+    }
+    return true;
+}
+
+bool AggWindow_aggregate(AggWindow* window, void* result) {
+    assert(window != NULL);
+
+    size_t const n = Deque_size(window->elems);
+    if (n == 0) return false;
+
+    char const* front = window->suffixes + window->top * window->elemsz;
+    if (window->nfront == n) {
+        memcpy(result, front, window->elemsz);
+    } else if (window->nfront == 0) {
+        memcpy(result, window->back, window->elemsz);
+    } else {
+        window->op(result, front, window->back);
+    }
+    return true;
+}
@@ -0,0 +1,285 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), srand()
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"    // UnitTest, run_tests(), handle_error()
+#include "delayqueue.h"    // DelayQueue, DelayQueue_*()
+
+/** Span of ticks of the timing wheel, beyond which elements are moved again. */
+static uint64_t const WHEEL_SPAN = (uint64_t)1 << 24;
+
+/** An element that records when it is due and which one it is. */
+typedef struct {
+    uint64_t due;
+    size_t   key;
+} Timeout;
+
+/** Expiry context that records how many elements expired, and which. */
+typedef struct {
+    DelayQueue* dq;
+    size_t      n;
+    bool*       expired;   // Keys of the elements expired, if not `NULL`.
+} Expired;
+
+/** Checks that an element expires on its due tick, and only once. */
+void check_due(void const* elem, void* ctx) {
+    Timeout const* t = elem;
+    Expired*       x = ctx;
+    assert(t->due == DelayQueue_now(x->dq) && "element expires off its tick");
+    if (x->expired != NULL) {
+        assert(!x->expired[t->key] && "element expires more than once");
+        x->expired[t->key] = true;
+    }
+    x->n += 1;
+}
+
+/** Schedules an element due after a delay, exiting on failure. */
+TimerId schedule(DelayQueue* dq, uint64_t delay, size_t key) {
+    Timeout const t  = { DelayQueue_now(dq) + (delay > 0 ? delay : 1), key };
+    TimerId       id = 0;
+    if (!DelayQueue_schedule(dq, delay, &t, &id)) {
+        handle_error("cannot allocate memory to schedule()");
+    }
+    return id;
+}
+
+void test_empty() {
+    //
+    DelayQueue* dq = DelayQueue_create(sizeof(Timeout));
+    Expired     x  = { dq, 0, NULL };
+    if (dq == NULL) handle_error("cannot allocate memory for a delayqueue");
+
+    assert(DelayQueue_empty(dq) && DelayQueue_size(dq) == 0 &&
+           DelayQueue_now(dq) == 0 && "delay queue not empty when created");
+
+    bool const   cancelled = DelayQueue_cancel(dq, 0);
+    assert(!cancelled && "DelayQueue_cancel() returns true when empty");
+
+    size_t const expired   = DelayQueue_advance(dq, 1000, check_due, &x);
+    assert(expired == 0 && x.n == 0 &&
+           "DelayQueue_advance() expires elements when empty");
+    assert(DelayQueue_now(dq) == 1000 && "DelayQueue_advance() skips ticks");
+
+    (void)cancelled;
+    (void)expired;
+    DelayQueue_destroy(dq);
+}
+
+void test_expire_on_due_tick() {
+    //
+    uint64_t const delays[] = { 0, 1, 2, 63, 64, 65, 4095, 4096, 4097,
+                                262143, 262144, 262145, WHEEL_SPAN - 1,
+                                WHEEL_SPAN, WHEEL_SPAN + 1,
+                                2 * WHEEL_SPAN + 77 };
+    size_t const   n        = sizeof(delays) / sizeof(delays[0]);
+
+    // Start off a tick that is a multiple of the spans of the levels
+    for (uint64_t start = 0; start < 2 * WHEEL_SPAN; start += WHEEL_SPAN - 3) {
+        DelayQueue* dq = DelayQueue_create(sizeof(Timeout));
+        Expired     x  = { dq, 0, NULL };
+        if (dq == NULL) handle_error("cannot allocate memory for a delayqueue");
+
+        DelayQueue_advance(dq, start, check_due, &x);
+        for (size_t i = 0; i < n; ++i) schedule(dq, delays[i], i);
+        assert(DelayQueue_size(dq) == n && "DelayQueue_size() is wrong");
+
+        size_t expired = 0;
+        while (!DelayQueue_empty(dq)) {
+            expired += DelayQueue_advance(dq, 4093, check_due, &x);
+        }
+        assert(expired == n && x.n == n && "elements lost in the wheel");
+
+        (void)expired;
+        DelayQueue_destroy(dq);
+    }
+}
+
+void test_cancel() {
+    //
+    size_t const n       = 3000;
+    bool*        expired = calloc(n, sizeof(bool));
+    TimerId*     ids     = malloc(n * sizeof(TimerId));
+    DelayQueue*  dq      = DelayQueue_create(sizeof(Timeout));
+    Expired      x       = { dq, 0, expired };
+    if (expired == NULL || ids == NULL || dq == NULL) {
+        handle_error("cannot allocate memory");
+    }
+
+    for (size_t i = 0; i < n; ++i) ids[i] = schedule(dq, i * 7, i);
+    for (size_t i = 0; i < n; i += 3) {
+        bool const cancelled = DelayQueue_cancel(dq, ids[i]);
+        assert(cancelled && "DelayQueue_cancel() fails on a pending element");
+
+        bool const again     = DelayQueue_cancel(dq, ids[i]);
+        assert(!again &&
+               "DelayQueue_cancel() returns true when already cancelled");
+
+        (void)cancelled;
+        (void)again;
+    }
+    assert(DelayQueue_size(dq) == n - n / 3 &&
+           "DelayQueue_size() counts cancelled elements");
+
+    DelayQueue_advance(dq, n * 7, check_due, &x);
+    assert(DelayQueue_empty(dq) && x.n == n - n / 3 &&
+           "elements not expired when due");
+    for (size_t i = 0; i < n; ++i) {
+        bool const cancelled = DelayQueue_cancel(dq, ids[i]);
+        assert(expired[i] == (i % 3 != 0) && "cancelled elements expire");
+        assert(!cancelled &&
+               "DelayQueue_cancel() returns true when already expired");
+
+        (void)cancelled;
+    }
+
+    free(expired);
+    free(ids);
+    DelayQueue_destroy(dq);
+}
+
+/** Number of times an element is scheduled again when it expires. */
+static size_t const N_RETRIES = 5;
+
+/** Schedules an element again, with a longer delay, until out of retries. */
+void retry(void const* elem, void* ctx) {
+    Timeout const* t = elem;
+    Expired*       x = ctx;
+    check_due(elem, ctx);
+    if (t->key < N_RETRIES) schedule(x->dq, (t->key + 1) * 100, t->key + 1);
+}
+
+void test_schedule_on_expiry() {
+    //
+    DelayQueue* dq = DelayQueue_create(sizeof(Timeout));
+    Expired     x  = { dq, 0, NULL };
+    if (dq == NULL) handle_error("cannot allocate memory for a delayqueue");
+
+    schedule(dq, 1, 0);
+    size_t const expired = DelayQueue_advance(dq, 10000, retry, &x);
+    assert(expired == N_RETRIES + 1 && x.n == N_RETRIES + 1 &&
+           DelayQueue_empty(dq) && "elements scheduled on expiry lost");
+    assert(DelayQueue_now(dq) == 10000 && "DelayQueue_advance() skips ticks");
+
+    (void)expired;
+    DelayQueue_destroy(dq);
+}
+
+void test_random_schedule_cancel_and_advance() {
+    //
+    size_t const n_ops   = 20000;
+    bool*        expired = calloc(n_ops, sizeof(bool));
+    TimerId*     ids     = malloc(n_ops * sizeof(TimerId));
+    DelayQueue*  dq      = DelayQueue_create(sizeof(Timeout));
+    Expired      x       = { dq, 0, expired };
+    size_t       n       = 0;   // number of elements scheduled
+    size_t       n_live  = 0;   // number of elements pending
+    if (expired == NULL || ids == NULL || dq == NULL) {
+        handle_error("cannot allocate memory");
+    }
+
+    // Delays span every level of the wheel, and beyond
+    srand(5);
+    for (size_t i = 0; i < n_ops; ++i) {
+        int const op = rand() % 8;
+        if (op < 4) {
+            uint64_t const delay = (uint64_t)rand() % (1u << (rand() % 26));
+            ids[n] = schedule(dq, delay, n);
+            ++n;
+            ++n_live;
+        } else if (op < 5 && n > 0) {
+            size_t const key = (size_t)rand() % n;
+            if (DelayQueue_cancel(dq, ids[key])) {
+                assert(!expired[key] && "DelayQueue_cancel() after expiry");
+                expired[key] = true;   // so check_due() fails if it expires
+                --n_live;
+            }
+        } else {
+            size_t const ticks = (size_t)rand() % (1u << (rand() % 20));
+            n_live -= DelayQueue_advance(dq, ticks, check_due, &x);
+        }
+        assert(DelayQueue_size(dq) == n_live && "DelayQueue_size() is wrong");
+    }
+
+    while (!DelayQueue_empty(dq)) {
+        n_live -= DelayQueue_advance(dq, WHEEL_SPAN, check_due, &x);
+    }
+    assert(n_live == 0 && "elements lost in the wheel");
+    for (size_t key = 0; key < n; ++key) {
+        assert(expired[key] && "element neither expired nor cancelled");
+    }
+
+    free(expired);
+    free(ids);
+    DelayQueue_destroy(dq);
+}
+
+/**
+ * Runs all tests on the DelayQueue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_empty,
+                          test_expire_on_due_tick,
+                          test_cancel,
+                          test_schedule_on_expiry,
+                          test_random_schedule_cancel_and_advance,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/delayqueue_wheel.c test_delayqueue.c -o test_delayqueue_circ_array -std=c99 -g -Og -Wall -pedantic -march=native -DQUEUE_INIT_CAP=2 -I../src && ./test_delayqueue_circ_array
+
+gcc ../src/queue_linked_list.c ../src/delayqueue_wheel.c test_delayqueue.c -o test_delayqueue_linked_list -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_delayqueue_linked_list
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/
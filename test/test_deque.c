@@ -0,0 +1,320 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, rand(), srand()
+#include <stdio.h>    // printf(), stderr
+#include <string.h>   // memset(), strcmp()
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "deque.h"        // Deque, Deque_*()
+
+static int    NUMS[]      = { 3, 1, 4, 1, 5, 9, 2, 6, 5, 3, 5 };
+static size_t MAX_N_ELEMS = sizeof(NUMS) / sizeof(int);
+
+void print_int(void const* a) { printf("%d", *(int*)a); }
+
+Deque* create_empty_test_deque(void) {
+    Deque* d = Deque_create(sizeof(int));
+    if (d == NULL) handle_error("cannot allocate memory to create a deque");
+    return d;
+}
+
+/**
+ * Creates a deque of the first `n_elems` numbers, pushing them alternately to
+ * the front and to the back so that they wrap around the underlying array.
+ */
+Deque* create_prefilled_test_deque(size_t n_elems) {
+    if (n_elems > MAX_N_ELEMS) {
+        handle_error(
+            "number of prefilled elements exceeded maximum allowed value");
+    }
+
+    Deque* d = create_empty_test_deque();
+    for (size_t i = 0; i < n_elems; ++i) {
+        bool const res = i % 2 == 0 ? Deque_push_front(d, &NUMS[i])
+                                    : Deque_push_back(d, &NUMS[i]);
+        if (!res) handle_error("cannot allocate memory to push an element");
+    }
+    return d;
+}
+
+/** Position of the `i`-th number in a deque created by the function above. */
+size_t prefilled_pos(size_t i, size_t n_elems) {
+    size_t const n_front = (n_elems + 1) / 2;
+    return i % 2 == 0 ? n_front - 1 - i / 2 : n_front + i / 2;
+}
+
+void test_create() {
+    //
+    Deque* d = create_empty_test_deque();
+
+    assert(Deque_size(d) == 0 && Deque_empty(d) && "deque size is not zero");
+    assert(Deque_capacity(d) > 0 && "deque capacity is zero");
+    assert((Deque_capacity(d) & (Deque_capacity(d) - 1)) == 0 &&
+           "deque capacity is not a power of two");
+
+    Deque_destroy(d);
+}
+
+void test_access_when_empty() {
+    //
+    Deque* d    = create_empty_test_deque();
+    int    elem = 0;
+
+    assert(!Deque_front(d, &elem) &&
+           "Deque_front() returns true when deque is empty");
+    assert(!Deque_back(d, &elem) &&
+           "Deque_back() returns true when deque is empty");
+    assert(Deque_at(d, 0) == NULL &&
+           "Deque_at() returns non-NULL value when deque is empty");
+    assert(!Deque_pop_front(d) &&
+           "Deque_pop_front() returns true when deque is empty");
+    assert(!Deque_pop_back(d) &&
+           "Deque_pop_back() returns true when deque is empty");
+
+    (void)elem;
+    Deque_destroy(d);
+}
+
+void test_push_both_ends() {
+    //
+    Deque* d = create_prefilled_test_deque(MAX_N_ELEMS);
+    assert(Deque_size(d) == MAX_N_ELEMS && "Deque_size() returns wrong size");
+
+    for (size_t i = 0; i < MAX_N_ELEMS; ++i) {
+        int const* elem = Deque_at(d, prefilled_pos(i, MAX_N_ELEMS));
+        assert(elem != NULL && *elem == NUMS[i] &&
+               "Deque_at() returns wrong element");
+        (void)elem;
+    }
+    assert(Deque_at(d, MAX_N_ELEMS) == NULL &&
+           "Deque_at() returns non-NULL value when out of range");
+
+    int front = 0, back = 0;
+    if (!Deque_front(d, &front) || !Deque_back(d, &back)) {
+        handle_error("Deque_front() or Deque_back() fails when not empty");
+    }
+    assert(front == NUMS[MAX_N_ELEMS - 1] && back == NUMS[MAX_N_ELEMS - 2] &&
+           "Deque_front() or Deque_back() copies wrong element");
+
+    Deque_destroy(d);
+}
+
+void test_at_writes_in_place() {
+    //
+    Deque* d = create_prefilled_test_deque(5);
+
+    *(int*)Deque_at(d, 2) = 42;
+
+    int const* elem = Deque_at(d, 2);
+    assert(*elem == 42 && "Deque_at() does not access element in place");
+
+    (void)elem;
+    Deque_destroy(d);
+}
+
+void test_pop_both_ends() {
+    //
+    Deque* d    = create_prefilled_test_deque(MAX_N_ELEMS);
+    int    elem = 0;
+
+    // Elements pushed to the front come off the front in reverse order
+    for (size_t i = MAX_N_ELEMS - 1; Deque_size(d) > 1; --i) {
+        bool const from_front = i % 2 == 0;
+        if (!(from_front ? Deque_front(d, &elem) : Deque_back(d, &elem))) {
+            handle_error("Deque_front() or Deque_back() fails when not empty");
+        }
+        assert(elem == NUMS[i] && "popping removes wrong element");
+
+        if (!(from_front ? Deque_pop_front(d) : Deque_pop_back(d))) {
+            handle_error("popping fails when deque not empty");
+        }
+    }
+    if (!Deque_pop_back(d)) handle_error("popping fails when deque not empty");
+    assert(Deque_empty(d) && "deque not empty after popping all elements");
+
+    Deque_destroy(d);
+}
+
+void test_matches_array_model() {
+    //
+    size_t const n_ops = 20000;
+    int* const   model = malloc(2 * n_ops * sizeof(int));
+    size_t       first = n_ops, last = n_ops;   // model holds [first, last)
+    Deque*       d     = create_empty_test_deque();
+    if (model == NULL) handle_error("cannot allocate memory for model");
+
+    // Grow to thousands of elements and shrink back, pushing and popping at
+    // random ends
+    srand(42);
+    for (size_t i = 0; i < n_ops; ++i) {
+        int const  r     = rand();
+        bool const grow  = (i / 5000) % 2 == 0 ? r % 4 != 0 : r % 4 == 0;
+        bool const front = r / 4 % 2 == 0;
+        bool       res;
+
+        if (grow || first == last) {
+            res = front ? Deque_push_front(d, &r) : Deque_push_back(d, &r);
+            if (!res) handle_error("cannot allocate memory to push element");
+            model[front ? --first : last++] = r;
+        } else {
+            res = front ? Deque_pop_front(d) : Deque_pop_back(d);
+            assert(res && "popping fails when deque not empty");
+            front ? ++first : --last;
+        }
+
+        assert(Deque_size(d) == last - first && "deque size differs");
+        assert(Deque_capacity(d) >= Deque_size(d) && "capacity too small");
+        if (i % 97 == 0) {
+            for (size_t j = first; j < last; ++j) {
+                assert(*(int*)Deque_at(d, j - first) == model[j] &&
+                       "deque elements differ");
+            }
+        }
+    }
+
+    free(model);
+    Deque_destroy(d);
+}
+
+void test_reserve_and_clear() {
+    //
+    Deque* d = create_prefilled_test_deque(5);
+
+    if (!Deque_reserve(d, 3000)) {
+        handle_error("cannot allocate memory to reserve capacity");
+    }
+    size_t const cap = Deque_capacity(d);
+    assert(cap >= 3000 && "Deque_reserve() does not reserve enough capacity");
+    assert(Deque_size(d) == 5 && "Deque_reserve() changes deque size");
+    for (size_t i = 0; i < 5; ++i) {
+        assert(*(int*)Deque_at(d, prefilled_pos(i, 5)) == NUMS[i] &&
+               "Deque_reserve() reorders elements");
+    }
+
+    for (size_t i = 0; i < 3000; ++i) {
+        if (!Deque_push_front(d, &NUMS[0])) {
+            handle_error("cannot allocate memory to push an element");
+        }
+    }
+    assert(Deque_capacity(d) == cap && "deque grows within reserved capacity");
+
+    Deque_clear(d);
+    assert(Deque_empty(d) && "Deque_clear() leaves elements");
+    assert(Deque_capacity(d) == cap && "Deque_clear() releases capacity");
+
+    (void)cap;
+    Deque_destroy(d);
+}
+
+void test_print_when_nonempty() {
+    //
+    Deque* d             = create_prefilled_test_deque(5);
+
+    char const* expected = "5,4,3,1,1";
+
+    size_t const buf_sz  = 0x400;
+
+    char actual[buf_sz];
+    memset(actual, 0, buf_sz);
+
+    FILE* f1 = freopen("/dev/null", "a", stdout);
+    (void)f1;
+    setvbuf(stdout, actual, _IOFBF, buf_sz);
+
+    // horizontal layout
+    Deque_print(d, ",", false, print_int);
+
+    // detach the stack buffer before it goes out of scope
+    FILE* f2 = freopen("/dev/tty", "a", stdout);
+    (void)f2;
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    printf(">> actual  : %s\n", actual);
+    printf(">> expected: %s\n", expected);
+
+    assert(strcmp(expected, actual) == 0 &&
+           "string print to stdout differs from what is expected");
+
+    Deque_destroy(d);
+}
+
+/**
+ * Runs all tests on the Deque ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_create,
+                          test_access_when_empty,
+                          test_push_both_ends,
+                          test_at_writes_in_place,
+                          test_pop_both_ends,
+                          test_matches_array_model,
+                          test_reserve_and_clear,
+                          test_print_when_nonempty,
+                          NULL };
+    run_tests(utests);
+
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/deque_circ_array.c test_deque.c -o test_deque -std=c99 -g -Og -Wall -pedantic -march=native -DDEQUE_INIT_CAP=2 -I../src && ./test_deque
+
+gcc ../src/deque_circ_array.c test_deque.c -o test_deque -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_deque
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+Running...
+Test 6 passed 👍
+Running...
+Test 7 passed 👍
+Running...
+>> actual  : 5,4,3,1,1
+>> expected: 5,4,3,1,1
+Test 8 passed 👍
+ALL PASSED
+*/
@@ -0,0 +1,254 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), srand()
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "intqueue.h"     // IntQueue, IntQueue_*()
+
+/** A cheap pseudo-random number generator of all 64 bits. */
+uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/** Adds values to an integer queue, exiting on failure. */
+void write_all(IntQueue* iq, uint64_t const* values, size_t n) {
+    if (IntQueue_write(iq, values, n) != n) {
+        handle_error("cannot allocate memory to write()");
+    }
+}
+
+void test_empty() {
+    //
+    IntQueue* iq    = IntQueue_create();
+    uint64_t  value = 0;
+    if (iq == NULL) handle_error("cannot allocate memory for an intqueue");
+
+    assert(IntQueue_empty(iq) && IntQueue_size(iq) == 0 &&
+           "integer queue not empty when created");
+    assert(!IntQueue_front(iq, &value) &&
+           "IntQueue_front() returns true when empty");
+    assert(!IntQueue_dequeue(iq) &&
+           "IntQueue_dequeue() returns true when empty");
+    assert(IntQueue_read(iq, &value, 1) == 0 &&
+           "IntQueue_read() returns values when empty");
+
+    (void)value;
+    IntQueue_destroy(iq);
+}
+
+void test_fifo_sequential() {
+    //
+    uint64_t const n  = 1000000;
+    IntQueue*      iq = IntQueue_create();
+    if (iq == NULL) handle_error("cannot allocate memory for an intqueue");
+
+    // Remove some values while adding, across block boundaries
+    uint64_t front = 0;
+    for (uint64_t i = 0; i < n; ++i) {
+        if (!IntQueue_enqueue(iq, 1000 + i)) {
+            handle_error("cannot allocate memory to enqueue()");
+        }
+        if (i % 5 == 4) {
+            uint64_t value = 0;
+            if (!IntQueue_front(iq, &value)) handle_error("front() failed");
+            assert(value == 1000 + front && "values not dequeued in order");
+            if (!IntQueue_dequeue(iq)) handle_error("dequeue() failed");
+            front += 1;
+            (void)value;
+        }
+    }
+    assert(IntQueue_size(iq) == n - front &&
+           "IntQueue_size() returns wrong size");
+
+    // Sequential IDs compress to well under a byte each
+    assert(IntQueue_bytes(iq) < IntQueue_size(iq) &&
+           "sequential values not compressed");
+
+    for (; front < n; ++front) {
+        uint64_t value = 0;
+        if (!IntQueue_front(iq, &value)) handle_error("front() failed");
+        assert(value == 1000 + front && "values not dequeued in order");
+        if (!IntQueue_dequeue(iq)) handle_error("dequeue() failed");
+        (void)value;
+    }
+    assert(IntQueue_empty(iq) && "integer queue not empty when drained");
+
+    IntQueue_destroy(iq);
+}
+
+void test_round_trip_widths() {
+    //
+    size_t const n      = 10 * INTQUEUE_BLOCK_LEN + 17;
+    uint64_t*    values = malloc(n * sizeof(uint64_t));
+    uint64_t*    out    = malloc(n * sizeof(uint64_t));
+    uint64_t     state  = 88172645463325252u;
+    if (values == NULL || out == NULL) handle_error("cannot allocate memory");
+
+    // Differences of every width, of both signs, and values that wrap around
+    for (unsigned width = 0; width <= 64; ++width) {
+        uint64_t const mask = width == 64 ? ~(uint64_t)0
+                                          : ((uint64_t)1 << width) - 1;
+        values[0] = UINT64_MAX - 3 * INTQUEUE_BLOCK_LEN;
+        for (size_t i = 1; i < n; ++i) {
+            uint64_t const d = next_random(&state) & mask;
+            values[i] = width % 2 == 0 ? values[i - 1] + d : values[i - 1] - d;
+        }
+
+        IntQueue* iq = IntQueue_create();
+        if (iq == NULL) handle_error("cannot allocate memory for an intqueue");
+        if (!IntQueue_enqueue(iq, values[0])) handle_error("enqueue() failed");
+        write_all(iq, values + 1, n - 1);
+        assert(IntQueue_size(iq) == n && "IntQueue_size() returns wrong size");
+
+        // Read in uneven chunks, some of them longer than a block
+        size_t done = 0;
+        while (done < n) {
+            size_t const chunk = 1 + (size_t)rand() % (2 * INTQUEUE_BLOCK_LEN);
+            done += IntQueue_read(iq, out + done, chunk);
+        }
+        for (size_t i = 0; i < n; ++i) {
+            assert(out[i] == values[i] && "values not read back intact");
+        }
+        assert(IntQueue_empty(iq) && "integer queue not empty when drained");
+
+        IntQueue_destroy(iq);
+    }
+
+    free(out);
+    free(values);
+}
+
+void test_random_ops() {
+    //
+    srand(49);
+    size_t const cap   = 1 << 20;
+    uint64_t*    model = malloc(cap * sizeof(uint64_t));
+    uint64_t     buf[3 * INTQUEUE_BLOCK_LEN];
+    uint64_t     state = 1;
+    uint64_t     last  = 0;
+    IntQueue*    iq    = IntQueue_create();
+    if (model == NULL) handle_error("cannot allocate memory for the model");
+    if (iq == NULL) handle_error("cannot allocate memory for an intqueue");
+
+    // Values [front, back) of the model are in the integer queue
+    size_t front = 0;
+    size_t back  = 0;
+    for (int iter = 0; iter < 20000; ++iter) {
+        size_t const k = (size_t)rand() % (3 * INTQUEUE_BLOCK_LEN);
+        switch (rand() % 4) {
+        case 0:
+            if (back + k > cap) break;
+            for (size_t i = 0; i < k; ++i) {
+                last          += next_random(&state) % 1000;
+                model[back++]  = last;
+                if (!IntQueue_enqueue(iq, last)) handle_error("enqueue failed");
+            }
+            break;
+        case 1:
+            if (back + k > cap) break;
+            for (size_t i = 0; i < k; ++i) {
+                last   += next_random(&state) % 1000;
+                buf[i]  = last;
+            }
+            write_all(iq, buf, k);
+            for (size_t i = 0; i < k; ++i) model[back++] = buf[i];
+            break;
+        case 2: {
+            size_t const m = IntQueue_read(iq, buf, k);
+            assert(m == (back - front < k ? back - front : k) &&
+                   "IntQueue_read() returns wrong number of values");
+            for (size_t i = 0; i < m; ++i) {
+                assert(buf[i] == model[front + i] &&
+                       "values not read in order");
+            }
+            front += m;
+            break;
+        }
+        default:
+            for (size_t i = 0; i < k % 16 && front < back; ++i) {
+                uint64_t value = 0;
+                if (!IntQueue_front(iq, &value)) handle_error("front() failed");
+                assert(value == model[front] && "values not dequeued in order");
+                if (!IntQueue_dequeue(iq)) handle_error("dequeue() failed");
+                front += 1;
+                (void)value;
+            }
+        }
+        assert(IntQueue_size(iq) == back - front &&
+               "IntQueue_size() returns wrong size");
+    }
+
+    IntQueue_destroy(iq);
+    free(model);
+}
+
+/**
+ * Runs all tests on the IntQueue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_empty,
+                          test_fifo_sequential,
+                          test_round_trip_widths,
+                          test_random_ops,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/recordqueue_circ_array.c ../src/intqueue_delta.c test_intqueue.c -o test_intqueue -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_intqueue
+
+gcc ../src/recordqueue_circ_array.c ../src/intqueue_delta.c test_intqueue.c -o test_intqueue -std=c99 -O3 -march=native -mno-avx2 -DNDEBUG -I../src && ./test_intqueue
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+ALL PASSED
+*/
@@ -0,0 +1,259 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), srand()
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "lanequeue.h"    // LaneQueue, LaneQueue_*()
+
+/** An element that records the lane it was added to and when. */
+typedef struct {
+    int lane;
+    int seq;
+} Job;
+
+/** Adds a job to a lane of a multi-level queue, exiting on failure. */
+void enqueue_job(LaneQueue* lq, int lane, int seq) {
+    Job const job = { lane, seq };
+    if (!LaneQueue_enqueue(lq, (size_t)lane, &job)) {
+        handle_error("cannot allocate memory to enqueue()");
+    }
+}
+
+void test_empty() {
+    //
+    LaneQueue* lq   = LaneQueue_create(sizeof(Job), LANEQUEUE_MAX_LANES);
+    Job        job  = { 0, 0 };
+    size_t     lane = 0;
+    if (lq == NULL) handle_error("cannot allocate memory for a lanequeue");
+
+    assert(LaneQueue_lanes(lq) == LANEQUEUE_MAX_LANES &&
+           "LaneQueue_lanes() returns wrong number of lanes");
+    assert(LaneQueue_empty(lq) && LaneQueue_size(lq) == 0 &&
+           "multi-level queue not empty when created");
+    assert(LaneQueue_lane_size(lq, 0) == 0 &&
+           LaneQueue_lane_size(lq, LANEQUEUE_MAX_LANES - 1) == 0 &&
+           "lanes not empty when created");
+    assert(!LaneQueue_front(lq, &job, &lane) &&
+           "LaneQueue_front() returns true when empty");
+    assert(LaneQueue_peek(lq, NULL) == NULL &&
+           "LaneQueue_peek() returns non-NULL value when empty");
+    assert(!LaneQueue_dequeue(lq) &&
+           "LaneQueue_dequeue() returns true when empty");
+
+    (void)job;
+    (void)lane;
+    LaneQueue_destroy(lq);
+}
+
+void test_fifo_within_lane() {
+    //
+    int const  n  = 5000;
+    LaneQueue* lq = LaneQueue_create(sizeof(Job), 3);
+    if (lq == NULL) handle_error("cannot allocate memory for a lanequeue");
+
+    // Remove some elements while adding, so its front wraps around
+    for (int i = 0; i < n; ++i) {
+        enqueue_job(lq, 1, i);
+        if (i % 3 == 2 && !LaneQueue_dequeue(lq)) {
+            handle_error("LaneQueue_dequeue() failed");
+        }
+    }
+    assert(LaneQueue_lane_size(lq, 1) == (size_t)(n - n / 3) &&
+           LaneQueue_size(lq) == (size_t)(n - n / 3) &&
+           "LaneQueue_size() returns wrong size");
+
+    for (int i = n / 3; i < n; ++i) {
+        Job    job  = { -1, -1 };
+        size_t lane = 0;
+        if (!LaneQueue_front(lq, &job, &lane)) {
+            handle_error("LaneQueue_front() failed");
+        }
+        assert(job.seq == i && lane == 1 && "elements not dequeued in order");
+        if (!LaneQueue_dequeue(lq)) handle_error("LaneQueue_dequeue() failed");
+        (void)job;
+    }
+    assert(LaneQueue_empty(lq) && "multi-level queue not empty when drained");
+
+    LaneQueue_destroy(lq);
+}
+
+void test_highest_lane_first() {
+    //
+    int const  per_lane = 100;
+    int const  n_lanes  = LANEQUEUE_MAX_LANES;
+    LaneQueue* lq       = LaneQueue_create(sizeof(Job), (size_t)n_lanes);
+    if (lq == NULL) handle_error("cannot allocate memory for a lanequeue");
+
+    // Interleave the lanes so that no lane is added to as a whole
+    for (int i = 0; i < per_lane; ++i) {
+        for (int lane = 0; lane < n_lanes; ++lane) {
+            enqueue_job(lq, (lane * 37) % n_lanes, i);
+        }
+    }
+
+    for (int lane = n_lanes - 1; lane >= 0; --lane) {
+        for (int i = 0; i < per_lane; ++i) {
+            size_t     top = 0;
+            Job const* job = LaneQueue_peek(lq, &top);
+            assert(job != NULL && job->lane == lane && job->seq == i &&
+                   top == (size_t)lane &&
+                   "elements not dequeued by lane then in order");
+            if (!LaneQueue_dequeue(lq)) {
+                handle_error("LaneQueue_dequeue() failed");
+            }
+            (void)job;
+        }
+        assert(LaneQueue_lane_size(lq, (size_t)lane) == 0 &&
+               "lane not empty when drained");
+    }
+    assert(LaneQueue_empty(lq) && "multi-level queue not empty when drained");
+
+    LaneQueue_destroy(lq);
+}
+
+void test_interleaved_enqueue_and_dequeue() {
+    //
+    int const  n_ops     = 50000;
+    int const  n_lanes   = 10;
+    int        added[10] = { 0 };   // number of jobs added to each lane
+    int        taken[10] = { 0 };   // number of jobs dequeued from each lane
+    LaneQueue* lq        = LaneQueue_create(sizeof(Job), (size_t)n_lanes);
+    if (lq == NULL) handle_error("cannot allocate memory for a lanequeue");
+
+    // Check the next element against the highest lane with jobs left
+    srand(4);
+    for (int i = 0; i < n_ops; ++i) {
+        if (rand() % 2 == 0) {
+            int const lane = rand() % n_lanes;
+            enqueue_job(lq, lane, added[lane]++);
+            continue;
+        }
+
+        int top = n_lanes - 1;
+        while (top >= 0 && added[top] == taken[top]) --top;
+        if (top < 0) {
+            assert(!LaneQueue_dequeue(lq) &&
+                   "LaneQueue_dequeue() returns true when empty");
+            continue;
+        }
+
+        Job job = { -1, -1 };
+        if (!LaneQueue_front(lq, &job, NULL)) {
+            handle_error("LaneQueue_front() failed");
+        }
+        assert(job.lane == top && job.seq == taken[top] &&
+               "LaneQueue_front() differs from the highest lane's front");
+        if (!LaneQueue_dequeue(lq)) handle_error("LaneQueue_dequeue() failed");
+        taken[top] += 1;
+        assert(LaneQueue_lane_size(lq, (size_t)top) ==
+                   (size_t)(added[top] - taken[top]) &&
+               "LaneQueue_lane_size() returns wrong size");
+        (void)job;
+    }
+
+    LaneQueue_destroy(lq);
+}
+
+void test_reserve() {
+    //
+    LaneQueue* lq = LaneQueue_create(sizeof(Job), 2);
+    if (lq == NULL) handle_error("cannot allocate memory for a lanequeue");
+
+    if (!LaneQueue_reserve(lq, 0, 3)) {
+        handle_error("cannot allocate memory to reserve()");
+    }
+    assert(LaneQueue_empty(lq) && "LaneQueue_reserve() adds elements");
+
+    // Reserve more once the front of the lane has moved, then wrap around
+    for (int i = 0; i < 3; ++i) enqueue_job(lq, 0, i);
+    if (!LaneQueue_dequeue(lq) || !LaneQueue_dequeue(lq)) {
+        handle_error("LaneQueue_dequeue() failed");
+    }
+    for (int i = 3; i < 6; ++i) enqueue_job(lq, 0, i);
+    if (!LaneQueue_reserve(lq, 0, 100)) {
+        handle_error("cannot allocate memory to reserve()");
+    }
+    for (int i = 6; i < 100; ++i) enqueue_job(lq, 0, i);
+
+    for (int i = 2; i < 100; ++i) {
+        Job const* job = LaneQueue_peek(lq, NULL);
+        assert(job != NULL && job->seq == i &&
+               "LaneQueue_reserve() reorders elements");
+        if (!LaneQueue_dequeue(lq)) handle_error("LaneQueue_dequeue() failed");
+        (void)job;
+    }
+    assert(LaneQueue_empty(lq) && "multi-level queue not empty when drained");
+
+    LaneQueue_destroy(lq);
+}
+
+/**
+ * Runs all tests on the LaneQueue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_empty,
+                          test_fifo_within_lane,
+                          test_highest_lane_first,
+                          test_interleaved_enqueue_and_dequeue,
+                          test_reserve,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/lanequeue_bitmap.c test_lanequeue.c -o test_lanequeue -std=c99 -g -Og -Wall -pedantic -march=native -DLANEQUEUE_INIT_CAP=2 -I../src && ./test_lanequeue
+
+gcc ../src/lanequeue_bitmap.c test_lanequeue.c -o test_lanequeue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_lanequeue
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/
@@ -30,14 +30,16 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
-#include <stdlib.h>   // EXIT_*, malloc(), free(), memset()
+#include <stdlib.h>   // EXIT_*, malloc(), free(), qsort()
+#include <stdint.h>   // int32_t, uint32_t, int64_t, uint64_t
+#include <stddef.h>   // offsetof()
 #include <stdio.h>    // printf(), stderr,
-#include <string.h>   // strcmp()
+#include <string.h>   // strcmp(), memcmp(), memset()
 #include <assert.h>   // assert()
 
 #include "test_utils.h"   // UnitTest, run_tests(), handle_error()
 #include "queue.h"        // Queue, Queue_*()
-#include "algos.h"        // merge_queues()
+#include "algos.h"        // merge_*()
 
 bool greater(void const* a, void const* b) { return *(int*)a > *(int*)b; }
 bool less(void const* a, void const* b) { return *(int*)a < *(int*)b; }
@@ -277,14 +279,814 @@ void test_merging_two_nonempty(void) {
     Queue_destroy(q_lt);
 }
 
+/** An element ordered by `key` and identified by `tag`. */
+typedef struct
+{
+    int key;
+    int tag;
+} Tagged;
+
+bool key_less(void const* a, void const* b) {
+    return ((Tagged*)a)->key < ((Tagged*)b)->key;
+}
+
 /**
- * Runs all tests on merge_queues().
+ * Fills a queue with `n` elements of ascending keys in clusters of `run`
+ * elements with many duplicates, with random gaps between clusters.
+ */
+Queue* create_clustered_test_queue(size_t n, size_t run, int tag_base) {
+    Queue* q    = Queue_create(sizeof(Tagged));
+    Tagged elem = { 0, 0 };
+    for (size_t i = 0; i < n; ++i) {
+        elem.key += i % run == 0 ? rand() % (4 * (int)run) : rand() % 2;
+        elem.tag  = tag_base + (int)i;
+        if (!Queue_enqueue(q, &elem)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+    return q;
+}
+
+void test_merging_clustered_is_stable(void) {
+    size_t const runs[] = { 1, 5, 40, 1000 };
+    size_t const n_runs = sizeof(runs) / sizeof(runs[0]);
+
+    for (size_t r = 0; r < n_runs; ++r) {
+        srand(r);
+        Queue* p1 = create_clustered_test_queue(3000, runs[r], 0);
+        Queue* p2 = create_clustered_test_queue(2000, runs[r], 1 << 20);
+        srand(r);
+        Queue* s1 = create_clustered_test_queue(3000, runs[r], 0);
+        Queue* s2 = create_clustered_test_queue(2000, runs[r], 1 << 20);
+
+        // The iterator merges element by element, never galloping
+        MergeIter* iter = MergeIter_create(s1, s2, sizeof(Tagged), key_less);
+        Queue*     q    = merge_queues(p1, p2, sizeof(Tagged), key_less);
+        if (iter == NULL) handle_error("cannot allocate memory for an iterator");
+
+        assert(Queue_size(q) == 5000 && "merge_queues() loses elements");
+
+        Tagged expected;
+        while (MergeIter_next(iter, &expected)) {
+            Tagged const actual = *(Tagged const*)Queue_peek(q);
+            assert(actual.key == expected.key && actual.tag == expected.tag &&
+                   "merge_queues() is not stable on clustered queues");
+            if (!Queue_dequeue(q)) {
+                handle_error(
+                    "Queue_dequeue() returns false when queue is not empty");
+            }
+        }
+
+        MergeIter_destroy(iter);
+        Queue_destroy(p1);
+        Queue_destroy(p2);
+        Queue_destroy(s1);
+        Queue_destroy(s2);
+        Queue_destroy(q);
+    }
+}
+
+/** Number of calls to `counting_less()`. */
+static size_t n_compares = 0;
+
+bool counting_less(void const* a, void const* b) {
+    n_compares += 1;
+    return less(a, b);
+}
+
+void test_merging_runs_gallops(void) {
+    size_t const n  = 1000;
+    Queue*       q1 = Queue_create(sizeof(int));
+    Queue*       q2 = Queue_create(sizeof(int));
+    for (int i = 0; i < (int)n; ++i) {
+        int const j = i + (int)n;
+        if (!Queue_enqueue(q1, &i) || !Queue_enqueue(q2, &j)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+
+    // Galloping can only skip comparisons within a contiguous segment
+    size_t len = 0;
+    Queue_segment(q1, NULL, &len);
+
+    n_compares = 0;
+    Queue* q   = merge_queues(q1, q2, sizeof(int), counting_less);
+    assert(Queue_size(q) == 2 * n && "merge_queues() loses elements");
+    assert((len < n || n_compares < n / 10) &&
+           "merge_queues() does not gallop through a long run");
+
+    for (int i = 0; i < 2 * (int)n; ++i) {
+        assert(*(int const*)Queue_peek(q) == i &&
+               "merge_queues() merges a long run out of order");
+        if (!Queue_dequeue(q)) {
+            handle_error(
+                "Queue_dequeue() returns false when queue is not empty");
+        }
+    }
+
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+    Queue_destroy(q);
+}
+
+void test_k_merging_no_queues(void) {
+    Queue* qs[] = { NULL, Queue_create(sizeof(int)), NULL };
+
+    assert(merge_k_queues(NULL, 0, sizeof(int), less) == NULL &&
+           "merge_k_queues() returns non-NULL value when given no queues");
+    assert(merge_k_queues(qs, 3, sizeof(int), less) == NULL &&
+           "merge_k_queues() returns non-NULL value when all queues empty");
+
+    Queue_destroy(qs[1]);
+}
+
+void test_k_merging_two_same_as_pairwise(void) {
+    int          nums1[] = { 4, 7, 2, 10 };
+    int          nums2[] = { 3, 6, 8, 9, 5, 1 };
+    size_t const n1      = sizeof(nums1) / sizeof(int);
+    size_t const n2      = sizeof(nums2) / sizeof(int);
+
+    Queue* qs[2];
+    Queue* pair[2];
+    for (size_t j = 0; j < 2; ++j) {
+        qs[j]   = Queue_create(sizeof(int));
+        pair[j] = Queue_create(sizeof(int));
+    }
+    for (size_t i = 0; i < n1 + n2; ++i) {
+        size_t const j    = i < n1 ? 0 : 1;
+        int const*   elem = i < n1 ? &nums1[i] : &nums2[i - n1];
+        if (!Queue_enqueue(qs[j], elem) || !Queue_enqueue(pair[j], elem)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+
+    Queue* q_k    = merge_k_queues(qs, 2, sizeof(int), greater);
+    Queue* q_pair = merge_queues(pair[0], pair[1], sizeof(int), greater);
+    assert(q_k != NULL && "merge_k_queues() returns NULL");
+    assert(Queue_size(q_k) == n1 + n2 &&
+           "merge_k_queues() loses elements of queues to merge");
+    assert(Queue_empty(qs[0]) && Queue_empty(qs[1]) &&
+           "merge_k_queues() does not empty queues to merge");
+
+    Queue_print(q_k, ",", false, print_int);
+    printf("\n");
+
+    while (!Queue_empty(q_pair)) {
+        int const actual   = *(int const*)Queue_peek(q_k);
+        int const expected = *(int const*)Queue_peek(q_pair);
+        assert(actual == expected &&
+               "merge_k_queues() differs from merge_queues()");
+        if (!Queue_dequeue(q_k) || !Queue_dequeue(q_pair)) {
+            handle_error(
+                "Queue_dequeue() returns false when queue is not empty");
+        }
+    }
+
+    for (size_t j = 0; j < 2; ++j) {
+        Queue_destroy(qs[j]);
+        Queue_destroy(pair[j]);
+    }
+    Queue_destroy(q_k);
+    Queue_destroy(q_pair);
+}
+
+void test_k_merging_many_is_stable(void) {
+    // Queues of assorted sizes with many equal keys, including gaps
+    size_t const k       = 7;
+    size_t const sizes[] = { 5, 0, 12, 1, 0, 9, 30 };
+    Queue*       qs[7]   = { NULL };
+    size_t       n_elems = 0;
+    for (size_t j = 0; j < k; ++j) {
+        if (j == 4) continue;   // leave a NULL queue in between
+        qs[j] = Queue_create(sizeof(Tagged));
+        for (size_t i = 0; i < sizes[j]; ++i) {
+            Tagged const elem = { (int)(i * (j + 1)) / 3, (int)(j * 1000 + i) };
+            if (!Queue_enqueue(qs[j], &elem)) {
+                handle_error("cannot allocate memory to complete enqueue()");
+            }
+        }
+        n_elems += sizes[j];
+    }
+
+    Queue* q = merge_k_queues(qs, k, sizeof(Tagged), key_less);
+    assert(q != NULL && "merge_k_queues() returns NULL");
+    assert(Queue_size(q) == n_elems &&
+           "merge_k_queues() loses elements of queues to merge");
+
+    int    next_pos[7] = { 0 };
+    Tagged prev        = { -1, -1 };
+    while (!Queue_empty(q)) {
+        Tagged const curr = *(Tagged const*)Queue_peek(q);
+        int const    j    = curr.tag / 1000;
+
+        assert(prev.key <= curr.key &&
+               "merge_k_queues() orders elements incorrectly");
+        assert(curr.tag % 1000 == next_pos[j]++ &&
+               "merge_k_queues() reorders elements of the same queue");
+        assert((prev.key < curr.key || prev.tag / 1000 >= j) &&
+               "merge_k_queues() breaks ties in the wrong queue order");
+
+        prev = curr;
+        if (!Queue_dequeue(q)) {
+            handle_error(
+                "Queue_dequeue() returns false when queue is not empty");
+        }
+    }
+
+    for (size_t j = 0; j < k; ++j) {
+        if (qs[j] != NULL) Queue_destroy(qs[j]);
+    }
+    Queue_destroy(q);
+}
+
+/** Fills a queue with `n` elements of ascending keys with many duplicates. */
+Queue* create_tagged_test_queue(size_t n, int tag_base) {
+    Queue* q   = Queue_create(sizeof(Tagged));
+    Tagged elem = { 0, 0 };
+    for (size_t i = 0; i < n; ++i) {
+        elem.key += rand() % 3;
+        elem.tag = tag_base + (int)i;
+        if (!Queue_enqueue(q, &elem)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+    return q;
+}
+
+void test_parallel_merging_same_as_sequential(void) {
+    size_t const n1 = 70000;
+    size_t const n2 = 50000;
+
+    for (size_t n_threads = 0; n_threads <= 5; ++n_threads) {
+        srand(n_threads);
+        Queue* p1 = create_tagged_test_queue(n1, 0);
+        Queue* p2 = create_tagged_test_queue(n2, 1 << 20);
+        srand(n_threads);
+        Queue* s1 = create_tagged_test_queue(n1, 0);
+        Queue* s2 = create_tagged_test_queue(n2, 1 << 20);
+
+        Queue* q_par =
+            merge_queues_parallel(p1, p2, sizeof(Tagged), key_less, n_threads);
+        Queue* q_seq = merge_queues(s1, s2, sizeof(Tagged), key_less);
+
+        assert(q_par != NULL && Queue_size(q_par) == n1 + n2 &&
+               "merge_queues_parallel() loses elements of queues to merge");
+        assert(Queue_empty(p1) && Queue_empty(p2) &&
+               "merge_queues_parallel() does not empty queues to merge");
+
+        while (!Queue_empty(q_seq)) {
+            Tagged const actual   = *(Tagged const*)Queue_peek(q_par);
+            Tagged const expected = *(Tagged const*)Queue_peek(q_seq);
+            assert(actual.key == expected.key && actual.tag == expected.tag &&
+                   "merge_queues_parallel() differs from merge_queues()");
+            if (!Queue_dequeue(q_par) || !Queue_dequeue(q_seq)) {
+                handle_error(
+                    "Queue_dequeue() returns false when queue is not empty");
+            }
+        }
+
+        Queue_destroy(p1);
+        Queue_destroy(p2);
+        Queue_destroy(s1);
+        Queue_destroy(s2);
+        Queue_destroy(q_par);
+        Queue_destroy(q_seq);
+    }
+}
+
+void test_merge_iter_same_as_merging(void) {
+    srand(7);
+    Queue* p1 = create_tagged_test_queue(300, 0);
+    Queue* p2 = create_tagged_test_queue(200, 1 << 20);
+    srand(7);
+    Queue* s1 = create_tagged_test_queue(300, 0);
+    Queue* s2 = create_tagged_test_queue(200, 1 << 20);
+
+    MergeIter* iter = MergeIter_create(p1, p2, sizeof(Tagged), key_less);
+    Queue*     q    = merge_queues(s1, s2, sizeof(Tagged), key_less);
+    if (iter == NULL) handle_error("cannot allocate memory for an iterator");
+
+    Tagged actual;
+    while (MergeIter_next(iter, &actual)) {
+        Tagged const expected = *(Tagged const*)Queue_peek(q);
+        assert(actual.key == expected.key && actual.tag == expected.tag &&
+               "MergeIter_next() differs from merge_queues()");
+        if (!Queue_dequeue(q)) {
+            handle_error(
+                "Queue_dequeue() returns false when queue is not empty");
+        }
+    }
+    assert(Queue_empty(q) && "MergeIter_next() stops before merge ends");
+    assert(MergeIter_peek(iter) == NULL &&
+           "MergeIter_peek() returns non-NULL value after merge ends");
+
+    MergeIter_destroy(iter);
+    Queue_destroy(p1);
+    Queue_destroy(p2);
+    Queue_destroy(s1);
+    Queue_destroy(s2);
+    Queue_destroy(q);
+}
+
+void test_merge_iter_consumes_lazily(void) {
+    Queue*       q1      = Queue_create(sizeof(int));
+    int          nums1[] = { 4, 7, 2, 10 };
+    size_t const n1      = sizeof(nums1) / sizeof(int);
+    for (size_t i = 0; i < n1; ++i) {
+        if (!Queue_enqueue(q1, &nums1[i])) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+
+    // Merge with a queue to which elements come in as the merge goes
+    Queue*     q2   = Queue_create(sizeof(int));
+    MergeIter* iter = MergeIter_create(q1, q2, sizeof(int), greater);
+    if (iter == NULL) handle_error("cannot allocate memory for an iterator");
+
+    int const* next = MergeIter_peek(iter);
+    assert(next != NULL && *next == 4 && "MergeIter_peek() returns wrong elem");
+    if (!MergeIter_next(iter, NULL)) {
+        handle_error("MergeIter_next() returns false when queue not empty");
+    }
+    assert(Queue_size(q1) == n1 - 1 && "MergeIter_next() consumes eagerly");
+
+    int const late = 8;
+    if (!Queue_enqueue(q2, &late)) {
+        handle_error("cannot allocate memory to complete enqueue()");
+    }
+
+    int expected[] = { 8, 7, 2, 10 };
+    int actual;
+    for (size_t i = 0; MergeIter_next(iter, &actual); ++i) {
+        assert(actual == expected[i] && "MergeIter_next() yields wrong elem");
+    }
+    assert(Queue_empty(q1) && Queue_empty(q2) &&
+           "MergeIter_next() leaves elements behind");
+
+    MergeIter_destroy(iter);
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+}
+
+int compare_ints(void const* a, void const* b) {
+    return (*(int*)a > *(int*)b) - (*(int*)a < *(int*)b);
+}
+
+/**
+ * Fills a queue with `n` sorted random keys below `max_key`, many of them
+ * duplicates, and flags the keys present in `present`.
+ */
+Queue* create_set_test_queue(size_t n, int max_key, bool* present) {
+    int*   keys = malloc(n * sizeof(int) + 1);
+    Queue* q    = Queue_create(sizeof(int));
+    if (keys == NULL || q == NULL) handle_error("cannot allocate memory");
+
+    for (size_t i = 0; i < n; ++i) {
+        keys[i]          = rand() % max_key;
+        present[keys[i]] = true;
+    }
+    qsort(keys, n, sizeof(int), compare_ints);
+    for (size_t i = 0; i < n; ++i) {
+        if (!Queue_enqueue(q, &keys[i])) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+
+    free(keys);
+    return q;
+}
+
+void test_set_operations_same_as_naive(void) {
+    Queue* (*const ops[])(Queue*, Queue*, size_t,
+                          bool (*)(void const*, void const*)) = {
+        union_queues, intersect_queues, subtract_queues
+    };
+    size_t const sizes[][2] = { { 0, 0 },       { 0, 50 },     { 50, 0 },
+                                { 1000, 1000 }, { 20000, 30 }, { 30, 20000 } };
+    size_t const n_sizes    = sizeof(sizes) / sizeof(sizes[0]);
+    int const    max_key    = 4096;
+    bool*        in1        = malloc(max_key * sizeof(bool));
+    bool*        in2        = malloc(max_key * sizeof(bool));
+    if (in1 == NULL || in2 == NULL) handle_error("cannot allocate memory");
+
+    for (size_t op = 0; op < 3; ++op) {
+        for (size_t s = 0; s < n_sizes; ++s) {
+            memset(in1, 0, max_key * sizeof(bool));
+            memset(in2, 0, max_key * sizeof(bool));
+
+            srand(s);
+            Queue* q1 = create_set_test_queue(sizes[s][0], max_key, in1);
+            Queue* q2 = create_set_test_queue(sizes[s][1], max_key, in2);
+            Queue* q  = ops[op](q1, q2, sizeof(int), less);
+            if (q == NULL) handle_error("cannot allocate memory for result");
+
+            assert(Queue_empty(q1) && Queue_empty(q2) &&
+                   "set operation does not empty queues");
+
+            // Keys in the result in order, each once, as flagged
+            for (int key = 0; key < max_key; ++key) {
+                bool const expected = op == 0   ? in1[key] || in2[key]
+                                      : op == 1 ? in1[key] && in2[key]
+                                                : in1[key] && !in2[key];
+                if (!expected) continue;
+
+                int const* actual = Queue_peek(q);
+                assert(actual != NULL && *actual == key &&
+                       "set operation differs from naive computation");
+                if (!Queue_dequeue(q)) {
+                    handle_error(
+                        "Queue_dequeue() returns false when queue not empty");
+                }
+            }
+            assert(Queue_empty(q) && "set operation outputs extra elements");
+
+            Queue_destroy(q1);
+            Queue_destroy(q2);
+            Queue_destroy(q);
+        }
+    }
+
+    free(in1);
+    free(in2);
+}
+
+void test_set_operations_keep_first_queue_elems(void) {
+    Tagged const elems1[] = { { 1, 10 }, { 2, 11 }, { 2, 12 }, { 4, 13 } };
+    Tagged const elems2[] = { { 1, 20 }, { 3, 21 }, { 4, 22 }, { 4, 23 } };
+    Tagged const unite[]  = { { 1, 10 }, { 2, 11 }, { 3, 21 }, { 4, 13 } };
+    Tagged const common[] = { { 1, 10 }, { 4, 13 } };
+    Tagged const rest[]   = { { 2, 11 } };
+
+    Queue* (*const ops[])(Queue*, Queue*, size_t,
+                          bool (*)(void const*, void const*)) = {
+        union_queues, intersect_queues, subtract_queues
+    };
+    Tagged const* expected[]   = { unite, common, rest };
+    size_t const  n_expected[] = { 4, 2, 1 };
+
+    for (size_t op = 0; op < 3; ++op) {
+        Queue* q1 = Queue_create(sizeof(Tagged));
+        Queue* q2 = Queue_create(sizeof(Tagged));
+        for (size_t i = 0; i < 4; ++i) {
+            if (!Queue_enqueue(q1, &elems1[i]) ||
+                !Queue_enqueue(q2, &elems2[i])) {
+                handle_error("cannot allocate memory to complete enqueue()");
+            }
+        }
+
+        Queue* q = ops[op](q1, q2, sizeof(Tagged), key_less);
+        if (q == NULL) handle_error("cannot allocate memory for result");
+        assert(Queue_size(q) == n_expected[op] &&
+               "set operation outputs wrong number of elements");
+
+        for (size_t i = 0; i < n_expected[op]; ++i) {
+            Tagged const* actual = Queue_peek(q);
+            assert(actual->key == expected[op][i].key &&
+                   actual->tag == expected[op][i].tag &&
+                   "set operation outputs wrong element of equal elements");
+            if (!Queue_dequeue(q)) {
+                handle_error(
+                    "Queue_dequeue() returns false when queue not empty");
+            }
+        }
+
+        Queue_destroy(q1);
+        Queue_destroy(q2);
+        Queue_destroy(q);
+    }
+}
+
+/** Element types of typed merges. */
+enum elem_type
+{
+    I32,
+    U64,
+    F32,
+    F64,
+    N_ELEM_TYPES
+};
+
+/** Size of each element of each type in bytes. */
+static size_t const elem_sizes[] = { sizeof(int32_t), sizeof(uint64_t),
+                                     sizeof(float), sizeof(double) };
+
+/** Stores an integral key as an element of some type. */
+void store_key(enum elem_type type, long key, void* elem) {
+    switch (type) {
+    case I32: *(int32_t*)elem = (int32_t)key; break;
+    case U64: *(uint64_t*)elem = (uint64_t)key; break;
+    case F32: *(float*)elem = (float)key; break;
+    case F64: *(double*)elem = (double)key; break;
+    default: break;
+    }
+}
+
+// clang-format off
+bool less_i32(void const* a, void const* b) { return *(int32_t*)a < *(int32_t*)b; }
+bool greater_i32(void const* a, void const* b) { return *(int32_t*)a > *(int32_t*)b; }
+bool less_u64(void const* a, void const* b) { return *(uint64_t*)a < *(uint64_t*)b; }
+bool greater_u64(void const* a, void const* b) { return *(uint64_t*)a > *(uint64_t*)b; }
+bool less_f32(void const* a, void const* b) { return *(float*)a < *(float*)b; }
+bool greater_f32(void const* a, void const* b) { return *(float*)a > *(float*)b; }
+bool less_f64(void const* a, void const* b) { return *(double*)a < *(double*)b; }
+bool greater_f64(void const* a, void const* b) { return *(double*)a > *(double*)b; }
+// clang-format on
+
+/**
+ * Fills a queue with `n` elements of sorted keys with many duplicates, half
+ * of which are enqueued after dequeuing as many, so that the elements wrap
+ * around the end of the storage of circular-array queues.
+ */
+Queue* create_typed_test_queue(size_t n, enum elem_type type, KeyOrder order) {
+    long const   base = 10 * (long)n + 1000;
+    long const   step = order == ASCENDING ? 1 : -1;
+    long const   skip = step * (3 * (long)n + 1);
+    long* const  keys = malloc(n * sizeof(long));
+    Queue* const q    = Queue_create(elem_sizes[type]);
+    double       elem;   // large enough for any element type
+    if (keys == NULL || q == NULL) handle_error("cannot allocate memory");
+
+    for (size_t i = 0; i < n; ++i) {
+        keys[i] = (i == 0 ? base : keys[i - 1]) + step * (rand() % 3);
+        store_key(type, keys[i], &elem);
+        if (!Queue_enqueue(q, &elem)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+    for (size_t i = 0; i < n / 2; ++i) {
+        store_key(type, keys[i] + skip, &elem);
+        if (!Queue_dequeue(q) || !Queue_enqueue(q, &elem)) {
+            handle_error("cannot rotate queue");
+        }
+    }
+
+    free(keys);
+    return q;
+}
+
+void test_typed_merging_same_as_generic(void) {
+    Queue* (*const merges[])(Queue*, Queue*, KeyOrder) = {
+        merge_queues_i32, merge_queues_u64, merge_queues_f32, merge_queues_f64
+    };
+    bool (*const compares[][2])(void const*, void const*) = {
+        { less_i32, greater_i32 },
+        { less_u64, greater_u64 },
+        { less_f32, greater_f32 },
+        { less_f64, greater_f64 },
+    };
+    size_t const sizes[][2] = { { 1, 1 }, { 5, 300 }, { 1000, 1000 },
+                                { 3000, 17 }, { 40, 64 } };
+    size_t const n_sizes    = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (int type = I32; type < N_ELEM_TYPES; ++type) {
+        for (int order = ASCENDING; order <= DESCENDING; ++order) {
+            for (size_t s = 0; s < n_sizes; ++s) {
+                size_t const n1 = sizes[s][0];
+                size_t const n2 = sizes[s][1];
+
+                srand(s);
+                Queue* p1 = create_typed_test_queue(n1, type, order);
+                Queue* p2 = create_typed_test_queue(n2, type, order);
+                srand(s);
+                Queue* s1 = create_typed_test_queue(n1, type, order);
+                Queue* s2 = create_typed_test_queue(n2, type, order);
+
+                Queue* q_typed = merges[type](p1, p2, order);
+                Queue* q_gen   = merge_queues(s1, s2, elem_sizes[type],
+                                              compares[type][order]);
+
+                assert(q_typed != NULL && Queue_size(q_typed) == n1 + n2 &&
+                       "typed merge loses elements of queues to merge");
+                assert(Queue_empty(p1) && Queue_empty(p2) &&
+                       "typed merge does not empty queues to merge");
+
+                while (!Queue_empty(q_gen)) {
+                    assert(memcmp(Queue_peek(q_typed), Queue_peek(q_gen),
+                                  elem_sizes[type]) == 0 &&
+                           "typed merge differs from merge_queues()");
+                    if (!Queue_dequeue(q_typed) || !Queue_dequeue(q_gen)) {
+                        handle_error("Queue_dequeue() returns false when "
+                                     "queue is not empty");
+                    }
+                }
+
+                Queue_destroy(p1);
+                Queue_destroy(p2);
+                Queue_destroy(s1);
+                Queue_destroy(s2);
+                Queue_destroy(q_typed);
+                Queue_destroy(q_gen);
+            }
+        }
+    }
+}
+
+/** An element with the same key in each primitive type, identified by `tag`. */
+typedef struct
+{
+    char     c;
+    int32_t  i32;
+    uint32_t u32;
+    int64_t  i64;
+    uint64_t u64;
+    float    f32;
+    double   f64;
+    int      key;
+    int      tag;
+} Record;
+
+bool record_less(void const* a, void const* b) {
+    return ((Record*)a)->key < ((Record*)b)->key;
+}
+
+bool record_greater(void const* a, void const* b) {
+    return ((Record*)a)->key > ((Record*)b)->key;
+}
+
+/** Fills a queue with `n` records of sorted keys with many duplicates. */
+Queue* create_record_test_queue(size_t n, KeyOrder order, int tag_base) {
+    Queue* q    = Queue_create(sizeof(Record));
+    Record elem = { 0 };
+    int    key  = 1000;
+    for (size_t i = 0; i < n; ++i) {
+        key += (order == ASCENDING ? 1 : -1) * (rand() % 3);
+        elem.i32 = elem.key = key;
+        elem.u32 = (uint32_t)key;
+        elem.i64 = key;
+        elem.u64 = (uint64_t)key;
+        elem.f32 = (float)key;
+        elem.f64 = key;
+        elem.tag = tag_base + (int)i;
+        if (!Queue_enqueue(q, &elem)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+    return q;
+}
+
+void test_merging_by_key_same_as_generic(void) {
+    size_t const offsets[] = {
+        [KEY_I32] = offsetof(Record, i32), [KEY_U32] = offsetof(Record, u32),
+        [KEY_I64] = offsetof(Record, i64), [KEY_U64] = offsetof(Record, u64),
+        [KEY_F32] = offsetof(Record, f32), [KEY_F64] = offsetof(Record, f64),
+    };
+
+    for (KeyType type = KEY_I32; type <= KEY_F64; ++type) {
+        for (KeyOrder order = ASCENDING; order <= DESCENDING; ++order) {
+            srand(type);
+            Queue* p1 = create_record_test_queue(300, order, 0);
+            Queue* p2 = create_record_test_queue(200, order, 1 << 20);
+            srand(type);
+            Queue* s1 = create_record_test_queue(300, order, 0);
+            Queue* s2 = create_record_test_queue(200, order, 1 << 20);
+
+            Queue* q_key = merge_queues_by_key(p1, p2, sizeof(Record),
+                                               offsets[type], type, order);
+            Queue* q_gen = merge_queues(
+                s1, s2, sizeof(Record),
+                order == ASCENDING ? record_less : record_greater);
+
+            assert(q_key != NULL && Queue_size(q_key) == 500 &&
+                   "merge_queues_by_key() loses elements of queues to merge");
+
+            while (!Queue_empty(q_gen)) {
+                Record const* actual   = Queue_peek(q_key);
+                Record const* expected = Queue_peek(q_gen);
+                assert(actual->key == expected->key &&
+                       actual->tag == expected->tag &&
+                       "merge_queues_by_key() differs from merge_queues()");
+                if (!Queue_dequeue(q_key) || !Queue_dequeue(q_gen)) {
+                    handle_error(
+                        "Queue_dequeue() returns false when queue is not empty");
+                }
+            }
+
+            Queue_destroy(p1);
+            Queue_destroy(p2);
+            Queue_destroy(s1);
+            Queue_destroy(s2);
+            Queue_destroy(q_key);
+            Queue_destroy(q_gen);
+        }
+    }
+}
+
+/** Number of elements freed by `count_and_free()`. */
+static size_t n_freed = 0;
+
+/** Frees an element owned by a queue, and counts it. */
+void count_and_free(void* elem) {
+    free(elem);
+    n_freed += 1;
+}
+
+/** Orders integers held by address in owning queues, smallest first. */
+bool owned_less(void const* a, void const* b) {
+    return **(int* const*)a < **(int* const*)b;
+}
+
+/** Creates a queue that owns copies of `n` integers, exiting on failure. */
+Queue* create_owned_test_queue(int const* nums, size_t n) {
+    Queue* q = Queue_create_owned(count_and_free);
+    if (q == NULL) handle_error("cannot allocate memory for an owning queue");
+
+    for (size_t i = 0; i < n; ++i) {
+        int* num = malloc(sizeof(int));
+        if (num == NULL) handle_error("cannot allocate memory for an element");
+        *num = nums[i];
+        if (!Queue_enqueue_owned(q, num)) {
+            handle_error("cannot allocate memory to complete enqueue_owned()");
+        }
+    }
+    return q;
+}
+
+void test_merging_owned_queues(void) {
+    int const nums1[] = { 1, 4, 6, 9 };
+    int const nums2[] = { 2, 3, 7 };
+    Queue*    q1      = create_owned_test_queue(nums1, 4);
+    Queue*    q2      = create_owned_test_queue(nums2, 3);
+
+    // The merged queue takes over the elements, owning them like the inputs
+    Queue* merged = merge_queues(q1, q2, sizeof(int*), owned_less);
+    assert(merged != NULL && merged != q1 && merged != q2 &&
+           Queue_owned(merged) && Queue_size(merged) == 7 &&
+           "merge_queues() does not own the elements of owning queues");
+
+    int const expected[] = { 1, 2, 3 };
+    for (size_t i = 0; i < 3; ++i) {
+        int* num = Queue_take_front(merged);
+        assert(num != NULL && *num == expected[i] &&
+               "merge_queues() misorders the elements of owning queues");
+        free(num);
+    }
+
+    n_freed = 0;
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+    assert(n_freed == 0 && "merge_queues() leaves elements in the inputs");
+    Queue_destroy(merged);
+    assert(n_freed == 4 && "Queue_destroy() misses merged elements");
+
+    // An empty input yields the other one, which keeps its elements
+    q1     = create_owned_test_queue(nums1, 4);
+    q2     = create_owned_test_queue(nums2, 0);
+    merged = merge_queues(q1, q2, sizeof(int*), owned_less);
+    assert(merged == q1 && Queue_owned(merged) && Queue_size(merged) == 4 &&
+           "merge_queues() does not return first queue when the second is "
+           "empty");
+
+    n_freed = 0;
+    if (merged != q1 && merged != q2) Queue_destroy(merged);
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+    assert(n_freed == 4 && "Queue_destroy() misses owned elements");
+}
+
+void test_set_operations_on_owned_queues(void) {
+    int const nums1[] = { 1, 2, 4, 6 };
+    int const nums2[] = { 2, 3, 6, 7 };
+    Queue*    q1      = create_owned_test_queue(nums1, 4);
+    Queue*    q2      = create_owned_test_queue(nums2, 4);
+
+    // Elements left out of the result are destroyed as they are dropped
+    n_freed              = 0;
+    Queue*       common  = intersect_queues(q1, q2, sizeof(int*), owned_less);
+    size_t const dropped = n_freed;
+    assert(common != NULL && Queue_owned(common) && Queue_size(common) == 2 &&
+           dropped == 6 && Queue_empty(q1) && Queue_empty(q2) &&
+           "intersect_queues() leaks the elements of owning queues");
+
+    Queue_destroy(common);
+    Queue_destroy(q1);
+    Queue_destroy(q2);
+    assert(n_freed == 8 && "Queue_destroy() misses owned elements");
+    (void)dropped;
+}
+
+/**
+ * Runs all tests on merge_queues() and its variants, including MergeIter.
  */
 int main(int argc, char** argv) {
     UnitTest utests[] = { test_merging_two_empty_queues,
                           test_merging_first_empty_second_nonempty,
                           test_merging_first_nonempty_second_empty,
-                          test_merging_two_nonempty, NULL };
+                          test_merging_two_nonempty,
+                          test_merging_clustered_is_stable,
+                          test_merging_runs_gallops,
+                          test_k_merging_no_queues,
+                          test_k_merging_two_same_as_pairwise,
+                          test_k_merging_many_is_stable,
+                          test_parallel_merging_same_as_sequential,
+                          test_merge_iter_same_as_merging,
+                          test_merge_iter_consumes_lazily,
+                          test_set_operations_same_as_naive,
+                          test_set_operations_keep_first_queue_elems,
+                          test_typed_merging_same_as_generic,
+                          test_merging_by_key_same_as_generic,
+                          test_merging_owned_queues,
+                          test_set_operations_on_owned_queues,
+                          NULL };
 
     run_tests(utests);
     return EXIT_SUCCESS;
@@ -295,13 +1097,13 @@ int main(int argc, char** argv) {
 // clang-format off
 
 /* === COMPILE & RUN ===
-gcc ../src/queue_circ_array.c ../src/algos.c test_merge_queues.c -o test_merge_queues_circ_array -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_merge_queues_circ_array
+gcc ../src/queue_circ_array.c ../src/algos.c ../src/merge_kernels.c test_merge_queues.c -o test_merge_queues_circ_array -std=c99 -g -Og -Wall -pedantic -march=native -pthread -I../src && ./test_merge_queues_circ_array
 
-gcc ../src/queue_linked_list.c ../src/algos.c test_merge_queues.c -o test_merge_queues_linked_list -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_merge_queues_linked_list
+gcc ../src/queue_linked_list.c ../src/algos.c ../src/merge_kernels.c test_merge_queues.c -o test_merge_queues_linked_list -std=c99 -g -Og -Wall -pedantic -march=native -pthread -I../src && ./test_merge_queues_linked_list
 
-gcc ../src/queue_circ_array.c ../src/algos.c test_merge_queues.c -o test_merge_queues_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_merge_queues_circ_array
+gcc ../src/queue_circ_array.c ../src/algos.c ../src/merge_kernels.c test_merge_queues.c -o test_merge_queues_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_merge_queues_circ_array
 
-gcc ../src/queue_linked_list.c ../src/algos.c test_merge_queues.c -o test_merge_queues_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_merge_queues_linked_list
+gcc ../src/queue_linked_list.c ../src/algos.c ../src/merge_kernels.c test_merge_queues.c -o test_merge_queues_linked_list -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_merge_queues_linked_list
 */
 
 /* === OUTPUT ===
@@ -335,5 +1137,34 @@ actual: 5, expected: 5
 actual: 1, expected: 1
 actual: 10, expected: 10
 Test 4 passed 👍
+Running...
+Test 5 passed 👍
+Running...
+Test 6 passed 👍
+Running...
+Test 7 passed 👍
+Running...
+4,7,3,6,8,9,5,2,10,1
+Test 8 passed 👍
+Running...
+Test 9 passed 👍
+Running...
+Test 10 passed 👍
+Running...
+Test 11 passed 👍
+Running...
+Test 12 passed 👍
+Running...
+Test 13 passed 👍
+Running...
+Test 14 passed 👍
+Running...
+Test 15 passed 👍
+Running...
+Test 16 passed 👍
+Running...
+Test 17 passed 👍
+Running...
+Test 18 passed 👍
 ALL PASSED
 */
\ No newline at end of file
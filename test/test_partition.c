@@ -0,0 +1,277 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "queue.h"        // Queue, Queue_*()
+#include "algos.h"        // Queue_partition(), Queue_filter_in_place()
+
+bool is_even(void const* elem) { return *(int*)elem % 2 == 0; }
+
+bool is_small(void const* elem) { return *(int*)elem < 100; }
+
+bool is_odd(void const* elem) { return !is_even(elem); }
+
+bool is_large(void const* elem) { return !is_small(elem); }
+
+bool is_any(void const* elem) { return true; }
+
+/**
+ * Fills a queue with the integers `0, 1, ..., n - 1`, after enqueuing and
+ * dequeuing `n / 2` others, so that the elements wrap around the end of the
+ * storage of circular-array queues.
+ */
+Queue* create_test_queue(int n) {
+    Queue* q = Queue_create(sizeof(int));
+    if (q == NULL) handle_error("cannot allocate memory to create a queue");
+
+    for (int i = -(n / 2); i < n; ++i) {
+        if (!Queue_enqueue(q, &i)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+    }
+    if (!Queue_dequeue_n(q, n / 2)) {
+        handle_error("Queue_dequeue_n() failed when queue that large");
+    }
+    return q;
+}
+
+/**
+ * Checks that the front elements of a queue are the integers below `n`
+ * satisfying a predicate in ascending order, dequeuing them.
+ */
+void assert_filtered(Queue* q, int n, bool (*pred)(void const*),
+                     char const* message) {
+    for (int i = 0; i < n; ++i) {
+        if (!pred(&i)) continue;
+
+        int const* front = Queue_peek(q);
+        assert(front != NULL && *front == i && message);
+        if (!Queue_dequeue(q)) handle_error("Queue_dequeue() failed");
+        (void)front;
+    }
+    (void)message;
+}
+
+void test_partitioning_is_stable(void) {
+    int const    sizes[] = { 0, 1, 2, 3, 100, 1000 };
+    size_t const n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    bool (*const preds[])(void const*) = { is_even, is_small };
+    bool (*const negs[])(void const*)  = { is_odd, is_large };
+
+    for (size_t i = 0; i < n_sizes; ++i) {
+        for (size_t j = 0; j < sizeof(preds) / sizeof(preds[0]); ++j) {
+            Queue* src       = create_test_queue(sizes[i]);
+            Queue* out_true  = Queue_create(sizeof(int));
+            Queue* out_false = Queue_create(sizeof(int));
+            if (out_true == NULL || out_false == NULL) {
+                handle_error("cannot allocate memory to create a queue");
+            }
+
+            if (!Queue_partition(src, sizeof(int), preds[j], out_true,
+                                 out_false)) {
+                handle_error("cannot allocate memory to complete partition()");
+            }
+            assert(Queue_empty(src) && "Queue_partition() leaves elements");
+            assert_filtered(out_true, sizes[i], preds[j],
+                            "Queue_partition() misplaces true elements");
+            assert_filtered(out_false, sizes[i], negs[j],
+                            "Queue_partition() misplaces false elements");
+            assert(Queue_empty(out_true) && Queue_empty(out_false) &&
+                   "Queue_partition() adds extra elements");
+
+            Queue_destroy(src);
+            Queue_destroy(out_true);
+            Queue_destroy(out_false);
+        }
+    }
+}
+
+void test_partitioning_appends_to_outputs(void) {
+    Queue* src = create_test_queue(10);
+    Queue* out = create_test_queue(3);
+
+    if (!Queue_partition(src, sizeof(int), is_even, out, out)) {
+        handle_error("cannot allocate memory to complete partition()");
+    }
+    assert(Queue_size(out) == 13 && "Queue_partition() loses elements");
+
+    int const expected[] = { 0, 1, 2, 0, 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+    for (size_t i = 0; i < sizeof(expected) / sizeof(expected[0]); ++i) {
+        int const* front = Queue_peek(out);
+        assert(front != NULL && *front == expected[i] &&
+               "Queue_partition() does not append elements in order");
+        if (!Queue_dequeue(out)) handle_error("Queue_dequeue() failed");
+        (void)front;
+    }
+
+    Queue_destroy(src);
+    Queue_destroy(out);
+}
+
+void test_partitioning_stops_at_limit(void) {
+    Queue* src       = create_test_queue(10);
+    Queue* out_true  = Queue_create(sizeof(int));
+    Queue* out_false = Queue_create(sizeof(int));
+    if (out_true == NULL || out_false == NULL) {
+        handle_error("cannot allocate memory to create a queue");
+    }
+    Queue_set_limit(out_true, 2);
+
+    bool const res =
+        Queue_partition(src, sizeof(int), is_even, out_true, out_false);
+    assert(!res && "Queue_partition() exceeds size limit");
+    assert(Queue_size(out_true) == 2 && Queue_size(out_false) == 2 &&
+           Queue_size(src) == 6 && "Queue_partition() does not stop at limit");
+    assert(*(int const*)Queue_peek(src) == 4 &&
+           "Queue_partition() drops elements not moved");
+
+    (void)res;
+    Queue_destroy(src);
+    Queue_destroy(out_true);
+    Queue_destroy(out_false);
+}
+
+void test_filtering_in_place(void) {
+    int const    sizes[] = { 0, 1, 2, 3, 100, 1000 };
+    size_t const n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+    bool (*const preds[])(void const*) = { is_even, is_small, is_any,
+                                           is_large };
+
+    for (size_t i = 0; i < n_sizes; ++i) {
+        for (size_t j = 0; j < sizeof(preds) / sizeof(preds[0]); ++j) {
+            Queue* q = create_test_queue(sizes[i]);
+            if (!Queue_filter_in_place(q, sizeof(int), preds[j])) {
+                handle_error("cannot allocate memory to complete filter()");
+            }
+
+            // The queue stays usable at both ends
+            int const elem = -1;
+            if (!Queue_enqueue(q, &elem)) {
+                handle_error("cannot allocate memory to complete enqueue()");
+            }
+            assert_filtered(q, sizes[i], preds[j],
+                            "Queue_filter_in_place() keeps wrong elements");
+            assert(Queue_size(q) == 1 && *(int const*)Queue_peek(q) == -1 &&
+                   "Queue_filter_in_place() corrupts queue");
+            Queue_destroy(q);
+        }
+    }
+}
+
+/** Number of elements freed by `count_and_free()`. */
+static size_t n_freed = 0;
+
+/** Frees an element owned by a queue, and counts it. */
+void count_and_free(void* elem) {
+    free(elem);
+    n_freed += 1;
+}
+
+/** Tells whether an integer held by address is even. */
+bool owned_is_even(void const* elem) { return is_even(*(int* const*)elem); }
+
+void test_filtering_owned_in_place(void) {
+    int const n = 100;
+    Queue*    q = Queue_create_owned(count_and_free);
+    if (q == NULL) handle_error("cannot allocate memory for an owning queue");
+
+    for (int i = 0; i < n; ++i) {
+        int* num = malloc(sizeof(int));
+        if (num == NULL) handle_error("cannot allocate memory for an element");
+        *num = i;
+        if (!Queue_enqueue_owned(q, num)) {
+            handle_error("cannot allocate memory to complete enqueue_owned()");
+        }
+    }
+
+    // Elements dropped are destroyed, while those kept stay owned
+    n_freed = 0;
+    if (!Queue_filter_in_place(q, sizeof(int*), owned_is_even)) {
+        handle_error("cannot allocate memory to complete filter()");
+    }
+    assert(n_freed == (size_t)n / 2 && Queue_size(q) == (size_t)n / 2 &&
+           "Queue_filter_in_place() leaks the elements dropped");
+
+    for (int i = 0; i < n; i += 2) {
+        int* num = Queue_take_front(q);
+        assert(num != NULL && *num == i &&
+               "Queue_filter_in_place() keeps wrong elements");
+        free(num);
+    }
+    assert(Queue_empty(q) && "Queue_filter_in_place() corrupts queue");
+    Queue_destroy(q);
+}
+
+/**
+ * Runs all tests on Queue_partition() and Queue_filter_in_place().
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_partitioning_is_stable,
+                          test_partitioning_appends_to_outputs,
+                          test_partitioning_stops_at_limit,
+                          test_filtering_in_place,
+                          test_filtering_owned_in_place,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/partition.c test_partition.c -o test_partition_circ_array -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_partition_circ_array
+
+gcc ../src/queue_linked_list.c ../src/partition.c test_partition.c -o test_partition_linked_list -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_partition_linked_list
+
+gcc ../src/queue_circ_array.c ../src/partition.c test_partition.c -o test_partition_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_partition_circ_array
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/
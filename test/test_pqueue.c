@@ -0,0 +1,227 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), qsort(), rand(), srand()
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "pqueue.h"       // PQueue, PQueue_*()
+
+static size_t const SIZES[] = { 1, 2, 3, 4, 5, 17, 100, 1000, 5000 };
+
+bool greater(void const* a, void const* b) { return *(int*)a > *(int*)b; }
+
+int cmp_desc(void const* a, void const* b) {
+    int const x = *(int*)a;
+    int const y = *(int*)b;
+    return (x < y) - (x > y);
+}
+
+/** Creates an array of `n` random integers with duplicates. */
+int* create_test_elems(size_t n) {
+    int* elems = malloc(n * sizeof(int));
+    if (elems == NULL) handle_error("cannot allocate memory for elements");
+
+    for (size_t i = 0; i < n; ++i) elems[i] = rand() % (int)(n / 2 + 1);
+    return elems;
+}
+
+/**
+ * Checks that popping a priority queue yields the elements of an array in
+ * descending order, emptying the priority queue.
+ */
+void assert_pops_sorted(PQueue* pq, int* elems, size_t n,
+                        char const* message) {
+    qsort(elems, n, sizeof(int), cmp_desc);
+    assert(PQueue_size(pq) == n && message);
+
+    for (size_t i = 0; i < n; ++i) {
+        int top = 0;
+        if (!PQueue_top(pq, &top)) handle_error("PQueue_top() failed");
+        assert(top == elems[i] && *(int const*)PQueue_peek(pq) == top &&
+               message);
+        if (!PQueue_pop(pq)) handle_error("PQueue_pop() failed");
+    }
+    assert(PQueue_empty(pq) && message);
+    (void)message;
+}
+
+void test_empty() {
+    //
+    PQueue* pq  = PQueue_create(sizeof(int), greater);
+    int     top = 0;
+    if (pq == NULL) handle_error("cannot allocate memory for a pqueue");
+
+    assert(PQueue_empty(pq) && PQueue_size(pq) == 0 &&
+           "priority queue not empty when created");
+    assert(!PQueue_top(pq, &top) &&
+           "PQueue_top() returns true when priority queue is empty");
+    assert(PQueue_peek(pq) == NULL &&
+           "PQueue_peek() returns non-NULL value when empty");
+    assert(!PQueue_pop(pq) &&
+           "PQueue_pop() returns true when priority queue is empty");
+
+    (void)top;
+    PQueue_destroy(pq);
+}
+
+void test_push_then_pop_all() {
+    //
+    srand(1);
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); ++s) {
+        int*    elems = create_test_elems(SIZES[s]);
+        PQueue* pq    = PQueue_create(sizeof(int), greater);
+        if (pq == NULL) handle_error("cannot allocate memory for a pqueue");
+
+        for (size_t i = 0; i < SIZES[s]; ++i) {
+            if (!PQueue_push(pq, &elems[i])) {
+                handle_error("cannot allocate memory to push()");
+            }
+        }
+        assert_pops_sorted(pq, elems, SIZES[s],
+                           "PQueue_pop() out of priority order after push()");
+
+        free(elems);
+        PQueue_destroy(pq);
+    }
+}
+
+void test_heapify_then_pop_all() {
+    //
+    srand(2);
+    for (size_t s = 0; s < sizeof(SIZES) / sizeof(SIZES[0]); ++s) {
+        int*    elems = create_test_elems(SIZES[s]);
+        int     first = elems[0];
+        PQueue* pq    = PQueue_heapify(sizeof(int), greater, elems, SIZES[s]);
+        if (pq == NULL) handle_error("cannot allocate memory for a pqueue");
+        assert(elems[0] == first && "PQueue_heapify() modifies the array");
+
+        assert_pops_sorted(pq, elems, SIZES[s],
+                           "PQueue_pop() out of priority order after heapify");
+
+        (void)first;
+        free(elems);
+        PQueue_destroy(pq);
+    }
+}
+
+void test_heapify_empty() {
+    //
+    PQueue* pq = PQueue_heapify(sizeof(int), greater, NULL, 0);
+    if (pq == NULL) handle_error("cannot allocate memory for a pqueue");
+
+    assert(PQueue_empty(pq) && "PQueue_heapify() adds elements");
+    int const elem = 7;
+    if (!PQueue_push(pq, &elem)) {
+        handle_error("cannot allocate memory to push()");
+    }
+    assert(*(int const*)PQueue_peek(pq) == 7 &&
+           "PQueue_push() fails after heapify");
+
+    PQueue_destroy(pq);
+}
+
+void test_interleaved_push_and_pop() {
+    //
+    size_t const n_ops = 20000;
+    int*         model = malloc(n_ops * sizeof(int));
+    size_t       n     = 0;
+    PQueue*      pq    = PQueue_create(sizeof(int), greater);
+    if (model == NULL || pq == NULL) handle_error("cannot allocate memory");
+
+    // Check the top element against a linear scan of the elements added
+    srand(3);
+    for (size_t i = 0; i < n_ops; ++i) {
+        if (n == 0 || rand() % 3 != 0) {
+            int const elem = rand() % 1000;
+            if (!PQueue_push(pq, &elem)) {
+                handle_error("cannot allocate memory to push()");
+            }
+            model[n++] = elem;
+        } else {
+            size_t best = 0;
+            for (size_t j = 1; j < n; ++j) {
+                if (model[j] > model[best]) best = j;
+            }
+            assert(*(int const*)PQueue_peek(pq) == model[best] &&
+                   "PQueue_peek() differs from the maximum");
+            if (!PQueue_pop(pq)) handle_error("PQueue_pop() failed");
+            model[best] = model[--n];
+        }
+        assert(PQueue_size(pq) == n && "PQueue_size() returns wrong size");
+    }
+
+    free(model);
+    PQueue_destroy(pq);
+}
+
+/**
+ * Runs all tests on the PQueue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_empty,
+                          test_push_then_pop_all,
+                          test_heapify_then_pop_all,
+                          test_heapify_empty,
+                          test_interleaved_push_and_pop,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/pqueue_heap.c test_pqueue.c -o test_pqueue -std=c99 -g -Og -Wall -pedantic -march=native -DPQUEUE_INIT_CAP=2 -I../src && ./test_pqueue
+
+gcc ../src/pqueue_heap.c test_pqueue.c -o test_pqueue -std=c99 -g -Og -Wall -pedantic -march=native -DPQUEUE_ARITY=2 -I../src && ./test_pqueue
+
+gcc ../src/pqueue_heap.c test_pqueue.c -o test_pqueue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_pqueue
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/
@@ -30,10 +30,15 @@ OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
 OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 */
 
+#define _POSIX_C_SOURCE 200809L   // fileno(), ftruncate()
+
+#include <stdint.h>   // uint64_t
 #include <stdlib.h>   // EXIT_*, malloc(), free(), memset()
-#include <stdio.h>    // printf(), stderr,
-#include <string.h>   // strcmp()
+#include <stdio.h>    // printf(), stderr, tmpfile(), fileno()
+#include <string.h>   // strcmp(), memcmp()
 #include <assert.h>   // assert()
+#include <errno.h>    // errno, EINVAL
+#include <unistd.h>   // lseek(), ftruncate(), pwrite()
 
 #include "test_utils.h"   // UnitTest, run_tests(), handle_error()
 #include "queue.h"        // Queue, Queue_*()
@@ -304,6 +309,744 @@ void test_print_when_nonempty() {
     Queue_destroy(q);
 }
 
+void test_peek() {
+    //
+    Queue* q = create_empty_test_queue(sizeof(int));
+    assert(Queue_peek(q) == NULL &&
+           "Queue_peek() returns non-NULL value when queue is empty");
+    Queue_destroy(q);
+
+    q = create_prefilled_test_queue(sizeof(int), 3);
+    for (size_t i = 0; i < 3; ++i) {
+        assert(Queue_peek(q) != NULL &&
+               "Queue_peek() returns NULL when queue is not empty");
+        assert(*(int const*)Queue_peek(q) == NUMS[i] &&
+               "Queue_peek() points to wrong element");
+        if (!Queue_dequeue(q)) {
+            handle_error(
+                "Queue_dequeue() returns false when queue is not empty");
+        }
+    }
+    Queue_destroy(q);
+}
+
+void test_reserve() {
+    //
+    Queue* q = create_prefilled_test_queue(sizeof(int), 3);
+
+    if (!Queue_reserve(q, 100)) {
+        handle_error("cannot allocate memory to reserve capacity");
+    }
+    assert(Queue_capacity(q) >= 100 &&
+           "Queue_reserve() does not grow queue capacity");
+    assert(Queue_size(q) == 3 && "Queue_reserve() changes queue size");
+    assert(*(int const*)Queue_peek(q) == NUMS[0] &&
+           "Queue_reserve() changes queue elements");
+
+    Queue_destroy(q);
+}
+
+void test_transfer() {
+    //
+    Queue* src = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    Queue* dst = create_prefilled_test_queue(sizeof(int), 3);
+
+    // Wrap the source around its underlying array, if any
+    for (size_t i = 0; i < 2; ++i) {
+        if (!Queue_dequeue(src) || !Queue_enqueue(src, &NUMS[i])) {
+            handle_error("cannot rotate queue");
+        }
+    }
+
+    bool res = Queue_transfer(dst, src, MAX_N_ELEMS + 1);
+    assert(!res &&
+           "Queue_transfer() returns true when source has too few elements");
+
+    if (!Queue_transfer(dst, src, 4)) {
+        handle_error("cannot allocate memory to transfer elements");
+    }
+    assert(Queue_size(dst) == 7 && Queue_size(src) == MAX_N_ELEMS - 4 &&
+           "Queue_transfer() moves wrong number of elements");
+
+    if (!Queue_transfer(dst, src, Queue_size(src))) {
+        handle_error("cannot allocate memory to transfer elements");
+    }
+    assert(Queue_empty(src) && "Queue_transfer() leaves elements behind");
+    assert(Queue_peek(src) == NULL && "Queue_peek() returns non-NULL value");
+
+    // Expect the prefix of dst, followed by the rotated source elements
+    for (size_t i = 0; i < 3 + MAX_N_ELEMS; ++i) {
+        int const expected = i < 3 ? NUMS[i] : NUMS[(i - 3 + 2) % MAX_N_ELEMS];
+        assert(*(int const*)Queue_peek(dst) == expected &&
+               "Queue_transfer() orders elements incorrectly");
+        if (!Queue_dequeue(dst)) {
+            handle_error(
+                "Queue_dequeue() returns false when queue is not empty");
+        }
+    }
+
+    // Elements can flow back and forth
+    if (!Queue_enqueue(src, &NUMS[0]) || !Queue_transfer(dst, src, 1) ||
+        !Queue_transfer(src, dst, 1)) {
+        handle_error("cannot allocate memory to transfer elements");
+    }
+    assert(Queue_size(src) == 1 && Queue_empty(dst) &&
+           "Queue_transfer() fails to move elements back");
+
+    Queue_destroy(src);
+    Queue_destroy(dst);
+}
+
+void test_segments() {
+    //
+    Queue* q   = create_empty_test_queue(sizeof(int));
+    size_t len = 0;
+    assert(Queue_segment(q, NULL, &len) == NULL &&
+           "Queue_segment() returns non-NULL value when queue is empty");
+    Queue_destroy(q);
+
+    // Wrap the queue around its underlying array, if any
+    q = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    for (size_t i = 0; i < 3; ++i) {
+        if (!Queue_dequeue(q) || !Queue_enqueue(q, &NUMS[i])) {
+            handle_error("cannot rotate queue");
+        }
+    }
+
+    size_t i   = 0;
+    void*  seg = NULL;
+    while ((seg = Queue_segment(q, seg, &len)) != NULL) {
+        assert(len > 0 && "Queue_segment() returns empty segment");
+        for (size_t j = 0; j < len; ++j, ++i) {
+            assert(((int*)seg)[j] == NUMS[(i + 3) % MAX_N_ELEMS] &&
+                   "Queue_segment() returns elements out of order");
+        }
+    }
+    assert(i == MAX_N_ELEMS && "Queue_segment() misses elements");
+
+    Queue_destroy(q);
+}
+
+void test_linearize() {
+    //
+    Queue* q = create_empty_test_queue(sizeof(int));
+    assert(Queue_linearize(q) == NULL &&
+           "Queue_linearize() returns non-NULL value when queue is empty");
+    Queue_destroy(q);
+
+    // Wrap the queue around its underlying array, if any
+    q = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    for (size_t i = 0; i < 3; ++i) {
+        if (!Queue_dequeue(q) || !Queue_enqueue(q, &NUMS[i])) {
+            handle_error("cannot rotate queue");
+        }
+    }
+
+    // Implementations may not be able to store elements contiguously
+    int const* elems = Queue_linearize(q);
+    if (elems != NULL) {
+        size_t len = 0;
+        assert(Queue_segment(q, NULL, &len) == elems && len == MAX_N_ELEMS &&
+               "Queue_linearize() leaves elements in more than one segment");
+        for (size_t i = 0; i < MAX_N_ELEMS; ++i) {
+            assert(elems[i] == NUMS[(i + 3) % MAX_N_ELEMS] &&
+                   "Queue_linearize() reorders elements");
+        }
+    }
+    assert(Queue_size(q) == MAX_N_ELEMS && "Queue_linearize() loses elements");
+
+    Queue_destroy(q);
+}
+
+/** Visitor that records each element visited in the array at `ctx`. */
+void record_elem(void const* elem, void* ctx) {
+    int** next = ctx;
+    *(*next)++ = *(int const*)elem;
+}
+
+/** Combiner that adds an element to a running sum. */
+void add_elem(void* acc, void const* elem) { *(long*)acc += *(int const*)elem; }
+
+void test_for_each_and_fold() {
+    //
+    int    seen[sizeof(NUMS) / sizeof(int)];
+    Queue* q    = create_empty_test_queue(sizeof(int));
+    int*   next = seen;
+    long   sum  = 7;
+
+    Queue_for_each(q, record_elem, &next);
+    Queue_fold(q, &sum, add_elem);
+    assert(next == seen && sum == 7 &&
+           "Queue_for_each() or Queue_fold() visits elements of empty queue");
+    Queue_destroy(q);
+
+    // Wrap the queue around its underlying array, if any
+    q = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    for (size_t i = 0; i < 3; ++i) {
+        if (!Queue_dequeue(q) || !Queue_enqueue(q, &NUMS[i])) {
+            handle_error("cannot rotate queue");
+        }
+    }
+
+    long expected = 7;
+    Queue_for_each(q, record_elem, &next);
+    Queue_fold(q, &sum, add_elem);
+    assert(next == seen + MAX_N_ELEMS &&
+           "Queue_for_each() visits wrong number of elements");
+    for (size_t i = 0; i < MAX_N_ELEMS; ++i) {
+        assert(seen[i] == NUMS[(i + 3) % MAX_N_ELEMS] &&
+               "Queue_for_each() visits elements out of order");
+        expected += NUMS[i];
+    }
+    assert(sum == expected && "Queue_fold() gives wrong result");
+    assert(Queue_size(q) == MAX_N_ELEMS && "Queue_for_each() modifies queue");
+
+    (void)expected;
+    Queue_destroy(q);
+}
+
+void test_extend() {
+    //
+    Queue* q = create_prefilled_test_queue(sizeof(int), 2);
+
+    if (!Queue_extend(q, 5)) {
+        handle_error("cannot allocate memory to extend queue");
+    }
+    assert(Queue_size(q) == 7 && "Queue_extend() adds wrong number of elements");
+
+    // Write the elements added in place
+    size_t i   = 0;
+    size_t len = 0;
+    void*  seg = NULL;
+    while ((seg = Queue_segment(q, seg, &len)) != NULL) {
+        for (size_t j = 0; j < len; ++j, ++i) {
+            if (i >= 2) ((int*)seg)[j] = NUMS[i];
+        }
+    }
+
+    int* front_elem = malloc(sizeof(int));
+    for (i = 0; i < 7; ++i) {
+        if (!Queue_front(q, front_elem) || !Queue_dequeue(q)) {
+            handle_error("cannot dequeue when queue is not empty");
+        }
+        assert(*front_elem == NUMS[i] &&
+               "Queue_extend() adds elements that cannot be written");
+    }
+    free(front_elem);
+
+    Queue_set_limit(q, 3);
+    bool res = Queue_extend(q, 4);
+    assert(!res && Queue_empty(q) &&
+           "Queue_extend() extends queue beyond its size limit");
+
+    Queue_destroy(q);
+}
+
+void test_dequeue_n() {
+    //
+    Queue* q = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+
+    bool res = Queue_dequeue_n(q, MAX_N_ELEMS + 1);
+    assert(!res && Queue_size(q) == MAX_N_ELEMS &&
+           "Queue_dequeue_n() returns true when queue has too few elements");
+
+    if (!Queue_dequeue_n(q, 4)) {
+        handle_error("Queue_dequeue_n() returns false when queue is not empty");
+    }
+    assert(Queue_size(q) == MAX_N_ELEMS - 4 &&
+           "Queue_dequeue_n() removes wrong number of elements");
+    assert(*(int const*)Queue_peek(q) == NUMS[4] &&
+           "Queue_dequeue_n() removes wrong elements");
+
+    if (!Queue_dequeue_n(q, Queue_size(q))) {
+        handle_error("Queue_dequeue_n() returns false when queue is not empty");
+    }
+    assert(Queue_empty(q) && "Queue_dequeue_n() leaves elements behind");
+    if (!Queue_enqueue(q, &NUMS[0])) {
+        handle_error("cannot allocate memory to enqueue an element");
+    }
+    assert(*(int const*)Queue_peek(q) == NUMS[0] &&
+           "Queue_enqueue() fails after Queue_dequeue_n() empties queue");
+
+    Queue_destroy(q);
+}
+
+/** Counts high (index 0) and low (index 1) watermark crossings in `ctx`. */
+void count_high(Queue* queue, void* ctx) { ((size_t*)ctx)[0] += 1; }
+void count_low(Queue* queue, void* ctx) { ((size_t*)ctx)[1] += 1; }
+
+void test_watermarks_fire_on_transition() {
+    //
+    Queue* q          = create_empty_test_queue(sizeof(int));
+    size_t crossed[2] = { 0, 0 };
+
+    bool res = Queue_set_watermarks(q, 5, 5, count_high, count_low, crossed);
+    assert(!res &&
+           "Queue_set_watermarks() accepts low watermark not below high");
+
+    if (!Queue_set_watermarks(q, 2, 5, count_high, count_low, crossed)) {
+        handle_error("Queue_set_watermarks() rejects valid watermarks");
+    }
+
+    for (size_t round = 1; round <= 2; ++round) {
+        for (size_t i = 0; i < 7; ++i) {
+            if (!Queue_enqueue(q, &NUMS[i])) {
+                handle_error("cannot allocate memory to enqueue an element");
+            }
+            assert(Queue_congested(q) == (i + 1 >= 5) &&
+                   "queue congestion differs from high watermark crossing");
+        }
+        assert(crossed[0] == round && crossed[1] == round - 1 &&
+               "high watermark does not fire exactly once on crossing");
+
+        while (Queue_size(q) > 0) {
+            if (!Queue_dequeue(q)) {
+                handle_error(
+                    "Queue_dequeue() returns false when queue is not empty");
+            }
+            assert(Queue_congested(q) == (Queue_size(q) > 2) &&
+                   "queue congestion differs from low watermark crossing");
+        }
+        assert(crossed[0] == round && crossed[1] == round &&
+               "low watermark does not fire exactly once on crossing");
+    }
+
+    Queue_destroy(q);
+}
+
+void test_enqueue_when_at_limit() {
+    //
+    Queue* q = create_prefilled_test_queue(sizeof(int), 5);
+
+    Queue_set_limit(q, 5);
+    assert(!Queue_enqueue(q, &NUMS[5]) &&
+           "Queue_enqueue() returns true when queue is at its limit");
+    assert(Queue_size(q) == 5 && "Queue_enqueue() grows queue beyond limit");
+
+    if (!Queue_dequeue(q)) {
+        handle_error("Queue_dequeue() returns false when queue is not empty");
+    }
+    if (!Queue_enqueue(q, &NUMS[5])) {
+        handle_error("Queue_enqueue() returns false when queue is below limit");
+    }
+
+    Queue_set_limit(q, 0);
+    if (!Queue_enqueue(q, &NUMS[6])) {
+        handle_error("Queue_enqueue() returns false when queue has no limit");
+    }
+    assert(Queue_size(q) == 6 && "Queue_size() returns wrong number");
+
+    Queue_destroy(q);
+}
+
+/** Checks that the elements of a queue are `NUMS[first]` onwards, in order. */
+void assert_nums_from(Queue* q, size_t first) {
+    size_t i   = first;
+    size_t len = 0;
+    void*  seg = NULL;
+    while ((seg = Queue_segment(q, seg, &len)) != NULL) {
+        for (size_t j = 0; j < len; ++j, ++i) {
+            assert(((int*)seg)[j] == NUMS[i] && "ring holds wrong elements");
+        }
+    }
+    assert(i - first == Queue_size(q) && "Queue_segment() misses elements");
+}
+
+void test_ring_overwrites_oldest() {
+    //
+    assert(Queue_create_ring(sizeof(int), 0) == NULL &&
+           "Queue_create_ring() creates a ring of zero capacity");
+
+    Queue* q = Queue_create_ring(sizeof(int), 4);
+    if (q == NULL) handle_error("cannot allocate memory for a ring");
+    assert(Queue_empty(q) && Queue_capacity(q) == 4 &&
+           Queue_dropped(q) == 0 && "ring not empty when created");
+
+    for (size_t i = 0; i < MAX_N_ELEMS; ++i) {
+        if (!Queue_enqueue(q, &NUMS[i])) {
+            handle_error("Queue_enqueue() returns false when ring is full");
+        }
+        assert(Queue_size(q) == (i < 4 ? i + 1 : 4) &&
+               Queue_dropped(q) == (i < 4 ? 0 : i - 3) &&
+               "Queue_enqueue() does not overwrite the oldest element");
+    }
+    assert(Queue_capacity(q) == 4 && !Queue_reserve(q, 5) &&
+           "ring grows beyond its capacity");
+    assert_nums_from(q, MAX_N_ELEMS - 4);
+
+    // The elements wrap around the array, if any, and can be unwrapped in place
+    int const* elems = Queue_linearize(q);
+    if (elems != NULL) {
+        size_t len = 0;
+        assert(Queue_segment(q, NULL, &len) == elems && len == 4 &&
+               "Queue_linearize() leaves elements in more than one segment");
+    }
+    assert_nums_from(q, MAX_N_ELEMS - 4);
+
+    // A ring that is not full drops nothing, and the limit applies only then
+    if (!Queue_dequeue(q) || !Queue_enqueue(q, &NUMS[0])) {
+        handle_error("cannot rotate ring");
+    }
+    assert(Queue_dropped(q) == MAX_N_ELEMS - 4 &&
+           "Queue_enqueue() drops elements when ring is not full");
+    Queue_set_limit(q, 4);
+    assert(Queue_enqueue(q, &NUMS[1]) && Queue_size(q) == 4 &&
+           "Queue_enqueue() rejects element when ring is full at its limit");
+
+    Queue_destroy(q);
+}
+
+void test_ring_extend_and_transfer() {
+    //
+    Queue* q   = Queue_create_ring(sizeof(int), 5);
+    Queue* src = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    if (q == NULL) handle_error("cannot allocate memory for a ring");
+
+    bool res = Queue_extend(q, 6);
+    assert(!res && Queue_empty(q) &&
+           "Queue_extend() extends ring beyond its capacity");
+    res = Queue_transfer(q, src, 6);
+    assert(!res && Queue_empty(q) && Queue_size(src) == MAX_N_ELEMS &&
+           "Queue_transfer() fills ring beyond its capacity");
+
+    // Fill the ring, then push its front elements out with more elements
+    if (!Queue_transfer(q, src, 3) || !Queue_transfer(q, src, 4)) {
+        handle_error("Queue_transfer() returns false when ring is full");
+    }
+    assert(Queue_size(q) == 5 && Queue_dropped(q) == 2 &&
+           Queue_size(src) == MAX_N_ELEMS - 7 &&
+           "Queue_transfer() does not drop the oldest elements of ring");
+    assert_nums_from(q, 2);
+
+    if (!Queue_extend(q, 3)) {
+        handle_error("Queue_extend() returns false when ring is full");
+    }
+    assert(Queue_size(q) == 5 && Queue_dropped(q) == 5 &&
+           "Queue_extend() does not drop the oldest elements of ring");
+    assert(*(int const*)Queue_peek(q) == NUMS[5] &&
+           "Queue_extend() drops wrong elements of ring");
+
+    Queue_destroy(q);
+    Queue_destroy(src);
+}
+
+/** Creates a temporary file, returning its descriptor. */
+FILE* create_temp_file(int* fd) {
+    FILE* f = tmpfile();
+    if (f == NULL) handle_error("cannot create a temporary file");
+    *fd = fileno(f);
+    return f;
+}
+
+/** Moves a file descriptor back to the start of its file. */
+void rewind_fd(int fd) {
+    if (lseek(fd, 0, SEEK_SET) != 0) handle_error("cannot rewind a file");
+}
+
+void test_save_and_load() {
+    //
+    int   fd;
+    FILE* f = create_temp_file(&fd);
+
+    // Wrap the queue around its underlying array, if any
+    Queue* q = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    for (size_t i = 0; i < 3; ++i) {
+        if (!Queue_dequeue(q) || !Queue_enqueue(q, &NUMS[i])) {
+            handle_error("cannot rotate queue");
+        }
+    }
+
+    // An empty queue follows the first one in the same file
+    Queue* empty = create_empty_test_queue(sizeof(int));
+    if (!Queue_save(q, fd) || !Queue_save(empty, fd)) {
+        handle_error("cannot write queue to file");
+    }
+    assert(Queue_size(q) == MAX_N_ELEMS && "Queue_save() modifies queue");
+    Queue_destroy(empty);
+
+    rewind_fd(fd);
+    Queue* loaded = Queue_load(fd, sizeof(int));
+    empty         = Queue_load(fd, sizeof(int));
+    assert(loaded != NULL && empty != NULL &&
+           "Queue_load() fails on queues written by Queue_save()");
+    assert(Queue_empty(empty) && "Queue_load() fills empty queue");
+
+    for (size_t i = 0; i < MAX_N_ELEMS; ++i) {
+        assert(*(int const*)Queue_peek(loaded) == NUMS[(i + 3) % MAX_N_ELEMS] &&
+               "Queue_load() reads elements out of order");
+        if (!Queue_dequeue(loaded)) {
+            handle_error("Queue_dequeue() returns false when queue not empty");
+        }
+    }
+    assert(Queue_empty(loaded) && "Queue_load() reads extra elements");
+
+    // A queue loaded is a queue like any other
+    if (!Queue_enqueue(empty, &NUMS[0]) || !Queue_enqueue(loaded, &NUMS[1])) {
+        handle_error("cannot allocate memory to enqueue an element");
+    }
+    Queue_destroy(loaded);
+    Queue_destroy(empty);
+
+    // Headers of another element size, or files cut short, are rejected
+    rewind_fd(fd);
+    assert(Queue_load(fd, sizeof(long)) == NULL &&
+           "Queue_load() reads elements of another size");
+    if (ftruncate(fd, 24 + sizeof(int)) != 0) {
+        handle_error("cannot truncate file");
+    }
+    rewind_fd(fd);
+    assert(Queue_load(fd, sizeof(int)) == NULL &&
+           "Queue_load() reads queue from truncated file");
+
+    Queue_destroy(q);
+    fclose(f);
+}
+
+void test_save_and_load_many() {
+    //
+    int          fd;
+    FILE*        f          = create_temp_file(&fd);
+    size_t const n          = 5000;   // more than a batch of segments holds
+    size_t const elem_szs[] = { sizeof(size_t), 640 };   // small and large
+
+    for (size_t k = 0; k < 2; ++k) {
+        size_t const elem_sz = elem_szs[k];
+        char*        elem    = calloc(1, elem_sz);
+        Queue*       q       = Queue_create(elem_sz);
+        if (elem == NULL || q == NULL) handle_error("cannot allocate memory");
+
+        // Tag each element at both ends
+        for (size_t i = 0; i < n; ++i) {
+            memcpy(elem, &i, sizeof(i));
+            memcpy(elem + elem_sz - sizeof(i), &i, sizeof(i));
+            if (!Queue_enqueue(q, elem)) {
+                handle_error("cannot allocate memory to enqueue an element");
+            }
+        }
+        rewind_fd(fd);
+        if (!Queue_save(q, fd)) handle_error("cannot write queue to file");
+        Queue_destroy(q);
+
+        rewind_fd(fd);
+        q = Queue_load(fd, elem_sz);
+        assert(q != NULL && Queue_size(q) == n &&
+               "Queue_load() fails on queues written by Queue_save()");
+
+        for (size_t i = 0; i < n; ++i) {
+            if (!Queue_front(q, elem) || !Queue_dequeue(q)) {
+                handle_error("cannot dequeue when queue is not empty");
+            }
+            assert(memcmp(elem, &i, sizeof(i)) == 0 &&
+                   memcmp(elem + elem_sz - sizeof(i), &i, sizeof(i)) == 0 &&
+                   "Queue_load() reads elements out of order");
+        }
+
+        free(elem);
+        Queue_destroy(q);
+    }
+    fclose(f);
+}
+
+void test_load_when_count_exceeds_payload() {
+    //
+    int   fd;
+    FILE* f = create_temp_file(&fd);
+
+    Queue* q = create_prefilled_test_queue(sizeof(int), MAX_N_ELEMS);
+    if (!Queue_save(q, fd)) handle_error("cannot write queue to file");
+    Queue_destroy(q);
+
+    // Claim far more elements than follow, as a corrupt header would, which
+    // must fail on the missing elements rather than on allocating them all
+    uint64_t const nelems = (uint64_t)1 << 40;
+    if (pwrite(fd, &nelems, sizeof(nelems), 16) != sizeof(nelems)) {
+        handle_error("cannot overwrite the header");
+    }
+    rewind_fd(fd);
+    assert(Queue_load(fd, sizeof(int)) == NULL &&
+           "Queue_load() accepts a count of elements beyond the file");
+
+    fclose(f);
+}
+
+/** Number of elements freed by `count_and_free()`. */
+static size_t n_freed = 0;
+
+/** Frees an element owned by a queue, and counts it. */
+void count_and_free(void* elem) {
+    free(elem);
+    n_freed += 1;
+}
+
+/** Allocates an element that holds `NUMS[i]`, exiting on failure. */
+int* create_owned_num(size_t i) {
+    int* num = malloc(sizeof(int));
+    if (num == NULL) handle_error("cannot allocate memory for an element");
+    *num = NUMS[i];
+    return num;
+}
+
+void test_owned_take_front_and_destroy() {
+    //
+    Queue* q = Queue_create_owned(count_and_free);
+    int*   nums[sizeof(NUMS) / sizeof(int)];
+    if (q == NULL) handle_error("cannot allocate memory for an owning queue");
+    assert(Queue_take_front(q) == NULL &&
+           "Queue_take_front() returns an element when empty");
+
+    for (size_t i = 0; i < MAX_N_ELEMS; ++i) {
+        nums[i] = create_owned_num(i);
+        if (!Queue_enqueue_owned(q, nums[i])) {
+            handle_error("cannot allocate memory to enqueue_owned()");
+        }
+    }
+    assert(Queue_size(q) == MAX_N_ELEMS &&
+           "Queue_size() returns wrong size of an owning queue");
+
+    // The very elements added come back, in order, rather than copies
+    for (size_t i = 0; i < 3; ++i) {
+        int* num = Queue_take_front(q);
+        assert(num == nums[i] && *num == NUMS[i] &&
+               "Queue_take_front() returns another element than added");
+        free(num);
+    }
+
+    // An element removed after being accessed is handed back too
+    int* front = NULL;
+    if (!Queue_front(q, &front) || !Queue_dequeue(q)) {
+        handle_error("cannot remove the front element of an owning queue");
+    }
+    assert(front == nums[3] && "Queue_front() returns another element");
+    free(front);
+
+    n_freed = 0;
+    Queue_destroy(q);
+    assert(n_freed == MAX_N_ELEMS - 4 &&
+           "Queue_destroy() does not destroy the elements left");
+}
+
+void test_owned_transfer() {
+    //
+    Queue* src = Queue_create_owned(count_and_free);
+    Queue* dst = Queue_create_owned(NULL);
+    int*   nums[5];
+    if (src == NULL || dst == NULL) {
+        handle_error("cannot allocate memory for an owning queue");
+    }
+
+    for (size_t i = 0; i < 5; ++i) {
+        nums[i] = create_owned_num(i);
+        if (!Queue_enqueue_owned(src, nums[i])) {
+            handle_error("cannot allocate memory to enqueue_owned()");
+        }
+    }
+    if (!Queue_transfer(dst, src, 3)) handle_error("Queue_transfer() failed");
+
+    // Elements moved are no longer destroyed with the queue they left
+    n_freed = 0;
+    Queue_destroy(src);
+    assert(n_freed == 2 && "Queue_destroy() destroys elements moved away");
+
+    for (size_t i = 0; i < 3; ++i) {
+        int* num = Queue_take_front(dst);
+        assert(num == nums[i] && "Queue_transfer() does not move the elements");
+        free(num);
+    }
+    assert(Queue_take_front(dst) == NULL &&
+           "Queue_take_front() returns an element when empty");
+
+    Queue_destroy(dst);
+    assert(n_freed == 2 && "Queue_destroy() runs a destructor not given");
+}
+
+void test_owned_extend_and_save() {
+    //
+    int    fd;
+    FILE*  f = create_temp_file(&fd);
+    Queue* q = Queue_create_owned(count_and_free);
+    if (q == NULL) handle_error("cannot allocate memory for an owning queue");
+    if (!Queue_enqueue_owned(q, create_owned_num(0))) {
+        handle_error("cannot allocate memory to enqueue_owned()");
+    }
+
+    // Neither adds elements that are not addresses handed over to the queue
+    bool const extended = Queue_extend(q, 3);
+    assert(!extended && Queue_size(q) == 1 &&
+           "Queue_extend() adds elements to an owning queue");
+
+    errno            = 0;
+    bool const saved = Queue_save(q, fd);
+    assert(!saved && errno == EINVAL &&
+           "Queue_save() writes the addresses of owned elements");
+
+    n_freed = 0;
+    Queue_destroy(q);
+    assert(n_freed == 1 && "Queue_destroy() misses owned elements");
+
+    (void)extended;
+    (void)saved;
+    fclose(f);
+}
+
+void test_owned_create_like_and_discard() {
+    //
+    Queue* q     = Queue_create_owned(count_and_free);
+    Queue* plain = Queue_create(sizeof(int));
+    if (q == NULL || plain == NULL) {
+        handle_error("cannot allocate memory for a queue");
+    }
+    assert(Queue_owned(q) && !Queue_owned(plain) &&
+           "Queue_owned() does not tell owning queues apart");
+
+    // A queue created like another owns its elements the same way
+    Queue* like       = Queue_create_like(q);
+    Queue* plain_like = Queue_create_like(plain);
+    if (like == NULL || plain_like == NULL) {
+        handle_error("cannot allocate memory for a queue");
+    }
+    assert(Queue_owned(like) && !Queue_owned(plain_like) &&
+           "Queue_create_like() does not keep the ownership");
+
+    for (size_t i = 0; i < 5; ++i) {
+        if (!Queue_enqueue_owned(like, create_owned_num(i))) {
+            handle_error("cannot allocate memory to enqueue_owned()");
+        }
+    }
+
+    // Discarding runs the destructor of the queue created like the other
+    n_freed              = 0;
+    bool const too_many  = Queue_discard_n(like, 6);
+    bool const discarded = Queue_discard_n(like, 2);
+    assert(!too_many && discarded && n_freed == 2 && Queue_size(like) == 3 &&
+           "Queue_discard_n() does not destroy the elements removed");
+
+    int* front = Queue_take_front(like);
+    assert(front != NULL && *front == NUMS[2] &&
+           "Queue_discard_n() removes other elements than the front ones");
+    free(front);
+
+    // Queues that own nothing discard elements just like Queue_dequeue_n()
+    for (size_t i = 0; i < 3; ++i) {
+        if (!Queue_enqueue(plain_like, &NUMS[i])) {
+            handle_error("cannot allocate memory to enqueue()");
+        }
+    }
+    bool const dropped = Queue_discard_n(plain_like, 2);
+    assert(dropped && Queue_size(plain_like) == 1 &&
+           "Queue_discard_n() fails on a queue that owns nothing");
+
+    n_freed = 0;
+    Queue_destroy(like);
+    assert(n_freed == 2 && "Queue_destroy() misses owned elements");
+
+    (void)too_many;
+    (void)discarded;
+    (void)dropped;
+    Queue_destroy(plain_like);
+    Queue_destroy(plain);
+    Queue_destroy(q);
+}
+
 /**
  * Runs unit tests on a specific implementation of the Queue ADT.
  */
@@ -319,6 +1062,25 @@ int main(int argc, char** argv) {
                           test_dequeue_when_only_one,
                           test_print_when_empty,
                           test_print_when_nonempty,
+                          test_watermarks_fire_on_transition,
+                          test_enqueue_when_at_limit,
+                          test_peek,
+                          test_reserve,
+                          test_transfer,
+                          test_segments,
+                          test_linearize,
+                          test_for_each_and_fold,
+                          test_extend,
+                          test_dequeue_n,
+                          test_ring_overwrites_oldest,
+                          test_ring_extend_and_transfer,
+                          test_save_and_load,
+                          test_save_and_load_many,
+                          test_load_when_count_exceeds_payload,
+                          test_owned_take_front_and_destroy,
+                          test_owned_transfer,
+                          test_owned_extend_and_save,
+                          test_owned_create_like_and_discard,
                           NULL };
     run_tests(utests);
 
@@ -359,12 +1121,46 @@ Test 8 passed 👍
 Running...
 Test 9 passed 👍
 Running...
->> actual  : 
->> expected: 
 Test 10 passed 👍
 Running...
->> actual  : 3,1,4,1,5
->> expected: 3,1,4,1,5
 Test 11 passed 👍
+Running...
+Test 12 passed 👍
+Running...
+Test 13 passed 👍
+Running...
+Test 14 passed 👍
+Running...
+Test 15 passed 👍
+Running...
+Test 16 passed 👍
+Running...
+Test 17 passed 👍
+Running...
+Test 18 passed 👍
+Running...
+Test 19 passed 👍
+Running...
+Test 20 passed 👍
+Running...
+Test 21 passed 👍
+Running...
+Test 22 passed 👍
+Running...
+Test 23 passed 👍
+Running...
+Test 24 passed 👍
+Running...
+Test 25 passed 👍
+Running...
+Test 26 passed 👍
+Running...
+Test 27 passed 👍
+Running...
+Test 28 passed 👍
+Running...
+Test 29 passed 👍
+Running...
+Test 30 passed 👍
 ALL PASSED
-*/
\ No newline at end of file
+*/
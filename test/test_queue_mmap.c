@@ -0,0 +1,252 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // mkstemp(), fork()
+
+#include <stdlib.h>     // EXIT_*, mkstemp()
+#include <stdio.h>      // printf(), stderr
+#include <string.h>     // strcpy()
+#include <assert.h>     // assert()
+#include <unistd.h>     // close(), unlink(), write(), fork(), _exit()
+#include <sys/wait.h>   // waitpid()
+
+#include "test_utils.h"    // UnitTest, run_tests(), handle_error()
+#include "queue_mmap.h"    // Queue, Queue_*()
+
+/** Path of the file that backs the queues under test. */
+static char path[] = "/tmp/test_queue_mmap_XXXXXX";
+
+/** Creates an empty file for a queue to be opened on, exiting on failure. */
+void create_file() {
+    strcpy(path + sizeof(path) - 7, "XXXXXX");
+    int const fd = mkstemp(path);
+    if (fd < 0) handle_error("cannot create temporary file");
+    close(fd);
+}
+
+/** Opens a queue of ints on the file under test, exiting on failure. */
+Queue* open_queue() {
+    Queue* q = Queue_open(path, sizeof(int));
+    if (q == NULL) handle_error("cannot open queue");
+    return q;
+}
+
+/** Enqueues the ints in `[first, last)`, exiting on failure. */
+void enqueue_range(Queue* q, int first, int last) {
+    for (int i = first; i < last; ++i) {
+        if (!Queue_enqueue(q, &i)) {
+            handle_error("cannot allocate memory to enqueue()");
+        }
+    }
+}
+
+/** Checks that a queue holds exactly the ints in `[first, last)`. */
+void assert_range(Queue* q, int first, int last) {
+    assert(Queue_size(q) == (size_t)(last - first) &&
+           "queue recovered with wrong size");
+    for (int i = first; i < last; ++i) {
+        int elem = 0;
+        Queue_front(q, &elem);
+        assert(elem == i && "queue recovered with wrong elements");
+        Queue_dequeue(q);
+    }
+}
+
+void test_reopen_recovers_state() {
+    create_file();
+    Queue* q = open_queue();
+    assert(Queue_empty(q) && "Queue_open() opens empty file with elements");
+
+    enqueue_range(q, 0, 100);
+    Queue_dequeue_n(q, 30);
+    Queue_destroy(q);
+
+    q = open_queue();
+    assert_range(q, 30, 100);
+    Queue_destroy(q);
+
+    // What was dequeued after reopening stays dequeued
+    q = open_queue();
+    assert(Queue_empty(q) && "Queue_open() recovers dequeued elements");
+    Queue_destroy(q);
+    unlink(path);
+}
+
+void test_reopen_after_wrap_and_growth() {
+    create_file();
+    Queue* q = open_queue();
+
+    // Wrap the elements around the end of the array before it grows
+    size_t const cap = Queue_capacity(q);
+    enqueue_range(q, 0, (int)cap);
+    Queue_dequeue_n(q, cap / 2);
+    enqueue_range(q, (int)cap, (int)(4 * cap + 3));
+    assert(Queue_capacity(q) > cap && "queue does not grow");
+    Queue_destroy(q);
+
+    q = open_queue();
+    assert_range(q, (int)(cap / 2), (int)(4 * cap + 3));
+    enqueue_range(q, 0, 10);
+    Queue_destroy(q);
+
+    q = open_queue();
+    assert_range(q, 0, 10);
+    Queue_destroy(q);
+    unlink(path);
+}
+
+void test_linearize_keeps_capacity() {
+    create_file();
+    Queue* q = open_queue();
+
+    // Wrap and unwrap a few elements over and over, as steady traffic does
+    enqueue_range(q, 0, 3);
+    size_t const cap = Queue_capacity(q);
+    for (int i = 3; i < 10003; ++i) {
+        Queue_dequeue(q);
+        enqueue_range(q, i, i + 1);
+
+        int const* front = Queue_linearize(q);
+        assert(front != NULL && front[0] == i - 2 && front[2] == i &&
+               "Queue_linearize() reorders elements");
+        assert(Queue_capacity(q) <= 2 * cap &&
+               "Queue_linearize() grows queue with room to unwrap");
+        (void)front;
+    }
+    Queue_destroy(q);
+
+    q = open_queue();
+    assert_range(q, 10000, 10003);
+    Queue_destroy(q);
+    unlink(path);
+}
+
+void test_recover_after_crash() {
+    create_file();
+
+    // The child exits without destroying, unmapping or syncing the queue
+    pid_t const pid = fork();
+    if (pid < 0) handle_error("cannot fork");
+    if (pid == 0) {
+        Queue* q = Queue_open(path, sizeof(int));
+        if (q == NULL) _exit(EXIT_FAILURE);
+        enqueue_range(q, 0, 1000);
+        Queue_dequeue_n(q, 10);
+        _exit(EXIT_SUCCESS);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS &&
+           "child cannot open queue");
+
+    Queue* q = open_queue();
+    assert_range(q, 10, 1000);
+    Queue_destroy(q);
+    unlink(path);
+}
+
+void test_open_rejects_other_files() {
+    create_file();
+    Queue* q = open_queue();
+    enqueue_range(q, 0, 3);
+    Queue_destroy(q);
+
+    assert(Queue_open(path, sizeof(double)) == NULL &&
+           "Queue_open() opens queue with wrong element size");
+
+    // Anything but a queue is rejected, rather than mistaken for one
+    FILE* file = fopen(path, "w");
+    if (file == NULL) handle_error("cannot open temporary file");
+    for (int i = 0; i < 5000; ++i) fputs("not a queue", file);
+    fclose(file);
+    assert(Queue_open(path, sizeof(int)) == NULL &&
+           "Queue_open() opens file that is not a queue");
+    unlink(path);
+}
+
+void test_sync() {
+    create_file();
+    Queue* q = open_queue();
+
+    if (!Queue_sync(q)) handle_error("cannot sync empty queue");
+    Queue_set_sync(q, 16);
+    enqueue_range(q, 0, 100);
+    if (!Queue_sync(q)) handle_error("cannot sync queue");
+    Queue_destroy(q);
+
+    q = open_queue();
+    assert_range(q, 0, 100);
+    Queue_destroy(q);
+    unlink(path);
+}
+
+/**
+ * Runs all tests on the persistence of `libqueuemmap`, which otherwise runs
+ * the same tests as every other implementation of the Queue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_reopen_recovers_state,
+                          test_reopen_after_wrap_and_growth,
+                          test_linearize_keeps_capacity,
+                          test_recover_after_crash,
+                          test_open_rejects_other_files,
+                          test_sync,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_mmap.c test_queue_mmap.c -o test_queue_mmap -std=c99 -g -Og -Wall -pedantic -march=native -DQUEUE_INIT_CAP=2 -I../src && ./test_queue_mmap
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+Running...
+Test 6 passed 👍
+ALL PASSED
+*/
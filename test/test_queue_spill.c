@@ -0,0 +1,248 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // mkstemp(), setrlimit(), SIGXFSZ
+
+#include <stdlib.h>         // EXIT_*, rand(), srand(), mkstemp()
+#include <stdio.h>          // printf(), stderr
+#include <assert.h>         // assert()
+#include <signal.h>         // signal(), SIGXFSZ, SIG_IGN
+#include <unistd.h>         // close(), unlink(), lseek()
+#include <sys/resource.h>   // getrlimit(), setrlimit(), RLIMIT_FSIZE
+
+#include "test_utils.h"     // UnitTest, run_tests(), handle_error()
+#include "queue_spill.h"    // Queue, Queue_*()
+#include "algos.h"          // Queue_filter_in_place()
+
+/** Memory budget of the queues under test, for blocks of 4 ints. */
+static size_t const MEM_SZ = 16 * sizeof(int);
+
+/** Creates a queue of ints that spills beyond `MEM_SZ`, exiting on failure. */
+Queue* create_spill_queue() {
+    Queue* q = Queue_create_spill(sizeof(int), MEM_SZ, NULL);
+    if (q == NULL) handle_error("cannot allocate memory to create a queue");
+    return q;
+}
+
+/** Enqueues the ints in `[first, last)`, exiting on failure. */
+void enqueue_range(Queue* q, int first, int last) {
+    for (int i = first; i < last; ++i) {
+        if (!Queue_enqueue(q, &i)) {
+            handle_error("cannot allocate memory to enqueue()");
+        }
+    }
+}
+
+/** Dequeues `n` ints and checks that they run from `first` on. */
+void dequeue_range(Queue* q, int first, size_t n) {
+    for (size_t i = 0; i < n; ++i) {
+        int elem = -1;
+        if (!Queue_front(q, &elem) || !Queue_dequeue(q)) {
+            handle_error("cannot read spilled elements back");
+        }
+        assert(elem == first + (int)i && "spilled elements out of order");
+    }
+}
+
+void test_spill_and_read_back() {
+    //
+    Queue* q = create_spill_queue();
+
+    enqueue_range(q, 0, 10000);
+    assert(Queue_size(q) == 10000 && "Queue_enqueue() loses elements");
+    assert(Queue_spilled(q) > 9000 && "queue keeps elements beyond budget");
+
+    // Interleave, so that elements cross every tier while others are added
+    dequeue_range(q, 0, 5000);
+    enqueue_range(q, 10000, 12000);
+    dequeue_range(q, 5000, 7000);
+    assert(Queue_spilled(q) == 0 && "Queue_spilled() is wrong once drained");
+    assert(Queue_empty(q) && "Queue_dequeue() leaves elements");
+
+    Queue_destroy(q);
+}
+
+void test_random_operations() {
+    //
+    Queue* q     = create_spill_queue();
+    Queue* other = create_spill_queue();
+    int    front = 0;   // value of the front element of `q`
+    int    back  = 0;   // value of the element to enqueue to `q` next
+
+    // Moving elements to another queue in parts and back keeps them in order
+    srand(46);
+    for (size_t i = 0; i < 5000; ++i) {
+        int const op = rand() % 8;
+        if (op < 4) {
+            int const n = rand() % 40;
+            enqueue_range(q, back, back + n);
+            back += n;
+        } else if (op < 6) {
+            size_t const n = (size_t)rand() % 80;
+            if (Queue_dequeue_n(q, n)) front += (int)n;
+        } else if (op < 7) {
+            size_t const n = (size_t)rand() % 30;
+            if (!Queue_transfer(other, q, n)) continue;
+            if (!Queue_transfer(other, q, Queue_size(q)) ||
+                !Queue_transfer(q, other, Queue_size(other))) {
+                handle_error("cannot allocate memory to transfer()");
+            }
+        } else {
+            int elem = -1;
+            if (Queue_front(q, &elem)) {
+                assert(elem == front && "front element is wrong");
+            }
+        }
+        assert(Queue_size(q) == (size_t)(back - front) &&
+               "Queue_size() is wrong");
+    }
+    assert(Queue_empty(other) && "Queue_transfer() leaves elements behind");
+
+    Queue_destroy(q);
+    Queue_destroy(other);
+}
+
+void test_write_through_segments() {
+    //
+    Queue* q = create_spill_queue();
+
+    // Elements added by extension are on disk, but can be written in place
+    enqueue_range(q, 0, 3);
+    if (!Queue_extend(q, 997)) handle_error("cannot extend queue");
+    assert(Queue_spilled(q) > 0 && "Queue_extend() does not spill");
+
+    size_t len = 0;
+    size_t i   = 0;
+    int*   seg = NULL;
+    while ((seg = Queue_segment(q, seg, &len)) != NULL) {
+        for (size_t j = 0; j < len; ++j, ++i) seg[j] = (int)i;
+    }
+    assert(i == 1000 && "Queue_segment() misses elements");
+
+    dequeue_range(q, 0, 1000);
+    Queue_destroy(q);
+}
+
+void test_save_and_load_spilled() {
+    //
+    char      path[] = "/tmp/test_queue_spill_XXXXXX";
+    int const fd     = mkstemp(path);
+    if (fd < 0) handle_error("cannot create temporary file");
+    unlink(path);
+
+    Queue* q = create_spill_queue();
+    enqueue_range(q, 0, 5000);
+    Queue_dequeue_n(q, 7);
+    if (!Queue_save(q, fd)) handle_error("cannot write queue to file");
+    assert(Queue_size(q) == 4993 && "Queue_save() modifies queue");
+    Queue_destroy(q);
+
+    if (lseek(fd, 0, SEEK_SET) != 0) handle_error("cannot rewind file");
+    q = Queue_load(fd, sizeof(int));
+    if (q == NULL) handle_error("cannot read queue from file");
+    dequeue_range(q, 7, 4993);
+    assert(Queue_empty(q) && "Queue_load() loads too many elements");
+
+    Queue_destroy(q);
+    close(fd);
+}
+
+/** Keeps every element. */
+bool keep_all(void const* elem) {
+    (void)elem;
+    return true;
+}
+
+void test_filter_when_spilling_fails() {
+    //
+    Queue* q = create_spill_queue();
+    enqueue_range(q, 0, 10);
+    assert(Queue_spilled(q) == 0 && "queue spills elements within budget");
+
+    // Files cannot grow, so the queue the elements kept go to cannot spill
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_FSIZE, &lim) != 0) handle_error("cannot get limit");
+    rlim_t const cur = lim.rlim_cur;
+    void (*const on_xfsz)(int) = signal(SIGXFSZ, SIG_IGN);
+    lim.rlim_cur               = 0;
+    if (setrlimit(RLIMIT_FSIZE, &lim) != 0) handle_error("cannot set limit");
+
+    bool const res = Queue_filter_in_place(q, sizeof(int), keep_all);
+
+    lim.rlim_cur = cur;
+    if (setrlimit(RLIMIT_FSIZE, &lim) != 0) handle_error("cannot set limit");
+    signal(SIGXFSZ, on_xfsz);
+
+    assert(!res && "Queue_filter_in_place() succeeds when transfers fail");
+    assert(Queue_size(q) == 10 && "Queue_filter_in_place() loses elements");
+
+    (void)res;
+    Queue_destroy(q);
+}
+
+/**
+ * Runs all tests on spilling to disk in `libqueuespill`, which otherwise runs
+ * the same tests as every other implementation of the Queue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_spill_and_read_back,
+                          test_random_operations,
+                          test_write_through_segments,
+                          test_save_and_load_spilled,
+                          test_filter_when_spilling_fails,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_spill.c ../src/partition.c test_queue_spill.c -o test_queue_spill -std=c99 -g -Og -Wall -pedantic -march=native -DQUEUE_SPILL_BLOCK_CAP=2 -I../src && ./test_queue_spill
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/
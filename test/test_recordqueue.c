@@ -0,0 +1,256 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, rand(), srand()
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+#include <string.h>   // memcmp()
+
+#include "test_utils.h"     // UnitTest, run_tests(), handle_error()
+#include "recordqueue.h"    // RecordQueue, RecordQueue_*()
+
+/** Maximum length of a record in tests. */
+#define MAX_LEN 300
+
+/** Length of the record with sequence number `seq`, zero for some. */
+size_t len_of(size_t seq) {
+    return (seq * 2654435761u >> 7) % MAX_LEN / 3 * 3;
+}
+
+/** Fills a buffer with the bytes of the record with sequence number `seq`. */
+size_t fill(unsigned char* buf, size_t seq) {
+    size_t const len = len_of(seq);
+    for (size_t j = 0; j < len; ++j) buf[j] = (unsigned char)(seq * 31 + j);
+    return len;
+}
+
+/** Determines whether a span holds the record with sequence number `seq`. */
+bool holds(RecordSpan rec, size_t seq) {
+    unsigned char buf[MAX_LEN];
+    size_t const  len = fill(buf, seq);
+    return rec.len == len && (len == 0 || memcmp(rec.data, buf, len) == 0);
+}
+
+/** Adds the record with sequence number `seq`, exiting on failure. */
+void enqueue_seq(RecordQueue* rq, size_t seq) {
+    unsigned char buf[MAX_LEN];
+    size_t const  len = fill(buf, seq);
+    if (!RecordQueue_enqueue(rq, buf, len)) {
+        handle_error("cannot allocate memory to enqueue()");
+    }
+}
+
+/** Checks the front record and removes it, exiting on failure. */
+void dequeue_seq(RecordQueue* rq, size_t seq) {
+    RecordSpan rec = { NULL, 0 };
+    if (!RecordQueue_front(rq, &rec)) handle_error("RecordQueue_front() failed");
+    assert(holds(rec, seq) && "records not dequeued in order or intact");
+    if (!RecordQueue_dequeue(rq)) handle_error("RecordQueue_dequeue() failed");
+    (void)rec;
+}
+
+void test_empty() {
+    //
+    RecordQueue* rq  = RecordQueue_create();
+    RecordSpan   rec = { NULL, 0 };
+    if (rq == NULL) handle_error("cannot allocate memory for a recordqueue");
+
+    assert(RecordQueue_empty(rq) && RecordQueue_size(rq) == 0 &&
+           RecordQueue_bytes(rq) == 0 &&
+           "record queue not empty when created");
+    assert(RecordQueue_capacity(rq) > 0 && RecordQueue_capacity(rq) % 8 == 0 &&
+           "RecordQueue_capacity() returns invalid capacity");
+    assert(!RecordQueue_front(rq, &rec) &&
+           "RecordQueue_front() returns true when empty");
+    assert(RecordQueue_front_n(rq, &rec, 1) == 0 &&
+           "RecordQueue_front_n() returns records when empty");
+    assert(!RecordQueue_dequeue(rq) &&
+           "RecordQueue_dequeue() returns true when empty");
+    assert(RecordQueue_dequeue_n(rq, 0) &&
+           "RecordQueue_dequeue_n() of no records fails when empty");
+
+    (void)rec;
+    RecordQueue_destroy(rq);
+}
+
+void test_fifo_mixed_lengths() {
+    //
+    size_t const n     = 20000;
+    size_t       bytes = 0;
+    RecordQueue* rq    = RecordQueue_create();
+    if (rq == NULL) handle_error("cannot allocate memory for a recordqueue");
+
+    // Remove some records while adding, so that records wrap around
+    size_t front = 0;
+    for (size_t i = 0; i < n; ++i) {
+        enqueue_seq(rq, i);
+        bytes += len_of(i);
+        if (i % 3 != 0) {
+            dequeue_seq(rq, front);
+            bytes -= len_of(front++);
+        }
+    }
+    assert(RecordQueue_size(rq) == n - front &&
+           "RecordQueue_size() returns wrong size");
+    assert(RecordQueue_bytes(rq) == bytes &&
+           "RecordQueue_bytes() returns wrong number of bytes");
+
+    // Memory matches the payload, not the longest record
+    assert(RecordQueue_capacity(rq) <= 4 * (bytes + 16 * (n - front)) &&
+           "RecordQueue_capacity() out of proportion to payload");
+
+    while (front < n) dequeue_seq(rq, front++);
+    assert(RecordQueue_empty(rq) && RecordQueue_bytes(rq) == 0 &&
+           "record queue not empty when drained");
+
+    (void)bytes;
+    RecordQueue_destroy(rq);
+}
+
+void test_batch() {
+    //
+    size_t const  n = 64;
+    unsigned char bufs[64][MAX_LEN];
+    RecordSpan    recs[64];
+    RecordQueue*  rq = RecordQueue_create();
+    if (rq == NULL) handle_error("cannot allocate memory for a recordqueue");
+
+    size_t next  = 0;
+    size_t front = 0;
+    for (int round = 0; round < 50; ++round) {
+        size_t const k = (size_t)(round * 7) % n + 1;
+        for (size_t i = 0; i < k; ++i) {
+            recs[i].len  = fill(bufs[i], next + i);
+            recs[i].data = bufs[i];
+        }
+        if (!RecordQueue_enqueue_n(rq, recs, k)) {
+            handle_error("cannot allocate memory to enqueue_n()");
+        }
+        next += k;
+
+        size_t const m = RecordQueue_front_n(rq, recs, k / 2 + 1);
+        assert(m == k / 2 + 1 && "RecordQueue_front_n() returns too few");
+        for (size_t i = 0; i < m; ++i) {
+            assert(holds(recs[i], front + i) &&
+                   "RecordQueue_front_n() returns records out of order");
+        }
+        if (!RecordQueue_dequeue_n(rq, m)) {
+            handle_error("RecordQueue_dequeue_n() failed");
+        }
+        front += m;
+    }
+    assert(RecordQueue_size(rq) == next - front &&
+           "RecordQueue_size() returns wrong size");
+
+    // Removing more records than there are leaves the record queue as is
+    assert(!RecordQueue_dequeue_n(rq, next - front + 1) &&
+           RecordQueue_size(rq) == next - front &&
+           "RecordQueue_dequeue_n() of too many records modifies the queue");
+    assert(RecordQueue_front_n(rq, recs, n) == (next - front < n ? next - front
+                                                                 : n) &&
+           "RecordQueue_front_n() returns wrong number of records");
+
+    while (front < next) dequeue_seq(rq, front++);
+    assert(RecordQueue_empty(rq) && "record queue not empty when drained");
+
+    RecordQueue_destroy(rq);
+}
+
+void test_random_ops() {
+    //
+    srand(48);
+    RecordQueue* rq = RecordQueue_create();
+    if (rq == NULL) handle_error("cannot allocate memory for a recordqueue");
+
+    // Records [front, next) are in the record queue, as the model
+    size_t     next  = 0;
+    size_t     front = 0;
+    RecordSpan recs[16];
+    for (int iter = 0; iter < 100000; ++iter) {
+        size_t const k = (size_t)rand() % 16;
+        if (rand() % 2 == 0) {
+            for (size_t i = 0; i < k; ++i) enqueue_seq(rq, next++);
+        } else {
+            size_t const m = RecordQueue_front_n(rq, recs, k);
+            assert(m == (next - front < k ? next - front : k) &&
+                   "RecordQueue_front_n() returns wrong number of records");
+            for (size_t i = 0; i < m; ++i) {
+                assert(holds(recs[i], front + i) &&
+                       "records not dequeued in order or intact");
+            }
+            if (!RecordQueue_dequeue_n(rq, m)) {
+                handle_error("RecordQueue_dequeue_n() failed");
+            }
+            front += m;
+        }
+        assert(RecordQueue_size(rq) == next - front &&
+               "RecordQueue_size() returns wrong size");
+    }
+
+    RecordQueue_destroy(rq);
+}
+
+/**
+ * Runs all tests on the RecordQueue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_empty,
+                          test_fifo_mixed_lengths,
+                          test_batch,
+                          test_random_ops,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/recordqueue_circ_array.c test_recordqueue.c -o test_recordqueue -std=c99 -g -Og -Wall -pedantic -march=native -DRECORDQUEUE_INIT_CAP=64 -I../src && ./test_recordqueue
+
+gcc ../src/recordqueue_circ_array.c test_recordqueue.c -o test_recordqueue -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_recordqueue
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+ALL PASSED
+*/
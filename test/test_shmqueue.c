@@ -0,0 +1,264 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#define _POSIX_C_SOURCE 200809L   // fork(), sched_yield()
+
+#include <stdlib.h>     // EXIT_*
+#include <stdio.h>      // printf(), snprintf(), stderr
+#include <assert.h>     // assert()
+#include <sched.h>      // sched_yield()
+#include <unistd.h>     // fork(), getpid(), _exit()
+#include <sys/wait.h>   // waitpid()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "shmqueue.h"     // ShmQueue, ShmQueue_*()
+
+/** Name of the shared-memory object of the queue under test. */
+static char name[64];
+
+/** Creates a queue of ints in a role, under a name of its own. */
+ShmQueue* create_test_queue(size_t cap, ShmQueueRole role) {
+    static unsigned n_queues = 0;
+    snprintf(name, sizeof(name), "/test_shmqueue_%ld_%u", (long)getpid(),
+             n_queues++);
+
+    ShmQueue* sq = ShmQueue_create(name, sizeof(int), cap, role);
+    if (sq == NULL) handle_error("cannot create shared-memory queue");
+    return sq;
+}
+
+/** Opens the queue under test in a role, exiting on failure. */
+ShmQueue* open_test_queue(ShmQueueRole role) {
+    ShmQueue* sq = ShmQueue_open(name, sizeof(int), role);
+    if (sq == NULL) handle_error("cannot open shared-memory queue");
+    return sq;
+}
+
+/** Runs a function in a child process, and checks that it succeeds. */
+void run_child(void (*child)(size_t), size_t arg) {
+    pid_t const pid = fork();
+    if (pid < 0) handle_error("cannot fork");
+    if (pid == 0) {
+        child(arg);
+        _exit(EXIT_SUCCESS);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS &&
+           "child process fails");
+    (void)status;
+}
+
+void test_roles() {
+    //
+    ShmQueue* prod = create_test_queue(5, SHMQUEUE_PRODUCER);
+    assert(ShmQueue_capacity(prod) == 8 && "capacity not rounded up");
+    assert(!ShmQueue_peer_alive(prod) && "consumer alive before attaching");
+
+    assert(ShmQueue_open(name, sizeof(int), SHMQUEUE_PRODUCER) == NULL &&
+           "ShmQueue_open() takes role of live process");
+    assert(ShmQueue_open(name, sizeof(double), SHMQUEUE_CONSUMER) == NULL &&
+           "ShmQueue_open() opens queue with wrong element size");
+    ShmQueue* cons = open_test_queue(SHMQUEUE_CONSUMER);
+    assert(ShmQueue_peer_alive(prod) && ShmQueue_peer_alive(cons) &&
+           "ShmQueue_peer_alive() misses attached process");
+
+    for (int i = 0; i < 8; ++i) {
+        if (!ShmQueue_enqueue(prod, &i)) handle_error("cannot enqueue");
+    }
+    int elem = 8;
+    assert(!ShmQueue_enqueue(prod, &elem) && "ShmQueue_enqueue() when full");
+    assert(ShmQueue_size(cons) == 8 && "ShmQueue_size() is wrong");
+
+    for (int i = 0; i < 8; ++i) {
+        if (!ShmQueue_front(cons, &elem) || !ShmQueue_dequeue(cons)) {
+            handle_error("cannot dequeue when queue is not empty");
+        }
+        assert(elem == i && "elements out of order");
+    }
+    assert(ShmQueue_peek(cons) == NULL && "ShmQueue_peek() when empty");
+    assert(!ShmQueue_dequeue(cons) && "ShmQueue_dequeue() when empty");
+
+    // Detaching frees the role for another process to take
+    ShmQueue_destroy(cons);
+    assert(!ShmQueue_peer_alive(prod) && "consumer alive after detaching");
+    cons = open_test_queue(SHMQUEUE_CONSUMER);
+
+    ShmQueue_destroy(cons);
+    ShmQueue_destroy(prod);
+    ShmQueue_unlink(name);
+    assert(ShmQueue_open(name, sizeof(int), SHMQUEUE_CONSUMER) == NULL &&
+           "ShmQueue_open() opens unlinked queue");
+}
+
+void test_write_and_read() {
+    //
+    ShmQueue* prod = create_test_queue(16, SHMQUEUE_PRODUCER);
+    ShmQueue* cons = open_test_queue(SHMQUEUE_CONSUMER);
+    int       in[16];
+    int       out[16];
+    int       next_in  = 0;
+    int       next_out = 0;
+
+    // Batches of every size wrap around the array at every position
+    for (size_t n = 1; n <= 16; ++n) {
+        for (size_t rep = 0; rep < 17; ++rep) {
+            for (size_t i = 0; i < n; ++i) in[i] = next_in + (int)i;
+            size_t const nin = ShmQueue_write(prod, in, n);
+            next_in         += (int)nin;
+
+            size_t const nout = ShmQueue_read(cons, out, 16);
+            for (size_t i = 0; i < nout; ++i) {
+                assert(out[i] == next_out++ && "batch out of order");
+            }
+        }
+    }
+    size_t const nleft = ShmQueue_read(cons, out, 16);
+    assert(nleft == 0 && next_in == next_out &&
+           "ShmQueue_read() misses elements");
+    (void)nleft;
+
+    ShmQueue_destroy(cons);
+    ShmQueue_destroy(prod);
+    ShmQueue_unlink(name);
+}
+
+/** Consumes `n` ints from the queue under test, exiting if out of order. */
+void consume(size_t n) {
+    ShmQueue* cons = ShmQueue_open(name, sizeof(int), SHMQUEUE_CONSUMER);
+    if (cons == NULL) _exit(EXIT_FAILURE);
+
+    int elem = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (!ShmQueue_front(cons, &elem)) sched_yield();
+        if (elem != (int)i) _exit(EXIT_FAILURE);
+        ShmQueue_dequeue(cons);
+    }
+    ShmQueue_destroy(cons);
+}
+
+void test_across_processes() {
+    //
+    size_t const n    = 100000;
+    ShmQueue*    prod = create_test_queue(64, SHMQUEUE_PRODUCER);
+
+    pid_t const pid = fork();
+    if (pid < 0) handle_error("cannot fork");
+    if (pid == 0) {
+        consume(n);
+        _exit(EXIT_SUCCESS);
+    }
+
+    for (int i = 0; i < (int)n; ++i) {
+        while (!ShmQueue_enqueue(prod, &i)) sched_yield();
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    assert(WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS &&
+           "consumer process receives elements out of order");
+    (void)status;
+
+    ShmQueue_destroy(prod);
+    ShmQueue_unlink(name);
+}
+
+/** Produces `n` ints to the queue under test, and dies without detaching. */
+void produce_and_die(size_t n) {
+    ShmQueue* prod = ShmQueue_open(name, sizeof(int), SHMQUEUE_PRODUCER);
+    if (prod == NULL) _exit(EXIT_FAILURE);
+
+    for (int i = 0; i < (int)n; ++i) {
+        if (!ShmQueue_enqueue(prod, &i)) _exit(EXIT_FAILURE);
+    }
+}
+
+void test_take_over_from_dead_producer() {
+    //
+    ShmQueue* cons = create_test_queue(64, SHMQUEUE_CONSUMER);
+
+    run_child(produce_and_die, 10);
+    assert(!ShmQueue_peer_alive(cons) && "dead producer seen alive");
+
+    // What the dead producer added is intact, and a new one carries on
+    ShmQueue* prod = open_test_queue(SHMQUEUE_PRODUCER);
+    for (int i = 10; i < 20; ++i) {
+        if (!ShmQueue_enqueue(prod, &i)) handle_error("cannot enqueue");
+    }
+
+    int          out[32];
+    size_t const nout = ShmQueue_read(cons, out, 32);
+    assert(nout == 20 && "elements lost");
+    (void)nout;
+    for (int i = 0; i < 20; ++i) {
+        assert(out[i] == i && "elements out of order");
+    }
+
+    ShmQueue_destroy(prod);
+    ShmQueue_destroy(cons);
+    ShmQueue_unlink(name);
+}
+
+/**
+ * Runs all tests on the ShmQueue ADT.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_roles,
+                          test_write_and_read,
+                          test_across_processes,
+                          test_take_over_from_dead_producer,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/shmqueue_spsc.c test_shmqueue.c -o test_shmqueue -std=c99 -g -Og -Wall -pedantic -march=native -I../src -lrt && ./test_shmqueue
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+ALL PASSED
+*/
@@ -0,0 +1,212 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, rand(), srand()
+#include <stdint.h>   // uint64_t, UINT64_MAX
+#include <stddef.h>   // offsetof()
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "queue.h"        // Queue, Queue_*()
+#include "algos.h"        // Queue_sort(), Queue_radix_sort()
+
+/** An element ordered by `key` and identified by `tag`. */
+typedef struct
+{
+    int      tag;
+    uint64_t key;
+} Tagged;
+
+bool key_less(void const* a, void const* b) {
+    return ((Tagged*)a)->key < ((Tagged*)b)->key;
+}
+
+/**
+ * Fills a queue with `n` elements of random keys below `max_key` tagged in
+ * order, half of which are enqueued after dequeuing as many, so that the
+ * elements wrap around the end of the storage of circular-array queues.
+ */
+Queue* create_test_queue(size_t n, uint64_t max_key) {
+    Queue* q    = Queue_create(sizeof(Tagged));
+    Tagged elem = { 0, 0 };
+    if (q == NULL) handle_error("cannot allocate memory to create a queue");
+
+    for (size_t i = 0; i < n + n / 2; ++i) {
+        elem.key = ((uint64_t)rand() << 32 ^ (uint64_t)rand()) % max_key;
+        elem.tag = (int)i;
+        if (!Queue_enqueue(q, &elem)) {
+            handle_error("cannot allocate memory to complete enqueue()");
+        }
+        if (i < n / 2 && !Queue_dequeue(q)) {
+            handle_error("Queue_dequeue() returns false when queue not empty");
+        }
+    }
+    return q;
+}
+
+/** Checks that a queue is sorted by key and stable, emptying the queue. */
+void assert_sorted(Queue* q, size_t n, char const* message) {
+    assert(Queue_size(q) == n && message);
+
+    Tagged prev = *(Tagged const*)Queue_peek(q);
+    if (!Queue_dequeue(q)) handle_error("Queue_dequeue() failed");
+
+    while (!Queue_empty(q)) {
+        Tagged const curr = *(Tagged const*)Queue_peek(q);
+        assert((prev.key < curr.key ||
+                (prev.key == curr.key && prev.tag < curr.tag)) &&
+               message);
+        prev = curr;
+        if (!Queue_dequeue(q)) handle_error("Queue_dequeue() failed");
+    }
+    (void)message;
+}
+
+void test_sorting_empty_and_single(void) {
+    Queue* q    = Queue_create(sizeof(Tagged));
+    Tagged elem = { 1, 42 };
+
+    bool res = Queue_sort(q, sizeof(Tagged), key_less);
+    assert(res && Queue_empty(q) && "Queue_sort() fails on empty queue");
+    res = Queue_radix_sort(q, sizeof(Tagged), offsetof(Tagged, key), 8);
+    assert(res && Queue_empty(q) && "Queue_radix_sort() fails on empty queue");
+
+    if (!Queue_enqueue(q, &elem)) {
+        handle_error("cannot allocate memory to complete enqueue()");
+    }
+    res = Queue_sort(q, sizeof(Tagged), key_less);
+    assert(res && Queue_size(q) == 1 && "Queue_sort() fails on single elem");
+    res = Queue_radix_sort(q, sizeof(Tagged), offsetof(Tagged, key), 8);
+    assert(res && Queue_size(q) == 1 &&
+           "Queue_radix_sort() fails on single elem");
+
+    Tagged const* front = Queue_peek(q);
+    assert(front->tag == 1 && front->key == 42 && "sorting changes elements");
+
+    (void)res;
+    Queue_destroy(q);
+}
+
+void test_sorting_is_stable(void) {
+    size_t const sizes[] = { 2, 31, 33, 100, 1000, 5000 };
+    size_t const n_sizes = sizeof(sizes) / sizeof(sizes[0]);
+
+    for (size_t i = 0; i < n_sizes; ++i) {
+        srand(i);
+        Queue* q = create_test_queue(sizes[i], sizes[i] / 4 + 1);
+        if (!Queue_sort(q, sizeof(Tagged), key_less)) {
+            handle_error("cannot allocate memory to complete sort()");
+        }
+        assert_sorted(q, sizes[i], "Queue_sort() does not stable-sort");
+        Queue_destroy(q);
+    }
+}
+
+void test_sorting_sorted_queue(void) {
+    Queue* q = create_test_queue(1000, 1);
+    if (!Queue_sort(q, sizeof(Tagged), key_less)) {
+        handle_error("cannot allocate memory to complete sort()");
+    }
+    assert_sorted(q, 1000, "Queue_sort() reorders equal elements");
+    Queue_destroy(q);
+}
+
+void test_radix_sorting_is_stable(void) {
+    size_t const widths[] = { 1, 2, 3, 4, 8 };
+    size_t const n_widths = sizeof(widths) / sizeof(widths[0]);
+
+    for (size_t i = 0; i < n_widths; ++i) {
+        uint64_t const max_key =
+            widths[i] < 8 ? (uint64_t)1 << (8 * widths[i]) : UINT64_MAX;
+
+        srand(i);
+        Queue* q = create_test_queue(3000, max_key);
+        if (!Queue_radix_sort(q, sizeof(Tagged), offsetof(Tagged, key),
+                              widths[i])) {
+            handle_error("cannot allocate memory to complete radix_sort()");
+        }
+        assert_sorted(q, 3000, "Queue_radix_sort() does not stable-sort");
+        Queue_destroy(q);
+    }
+}
+
+void test_radix_sorting_few_distinct_keys(void) {
+    srand(7);
+    Queue* q = create_test_queue(2000, 3);
+    if (!Queue_radix_sort(q, sizeof(Tagged), offsetof(Tagged, key), 8)) {
+        handle_error("cannot allocate memory to complete radix_sort()");
+    }
+    assert_sorted(q, 2000, "Queue_radix_sort() does not stable-sort");
+    Queue_destroy(q);
+}
+
+/**
+ * Runs all tests on Queue_sort() and Queue_radix_sort().
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_sorting_empty_and_single,
+                          test_sorting_is_stable,
+                          test_sorting_sorted_queue,
+                          test_radix_sorting_is_stable,
+                          test_radix_sorting_few_distinct_keys,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/queue_circ_array.c ../src/sort.c test_sort.c -o test_sort_circ_array -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_sort_circ_array
+
+gcc ../src/queue_linked_list.c ../src/sort.c test_sort.c -o test_sort_linked_list -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_sort_linked_list
+
+gcc ../src/queue_circ_array.c ../src/sort.c test_sort.c -o test_sort_circ_array -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_sort_circ_array
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/
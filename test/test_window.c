@@ -0,0 +1,256 @@
+/*
+BSD 3-Clause License
+
+Copyright (c) 2023, KriztoferY (https://github.com/KriztoferY)
+All rights reserved.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are met:
+
+1. Redistributions of source code must retain the above copyright notice, this
+   list of conditions and the following disclaimer.
+
+2. Redistributions in binary form must reproduce the above copyright notice,
+   this list of conditions and the following disclaimer in the documentation
+   and/or other materials provided with the distribution.
+
+3. Neither the name of the copyright holder nor the names of its
+   contributors may be used to endorse or promote products derived from
+   this software without specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
+AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
+FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
+DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
+OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include <stdlib.h>   // EXIT_*, malloc(), free(), rand(), srand()
+#include <stdint.h>   // uint32_t, uint64_t
+#include <stdio.h>    // printf(), stderr
+#include <assert.h>   // assert()
+
+#include "test_utils.h"   // UnitTest, run_tests(), handle_error()
+#include "algos.h"        // MonoWindow, AggWindow, ...
+
+static size_t const WIDTHS[] = { 1, 2, 3, 10, 100, 1000 };
+static size_t const N_ELEMS  = 5000;
+
+/** Modulus of the affine functions composed by `compose()`. */
+static uint32_t const MODULUS = 1000003;
+
+/** An affine function `x -> a * x + b` modulo `MODULUS`. */
+typedef struct
+{
+    uint32_t a;
+    uint32_t b;
+} Affine;
+
+bool less(void const* a, void const* b) { return *(int*)a < *(int*)b; }
+
+bool greater(void const* a, void const* b) { return *(int*)a > *(int*)b; }
+
+void add(void* out, void const* a, void const* b) {
+    *(long*)out = *(long const*)a + *(long const*)b;
+}
+
+/** Composes two affine functions, applying `a` first; it isn't commutative. */
+void compose(void* out, void const* a, void const* b) {
+    Affine const* f = a;
+    Affine const* g = b;
+    Affine* const h = out;
+
+    h->a = (uint32_t)((uint64_t)g->a * f->a % MODULUS);
+    h->b = (uint32_t)(((uint64_t)g->a * f->b + g->b) % MODULUS);
+}
+
+/** Creates an array of `n` random integers, of few distinct values. */
+int* create_test_elems(size_t n) {
+    int* elems = malloc(n * sizeof(int));
+    if (elems == NULL) handle_error("cannot allocate memory for elements");
+
+    for (size_t i = 0; i < n; ++i) elems[i] = rand() % 50;
+    return elems;
+}
+
+/** Finds the index of the extreme of a window by rescanning it. */
+size_t rescan_extreme(int const* elems, size_t end, size_t width,
+                      bool (*compare)(void const*, void const*)) {
+    size_t const begin = end > width ? end - width : 0;
+    size_t       best  = begin;
+    for (size_t i = begin + 1; i < end; ++i) {
+        if (!compare(&elems[best], &elems[i])) best = i;
+    }
+    return best;
+}
+
+void test_mono_window_empty() {
+    //
+    MonoWindow* window = MonoWindow_create(sizeof(int), 3, less);
+    if (window == NULL) handle_error("cannot allocate memory for a window");
+
+    assert(MonoWindow_extreme(window) == NULL &&
+           "MonoWindow_extreme() returns non-NULL value when empty");
+
+    MonoWindow_destroy(window);
+}
+
+void test_mono_window_same_as_rescan() {
+    //
+    bool (*const compares[])(void const*, void const*) = { less, greater };
+
+    srand(1);
+    int* elems = create_test_elems(N_ELEMS);
+
+    for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); ++w) {
+        for (size_t c = 0; c < 2; ++c) {
+            MonoWindow* window =
+                MonoWindow_create(sizeof(int), WIDTHS[w], compares[c]);
+            if (window == NULL) {
+                handle_error("cannot allocate memory for a window");
+            }
+
+            for (size_t i = 0; i < N_ELEMS; ++i) {
+                if (!MonoWindow_push(window, &elems[i])) {
+                    handle_error("cannot allocate memory to push()");
+                }
+
+                // Of equal elements, the extreme is the most recent one
+                int const*   extreme = MonoWindow_extreme(window);
+                size_t const best =
+                    rescan_extreme(elems, i + 1, WIDTHS[w], compares[c]);
+                assert(extreme != NULL && *extreme == elems[best] &&
+                       "MonoWindow_extreme() differs from rescanning");
+                (void)extreme;
+                (void)best;
+            }
+            MonoWindow_destroy(window);
+        }
+    }
+    free(elems);
+}
+
+void test_agg_window_empty() {
+    //
+    AggWindow* window = AggWindow_create(sizeof(long), 3, add);
+    long       sum    = 0;
+    if (window == NULL) handle_error("cannot allocate memory for a window");
+
+    assert(!AggWindow_aggregate(window, &sum) &&
+           "AggWindow_aggregate() returns true when empty");
+
+    (void)sum;
+    AggWindow_destroy(window);
+}
+
+void test_agg_window_sum_same_as_rescan() {
+    //
+    srand(2);
+    int* elems = create_test_elems(N_ELEMS);
+
+    for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); ++w) {
+        AggWindow* window = AggWindow_create(sizeof(long), WIDTHS[w], add);
+        if (window == NULL) handle_error("cannot allocate memory for a window");
+
+        for (size_t i = 0; i < N_ELEMS; ++i) {
+            long const elem = elems[i];
+            if (!AggWindow_push(window, &elem)) {
+                handle_error("cannot allocate memory to push()");
+            }
+
+            long expected = 0, actual = 0;
+            for (size_t j = i + 1 > WIDTHS[w] ? i + 1 - WIDTHS[w] : 0; j <= i;
+                 ++j) {
+                expected += elems[j];
+            }
+            bool const res = AggWindow_aggregate(window, &actual);
+            assert(res && actual == expected &&
+                   "AggWindow_aggregate() differs from rescanning");
+            (void)res;
+        }
+        AggWindow_destroy(window);
+    }
+    free(elems);
+}
+
+void test_agg_window_keeps_operand_order() {
+    //
+    srand(3);
+    size_t const n     = 2000;
+    Affine*      funcs = malloc(n * sizeof(Affine));
+    if (funcs == NULL) handle_error("cannot allocate memory for elements");
+    for (size_t i = 0; i < n; ++i) {
+        funcs[i].a = (uint32_t)rand() % MODULUS;
+        funcs[i].b = (uint32_t)rand() % MODULUS;
+    }
+
+    for (size_t w = 0; w < sizeof(WIDTHS) / sizeof(WIDTHS[0]); ++w) {
+        AggWindow* window =
+            AggWindow_create(sizeof(Affine), WIDTHS[w], compose);
+        if (window == NULL) handle_error("cannot allocate memory for a window");
+
+        for (size_t i = 0; i < n; ++i) {
+            if (!AggWindow_push(window, &funcs[i])) {
+                handle_error("cannot allocate memory to push()");
+            }
+
+            // Compose the functions in the window from the least recent one
+            size_t const begin    = i + 1 > WIDTHS[w] ? i + 1 - WIDTHS[w] : 0;
+            Affine       expected = funcs[begin], actual = { 0, 0 };
+            for (size_t j = begin + 1; j <= i; ++j) {
+                Affine const prev = expected;
+                compose(&expected, &prev, &funcs[j]);
+            }
+            bool const res = AggWindow_aggregate(window, &actual);
+            assert(res && actual.a == expected.a && actual.b == expected.b &&
+                   "AggWindow_aggregate() reorders operands");
+            (void)res;
+        }
+        AggWindow_destroy(window);
+    }
+    free(funcs);
+}
+
+/**
+ * Runs all tests on MonoWindow and AggWindow.
+ */
+int main(int argc, char** argv) {
+    UnitTest utests[] = { test_mono_window_empty,
+                          test_mono_window_same_as_rescan,
+                          test_agg_window_empty,
+                          test_agg_window_sum_same_as_rescan,
+                          test_agg_window_keeps_operand_order,
+                          NULL };
+
+    run_tests(utests);
+    return EXIT_SUCCESS;
+}
+
+// -----------------------------------------------------------------------------
+
+// clang-format off
+
+/* === COMPILE & RUN ===
+gcc ../src/deque_circ_array.c ../src/window.c test_window.c -o test_window -std=c99 -g -Og -Wall -pedantic -march=native -I../src && ./test_window
+
+gcc ../src/deque_circ_array.c ../src/window.c test_window.c -o test_window -std=c99 -O3 -march=native -DNDEBUG -I../src && ./test_window
+*/
+
+/* === OUTPUT ===
+Running...
+Test 1 passed 👍
+Running...
+Test 2 passed 👍
+Running...
+Test 3 passed 👍
+Running...
+Test 4 passed 👍
+Running...
+Test 5 passed 👍
+ALL PASSED
+*/